@@ -3,6 +3,7 @@
 #include "../user.pb.h"
 #include "Krpcapplication.h"
 #include "Krpcprovider.h"
+#include "KrpcLog.h"
 
 /*
 UserService 原本是一个本地服务，提供了两个本地方法：Login 和 GetFriendLists。
@@ -13,8 +14,7 @@ class UserService : public Kuser::UserServiceRpc // 继承自 protobuf 生成的
 public:
     // 本地登录方法，用于处理实际的业务逻辑
     bool Login(std::string name, std::string pwd) {
-        std::cout << "doing local service: Login" << std::endl;
-        std::cout << "name:" << name << " pwd:" << pwd << std::endl;  
+        KRPC_LOG_DEBUG("doing local service: Login name:{}", name);
         return true;  // 模拟登录成功
     }
     void Add(::google::protobuf::RpcController* controller,
@@ -24,7 +24,7 @@ public:
     int32_t a = request->a();
     int32_t b = request->b();
     int32_t result = a + b;
-    std::cout << result << std::endl;
+    KRPC_LOG_DEBUG("Add {} + {} = {}", a, b, result);
     usleep(1000 * 1000); // 模拟耗时操作
     // 填入 ResultCode
     Kuser::ResultCode* code = response->mutable_result();
@@ -6,6 +6,7 @@
 #include <thread>
 #include <chrono>
 #include "KrpcLogger.h"
+#include "KrpcMetrics.h"
 
 void send_add_request(int thread_id,
                       std::atomic<int>& success_count,
@@ -59,14 +60,14 @@ void send_request(int thread_id, std::atomic<int> &success_count, std::atomic<in
 
     // 检查 RPC 调用是否成功
     if (controller.Failed()) {  // 如果调用失败
-        std::cout << controller.ErrorText() << std::endl;  // 打印错误信息
+        KRPC_LOG_ERROR("rpc login failed: {}", controller.ErrorText());  // 记录错误信息
         fail_count++;  // 失败计数加 1
     } else {  // 如果调用成功
         if (0 == response.result().errcode()) {  // 检查响应中的错误码
-            std::cout << "rpc login response success:" << response.success() << std::endl;  // 打印成功信息
+            KRPC_LOG_DEBUG("rpc login response success:{}", response.success());  // 记录成功信息
             success_count++;  // 成功计数加 1
         } else {  // 如果响应中有错误
-            std::cout << "rpc login response error : " << response.result().errmsg() << std::endl;  // 打印错误信息
+            KRPC_LOG_ERROR("rpc login response error : {}", response.result().errmsg());  // 记录错误信息
             fail_count++;  // 失败计数加 1
         }
     }
@@ -105,5 +106,21 @@ int main(int argc, char** argv) {
   LOG(INFO) << "Elapsed(sec): "   << elapsed;
   LOG(INFO) << "QPS: "            << (total / elapsed);
 
+  // 每个方法的耗时分布（微秒）
+  std::vector<KrpcMethodStats> stats = KrpcMetrics::Instance().Snapshot();
+  for (size_t i = 0; i < stats.size(); ++i) {
+    const KrpcHistogram &latency = stats[i].latency;
+    LOG(INFO) << stats[i].service << "." << stats[i].method << " requests: " << stats[i].requests
+              << " errors: " << stats[i].errors << " p50(us): " << latency.ValueAtQuantile(0.5) / 1000
+              << " p99(us): " << latency.ValueAtQuantile(0.99) / 1000 << " max(us): " << latency.Max() / 1000;
+  }
+  // 各阶段的耗时分布，看出慢的调用时间花在了哪里
+  std::vector<KrpcPhaseStats> phases = KrpcMetrics::Instance().PhaseSnapshot();
+  for (size_t i = 0; i < phases.size(); ++i) {
+    LOG(INFO) << phases[i].side << " " << KrpcPhaseName(phases[i].phase)
+              << " p50(us): " << phases[i].latency.ValueAtQuantile(0.5) / 1000
+              << " p99(us): " << phases[i].latency.ValueAtQuantile(0.99) / 1000;
+  }
+
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "KrpcAdaptiveCompress.h"
+#include "Krpcapplication.h"
+#include "KrpcLogger.h"
+#include "KrpcMetrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+// 候选的压缩方式，ratio和ns_per_byte是还没有样本时的估计
+struct CandidateSpec
+{
+    Krpc::CompressType type;
+    int level;
+    const char *name;
+    double ratio;
+    double ns_per_byte;
+};
+const CandidateSpec kCandidates[kCompressCandidates] = {
+    {Krpc::COMPRESS_NONE, 0, "none", 1.0, 0.0},
+    {Krpc::COMPRESS_LZ4, 0, "lz4", 0.5, 1.0},
+    {Krpc::COMPRESS_ZSTD, 1, "zstd1", 0.35, 3.0},
+    {Krpc::COMPRESS_ZSTD, 3, "zstd3", 0.3, 6.0},
+    {Krpc::COMPRESS_ZSTD, 9, "zstd9", 0.27, 30.0},
+};
+
+const int kWarmupSamples = 2;         // 每种方式至少先试用的次数
+const uint64_t kProbeInterval = 64;   // 每隔多少条负载轮流试用一种方式
+const double kSmoothing = 0.2;        // 压缩率和耗时估计的平滑系数
+const double kRateSmoothing = 0.3;    // 链路速率估计的平滑系数
+const double kMinAvailableShare = 0.05; // 链路饱和时仍然认为剩余的带宽比例
+const double kSwitchMargin = 0.9;     // 新方式的估计耗时至少低10%才切换，避免来回抖动
+const std::chrono::milliseconds kRateWindow(100);
+const double kDefaultLinkMbps = 1000;
+
+bool Usable(int candidate, uint32_t usable_mask) {
+    return candidate == 0 || (usable_mask & KrpcCompressBit(kCandidates[candidate].type));
+}
+
+// 发送速率统计窗口已满时结算，调用时已经持有link->mutex
+void RollWindow(KrpcLinkStats *link, std::chrono::steady_clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - link->window_start).count();
+    if (now - link->window_start < kRateWindow) {
+        return;
+    }
+    double rate = link->window_bytes / elapsed;
+    link->bytes_per_second = link->bytes_per_second * (1 - kRateSmoothing) + rate * kRateSmoothing;
+    link->window_start = now;
+    link->window_bytes = 0;
+}
+}  // namespace
+
+KrpcCompressTracker::KrpcCompressTracker(const std::string &peer, const std::string &method, KrpcLinkStats *link,
+                                         double link_bytes_per_second)
+    : peer_(peer), method_(method), link_(link), link_capacity_(link_bytes_per_second) {
+    for (int i = 0; i < kCompressCandidates; ++i) {
+        candidates_[i].ratio = kCandidates[i].ratio;
+        candidates_[i].ns_per_byte = kCandidates[i].ns_per_byte;
+    }
+}
+
+// 链路剩余带宽（字节/秒）
+double KrpcCompressTracker::AvailableBandwidth() {
+    std::lock_guard<std::mutex> lock(link_->mutex);
+    RollWindow(link_, std::chrono::steady_clock::now());
+    double utilization = std::min(link_->bytes_per_second / link_capacity_, 1.0);
+    return link_capacity_ * std::max(1 - utilization, kMinAvailableShare);
+}
+
+KrpcCompressChoice KrpcCompressTracker::Choose(uint32_t peer_mask) {
+    uint32_t usable_mask = peer_mask & KrpcCompressPolicy::Instance().SupportedMask();
+    double available = AvailableBandwidth();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++payloads_;
+    int pick = -1;
+    // 还没有样本的方式先试用几次，之后定期轮流试用，让估计跟上数据的变化
+    for (int i = 1; i < kCompressCandidates && pick < 0; ++i) {
+        if (Usable(i, usable_mask) && candidates_[i].samples < kWarmupSamples) {
+            pick = i;
+        }
+    }
+    if (pick < 0 && payloads_ % kProbeInterval == 0) {
+        for (int i = 1; i < kCompressCandidates && pick < 0; ++i) {
+            int candidate = next_probe_;
+            next_probe_ = next_probe_ % (kCompressCandidates - 1) + 1;
+            if (candidate != current_ && Usable(candidate, usable_mask)) {
+                pick = candidate;
+            }
+        }
+    }
+    if (pick < 0) {
+        // 每字节的估计耗时：压缩耗时 + 压缩后的字节在剩余带宽上的传输时间
+        double cost[kCompressCandidates];
+        int best = 0;
+        for (int i = 0; i < kCompressCandidates; ++i) {
+            cost[i] = candidates_[i].ns_per_byte * 1e-9 + candidates_[i].ratio / available;
+            if (Usable(i, usable_mask) && cost[i] < cost[best]) {
+                best = i;
+            }
+        }
+        if (best != current_ && (!Usable(current_, usable_mask) || cost[best] < cost[current_] * kSwitchMargin)) {
+            LOG(INFO) << "compression for " << method_ << " to " << peer_ << " switched from "
+                      << kCandidates[current_].name << " to " << kCandidates[best].name << " (ratio "
+                      << candidates_[best].ratio << ", " << candidates_[best].ns_per_byte << " ns/byte, available "
+                      << available / 1e6 << " MB/s)";
+            current_ = best;
+        }
+        pick = current_;
+    }
+
+    KrpcCompressChoice choice;
+    choice.type = kCandidates[pick].type;
+    choice.level = kCandidates[pick].level;
+    choice.candidate = pick;
+    return choice;
+}
+
+void KrpcCompressTracker::Record(const KrpcCompressChoice &choice, size_t raw_size, size_t wire_size,
+                                 int64_t compress_ns) {
+    if (choice.candidate < 0 || choice.candidate >= kCompressCandidates || raw_size == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Candidate &c = candidates_[choice.candidate];
+        ++c.chosen;
+        c.raw_bytes += raw_size;
+        c.wire_bytes += wire_size;
+        c.compress_ns += compress_ns;
+        if (choice.candidate != 0) {
+            double ratio = static_cast<double>(wire_size) / raw_size;
+            double ns_per_byte = static_cast<double>(compress_ns) / raw_size;
+            bool first = c.samples == 0;
+            c.ratio = first ? ratio : c.ratio * (1 - kSmoothing) + ratio * kSmoothing;
+            c.ns_per_byte = first ? ns_per_byte : c.ns_per_byte * (1 - kSmoothing) + ns_per_byte * kSmoothing;
+            ++c.samples;
+        }
+    }
+    std::lock_guard<std::mutex> lock(link_->mutex);
+    link_->window_bytes += wire_size;
+    RollWindow(link_, std::chrono::steady_clock::now());
+}
+
+int KrpcCompressTracker::Snapshot(Candidate *out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::copy(candidates_, candidates_ + kCompressCandidates, out);
+    return current_;
+}
+
+KrpcAdaptiveCompress &KrpcAdaptiveCompress::Instance() {
+    static KrpcAdaptiveCompress instance;
+    return instance;
+}
+
+KrpcAdaptiveCompress::KrpcAdaptiveCompress() {
+    std::string mbps = KrpcApplication::GetInstance().GetConfig().Load("compress_link_mbps");
+    double link_mbps = mbps.empty() ? kDefaultLinkMbps : atof(mbps.c_str());
+    if (link_mbps <= 0) {
+        link_mbps = kDefaultLinkMbps;
+    }
+    link_capacity_ = link_mbps * 1e6 / 8;
+}
+
+KrpcCompressTracker *KrpcAdaptiveCompress::Tracker(const std::string &peer, const std::string &method) {
+    std::string key = peer + "|" + method;
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<KrpcCompressTracker> &tracker = trackers_[key];
+    if (!tracker) {
+        std::unique_ptr<KrpcLinkStats> &link = links_[peer];
+        if (!link) {
+            link.reset(new KrpcLinkStats());
+            link->window_start = std::chrono::steady_clock::now();
+        }
+        tracker.reset(new KrpcCompressTracker(peer, method, link.get(), link_capacity_));
+    }
+    return tracker.get();
+}
+
+void KrpcAdaptiveCompress::AppendMetrics(std::string *out) {
+    struct Row
+    {
+        std::string labels; // peer和method
+        KrpcCompressTracker::Candidate candidates[kCompressCandidates];
+        int current;
+    };
+    std::vector<Row> rows;
+    std::vector<std::pair<std::string, double>> links;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &item : trackers_) {
+            rows.emplace_back();
+            rows.back().labels = "peer=\"" + item.second->peer_ + "\",method=\"" + item.second->method_ + "\"";
+            rows.back().current = item.second->Snapshot(rows.back().candidates);
+        }
+        for (auto &item : links_) {
+            std::lock_guard<std::mutex> link_lock(item.second->mutex);
+            links.emplace_back(item.first, item.second->bytes_per_second);
+        }
+    }
+
+    // 同一个指标的样本必须连续输出
+    struct Family
+    {
+        const char *name;
+        const char *type;
+        const char *help;
+        double (*value)(const KrpcCompressTracker::Candidate &);
+    };
+    const Family families[] = {
+        {"krpc_compress_payloads", "counter", "Payloads sent with each compression choice.",
+         [](const KrpcCompressTracker::Candidate &c) { return static_cast<double>(c.chosen); }},
+        {"krpc_compress_raw_bytes", "counter", "Payload bytes before compression.",
+         [](const KrpcCompressTracker::Candidate &c) { return static_cast<double>(c.raw_bytes); }},
+        {"krpc_compress_wire_bytes", "counter", "Payload bytes actually sent.",
+         [](const KrpcCompressTracker::Candidate &c) { return static_cast<double>(c.wire_bytes); }},
+        {"krpc_compress_saved_bytes", "counter", "Bytes saved by compression.",
+         [](const KrpcCompressTracker::Candidate &c) { return static_cast<double>(c.raw_bytes - c.wire_bytes); }},
+        {"krpc_compress_cpu_seconds", "counter", "Time spent compressing.",
+         [](const KrpcCompressTracker::Candidate &c) { return c.compress_ns * 1e-9; }},
+        {"krpc_compress_ratio", "gauge", "Smoothed compressed/raw size ratio.",
+         [](const KrpcCompressTracker::Candidate &c) { return c.ratio; }},
+    };
+    for (const Family &family : families) {
+        KrpcAppendMetricFamily(out, family.name, family.type, family.help);
+        // OpenMetrics中counter的样本名带_total后缀
+        std::string sample = std::string(family.name) + (strcmp(family.type, "counter") == 0 ? "_total" : "");
+        for (const Row &row : rows) {
+            for (int i = 0; i < kCompressCandidates; ++i) {
+                if (row.candidates[i].chosen > 0) {
+                    KrpcAppendMetricSample(out, sample, row.labels + ",codec=\"" + kCandidates[i].name + "\"",
+                                           family.value(row.candidates[i]));
+                }
+            }
+        }
+    }
+    KrpcAppendMetricFamily(out, "krpc_compress_selected", "gauge",
+                           "Compression choice currently preferred for a peer and method.");
+    for (const Row &row : rows) {
+        for (int i = 0; i < kCompressCandidates; ++i) {
+            KrpcAppendMetricSample(out, "krpc_compress_selected",
+                                   row.labels + ",codec=\"" + kCandidates[i].name + "\"", i == row.current ? 1 : 0);
+        }
+    }
+    KrpcAppendMetricFamily(out, "krpc_compress_link_bytes_per_second", "gauge", "Smoothed send rate to a peer.");
+    for (const auto &link : links) {
+        KrpcAppendMetricSample(out, "krpc_compress_link_bytes_per_second", "peer=\"" + link.first + "\"",
+                               link.second);
+    }
+}
+
+bool KrpcCompressPayload(KrpcCompressor *compressor, KrpcCompressTracker *tracker, const KrpcCompressChoice &choice,
+                         const std::string &raw, std::string *out) {
+    bool compressed = false;
+    int64_t compress_ns = 0;
+    if (choice.type != Krpc::COMPRESS_NONE) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        compressed = compressor->Compress(choice.type, choice.level, raw.data(), raw.size(), out) &&
+                     out->size() < raw.size();
+        compress_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                          .count();
+    }
+    if (tracker != nullptr) {
+        tracker->Record(choice, raw.size(), compressed ? out->size() : raw.size(), compress_ns);
+    }
+    return compressed;
+}
@@ -0,0 +1,93 @@
+#include "KrpcAdminServer.h"
+#include "KrpcLogger.h"
+#include <muduo/net/InetAddress.h>
+#include <cstring>
+
+namespace {
+const size_t kMaxRequestBytes = 8 * 1024;  // 请求头的上限，管理端口只需要处理很短的GET请求
+const char *kOpenMetricsType = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+}  // namespace
+
+KrpcAdminServer::KrpcAdminServer(muduo::net::EventLoop *loop, const std::string &ip, uint16_t port,
+                                 MetricsCollector collector)
+    : server_(new muduo::net::TcpServer(loop, muduo::net::InetAddress(ip, port), "KrpcAdmin")),
+      collector_(std::move(collector)) {
+    server_->setConnectionCallback(std::bind(&KrpcAdminServer::OnConnection, this, std::placeholders::_1));
+    server_->setMessageCallback(std::bind(&KrpcAdminServer::OnMessage, this, std::placeholders::_1,
+                                          std::placeholders::_2, std::placeholders::_3));
+}
+
+void KrpcAdminServer::AddPage(const std::string &path, PageHandler handler) {
+    pages_[path] = std::move(handler);
+}
+
+// 不设置线程数，所有连接都在loop中处理
+void KrpcAdminServer::Start() {
+    server_->start();
+}
+
+void KrpcAdminServer::OnConnection(const muduo::net::TcpConnectionPtr &conn) {
+    if (!conn->connected()) {
+        conn->shutdown();
+    }
+}
+
+// 只支持GET /metrics和登记过的页面，每个连接回复一次后关闭
+void KrpcAdminServer::OnMessage(const muduo::net::TcpConnectionPtr &conn, muduo::net::Buffer *buffer,
+                                muduo::Timestamp receive_time) {
+    std::string request(buffer->peek(), buffer->readableBytes());
+    size_t header_end = request.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+        if (request.size() > kMaxRequestBytes) {
+            buffer->retrieveAll();
+            Reply(conn, "431 Request Header Fields Too Large", "text/plain", "request too large\n");
+        }
+        return;
+    }
+    buffer->retrieveAll();
+    size_t line_end = request.find("\r\n");
+    std::string line = request.substr(0, line_end);
+    size_t method_end = line.find(' ');
+    size_t path_end = line.find(' ', method_end == std::string::npos ? 0 : method_end + 1);
+    if (method_end == std::string::npos || path_end == std::string::npos) {
+        Reply(conn, "400 Bad Request", "text/plain", "bad request\n");
+        return;
+    }
+    std::string method = line.substr(0, method_end);
+    std::string path = line.substr(method_end + 1, path_end - method_end - 1);
+    size_t query_begin = path.find('?');
+    std::string query = query_begin == std::string::npos ? std::string() : path.substr(query_begin + 1);
+    path = path.substr(0, query_begin);
+    if (method != "GET") {
+        Reply(conn, "405 Method Not Allowed", "text/plain", "only GET is supported\n");
+        return;
+    }
+    auto page = pages_.find(path);
+    if (page != pages_.end()) {
+        std::string body;
+        page->second(query, &body);
+        Reply(conn, "200 OK", "text/plain; charset=utf-8", body);
+        return;
+    }
+    if (path != "/metrics") {
+        Reply(conn, "404 Not Found", "text/plain", "not found, try /metrics\n");
+        return;
+    }
+    std::string body;
+    collector_(&body);
+    body.append("# EOF\n");
+    Reply(conn, "200 OK", kOpenMetricsType, body);
+}
+
+void KrpcAdminServer::Reply(const muduo::net::TcpConnectionPtr &conn, const char *status, const char *content_type,
+                            const std::string &body) {
+    std::string response;
+    response.reserve(body.size() + 256);
+    response.append("HTTP/1.1 ").append(status).append("\r\n");
+    response.append("Content-Type: ").append(content_type).append("\r\n");
+    response.append("Content-Length: ").append(std::to_string(body.size())).append("\r\n");
+    response.append("Connection: close\r\n\r\n");
+    response.append(body);
+    conn->send(response);
+    conn->shutdown();  // 数据写完后关闭写端
+}
@@ -0,0 +1,114 @@
+#include "KrpcAffinity.h"
+#include "KrpcLogger.h"
+#include "Krpcapplication.h"
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+// 读取sysfs文件的第一行
+std::string ReadFirstLine(const std::string &path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+}  // namespace
+
+std::vector<int> KrpcAffinity::ParseCpuList(const std::string &spec) {
+    std::vector<int> cpus;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        char *end = nullptr;
+        long first = strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) {
+            LOG(ERROR) << "invalid cpu list item: " << item;
+            continue;
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+std::vector<int> KrpcAffinity::CpusFromConfig(const std::string &key) {
+    Krpcconfig &config = KrpcApplication::GetInstance().GetConfig();
+    std::vector<int> cpus = ParseCpuList(config.Load(key));
+    if (key != "reactor_cpus") {
+        return cpus;
+    }
+
+    // IO线程放到网卡所在的NUMA节点上，新连接无论分给哪个IO线程都不会跨节点收发数据
+    std::string nic = config.Load("nic_numa_steer");
+    if (nic.empty()) {
+        return cpus;
+    }
+    std::vector<int> node_cpus = NodeCpus(NicNumaNode(nic));
+    if (node_cpus.empty()) {
+        LOG(WARNING) << "unknown numa node for nic " << nic << ", nic_numa_steer ignored";
+        return cpus;
+    }
+    if (cpus.empty()) {
+        return node_cpus;
+    }
+    std::vector<int> local;
+    for (int cpu : cpus) {
+        if (std::find(node_cpus.begin(), node_cpus.end(), cpu) != node_cpus.end()) {
+            local.push_back(cpu);
+        }
+    }
+    if (local.empty()) {
+        LOG(WARNING) << "reactor_cpus has no cpu on the numa node of " << nic << ", nic_numa_steer ignored";
+        return cpus;
+    }
+    return local;
+}
+
+bool KrpcAffinity::PinCurrentThread(const std::vector<int> &cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (ret != 0) {
+        LOG(ERROR) << "pthread_setaffinity_np error: " << strerror(ret);
+        return false;
+    }
+    return true;
+}
+
+bool KrpcAffinity::PinCurrentThread(int cpu) {
+    return PinCurrentThread(std::vector<int>{cpu});
+}
+
+int KrpcAffinity::NicNumaNode(const std::string &nic) {
+    std::string line = ReadFirstLine("/sys/class/net/" + nic + "/device/numa_node");
+    if (line.empty()) {
+        return -1;
+    }
+    return atoi(line.c_str());  // 单节点机器上内核会返回-1
+}
+
+std::vector<int> KrpcAffinity::NodeCpus(int node) {
+    if (node < 0) {
+        return {};
+    }
+    return ParseCpuList(ReadFirstLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+}
@@ -0,0 +1,84 @@
+#include "KrpcResource.h"
+#include <cstdlib>
+#include <new>
+
+// 替换全局的operator new/delete，按线程统计分配。这个文件不编进krpc_core，
+// 只有链接了krpc_alloc_accounting对象库的程序才会替换；内存仍然来自malloc（可以是jemalloc、tcmalloc等替换后的malloc）
+namespace {
+// 平凡类型的thread_local，访问时不需要初始化检查，在operator new里使用是安全的
+thread_local uint64_t t_alloc_bytes = 0;
+thread_local uint64_t t_alloc_count = 0;
+
+KrpcAllocCounters ReadCounters() {
+    KrpcAllocCounters counters;
+    counters.bytes = t_alloc_bytes;
+    counters.count = t_alloc_count;
+    return counters;
+}
+
+// 静态初始化时登记，之后KrpcThreadAllocCounters返回本文件的计数
+struct Registrar
+{
+    Registrar() { KrpcRegisterAllocCounters(&ReadCounters); }
+} g_registrar;
+
+inline void *CountedAlloc(std::size_t size) {
+    t_alloc_bytes += size;
+    ++t_alloc_count;
+    return malloc(size == 0 ? 1 : size);
+}
+
+void *CountedAllocOrThrow(std::size_t size) {
+    while (true) {
+        void *p = CountedAlloc(size);
+        if (p != nullptr) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+}  // namespace
+
+void *operator new(std::size_t size) {
+    return CountedAllocOrThrow(size);
+}
+
+void *operator new[](std::size_t size) {
+    return CountedAllocOrThrow(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return CountedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return CountedAlloc(size);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    free(p);
+}
@@ -0,0 +1,302 @@
+#include "KrpcBulk.h"
+#ifdef KRPC_WITH_UCX
+#include "Krpcapplication.h"
+#include "KrpcCompress.h"
+#include "KrpcLogger.h"
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+// 暴露的内存在对端没有通知释放时最多保留的时间
+const std::chrono::seconds kExposeTimeout(60);
+// 检查过期暴露的间隔
+const std::chrono::seconds kExpireCheckInterval(1);
+}  // namespace
+
+std::shared_ptr<UCXContext> KrpcSharedUcxContext() {
+    static std::shared_ptr<UCXContext> context = [] {
+        Krpcconfig &config = KrpcApplication::GetInstance().GetConfig();
+        std::string pool_bytes = config.Load("ucx_pool_bytes");
+        return UCXContext::Create(config.Load("ucx_transports"),
+                                  pool_bytes.empty() ? kUCXDefaultPoolBytes : strtoull(pool_bytes.c_str(), nullptr, 10));
+    }();
+    return context;
+}
+
+// 一次正在进行的RMA读取
+struct KrpcBulkAgent::FetchOp
+{
+    KrpcBulkAgent *agent;
+    ucp_ep_h ep;
+    ucp_rkey_h rkey;
+    UCXBuffer data;
+    uint64_t bulk_id;
+    FetchCallback done;
+};
+
+KrpcBulkAgent *KrpcBulkAgent::Instance() {
+    static KrpcBulkAgent *agent = []() -> KrpcBulkAgent * {
+        std::string threshold = KrpcApplication::GetInstance().GetConfig().Load("ucx_bulk_threshold");
+        size_t bytes = strtoull(threshold.c_str(), nullptr, 10);
+        if (bytes == 0) {
+            return nullptr;
+        }
+        std::shared_ptr<UCXContext> context = KrpcSharedUcxContext();
+        if (!context) {
+            return nullptr;
+        }
+        KrpcBulkAgent *instance = new KrpcBulkAgent(context, bytes);
+        if (!instance->Init()) {
+            LOG(ERROR) << "init ucx bulk agent error, large payloads stay on the normal path";
+            delete instance;
+            return nullptr;
+        }
+        return instance;
+    }();
+    return agent;
+}
+
+KrpcBulkAgent::KrpcBulkAgent(const std::shared_ptr<UCXContext> &context, size_t threshold)
+    : loop_(context), threshold_(threshold) {}
+
+bool KrpcBulkAgent::Init() {
+    if (!loop_.init() || !loop_.worker()->setAmHandler(kUCXAmBulkRelease, &KrpcBulkAgent::OnRelease, this)) {
+        return false;
+    }
+    ucp_address_t *address = nullptr;
+    size_t address_length = 0;
+    ucs_status_t status = ucp_worker_get_address(loop_.worker()->handle(), &address, &address_length);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_worker_get_address error: " << ucs_status_string(status);
+        return false;
+    }
+    worker_address_.assign(reinterpret_cast<const char *>(address), address_length);
+    ucp_worker_release_address(loop_.worker()->handle(), address);
+
+    next_expire_check_ = std::chrono::steady_clock::now() + kExpireCheckInterval;
+    // 对端读取暴露的内存时，某些传输（tcp、shm等）需要本端推进worker，因此始终运行一个progress线程
+    loop_.start(nullptr);
+    return true;
+}
+
+bool KrpcBulkAgent::Expose(UCXBuffer data, Krpc::BulkDescriptor *desc) {
+    void *rkey_buffer = nullptr;
+    size_t rkey_size = 0;
+    ucs_status_t status = ucp_rkey_pack(loop_.context().handle(), data.memh(), &rkey_buffer, &rkey_size);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_rkey_pack error: " << ucs_status_string(status);
+        return false;
+    }
+    desc->set_rkey(rkey_buffer, rkey_size);
+    ucp_rkey_buffer_release(rkey_buffer);
+    desc->set_worker_address(worker_address_);
+    desc->set_remote_addr(reinterpret_cast<uint64_t>(data.data()));
+    desc->set_length(data.size());
+
+    std::lock_guard<std::mutex> lock(exposures_mutex_);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now >= next_expire_check_) {
+        ExpireExposures();
+        next_expire_check_ = now + kExpireCheckInterval;
+    }
+    uint64_t bulk_id = ++next_bulk_id_;
+    desc->set_bulk_id(bulk_id);
+    Exposure &exposure = exposures_[bulk_id];
+    exposure.data = std::move(data);
+    exposure.expire = now + kExposeTimeout;
+    return true;
+}
+
+void KrpcBulkAgent::Release(uint64_t bulk_id) {
+    UCXBuffer data;
+    {
+        std::lock_guard<std::mutex> lock(exposures_mutex_);
+        auto it = exposures_.find(bulk_id);
+        if (it == exposures_.end()) {
+            return;  // 对端已经通知过，缓冲区已经归还
+        }
+        data = std::move(it->second.data);
+        exposures_.erase(it);
+    }
+    data.discard();  // 注销比较慢，放在锁外进行
+}
+
+void KrpcBulkAgent::Recycle(uint64_t bulk_id) {
+    std::lock_guard<std::mutex> lock(exposures_mutex_);
+    exposures_.erase(bulk_id);
+}
+
+// 调用时已经持有exposures_mutex_
+void KrpcBulkAgent::ExpireExposures() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for (auto it = exposures_.begin(); it != exposures_.end();) {
+        if (it->second.expire <= now) {
+            LOG(WARNING) << "bulk payload " << it->first << " was never fetched, released";
+            it->second.data.discard();
+            it = exposures_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void KrpcBulkAgent::FetchAsync(const Krpc::BulkDescriptor &desc, FetchCallback done) {
+    loop_.queueInLoop([this, desc, done]() { StartFetch(desc, done); });
+}
+
+bool KrpcBulkAgent::Fetch(const Krpc::BulkDescriptor &desc, int timeout_ms, UCXBuffer *data) {
+    if (loop_.isInLoopThread()) {
+        LOG(ERROR) << "synchronous bulk fetch from the ucx progress thread";
+        return false;
+    }
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool done = false;
+        bool ok = false;
+        UCXBuffer data;
+    };
+    std::shared_ptr<State> state = std::make_shared<State>();
+    FetchAsync(desc, [state](bool ok, UCXBuffer result) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->ok = ok;
+        state->data = std::move(result);
+        state->done = true;
+        state->cond.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (!state->cond.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&state] { return state->done; })) {
+        return false; // 读取仍在进行，缓冲区由回调持有，完成后自然归还内存池
+    }
+    if (!state->ok) {
+        return false;
+    }
+    *data = std::move(state->data);
+    return true;
+}
+
+void KrpcBulkAgent::StartFetch(const Krpc::BulkDescriptor &desc, FetchCallback done) {
+    if (desc.length() > KrpcCompressPolicy::Instance().MaxMessageBytes()) {
+        // 描述符中的长度由对端填写，超过负载上限时不分配
+        LOG(ERROR) << "bulk payload of " << desc.length() << " bytes exceeds max_message_bytes";
+        done(false, UCXBuffer());
+        return;
+    }
+    ucp_ep_h ep = EndpointFor(desc.worker_address());
+    if (ep == nullptr) {
+        done(false, UCXBuffer());
+        return;
+    }
+    ucp_rkey_h rkey = nullptr;
+    ucs_status_t status = ucp_ep_rkey_unpack(ep, desc.rkey().data(), &rkey);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_ep_rkey_unpack error: " << ucs_status_string(status);
+        done(false, UCXBuffer());
+        return;
+    }
+    UCXBuffer data = pool().acquire(desc.length());
+    if (!data) {
+        ucp_rkey_destroy(rkey);
+        done(false, UCXBuffer());
+        return;
+    }
+
+    FetchOp *op = new FetchOp{this, ep, rkey, std::move(data), desc.bulk_id(), std::move(done)};
+    ucp_request_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+    param.cb.send = &KrpcBulkAgent::OnFetchDone;
+    param.user_data = op;
+    UCXSetMemoryHandle(&param, op->data);
+    ucs_status_ptr_t request = ucp_get_nbx(ep, op->data.data(), op->data.size(), desc.remote_addr(), rkey, &param);
+    if (request == nullptr) {
+        OnFetchDone(nullptr, UCS_OK, op);
+    } else if (UCS_PTR_IS_ERR(request)) {
+        OnFetchDone(nullptr, UCS_PTR_STATUS(request), op);
+    }
+}
+
+void KrpcBulkAgent::OnFetchDone(void *request, ucs_status_t status, void *user_data) {
+    std::unique_ptr<FetchOp> op(static_cast<FetchOp *>(user_data));
+    if (request != nullptr) {
+        ucp_request_free(request);
+    }
+    ucp_rkey_destroy(op->rkey);
+    if (status == UCS_OK) {
+        op->agent->SendRelease(op->ep, op->bulk_id);
+    } else {
+        // 失败时不通知，对端暴露的内存超时后回收
+        LOG(ERROR) << "fetch bulk payload error: " << ucs_status_string(status);
+    }
+    op->done(status == UCS_OK, std::move(op->data));
+}
+
+// 按对端worker地址取得端点，没有时新建
+ucp_ep_h KrpcBulkAgent::EndpointFor(const std::string &worker_address) {
+    auto it = endpoints_.find(worker_address);
+    if (it != endpoints_.end()) {
+        return it->second;
+    }
+    ucp_ep_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS | UCP_EP_PARAM_FIELD_ERR_HANDLER |
+                        UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE;
+    params.address = reinterpret_cast<const ucp_address_t *>(worker_address.data());
+    params.err_mode = UCP_ERR_HANDLING_MODE_PEER;
+    params.err_handler.cb = &KrpcBulkAgent::OnError;
+    params.err_handler.arg = this;
+    ucp_ep_h ep = nullptr;
+    ucs_status_t status = ucp_ep_create(loop_.worker()->handle(), &params, &ep);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "create ucx endpoint for bulk fetch error: " << ucs_status_string(status);
+        return nullptr;
+    }
+    endpoints_[worker_address] = ep;
+    return ep;
+}
+
+// 通知对端读取已经完成，可以释放暴露的内存
+void KrpcBulkAgent::SendRelease(ucp_ep_h ep, uint64_t bulk_id) {
+    uint64_t *header = new uint64_t(bulk_id); // 发送完成前头部必须保持有效
+    ucp_request_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+    param.cb.send = &KrpcBulkAgent::OnReleaseSent;
+    param.user_data = header;
+    ucs_status_ptr_t request = ucp_am_send_nbx(ep, kUCXAmBulkRelease, header, sizeof(*header), nullptr, 0, &param);
+    if (!UCS_PTR_IS_PTR(request)) {
+        delete header;
+    }
+}
+
+void KrpcBulkAgent::OnReleaseSent(void *request, ucs_status_t status, void *user_data) {
+    delete static_cast<uint64_t *>(user_data);
+    ucp_request_free(request);
+}
+
+ucs_status_t KrpcBulkAgent::OnRelease(void *arg, const void *header, size_t header_length, void *data, size_t length,
+                                      const ucp_am_recv_param_t *param) {
+    if (header_length == sizeof(uint64_t)) {
+        uint64_t bulk_id = 0;
+        memcpy(&bulk_id, header, sizeof(bulk_id));
+        static_cast<KrpcBulkAgent *>(arg)->Recycle(bulk_id);
+    }
+    return UCS_OK;
+}
+
+void KrpcBulkAgent::OnError(void *arg, ucp_ep_h ep, ucs_status_t status) {
+    KrpcBulkAgent *agent = static_cast<KrpcBulkAgent *>(arg);
+    for (auto it = agent->endpoints_.begin(); it != agent->endpoints_.end(); ++it) {
+        if (it->second == ep) {
+            agent->endpoints_.erase(it);
+            break;
+        }
+    }
+    // 回调中不能推进worker，端点留到本轮progress结束后再关闭
+    agent->loop_.queueInLoop([agent, ep]() { agent->loop_.closeEndpoint(ep); });
+}
+
+#endif // KRPC_WITH_UCX
@@ -0,0 +1,209 @@
+#include "KrpcCapture.h"
+#include "Krpcapplication.h"
+#include "KrpcLog.h"
+#include "KrpcMetrics.h"
+#include "KrpcSampling.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+namespace {
+const char kMagic[] = "KRPCCAP1";
+const size_t kMagicSize = 8;
+const uint32_t kDefaultMaxRps = 1000;
+const uint64_t kDefaultMaxMb = 256;
+const size_t kMaxPendingBytes = 16 * 1024 * 1024; // 后台线程来不及写出时最多积压的字节数
+const size_t kRecordFixedBytes = 8 + 4 + 4 + 4;   // 到达时刻和三个长度
+const int kFlushMs = 100;
+
+void PutFixed32(std::string *out, uint32_t value) {
+    char buf[4];
+    for (int i = 0; i < 4; ++i) {
+        buf[i] = static_cast<char>(value >> (8 * i));
+    }
+    out->append(buf, 4);
+}
+
+void PutFixed64(std::string *out, uint64_t value) {
+    PutFixed32(out, static_cast<uint32_t>(value));
+    PutFixed32(out, static_cast<uint32_t>(value >> 32));
+}
+
+uint32_t GetFixed32(const char *p) {
+    const unsigned char *u = reinterpret_cast<const unsigned char *>(p);
+    return u[0] | (u[1] << 8) | (u[2] << 16) | (static_cast<uint32_t>(u[3]) << 24);
+}
+
+uint64_t GetFixed64(const char *p) {
+    return GetFixed32(p) | (static_cast<uint64_t>(GetFixed32(p + 4)) << 32);
+}
+}  // namespace
+
+KrpcCapture &KrpcCapture::Instance() {
+    static KrpcCapture capture;
+    return capture;
+}
+
+KrpcCapture::KrpcCapture()
+    : max_rps_(kDefaultMaxRps), max_bytes_(kDefaultMaxMb << 20), reserved_(0),
+      captured_(0), dropped_(0) {
+    Krpcconfig &config = KrpcApplication::GetInstance().GetConfig();
+    std::string path = config.Load("capture_file");
+    if (path.empty()) {
+        return;
+    }
+    std::string rate = config.Load("capture_sample_rate");
+    if (!rate.empty() && atof(rate.c_str()) < 1) {
+        sample_all_ = false;
+        sample_threshold_ = KrpcSampleThreshold(atof(rate.c_str()));
+    }
+    std::string max_rps = config.Load("capture_max_rps");
+    if (!max_rps.empty()) {
+        max_rps_ = static_cast<uint32_t>(atoi(max_rps.c_str()));
+    }
+    std::string max_mb = config.Load("capture_max_mb");
+    if (!max_mb.empty()) {
+        max_bytes_ = strtoull(max_mb.c_str(), nullptr, 10) << 20;
+    }
+    file_ = fopen(path.c_str(), "w");
+    if (file_ == nullptr) {
+        KRPC_LOG_ERROR("open capture_file {} error: {}", path, strerror(errno));
+        return;
+    }
+    fwrite(kMagic, 1, kMagicSize, file_);
+    reserved_.store(kMagicSize, std::memory_order_relaxed);
+    enabled_ = true;
+    std::thread([this]() { WriteLoop(); }).detach();
+    KRPC_LOG_INFO("capture requests to {}, sample rate {}, at most {}/s and {} bytes", path,
+                  sample_all_ ? 1.0 : KrpcSampleRate(sample_threshold_), max_rps_, max_bytes_);
+}
+
+bool KrpcCapture::Sample() {
+    if (!enabled_) {
+        return false;
+    }
+    if (!sample_all_ && KrpcRandom() >= sample_threshold_) {
+        return false;
+    }
+    return rate_window_.Admit(max_rps_);
+}
+
+void KrpcCapture::Record(const Krpc::RpcHeader &header, const char *args, size_t args_size, const char *attachment,
+                         int64_t arrival_unix_ns) {
+    Krpc::RpcHeader kept;
+    kept.set_service_name(header.service_name());
+    kept.set_method_name(header.method_name());
+    kept.set_args_size(static_cast<uint32_t>(args_size));
+    kept.set_attachment_size(header.attachment_size());
+    kept.set_priority(header.priority());
+    std::string header_str = kept.SerializeAsString();
+
+    size_t record_size = 4 + kRecordFixedBytes + header_str.size() + args_size + header.attachment_size();
+    if (reserved_.fetch_add(record_size, std::memory_order_relaxed) + record_size > max_bytes_) {
+        reserved_.fetch_sub(record_size, std::memory_order_relaxed);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::string record;
+    record.reserve(record_size);
+    PutFixed32(&record, static_cast<uint32_t>(record_size - 4));
+    PutFixed64(&record, static_cast<uint64_t>(arrival_unix_ns));
+    PutFixed32(&record, static_cast<uint32_t>(header_str.size()));
+    PutFixed32(&record, static_cast<uint32_t>(args_size));
+    PutFixed32(&record, header.attachment_size());
+    record.append(header_str);
+    record.append(args, args_size);
+    record.append(attachment, header.attachment_size());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_bytes_ + record.size() > kMaxPendingBytes) {
+        reserved_.fetch_sub(record_size, std::memory_order_relaxed);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending_bytes_ += record.size();
+    pending_.push_back(std::move(record));
+    captured_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 后台线程：定期写出积压的记录，文件写满后停止抓包
+void KrpcCapture::WriteLoop() {
+    std::vector<std::string> batch;
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kFlushMs));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch.swap(pending_);
+            pending_bytes_ = 0;
+        }
+        for (const std::string &record : batch) {
+            fwrite(record.data(), 1, record.size(), file_);
+        }
+        if (!batch.empty()) {
+            fflush(file_);
+        }
+        batch.clear();
+    }
+}
+
+void KrpcCapture::AppendMetrics(std::string *out) {
+    if (!enabled_) {
+        return;
+    }
+    KrpcAppendMetricFamily(out, "krpc_capture_requests", "counter", "Sampled requests written to the capture file.");
+    KrpcAppendMetricSample(out, "krpc_capture_requests_total", "result=\"captured\"",
+                           static_cast<double>(captured_.load(std::memory_order_relaxed)));
+    KrpcAppendMetricSample(out, "krpc_capture_requests_total", "result=\"dropped\"",
+                           static_cast<double>(dropped_.load(std::memory_order_relaxed)));
+    KrpcAppendMetricFamily(out, "krpc_capture_bytes", "gauge", "Bytes reserved in the capture file.");
+    KrpcAppendMetricSample(out, "krpc_capture_bytes", "", static_cast<double>(reserved_.load(std::memory_order_relaxed)));
+}
+
+bool KrpcCapture::ReadFile(const std::string &path, std::vector<Entry> *entries, std::string *error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        *error = "open " + path + " error";
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < kMagicSize || data.compare(0, kMagicSize, kMagic) != 0) {
+        *error = path + " is not a krpc capture file";
+        return false;
+    }
+    size_t pos = kMagicSize;
+    while (pos < data.size()) {
+        // 服务端退出时最后一条记录可能只写了一半，丢弃即可
+        if (data.size() - pos < 4 + kRecordFixedBytes) {
+            break;
+        }
+        uint32_t record_size = GetFixed32(data.data() + pos);
+        if (record_size > data.size() - pos - 4) {
+            break;
+        }
+        const char *p = data.data() + pos + 4;
+        uint32_t header_size = GetFixed32(p + 8);
+        uint32_t args_size = GetFixed32(p + 12);
+        uint32_t attachment_size = GetFixed32(p + 16);
+        if (static_cast<uint64_t>(header_size) + args_size + attachment_size + kRecordFixedBytes != record_size) {
+            *error = "corrupt record at offset " + std::to_string(pos);
+            return false;
+        }
+        Entry entry;
+        entry.arrival_unix_ns = static_cast<int64_t>(GetFixed64(p));
+        p += kRecordFixedBytes;
+        if (!entry.header.ParseFromArray(p, static_cast<int>(header_size))) {
+            *error = "corrupt header at offset " + std::to_string(pos);
+            return false;
+        }
+        p += header_size;
+        entry.args.assign(p, args_size);
+        entry.attachment.assign(p + args_size, attachment_size);
+        entries->push_back(std::move(entry));
+        pos += 4 + record_size;
+    }
+    return true;
+}
@@ -0,0 +1,253 @@
+#include "KrpcCompress.h"
+#include "Krpcapplication.h"
+#include "KrpcLogger.h"
+#include <cstdlib>
+#ifdef KRPC_WITH_LZ4
+#include <lz4.h>
+#endif
+#ifdef KRPC_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+const size_t kDefaultCompressThreshold = 4096;
+const int kDefaultZstdLevel = 1;
+const size_t kDefaultMaxMessageBytes = 64 * 1024 * 1024;
+const size_t kKeepBufferBytes = 1024 * 1024;  // 复用的缓冲区超过这个容量时释放
+
+// len字节的压缩数据最多能解压出的长度，raw_size超过它说明头部是伪造的或者已经损坏
+size_t MaxDecompressedSize(Krpc::CompressType type, const char *src, size_t len) {
+    switch (type) {
+#ifdef KRPC_WITH_LZ4
+    case Krpc::COMPRESS_LZ4:
+        // LZ4的一个字节最多展开成255个字节
+        return len * 255;
+#endif
+#ifdef KRPC_WITH_ZSTD
+    case Krpc::COMPRESS_ZSTD: {
+        // 帧头中带有原始长度时以它为准；否则每个最多128KB的块至少占4个字节（RLE块）
+        unsigned long long content_size = ZSTD_getFrameContentSize(src, len);
+        if (content_size != ZSTD_CONTENTSIZE_UNKNOWN && content_size != ZSTD_CONTENTSIZE_ERROR) {
+            return static_cast<size_t>(content_size);
+        }
+        return (len / 4 + 1) * 128 * 1024;
+    }
+#endif
+    default:
+        return 0;
+    }
+}
+}  // namespace
+
+const KrpcCompressPolicy &KrpcCompressPolicy::Instance() {
+    static KrpcCompressPolicy policy;
+    return policy;
+}
+
+KrpcCompressPolicy::KrpcCompressPolicy()
+    : supported_mask_(0), preferred_(Krpc::COMPRESS_NONE), adaptive_(false), level_(kDefaultZstdLevel),
+      default_threshold_(kDefaultCompressThreshold), max_message_bytes_(kDefaultMaxMessageBytes) {
+#ifdef KRPC_WITH_LZ4
+    supported_mask_ |= KrpcCompressBit(Krpc::COMPRESS_LZ4);
+#endif
+#ifdef KRPC_WITH_ZSTD
+    supported_mask_ |= KrpcCompressBit(Krpc::COMPRESS_ZSTD);
+#endif
+    Krpcconfig &config = KrpcApplication::GetInstance().GetConfig();
+    std::string type = config.Load("compress_type");
+    if (type == "lz4") {
+        preferred_ = Krpc::COMPRESS_LZ4;
+    } else if (type == "zstd") {
+        preferred_ = Krpc::COMPRESS_ZSTD;
+    } else if (type == "auto") {
+        adaptive_ = supported_mask_ != 0;
+    } else if (!type.empty()) {
+        LOG(WARNING) << "unknown compress_type " << type << ", compression disabled";
+    }
+    if (preferred_ != Krpc::COMPRESS_NONE && !(supported_mask_ & KrpcCompressBit(preferred_))) {
+        LOG(WARNING) << "compress_type " << type << " is not built in, compression disabled";
+        preferred_ = Krpc::COMPRESS_NONE;
+    }
+    std::string level = config.Load("compress_level");
+    if (!level.empty()) {
+        level_ = atoi(level.c_str());
+    }
+    std::string threshold = config.Load("compress_threshold");
+    if (!threshold.empty()) {
+        default_threshold_ = strtoull(threshold.c_str(), nullptr, 10);
+    }
+    std::string max_message = config.Load("max_message_bytes");
+    if (!max_message.empty()) {
+        max_message_bytes_ = strtoull(max_message.c_str(), nullptr, 10);
+    }
+}
+
+KrpcCompressChoice KrpcCompressPolicy::Choose(uint32_t peer_mask) const {
+    KrpcCompressChoice choice;
+    if (preferred_ != Krpc::COMPRESS_NONE && (peer_mask & KrpcCompressBit(preferred_))) {
+        choice.type = preferred_;
+        choice.level = level_;
+    }
+    return choice;
+}
+
+size_t KrpcCompressPolicy::Threshold(const std::string &service_name, const std::string &method_name) const {
+    if (!Enabled()) {
+        return 0;
+    }
+    std::string value =
+        KrpcApplication::GetInstance().GetConfig().Load("compress_threshold." + service_name + "." + method_name);
+    return value.empty() ? default_threshold_ : strtoull(value.c_str(), nullptr, 10);
+}
+
+// 压缩和解压上下文，跨消息复用。每条消息都独立压缩，流水线中的帧可以按任意顺序解压
+struct KrpcCompressor::Contexts
+{
+#ifdef KRPC_WITH_LZ4
+    std::string lz4_state; // LZ4_compress_fast_extState使用的状态
+#endif
+#ifdef KRPC_WITH_ZSTD
+    ZSTD_CCtx *zstd_cctx = nullptr;
+    ZSTD_DCtx *zstd_dctx = nullptr;
+    int zstd_level = 0;
+    ~Contexts() {
+        ZSTD_freeCCtx(zstd_cctx);
+        ZSTD_freeDCtx(zstd_dctx);
+    }
+#endif
+};
+
+KrpcCompressor::KrpcCompressor() = default;
+KrpcCompressor::~KrpcCompressor() = default;
+
+bool KrpcCompressor::Compress(Krpc::CompressType type, int level, const char *src, size_t len, std::string *out) {
+    if (!contexts_) {
+        contexts_.reset(new Contexts());
+    }
+    switch (type) {
+#ifdef KRPC_WITH_LZ4
+    case Krpc::COMPRESS_LZ4: {
+        if (len > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+            return false;
+        }
+        if (contexts_->lz4_state.empty()) {
+            contexts_->lz4_state.resize(LZ4_sizeofState());
+        }
+        out->resize(LZ4_compressBound(static_cast<int>(len)));
+        int n = LZ4_compress_fast_extState(&contexts_->lz4_state[0], src, &(*out)[0], static_cast<int>(len),
+                                           static_cast<int>(out->size()), 1);
+        if (n <= 0) {
+            return false;
+        }
+        out->resize(n);
+        return true;
+    }
+#endif
+#ifdef KRPC_WITH_ZSTD
+    case Krpc::COMPRESS_ZSTD: {
+        if (contexts_->zstd_cctx == nullptr) {
+            contexts_->zstd_cctx = ZSTD_createCCtx();
+            if (contexts_->zstd_cctx == nullptr) {
+                return false;
+            }
+        }
+        if (contexts_->zstd_level != level) {
+            ZSTD_CCtx_setParameter(contexts_->zstd_cctx, ZSTD_c_compressionLevel, level);
+            contexts_->zstd_level = level;
+        }
+        out->resize(ZSTD_compressBound(len));
+        size_t n = ZSTD_compress2(contexts_->zstd_cctx, &(*out)[0], out->size(), src, len);
+        if (ZSTD_isError(n)) {
+            LOG(ERROR) << "zstd compress error: " << ZSTD_getErrorName(n);
+            return false;
+        }
+        out->resize(n);
+        return true;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+bool KrpcCompressor::CompressWithDict(const KrpcZstdDict &dict, const char *src, size_t len, std::string *out) {
+#ifdef KRPC_WITH_ZSTD
+    if (!contexts_) {
+        contexts_.reset(new Contexts());
+    }
+    if (contexts_->zstd_cctx == nullptr) {
+        contexts_->zstd_cctx = ZSTD_createCCtx();
+        if (contexts_->zstd_cctx == nullptr) {
+            return false;
+        }
+    }
+    out->resize(ZSTD_compressBound(len));
+    size_t n = ZSTD_compress_usingCDict(contexts_->zstd_cctx, &(*out)[0], out->size(), src, len, dict.cdict());
+    if (ZSTD_isError(n)) {
+        LOG(ERROR) << "zstd dictionary compress error: " << ZSTD_getErrorName(n);
+        return false;
+    }
+    out->resize(n);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool KrpcCompressor::Decompress(Krpc::CompressType type, uint32_t dict_id, const char *src, size_t len,
+                                size_t raw_size, std::string *out) {
+    if (raw_size > KrpcCompressPolicy::Instance().MaxMessageBytes()) {
+        LOG(ERROR) << "decompressed size " << raw_size << " exceeds max_message_bytes";
+        return false;
+    }
+    if (raw_size > MaxDecompressedSize(type, src, len)) {
+        LOG(ERROR) << "decompressed size " << raw_size << " is impossible for " << len << " compressed bytes";
+        return false;
+    }
+    if (!contexts_) {
+        contexts_.reset(new Contexts());
+    }
+    out->resize(raw_size);
+    KrpcZstdDictPtr dict;
+    if (dict_id != 0) {
+        dict = KrpcDictStore::Instance().ById(dict_id);
+        if (!dict || type != Krpc::COMPRESS_ZSTD) {
+            LOG(ERROR) << "compression dictionary " << dict_id << " is not loaded";
+            return false;
+        }
+    }
+    switch (type) {
+#ifdef KRPC_WITH_LZ4
+    case Krpc::COMPRESS_LZ4: {
+        int n = LZ4_decompress_safe(src, &(*out)[0], static_cast<int>(len), static_cast<int>(raw_size));
+        return n >= 0 && static_cast<size_t>(n) == raw_size;
+    }
+#endif
+#ifdef KRPC_WITH_ZSTD
+    case Krpc::COMPRESS_ZSTD: {
+        if (contexts_->zstd_dctx == nullptr) {
+            contexts_->zstd_dctx = ZSTD_createDCtx();
+            if (contexts_->zstd_dctx == nullptr) {
+                return false;
+            }
+        }
+        size_t n = dict ? ZSTD_decompress_usingDDict(contexts_->zstd_dctx, &(*out)[0], raw_size, src, len, dict->ddict())
+                        : ZSTD_decompressDCtx(contexts_->zstd_dctx, &(*out)[0], raw_size, src, len);
+        if (ZSTD_isError(n)) {
+            LOG(ERROR) << "zstd decompress error: " << ZSTD_getErrorName(n);
+            return false;
+        }
+        return n == raw_size;
+    }
+#endif
+    default:
+        LOG(ERROR) << "unsupported compress type " << static_cast<int>(type);
+        return false;
+    }
+}
+
+void KrpcShrinkBuffer(std::string *buffer) {
+    if (buffer->capacity() > kKeepBufferBytes) {
+        std::string().swap(*buffer);
+    }
+}
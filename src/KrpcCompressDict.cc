@@ -0,0 +1,146 @@
+#include "KrpcCompressDict.h"
+#include "KrpcCompress.h"
+#include "Krpcapplication.h"
+#include "KrpcLogger.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#ifdef KRPC_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+const int kDefaultReloadSeconds = 10;
+const size_t kDefaultDictMinBytes = 32;
+const char kDictSuffix[] = ".dict";
+}  // namespace
+
+KrpcZstdDict::~KrpcZstdDict() {
+#ifdef KRPC_WITH_ZSTD
+    ZSTD_freeCDict(cdict_);
+    ZSTD_freeDDict(ddict_);
+#endif
+}
+
+KrpcDictStore &KrpcDictStore::Instance() {
+    static KrpcDictStore store;
+    return store;
+}
+
+KrpcDictStore::KrpcDictStore() : reload_seconds_(kDefaultReloadSeconds), min_bytes_(kDefaultDictMinBytes) {
+    Krpcconfig &config = KrpcApplication::GetInstance().GetConfig();
+    dir_ = config.Load("compress_dict_dir");
+    std::string reload = config.Load("compress_dict_reload_s");
+    if (!reload.empty() && atoi(reload.c_str()) > 0) {
+        reload_seconds_ = atoi(reload.c_str());
+    }
+    std::string min_bytes = config.Load("compress_dict_min_bytes");
+    if (!min_bytes.empty()) {
+        min_bytes_ = strtoull(min_bytes.c_str(), nullptr, 10);
+    }
+    if (dir_.empty()) {
+        return;
+    }
+#ifndef KRPC_WITH_ZSTD
+    LOG(WARNING) << "compress_dict_dir is set but krpc was built without zstd, ignored";
+    dir_.clear();
+#else
+    Scan();
+    // 定期重新扫描目录，新字典不需要重启进程就能生效
+    std::thread([this]() {
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::seconds(reload_seconds_));
+            Scan();
+        }
+    }).detach();
+#endif
+}
+
+KrpcZstdDictPtr KrpcDictStore::ForMethod(const std::string &method) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_method_.find(method);
+    return it != by_method_.end() ? it->second : nullptr;
+}
+
+KrpcZstdDictPtr KrpcDictStore::ById(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_id_.find(id);
+    return it != by_id_.end() ? it->second : nullptr;
+}
+
+uint32_t KrpcDictStore::PeerDictId(const std::string &peer, const std::string &method) {
+    std::string key = peer + "|" + method;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = peer_dicts_.find(key);
+    return it != peer_dicts_.end() ? it->second : 0;
+}
+
+void KrpcDictStore::SetPeerDictId(const std::string &peer, const std::string &method, uint32_t id) {
+    std::string key = peer + "|" + method;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id == 0) {
+        peer_dicts_.erase(key);  // 对端不再持有该方法的字典
+    } else {
+        peer_dicts_[key] = id;
+    }
+}
+
+// 扫描字典目录，加载新增或有变化的字典文件
+void KrpcDictStore::Scan() {
+    DIR *dir = opendir(dir_.c_str());
+    if (dir == nullptr) {
+        LOG(WARNING) << "open compress_dict_dir " << dir_ << " error";
+        return;
+    }
+    size_t suffix_len = sizeof(kDictSuffix) - 1;
+    while (struct dirent *entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() <= suffix_len || name.compare(name.size() - suffix_len, suffix_len, kDictSuffix) != 0) {
+            continue;
+        }
+        std::string path = dir_ + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        FileState &state = files_[name];
+        if (state.mtime == static_cast<int64_t>(st.st_mtime) && state.size == static_cast<int64_t>(st.st_size)) {
+            continue;
+        }
+        state.mtime = st.st_mtime;
+        state.size = st.st_size;
+
+        std::ifstream in(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        Load(name.substr(0, name.size() - suffix_len), data);
+    }
+    closedir(dir);
+}
+
+void KrpcDictStore::Load(const std::string &method, const std::string &data) {
+#ifdef KRPC_WITH_ZSTD
+    // 只接受训练出来的字典：ID写在字典头部，两端据此对应到同一个字典
+    uint32_t id = ZSTD_getDictID_fromDict(data.data(), data.size());
+    if (id == 0) {
+        LOG(WARNING) << "dictionary for " << method << " has no dict id, train it with krpc_dict_train";
+        return;
+    }
+    std::shared_ptr<KrpcZstdDict> dict(new KrpcZstdDict());
+    dict->id_ = id;
+    dict->method_ = method;
+    dict->cdict_ = ZSTD_createCDict(data.data(), data.size(), KrpcCompressPolicy::Instance().Level());
+    dict->ddict_ = ZSTD_createDDict(data.data(), data.size());
+    if (dict->cdict_ == nullptr || dict->ddict_ == nullptr) {
+        LOG(ERROR) << "load dictionary for " << method << " error";
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    by_method_[method] = dict;
+    by_id_[id] = dict; // 旧字典仍然按ID保留，对端可能还在用它
+    LOG(INFO) << "loaded compression dictionary " << id << " for " << method << " (" << data.size() << " bytes)";
+#endif
+}
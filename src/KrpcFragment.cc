@@ -0,0 +1,90 @@
+#include "KrpcFragment.h"
+#include "Krpccodec.h"
+#include "KrpcLogger.h"
+#include <cstring>
+
+KrpcFragmentScheduler::KrpcFragmentScheduler(size_t fragment_size) : fragment_size_(fragment_size) {}
+
+bool KrpcFragmentScheduler::Wants(uint64_t call_id, size_t frame_size) const {
+    return frame_size > fragment_size_ || calls_.count(call_id) != 0;
+}
+
+void KrpcFragmentScheduler::Add(uint64_t call_id, uint32_t priority, std::string frame) {
+    auto it = calls_.find(call_id);
+    if (it != calls_.end()) {
+        it->second->frames.push_back(std::move(frame));  // 排在同一调用前面的帧之后
+        return;
+    }
+    std::shared_ptr<Call> call = std::make_shared<Call>();
+    call->call_id = call_id;
+    call->priority = priority;
+    call->frames.push_back(std::move(frame));
+    calls_[call_id] = call;
+    queues_[priority].push_back(call);
+}
+
+void KrpcFragmentScheduler::Next(std::string *out) {
+    if (queues_.empty()) {
+        return;
+    }
+    auto qit = queues_.begin();  // 优先级最高的队列
+    std::shared_ptr<Call> call = qit->second.front();
+    qit->second.pop_front();
+
+    const std::string &frame = call->frames.front();
+    if (call->offset == 0 && frame.size() <= fragment_size_) {
+        out->append(frame);  // 小帧不需要分片
+        call->offset = frame.size();
+    } else {
+        size_t chunk = std::min(fragment_size_, frame.size() - call->offset);
+        Krpc::RpcResponseHeader header;
+        header.set_call_id(call->call_id);
+        header.set_response_size(chunk);
+        header.set_fragment_total(frame.size());
+        header.set_fragment_offset(call->offset);
+        KrpcCodec::EncodeResponse(header, std::string(), out);
+        out->append(frame, call->offset, chunk);
+        call->offset += chunk;
+    }
+
+    if (call->offset == frame.size()) {
+        call->frames.pop_front();
+        call->offset = 0;
+    }
+    if (!call->frames.empty()) {
+        qit->second.push_back(call);  // 轮到同一优先级的下一个调用
+    } else {
+        calls_.erase(call->call_id);
+    }
+    if (qit->second.empty()) {
+        queues_.erase(qit);
+    }
+}
+
+KrpcFragmentAssembler::Status KrpcFragmentAssembler::Add(const Krpc::RpcResponseHeader &header, const char *data,
+                                                         std::string *frame) {
+    uint64_t total = header.fragment_total();
+    uint64_t offset = header.fragment_offset();
+    size_t size = header.response_size();
+    if (total > KrpcCodec::MaxFrameSize()) {  // 在按完整帧的长度分配之前拒绝
+        LOG(ERROR) << "fragmented frame of call " << header.call_id() << " is too large: " << total;
+        return Status::kError;
+    }
+    Partial &partial = partials_[header.call_id()];
+    if (offset == 0 && partial.filled == 0) {
+        partial.data.resize(total);  // 第一个分片到达时按完整帧的长度一次分配好
+    }
+    if (partial.data.size() != total || offset != partial.filled || size > total - offset) {
+        LOG(ERROR) << "unexpected fragment of call " << header.call_id() << " at offset " << offset;
+        partials_.erase(header.call_id());
+        return Status::kError;
+    }
+    memcpy(&partial.data[offset], data, size);
+    partial.filled += size;
+    if (partial.filled < total) {
+        return Status::kPending;
+    }
+    frame->swap(partial.data);
+    partials_.erase(header.call_id());
+    return Status::kComplete;
+}
@@ -0,0 +1,331 @@
+#include "KrpcLog.h"
+#include "Krpcapplication.h"
+#include "KrpcMetrics.h"
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+const size_t kDefaultRingRecords = 4096;
+const int kDefaultFlushMs = 50;
+const uint32_t kDefaultSiteRate = 100;
+
+std::atomic<uint32_t> g_site_rate(kDefaultSiteRate);
+std::atomic<uint64_t> g_dropped(0);
+std::atomic<uint64_t> g_suppressed(0);
+
+// 一个线程的环形缓冲区，写日志的线程是唯一的生产者，后台线程是唯一的消费者
+struct ThreadRing
+{
+    explicit ThreadRing(size_t capacity) : head(0), tail(0), closed(false) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        records.reset(new KrpcLogRecord[size]);
+        mask = size - 1;
+        tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    }
+
+    std::unique_ptr<KrpcLogRecord[]> records;
+    size_t mask;
+    uint32_t tid;
+    std::atomic<uint64_t> head; // 生产者写入位置
+    char pad[64];
+    std::atomic<uint64_t> tail; // 消费者读取位置
+    std::atomic<bool> closed;   // 线程已经退出，取空后释放
+};
+
+// 后台写出线程和所有线程的环
+class LogBackend
+{
+public:
+    static LogBackend &Instance() {
+        static LogBackend *backend = new LogBackend();  // 不析构，退出时其他线程可能还在写日志
+        return *backend;
+    }
+
+    std::shared_ptr<ThreadRing> NewRing() {
+        std::shared_ptr<ThreadRing> ring = std::make_shared<ThreadRing>(ring_records_);
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    // 取出所有线程的记录，按时间排序后写出；后台线程和退出时的atexit都会调用，drain_mutex_保证只有一个消费者
+    void Flush() {
+        std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+        std::vector<std::shared_ptr<ThreadRing>> rings;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings = rings_;
+        }
+        batch_.clear();
+        for (const std::shared_ptr<ThreadRing> &ring : rings) {
+            bool closed = ring->closed.load(std::memory_order_acquire);
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail) {
+                batch_.push_back(ring->records[tail & ring->mask]);
+                batch_.back().tid = ring->tid;
+            }
+            ring->tail.store(tail, std::memory_order_release);
+            if (closed) {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings_.erase(std::remove(rings_.begin(), rings_.end(), ring), rings_.end());
+            }
+        }
+        if (batch_.empty()) {
+            return;
+        }
+        std::stable_sort(batch_.begin(), batch_.end(), [](const KrpcLogRecord &a, const KrpcLogRecord &b) {
+            return a.time_ns < b.time_ns;
+        });
+        std::string line;
+        for (const KrpcLogRecord &record : batch_) {
+            line.clear();
+            Format(record, &line);
+            fwrite(line.data(), 1, line.size(), out_);
+        }
+        fflush(out_);
+    }
+
+private:
+    LogBackend() : ring_records_(kDefaultRingRecords), flush_ms_(kDefaultFlushMs), out_(stderr) {
+        Krpcconfig &config = KrpcApplication::GetInstance().GetConfig();
+        KrpcLogLevel level;
+        std::string level_name = config.Load("log_level");
+        if (!level_name.empty()) {
+            if (KrpcLog::ParseLevel(level_name, &level)) {
+                KrpcLog::SetLevel(level);
+            } else {
+                fprintf(stderr, "unknown log_level %s, keep %s\n", level_name.c_str(), KrpcLog::LevelName(KrpcLog::Level()));
+            }
+        }
+        std::string rate = config.Load("log_site_rate");
+        if (!rate.empty()) {
+            g_site_rate.store(static_cast<uint32_t>(atoi(rate.c_str())), std::memory_order_relaxed);
+        }
+        std::string records = config.Load("log_ring_records");
+        if (!records.empty() && atoi(records.c_str()) > 0) {
+            ring_records_ = static_cast<size_t>(atoi(records.c_str()));
+        }
+        std::string flush_ms = config.Load("log_flush_ms");
+        if (!flush_ms.empty() && atoi(flush_ms.c_str()) > 0) {
+            flush_ms_ = atoi(flush_ms.c_str());
+        }
+        std::string file = config.Load("log_file");
+        if (!file.empty()) {
+            FILE *fp = fopen(file.c_str(), "a");
+            if (fp != nullptr) {
+                out_ = fp;
+            } else {
+                fprintf(stderr, "open log_file %s error, log to stderr\n", file.c_str());
+            }
+        }
+        std::thread([this]() {
+            while (true) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(flush_ms_));
+                Flush();
+            }
+        }).detach();
+        atexit([]() { LogBackend::Instance().Flush(); });
+    }
+
+    static void AppendArg(const KrpcLogRecord &record, const KrpcLogArg &arg, std::string *out) {
+        char buf[32];
+        switch (arg.type) {
+        case KrpcLogArg::kInt:
+            snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(arg.value.i));
+            out->append(buf);
+            break;
+        case KrpcLogArg::kUint:
+            snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(arg.value.u));
+            out->append(buf);
+            break;
+        case KrpcLogArg::kDouble:
+            snprintf(buf, sizeof(buf), "%g", arg.value.d);
+            out->append(buf);
+            break;
+        case KrpcLogArg::kBool:
+            out->append(arg.value.u != 0 ? "true" : "false");
+            break;
+        case KrpcLogArg::kText:
+            out->append(record.text + (arg.value.u & 0xffffffff), arg.value.u >> 32);
+            break;
+        }
+    }
+
+    // 格式与glog相同：I1019 12:34:56.123456  1234 file.cc:56] message
+    static void Format(const KrpcLogRecord &record, std::string *out) {
+        static const char kLevelChars[] = {'D', 'I', 'W', 'E'};
+        time_t seconds = static_cast<time_t>(record.time_ns / 1000000000);
+        struct tm tm;
+        localtime_r(&seconds, &tm);
+        const char *file = strrchr(record.site->file, '/');
+        file = file != nullptr ? file + 1 : record.site->file;
+        char prefix[128];
+        snprintf(prefix, sizeof(prefix), "%c%02d%02d %02d:%02d:%02d.%06d %5u %s:%d] ",
+                 kLevelChars[static_cast<int>(record.site->level)], tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min,
+                 tm.tm_sec, static_cast<int>(record.time_ns % 1000000000 / 1000), record.tid, file, record.site->line);
+        out->append(prefix);
+        int next = 0;
+        for (const char *p = record.format; *p != '\0'; ++p) {
+            if (p[0] == '{' && p[1] == '}' && next < record.nargs) {
+                AppendArg(record, record.args[next++], out);
+                ++p;
+            } else {
+                out->push_back(*p);
+            }
+        }
+        for (; next < record.nargs; ++next) {  // 多出的参数接在后面
+            out->push_back(' ');
+            AppendArg(record, record.args[next], out);
+        }
+        if (record.suppressed != 0) {
+            out->append(" (").append(std::to_string(record.suppressed)).append(" similar suppressed)");
+        }
+        out->push_back('\n');
+    }
+
+    size_t ring_records_;
+    int flush_ms_;
+    FILE *out_;
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<ThreadRing>> rings_;
+    std::mutex drain_mutex_;
+    std::vector<KrpcLogRecord> batch_; // 只在持有drain_mutex_时使用
+};
+
+// 线程退出时把环标记为关闭，后台线程取空后释放
+struct RingHolder
+{
+    std::shared_ptr<ThreadRing> ring;
+    ~RingHolder() {
+        if (ring) {
+            ring->closed.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local RingHolder t_ring;
+thread_local ThreadRing *t_pending_ring = nullptr; // Begin预留的记录所在的环，Commit时提交
+}  // namespace
+
+std::atomic<int> KrpcLog::min_level_(static_cast<int>(KrpcLogLevel::kInfo));
+
+bool KrpcLogSite::Admit() {
+    uint32_t rate = g_site_rate.load(std::memory_order_relaxed);
+    if (rate == 0) {
+        return true;
+    }
+    if (rate_window.Admit(rate)) {
+        return true;
+    }
+    suppressed.fetch_add(1, std::memory_order_relaxed);
+    g_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void KrpcLog::SetLevel(KrpcLogLevel level) {
+    min_level_.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+KrpcLogLevel KrpcLog::Level() {
+    return static_cast<KrpcLogLevel>(min_level_.load(std::memory_order_relaxed));
+}
+
+bool KrpcLog::ParseLevel(const std::string &name, KrpcLogLevel *level) {
+    static const KrpcLogLevel levels[] = {KrpcLogLevel::kDebug, KrpcLogLevel::kInfo, KrpcLogLevel::kWarning,
+                                          KrpcLogLevel::kError};
+    for (KrpcLogLevel candidate : levels) {
+        if (name == LevelName(candidate)) {
+            *level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *KrpcLog::LevelName(KrpcLogLevel level) {
+    switch (level) {
+    case KrpcLogLevel::kDebug:
+        return "debug";
+    case KrpcLogLevel::kInfo:
+        return "info";
+    case KrpcLogLevel::kWarning:
+        return "warning";
+    case KrpcLogLevel::kError:
+        return "error";
+    }
+    return "unknown";
+}
+
+uint64_t KrpcLog::Dropped() {
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+void KrpcLog::AppendMetrics(std::string *out) {
+    KrpcAppendMetricFamily(out, "krpc_log_records_lost", "counter", "Log records not written, by reason.");
+    KrpcAppendMetricSample(out, "krpc_log_records_lost_total", "reason=\"dropped\"",
+                           static_cast<double>(g_dropped.load(std::memory_order_relaxed)));
+    KrpcAppendMetricSample(out, "krpc_log_records_lost_total", "reason=\"suppressed\"",
+                           static_cast<double>(g_suppressed.load(std::memory_order_relaxed)));
+}
+
+void KrpcLog::Start() {
+    LogBackend::Instance();
+}
+
+KrpcLogRecord *KrpcLog::Begin(const KrpcLogSite *site, const char *format) {
+    if (!t_ring.ring) {
+        t_ring.ring = LogBackend::Instance().NewRing();
+    }
+    ThreadRing *ring = t_ring.ring.get();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) > ring->mask) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    KrpcLogRecord *record = &ring->records[head & ring->mask];
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    record->site = site;
+    record->format = format;
+    record->time_ns = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    record->suppressed = const_cast<KrpcLogSite *>(site)->suppressed.exchange(0, std::memory_order_relaxed);
+    record->text_used = 0;
+    record->nargs = 0;
+    t_pending_ring = ring;
+    return record;
+}
+
+void KrpcLog::Commit() {
+    ThreadRing *ring = t_pending_ring;
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void KrpcLog::AddArg(KrpcLogRecord *record, KrpcLogArg::Type type, uint64_t bits) {
+    if (record->nargs >= KrpcLogRecord::kMaxArgs) {
+        return;
+    }
+    KrpcLogArg &arg = record->args[record->nargs++];
+    arg.type = type;
+    arg.value.u = bits;
+}
+
+void KrpcLog::AddText(KrpcLogRecord *record, const char *data, size_t size) {
+    size_t room = KrpcLogRecord::kTextBytes - record->text_used;
+    size = std::min(size, room);
+    memcpy(record->text + record->text_used, data, size);
+    AddArg(record, KrpcLogArg::kText, (static_cast<uint64_t>(size) << 32) | record->text_used);
+    record->text_used = static_cast<uint16_t>(record->text_used + size);
+}
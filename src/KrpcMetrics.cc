@@ -0,0 +1,537 @@
+#include "KrpcMetrics.h"
+#include "KrpcLogger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+// 分片只由所属线程写入，读取的线程只读，因此用普通的读和写代替原子的读-改-写
+inline void Bump(std::atomic<uint64_t> &counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline uint64_t Load(const std::atomic<uint64_t> &counter) {
+    return counter.load(std::memory_order_relaxed);
+}
+
+const char *kSideNames[] = {"client", "server"};
+}  // namespace
+
+const char *KrpcPhaseName(KrpcPhase phase) {
+    static const char *names[kPhaseCount] = {"discovery", "connect", "serialize", "send", "server_queue",
+                                             "server_handler", "server_serialize", "network", "parse"};
+    return phase >= 0 && phase < kPhaseCount ? names[phase] : "unknown";
+}
+
+const int KrpcHistogram::kSubBucketBits;
+const int KrpcHistogram::kMaxValueBits;
+const int KrpcHistogram::kBuckets;
+const int KrpcMetrics::kMaxMethods;
+
+// 小于64的值每个值一格；更大的值按最高位所在的2的幂分段，每段再按紧跟最高位的5位分成32格
+int KrpcHistogram::BucketOf(uint64_t value) {
+    const uint64_t max_value = (1ULL << kMaxValueBits) - 1;
+    if (value > max_value) {
+        value = max_value;
+    }
+    if (value < (1ULL << kSubBucketBits)) {
+        return static_cast<int>(value);
+    }
+    int shift = (63 - __builtin_clzll(value)) - (kSubBucketBits - 1);
+    return 64 + (shift - 1) * 32 + static_cast<int>((value >> shift) - 32);
+}
+
+uint64_t KrpcHistogram::BucketUpper(int bucket) {
+    if (bucket < 64) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int shift = (bucket - 64) / 32 + 1;
+    uint64_t sub = static_cast<uint64_t>((bucket - 64) % 32 + 32);
+    return ((sub + 1) << shift) - 1;
+}
+
+void KrpcHistogram::Record(uint64_t value, uint64_t count) {
+    counts_[BucketOf(value)] += count;
+    count_ += count;
+    sum_ += value * count;
+}
+
+void KrpcHistogram::RecordCorrected(uint64_t value, uint64_t expected_interval) {
+    Record(value);
+    if (expected_interval == 0) {
+        return;
+    }
+    for (uint64_t missing = value > expected_interval ? value - expected_interval : 0; missing >= expected_interval;
+         missing -= expected_interval) {
+        Record(missing);
+    }
+}
+
+void KrpcHistogram::AddBucket(int bucket, uint64_t count) {
+    counts_[bucket] += count;
+    count_ += count;
+}
+
+void KrpcHistogram::Merge(const KrpcHistogram &other) {
+    for (int i = 0; i < kBuckets; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+}
+
+uint64_t KrpcHistogram::Max() const {
+    for (int i = kBuckets - 1; i >= 0; --i) {
+        if (counts_[i] != 0) {
+            return BucketUpper(i);
+        }
+    }
+    return 0;
+}
+
+uint64_t KrpcHistogram::ValueAtQuantile(double q) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    q = q < 0 ? 0 : (q > 1 ? 1 : q);
+    uint64_t target = static_cast<uint64_t>(std::ceil(q * count_));
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += counts_[i];
+        if (seen >= target) {
+            return BucketUpper(i);
+        }
+    }
+    return Max();
+}
+
+// 一个线程上一个方法的统计，只由该线程写入
+struct KrpcMetrics::Shard {
+    std::atomic<uint64_t> requests;
+    std::atomic<uint64_t> errors;
+    std::atomic<uint64_t> bytes_in;
+    std::atomic<uint64_t> bytes_out;
+    std::atomic<uint64_t> latency_sum;
+    std::atomic<uint64_t> buckets[KrpcHistogram::kBuckets];
+    std::atomic<uint64_t> phase_ns[kPhaseCount];
+    std::atomic<uint64_t> cpu_ns;
+    std::atomic<uint64_t> alloc_bytes;
+    std::atomic<uint64_t> allocs;
+
+    Shard()
+        : requests(0), errors(0), bytes_in(0), bytes_out(0), latency_sum(0), cpu_ns(0), alloc_bytes(0), allocs(0) {
+        for (auto &bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        for (auto &phase : phase_ns) {
+            phase.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// 一个线程上一侧所有方法的阶段分布，第一次记录阶段时才分配
+struct KrpcMetrics::PhaseShard {
+    std::atomic<uint64_t> sum[kPhaseCount];
+    std::atomic<uint64_t> buckets[kPhaseCount][KrpcHistogram::kBuckets];
+
+    PhaseShard() {
+        for (int phase = 0; phase < kPhaseCount; ++phase) {
+            sum[phase].store(0, std::memory_order_relaxed);
+            for (auto &bucket : buckets[phase]) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// 一个线程的全部分片，按方法编号索引，第一次记录某个方法时才分配
+struct KrpcMetrics::ThreadShards {
+    std::atomic<Shard *> slots[kMaxMethods];
+    std::atomic<PhaseShard *> phases[2]; // 按Side索引
+
+    ThreadShards() {
+        for (auto &slot : slots) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+        for (auto &phase : phases) {
+            phase.store(nullptr, std::memory_order_relaxed);
+        }
+        KrpcMetrics::Instance().Register(this);
+    }
+    ~ThreadShards() {
+        KrpcMetrics::Instance().Unregister(this);
+        for (auto &slot : slots) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+        for (auto &phase : phases) {
+            delete phase.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+void KrpcAppendMetricFamily(std::string *out, const char *name, const char *type, const char *help) {
+    out->append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out->append("# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+
+void KrpcAppendMetricSample(std::string *out, const std::string &name, const std::string &labels, double value) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.17g", value);
+    out->append(name);
+    if (!labels.empty()) {
+        out->append("{").append(labels).append("}");
+    }
+    out->append(" ").append(buf).append("\n");
+}
+
+KrpcMetrics &KrpcMetrics::Instance() {
+    static KrpcMetrics instance;
+    return instance;
+}
+
+KrpcMetrics::KrpcMetrics() : retired_phases_(2 * kPhaseCount) {
+    for (auto &side : sides_) {
+        side = kClient;
+    }
+}
+
+int KrpcMetrics::MethodId(Side side, const std::string &service, const std::string &method) {
+    const char *side_name = kSideNames[side];
+    std::string key = std::string(side_name) + "|" + service + "." + method;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(key);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    if (methods_.size() >= static_cast<size_t>(kMaxMethods)) {
+        LOG(WARNING) << "too many methods for metrics, " << service << "." << method << " is not recorded";
+        ids_[key] = -1;
+        return -1;
+    }
+    int id = static_cast<int>(methods_.size());
+    sides_[id] = side;
+    methods_.emplace_back();
+    methods_.back().side = side_name;
+    methods_.back().service = service;
+    methods_.back().method = method;
+    ids_[key] = id;
+    return id;
+}
+
+KrpcMetrics::ThreadShards *KrpcMetrics::LocalShards() {
+    static thread_local ThreadShards shards;
+    return &shards;
+}
+
+void KrpcMetrics::Register(ThreadShards *shards) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back(shards);
+}
+
+// 线程退出：它的统计并入累计值，之后不再读取它的分片
+void KrpcMetrics::Unregister(ThreadShards *shards) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t id = 0; id < methods_.size(); ++id) {
+        Shard *shard = shards->slots[id].load(std::memory_order_acquire);
+        if (shard != nullptr) {
+            Accumulate(*shard, &methods_[id]);
+        }
+    }
+    for (int side = 0; side < 2; ++side) {
+        PhaseShard *phases = shards->phases[side].load(std::memory_order_acquire);
+        if (phases != nullptr) {
+            std::vector<KrpcHistogram> merged(kPhaseCount);
+            AccumulatePhases(*phases, &merged);
+            for (int phase = 0; phase < kPhaseCount; ++phase) {
+                retired_phases_[side * kPhaseCount + phase].Merge(merged[phase]);
+            }
+        }
+    }
+    for (auto it = threads_.begin(); it != threads_.end(); ++it) {
+        if (*it == shards) {
+            threads_.erase(it);
+            break;
+        }
+    }
+}
+
+KrpcMetrics::Shard *KrpcMetrics::LocalShard(int id) {
+    ThreadShards *shards = LocalShards();
+    Shard *shard = shards->slots[id].load(std::memory_order_relaxed);
+    if (shard == nullptr) {
+        shard = new Shard();
+        shards->slots[id].store(shard, std::memory_order_release);
+    }
+    return shard;
+}
+
+void KrpcMetrics::Record(int id, uint64_t latency_ns, size_t bytes_in, size_t bytes_out, bool failed) {
+    if (id < 0) {
+        return;
+    }
+    Shard *shard = LocalShard(id);
+    Bump(shard->requests, 1);
+    if (failed) {
+        Bump(shard->errors, 1);
+    }
+    Bump(shard->bytes_in, bytes_in);
+    Bump(shard->bytes_out, bytes_out);
+    Bump(shard->latency_sum, latency_ns);
+    Bump(shard->buckets[KrpcHistogram::BucketOf(latency_ns)], 1);
+}
+
+void KrpcMetrics::RecordPhases(int id, const uint64_t (&phase_ns)[kPhaseCount]) {
+    if (id < 0) {
+        return;
+    }
+    ThreadShards *shards = LocalShards();
+    Shard *shard = LocalShard(id);
+    Side side = sides_[id];
+    PhaseShard *phases = shards->phases[side].load(std::memory_order_relaxed);
+    if (phases == nullptr) {
+        phases = new PhaseShard();
+        shards->phases[side].store(phases, std::memory_order_release);
+    }
+    for (int phase = 0; phase < kPhaseCount; ++phase) {
+        if (phase_ns[phase] == 0) {
+            continue;
+        }
+        Bump(shard->phase_ns[phase], phase_ns[phase]);
+        Bump(phases->sum[phase], phase_ns[phase]);
+        Bump(phases->buckets[phase][KrpcHistogram::BucketOf(phase_ns[phase])], 1);
+    }
+}
+
+void KrpcMetrics::RecordResources(int id, uint64_t cpu_ns, uint64_t alloc_bytes, uint64_t allocs) {
+    if (id < 0) {
+        return;
+    }
+    Shard *shard = LocalShard(id);
+    Bump(shard->cpu_ns, cpu_ns);
+    Bump(shard->alloc_bytes, alloc_bytes);
+    Bump(shard->allocs, allocs);
+}
+
+void KrpcMetrics::AccumulatePhases(const PhaseShard &shard, std::vector<KrpcHistogram> *phases) {
+    for (int phase = 0; phase < kPhaseCount; ++phase) {
+        KrpcHistogram &histogram = (*phases)[phase];
+        histogram.AddSum(Load(shard.sum[phase]));
+        for (int i = 0; i < KrpcHistogram::kBuckets; ++i) {
+            uint64_t count = Load(shard.buckets[phase][i]);
+            if (count != 0) {
+                histogram.AddBucket(i, count);
+            }
+        }
+    }
+}
+
+void KrpcMetrics::Accumulate(const Shard &shard, KrpcMethodStats *stats) {
+    stats->requests += Load(shard.requests);
+    stats->errors += Load(shard.errors);
+    stats->bytes_in += Load(shard.bytes_in);
+    stats->bytes_out += Load(shard.bytes_out);
+    stats->latency.AddSum(Load(shard.latency_sum));
+    stats->cpu_ns += Load(shard.cpu_ns);
+    stats->alloc_bytes += Load(shard.alloc_bytes);
+    stats->allocs += Load(shard.allocs);
+    for (int phase = 0; phase < kPhaseCount; ++phase) {
+        stats->phase_ns[phase] += Load(shard.phase_ns[phase]);
+    }
+    for (int i = 0; i < KrpcHistogram::kBuckets; ++i) {
+        uint64_t count = Load(shard.buckets[i]);
+        if (count != 0) {
+            stats->latency.AddBucket(i, count);
+        }
+    }
+}
+
+std::vector<KrpcMethodStats> KrpcMetrics::Snapshot() {
+    std::vector<KrpcMethodStats> merged;
+    std::lock_guard<std::mutex> lock(mutex_);
+    merged = methods_;
+    for (ThreadShards *shards : threads_) {
+        for (size_t id = 0; id < merged.size(); ++id) {
+            Shard *shard = shards->slots[id].load(std::memory_order_acquire);
+            if (shard != nullptr) {
+                Accumulate(*shard, &merged[id]);
+            }
+        }
+    }
+    std::vector<KrpcMethodStats> result;
+    for (KrpcMethodStats &stats : merged) {
+        if (stats.requests != 0) {
+            result.push_back(std::move(stats));
+        }
+    }
+    return result;
+}
+
+std::vector<KrpcPhaseStats> KrpcMetrics::PhaseSnapshot() {
+    std::vector<KrpcHistogram> merged;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        merged = retired_phases_;
+        for (ThreadShards *shards : threads_) {
+            for (int side = 0; side < 2; ++side) {
+                PhaseShard *phases = shards->phases[side].load(std::memory_order_acquire);
+                if (phases != nullptr) {
+                    std::vector<KrpcHistogram> side_phases(kPhaseCount);
+                    AccumulatePhases(*phases, &side_phases);
+                    for (int phase = 0; phase < kPhaseCount; ++phase) {
+                        merged[side * kPhaseCount + phase].Merge(side_phases[phase]);
+                    }
+                }
+            }
+        }
+    }
+    std::vector<KrpcPhaseStats> result;
+    for (int side = 0; side < 2; ++side) {
+        for (int phase = 0; phase < kPhaseCount; ++phase) {
+            KrpcHistogram &histogram = merged[side * kPhaseCount + phase];
+            if (histogram.Count() != 0) {
+                result.emplace_back();
+                result.back().side = kSideNames[side];
+                result.back().phase = static_cast<KrpcPhase>(phase);
+                result.back().latency = std::move(histogram);
+            }
+        }
+    }
+    return result;
+}
+
+void KrpcMetrics::AppendMetrics(std::string *out) {
+    std::vector<KrpcMethodStats> stats = Snapshot();
+    std::vector<std::string> labels;
+    for (const KrpcMethodStats &method : stats) {
+        labels.push_back("side=\"" + method.side + "\",service=\"" + method.service + "\",method=\"" +
+                         method.method + "\"");
+    }
+
+    // 同一个指标族的样本必须连续输出
+    struct Counter
+    {
+        const char *name;
+        const char *help;
+        uint64_t KrpcMethodStats::*field;
+    };
+    const Counter counters[] = {
+        {"krpc_requests", "Calls completed, including failed ones.", &KrpcMethodStats::requests},
+        {"krpc_request_errors", "Calls that failed.", &KrpcMethodStats::errors},
+        {"krpc_received_bytes", "Payload bytes received (protobuf message and attachment, uncompressed).",
+         &KrpcMethodStats::bytes_in},
+        {"krpc_sent_bytes", "Payload bytes sent (protobuf message and attachment, uncompressed).",
+         &KrpcMethodStats::bytes_out},
+    };
+    for (const Counter &counter : counters) {
+        KrpcAppendMetricFamily(out, counter.name, "counter", counter.help);
+        std::string sample = std::string(counter.name) + "_total";
+        for (size_t i = 0; i < stats.size(); ++i) {
+            KrpcAppendMetricSample(out, sample, labels[i], static_cast<double>(stats[i].*counter.field));
+        }
+    }
+
+    // 资源消耗只在服务端统计
+    KrpcAppendMetricFamily(out, "krpc_handler_cpu_seconds", "counter", "Thread CPU time spent handling calls.");
+    for (size_t i = 0; i < stats.size(); ++i) {
+        if (stats[i].side == "server") {
+            KrpcAppendMetricSample(out, "krpc_handler_cpu_seconds_total", labels[i], stats[i].cpu_ns * 1e-9);
+        }
+    }
+    KrpcAppendMetricFamily(out, "krpc_handler_allocated_bytes", "counter", "Bytes allocated while handling calls.");
+    for (size_t i = 0; i < stats.size(); ++i) {
+        if (stats[i].side == "server") {
+            KrpcAppendMetricSample(out, "krpc_handler_allocated_bytes_total", labels[i],
+                                   static_cast<double>(stats[i].alloc_bytes));
+        }
+    }
+    KrpcAppendMetricFamily(out, "krpc_handler_allocations", "counter", "Allocations made while handling calls.");
+    for (size_t i = 0; i < stats.size(); ++i) {
+        if (stats[i].side == "server") {
+            KrpcAppendMetricSample(out, "krpc_handler_allocations_total", labels[i],
+                                   static_cast<double>(stats[i].allocs));
+        }
+    }
+
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    KrpcAppendMetricFamily(out, "krpc_request_latency_seconds", "summary", "Call latency since process start.");
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const KrpcHistogram &latency = stats[i].latency;
+        for (double q : quantiles) {
+            char quantile[32];
+            snprintf(quantile, sizeof(quantile), ",quantile=\"%g\"", q);
+            KrpcAppendMetricSample(out, "krpc_request_latency_seconds", labels[i] + quantile,
+                                   latency.ValueAtQuantile(q) * 1e-9);
+        }
+        KrpcAppendMetricSample(out, "krpc_request_latency_seconds_sum", labels[i], latency.Sum() * 1e-9);
+        KrpcAppendMetricSample(out, "krpc_request_latency_seconds_count", labels[i],
+                               static_cast<double>(latency.Count()));
+    }
+    KrpcAppendMetricFamily(out, "krpc_request_latency_max_seconds", "gauge", "Slowest call since process start.");
+    for (size_t i = 0; i < stats.size(); ++i) {
+        KrpcAppendMetricSample(out, "krpc_request_latency_max_seconds", labels[i], stats[i].latency.Max() * 1e-9);
+    }
+
+    // 各方法每个阶段的累计耗时，除以调用次数就是每次调用在该阶段平均花费的时间
+    KrpcAppendMetricFamily(out, "krpc_call_phase_seconds", "counter", "Time spent in each phase of a call.");
+    for (size_t i = 0; i < stats.size(); ++i) {
+        for (int phase = 0; phase < kPhaseCount; ++phase) {
+            if (stats[i].phase_ns[phase] != 0) {
+                KrpcAppendMetricSample(out, "krpc_call_phase_seconds_total",
+                                       labels[i] + ",phase=\"" + KrpcPhaseName(static_cast<KrpcPhase>(phase)) + "\"",
+                                       stats[i].phase_ns[phase] * 1e-9);
+            }
+        }
+    }
+    std::vector<KrpcPhaseStats> phases = PhaseSnapshot();
+    KrpcAppendMetricFamily(out, "krpc_phase_latency_seconds", "summary",
+                           "Distribution of each call phase over all methods.");
+    for (const KrpcPhaseStats &phase : phases) {
+        std::string phase_labels = "side=\"" + phase.side + "\",phase=\"" + KrpcPhaseName(phase.phase) + "\"";
+        for (double q : quantiles) {
+            char quantile[32];
+            snprintf(quantile, sizeof(quantile), ",quantile=\"%g\"", q);
+            KrpcAppendMetricSample(out, "krpc_phase_latency_seconds", phase_labels + quantile,
+                                   phase.latency.ValueAtQuantile(q) * 1e-9);
+        }
+        KrpcAppendMetricSample(out, "krpc_phase_latency_seconds_sum", phase_labels, phase.latency.Sum() * 1e-9);
+        KrpcAppendMetricSample(out, "krpc_phase_latency_seconds_count", phase_labels,
+                               static_cast<double>(phase.latency.Count()));
+    }
+}
+
+void KrpcMetrics::AppendTopMethods(std::string *out, size_t limit) {
+    std::vector<KrpcMethodStats> stats = Snapshot();
+    std::vector<const KrpcMethodStats *> server;
+    uint64_t total_cpu_ns = 0;
+    for (const KrpcMethodStats &method : stats) {
+        if (method.side == "server") {
+            server.push_back(&method);
+            total_cpu_ns += method.cpu_ns;
+        }
+    }
+    std::sort(server.begin(), server.end(),
+              [](const KrpcMethodStats *a, const KrpcMethodStats *b) { return a->cpu_ns > b->cpu_ns; });
+    if (server.size() > limit) {
+        server.resize(limit);
+    }
+
+    // cpu/wall接近1表示方法一直在消耗CPU，远小于1表示大部分时间在等待（IO、锁、下游调用）
+    char line[512];
+    snprintf(line, sizeof(line), "%-4s %7s %12s %12s %12s %12s %8s %14s %12s  %s\n", "rank", "cpu%", "cpu_s", "calls",
+             "cpu_us/call", "wall_us/call", "cpu/wall", "alloc_B/call", "allocs/call", "method");
+    out->append(line);
+    for (size_t i = 0; i < server.size(); ++i) {
+        const KrpcMethodStats &method = *server[i];
+        double calls = method.requests == 0 ? 1 : static_cast<double>(method.requests);
+        double wall_ns = static_cast<double>(method.latency.Sum());
+        snprintf(line, sizeof(line), "%-4zu %6.2f%% %12.3f %12llu %12.1f %12.1f %8.2f %14.0f %12.1f  %s.%s\n", i + 1,
+                 total_cpu_ns == 0 ? 0.0 : 100.0 * method.cpu_ns / total_cpu_ns, method.cpu_ns * 1e-9,
+                 static_cast<unsigned long long>(method.requests), method.cpu_ns / calls / 1000,
+                 wall_ns / calls / 1000, wall_ns == 0 ? 0.0 : method.cpu_ns / wall_ns, method.alloc_bytes / calls,
+                 method.allocs / calls, method.service.c_str(), method.method.c_str());
+        out->append(line);
+    }
+}
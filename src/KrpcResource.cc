@@ -0,0 +1,27 @@
+#include "KrpcResource.h"
+#include <time.h>
+
+namespace {
+// 由分配统计的钩子在静态初始化时登记，没有链接钩子时为空
+KrpcAllocCounters (*g_alloc_counters)() = nullptr;
+}  // namespace
+
+void KrpcRegisterAllocCounters(KrpcAllocCounters (*reader)()) {
+    g_alloc_counters = reader;
+}
+
+KrpcAllocCounters KrpcThreadAllocCounters() {
+    return g_alloc_counters != nullptr ? g_alloc_counters() : KrpcAllocCounters();
+}
+
+bool KrpcAllocAccountingEnabled() {
+    return g_alloc_counters != nullptr;
+}
+
+uint64_t KrpcThreadCpuNanos() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
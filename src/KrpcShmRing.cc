@@ -0,0 +1,380 @@
+#include "KrpcShmRing.h"
+#include "Krpccodec.h"
+#include "KrpcLogger.h"
+#include "KrpcUnixServer.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace {
+const size_t kRecordHeaderSize = 8;    // 每条记录前的长度(uint32)和标志(uint32)
+const size_t kControlOffset = 256;     // 两个控制块在控制页中的间隔
+const uint32_t kSealMask = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL;
+
+size_t AlignRecord(size_t len) {
+    return (kRecordHeaderSize + len + 7) & ~static_cast<size_t>(7);
+}
+
+size_t PageSize() {
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+// 把memfd中offset开始的capacity字节连续映射两次
+char *MapRingTwice(int fd, off_t offset, size_t capacity) {
+    void *base = mmap(nullptr, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+    char *addr = static_cast<char *>(base);
+    if (mmap(addr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset) == MAP_FAILED ||
+        mmap(addr + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset) == MAP_FAILED) {
+        munmap(base, capacity * 2);
+        return nullptr;
+    }
+    return addr;
+}
+
+void Wakeup(int efd) {
+    uint64_t one = 1;
+    ssize_t n = write(efd, &one, sizeof(one));
+    (void)n;  // 计数器已满时写失败也没关系，对端反正会被唤醒
+}
+
+int64_t NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}  // namespace
+
+// ---------------- KrpcShmRing ----------------
+
+void KrpcShmRing::Init(KrpcShmRingControl *control, char *data, size_t capacity) {
+    control_ = control;
+    data_ = data;
+    capacity_ = capacity;
+    peeked_ = 0;
+}
+
+size_t KrpcShmRing::MaxRecordSize() const {
+    return capacity_ - kRecordHeaderSize;
+}
+
+char *KrpcShmRing::Reserve(size_t len) {
+    size_t need = AlignRecord(len);
+    uint64_t head = control_->head.load(std::memory_order_relaxed);
+    uint64_t tail = control_->tail.load(std::memory_order_acquire);
+    if (need > capacity_ - (head - tail)) {
+        return nullptr;
+    }
+    return data_ + head % capacity_ + kRecordHeaderSize;
+}
+
+bool KrpcShmRing::Commit(size_t len, uint32_t flags) {
+    uint64_t head = control_->head.load(std::memory_order_relaxed);
+    char *record = data_ + head % capacity_;
+    uint32_t record_len = static_cast<uint32_t>(len);
+    memcpy(record, &record_len, sizeof(record_len));
+    memcpy(record + sizeof(record_len), &flags, sizeof(flags));
+    control_->head.store(head + AlignRecord(len), std::memory_order_release);
+
+    // 与消费者PrepareWait中的顺序配对：先发布head再检查等待标志，保证不会丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return control_->consumer_waiting.load(std::memory_order_relaxed) != 0;
+}
+
+bool KrpcShmRing::Peek(const char **data, size_t *len, uint32_t *flags) {
+    uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    uint64_t head = control_->head.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+
+    const char *record = data_ + tail % capacity_;
+    uint32_t record_len = 0;
+    memcpy(&record_len, record, sizeof(record_len));
+    memcpy(flags, record + sizeof(record_len), sizeof(*flags));
+    // 对端进程写入的长度不可信，越界说明共享内存已经损坏
+    if (record_len > MaxRecordSize() || AlignRecord(record_len) > head - tail) {
+        LOG(ERROR) << "corrupted shm ring record, len=" << record_len;
+        return false;
+    }
+    *data = record + kRecordHeaderSize;
+    *len = record_len;
+    peeked_ = AlignRecord(record_len);
+    return true;
+}
+
+void KrpcShmRing::Release() {
+    uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    control_->tail.store(tail + peeked_, std::memory_order_release);
+    peeked_ = 0;
+}
+
+bool KrpcShmRing::PrepareWait() {
+    control_->consumer_waiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (control_->head.load(std::memory_order_relaxed) != control_->tail.load(std::memory_order_relaxed)) {
+        CancelWait();
+        return false;
+    }
+    return true;
+}
+
+void KrpcShmRing::CancelWait() {
+    control_->consumer_waiting.store(0, std::memory_order_relaxed);
+}
+
+// ---------------- KrpcShmSegment ----------------
+// memfd布局：[控制页：请求环控制块、响应环控制块][请求环数据][响应环数据]
+
+KrpcShmSegment::~KrpcShmSegment() {
+    if (control_ != nullptr) {
+        munmap(control_, PageSize());
+    }
+    if (request_data_ != nullptr) {
+        munmap(request_data_, ring_bytes_ * 2);
+    }
+    if (response_data_ != nullptr) {
+        munmap(response_data_, ring_bytes_ * 2);
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+bool KrpcShmSegment::Create(size_t ring_bytes) {
+    ring_bytes_ = (ring_bytes + PageSize() - 1) / PageSize() * PageSize();
+    fd_ = memfd_create("krpc_shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd_ < 0) {
+        LOG(ERROR) << "memfd_create error: " << strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd_, PageSize() + ring_bytes_ * 2) < 0 || fcntl(fd_, F_ADD_SEALS, kSealMask) < 0) {
+        LOG(ERROR) << "memfd setup error: " << strerror(errno);
+        return false;
+    }
+    return Map();
+}
+
+bool KrpcShmSegment::Attach(int fd, size_t ring_bytes) {
+    fd_ = fd;
+    ring_bytes_ = ring_bytes;
+    struct stat st;
+    if (ring_bytes_ == 0 || ring_bytes_ % PageSize() != 0 || fstat(fd_, &st) < 0 ||
+        static_cast<size_t>(st.st_size) != PageSize() + ring_bytes_ * 2) {
+        LOG(ERROR) << "invalid shm segment size";
+        return false;
+    }
+    int seals = fcntl(fd_, F_GET_SEALS);
+    if (seals < 0 || (static_cast<uint32_t>(seals) & kSealMask) != kSealMask) {
+        LOG(ERROR) << "shm segment is not sealed";
+        return false;
+    }
+    return Map();
+}
+
+bool KrpcShmSegment::Map() {
+    void *control = mmap(nullptr, PageSize(), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (control == MAP_FAILED) {
+        LOG(ERROR) << "mmap shm control error: " << strerror(errno);
+        return false;
+    }
+    control_ = control;
+    request_data_ = MapRingTwice(fd_, PageSize(), ring_bytes_);
+    response_data_ = MapRingTwice(fd_, PageSize() + ring_bytes_, ring_bytes_);
+    if (request_data_ == nullptr || response_data_ == nullptr) {
+        LOG(ERROR) << "mmap shm ring error: " << strerror(errno);
+        return false;
+    }
+
+    // 新建的memfd内容全为0，正好是两个空环的初始状态
+    char *base = static_cast<char *>(control_);
+    request_ring_.Init(reinterpret_cast<KrpcShmRingControl *>(base), request_data_, ring_bytes_);
+    response_ring_.Init(reinterpret_cast<KrpcShmRingControl *>(base + kControlOffset), response_data_, ring_bytes_);
+    return true;
+}
+
+// ---------------- KrpcShmClient ----------------
+
+std::unique_ptr<KrpcShmClient> KrpcShmClient::Connect(const std::string &path, size_t ring_bytes, int spin_us) {
+    std::unique_ptr<KrpcShmClient> client(new KrpcShmClient());
+    client->spin_us_ = spin_us;
+    if (!client->segment_.Create(ring_bytes)) {
+        return nullptr;
+    }
+    client->request_efd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    client->response_efd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    client->sock_fd_ = KrpcUnixServer::Connect(path);
+    if (client->request_efd_ < 0 || client->response_efd_ < 0 || client->sock_fd_ < 0) {
+        LOG(WARNING) << "connect shm bootstrap socket " << path << " error";
+        return nullptr;
+    }
+
+    // 引导消息：数据为环的容量，附带memfd、请求eventfd、响应eventfd三个描述符
+    uint64_t ring_size = client->segment_.ring_bytes();
+    struct iovec iov = {&ring_size, sizeof(ring_size)};
+    int fds[3] = {client->segment_.fd(), client->request_efd_, client->response_efd_};
+    char control[CMSG_SPACE(sizeof(fds))];
+    memset(control, 0, sizeof(control));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+    if (sendmsg(client->sock_fd_, &msg, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(ring_size))) {
+        LOG(WARNING) << "send shm bootstrap error: " << strerror(errno);
+        return nullptr;
+    }
+
+    // 等待服务端确认已经映射成功
+    struct pollfd pfd = {client->sock_fd_, POLLIN, 0};
+    char ack = 0;
+    if (poll(&pfd, 1, 1000) != 1 || recv(client->sock_fd_, &ack, 1, 0) != 1 || ack != 'K') {
+        LOG(WARNING) << "shm bootstrap rejected by server";
+        return nullptr;
+    }
+    return client;
+}
+
+KrpcShmClient::~KrpcShmClient() {
+    if (sock_fd_ >= 0) {
+        close(sock_fd_);  // 服务端据此释放通道
+    }
+    if (request_efd_ >= 0) {
+        close(request_efd_);
+    }
+    if (response_efd_ >= 0) {
+        close(response_efd_);
+    }
+}
+
+bool KrpcShmClient::Fits(size_t frame_size) {
+    return frame_size <= segment_.request_ring().MaxRecordSize();
+}
+
+bool KrpcShmClient::Call(const Krpc::RpcHeader &header, const google::protobuf::Message &request, const char *attachment,
+                         google::protobuf::Message *response, std::string *response_attachment, int timeout_ms,
+                         std::string *error) {
+    std::string header_str;
+    if (!header.SerializeToString(&header_str)) {
+        *error = "serialize rpc header error!";
+        return false;
+    }
+    size_t header_size = header_str.size();
+    size_t frame_size = google::protobuf::io::CodedOutputStream::VarintSize32(static_cast<uint32_t>(header_size)) +
+                        header_size + header.args_size() + header.attachment_size();
+
+    // 直接在请求环中组帧，请求参数序列化到环里，不经过中间缓冲区
+    KrpcShmRing &request_ring = segment_.request_ring();
+    char *slot = request_ring.Reserve(frame_size);
+    if (slot == nullptr) {
+        *error = "shm request ring full";
+        return false;
+    }
+    uint8_t *p = google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+        static_cast<uint32_t>(header_size), reinterpret_cast<uint8_t *>(slot));
+    memcpy(p, header_str.data(), header_size);
+    p += header_size;
+    if (!request.SerializeToArray(p, static_cast<int>(header.args_size()))) {
+        *error = "serialize request fail";
+        return false;
+    }
+    if (header.attachment_size() > 0) {
+        memcpy(p + header.args_size(), attachment, header.attachment_size());
+    }
+    if (request_ring.Commit(frame_size)) {
+        Wakeup(request_efd_);
+    }
+
+    if (!WaitResponse(timeout_ms, error)) {
+        return false;
+    }
+
+    // 在响应环中原地解析响应
+    KrpcShmRing &response_ring = segment_.response_ring();
+    const char *data = nullptr;
+    size_t len = 0;
+    uint32_t flags = 0;
+    response_ring.Peek(&data, &len, &flags);
+    if (flags & KrpcShmRing::kRecordTooLarge) {
+        response_ring.Release();
+        *error = "response too large for shm ring, increase shm_ring_bytes";
+        return false;
+    }
+    Krpc::RpcResponseHeader response_header;
+    size_t response_offset = 0;
+    size_t response_frame_size = 0;
+    bool ok = KrpcCodec::DecodeResponse(data, len, &response_header, &response_offset, &response_frame_size) ==
+                  KrpcCodec::DecodeStatus::kComplete &&
+              response_header.call_id() == header.call_id() &&
+              response->ParseFromArray(data + response_offset, response_header.response_size());
+    if (ok) {
+        // 环中的空间马上要归还给服务端，附件只能拷贝出来
+        response_attachment->assign(data + response_offset + response_header.response_size(),
+                                    response_header.attachment_size());
+    }
+    response_ring.Release();
+    if (!ok) {
+        *error = "parse shm response error";
+    }
+    return ok;
+}
+
+// 先自旋等待，超过spin_us_后声明睡眠，由服务端提交响应时通过eventfd唤醒
+bool KrpcShmClient::WaitResponse(int timeout_ms, std::string *error) {
+    KrpcShmRing &ring = segment_.response_ring();
+    int64_t start = NowMicros();
+    int64_t deadline = start + static_cast<int64_t>(timeout_ms) * 1000;
+    const char *data = nullptr;
+    size_t len = 0;
+    uint32_t flags = 0;
+
+    while (true) {
+        if (ring.Peek(&data, &len, &flags)) {
+            return true;
+        }
+        int64_t now = NowMicros();
+        if (now - start < spin_us_) {
+            continue;
+        }
+        if (now >= deadline) {
+            *error = "RPC call timed out";
+            return false;
+        }
+        if (!ring.PrepareWait()) {
+            continue;
+        }
+
+        struct pollfd pfds[2] = {{response_efd_, POLLIN, 0}, {sock_fd_, POLLIN, 0}};
+        int ret = poll(pfds, 2, static_cast<int>((deadline - now + 999) / 1000));
+        ring.CancelWait();
+        if (ret < 0 && errno != EINTR) {
+            *error = strerror(errno);
+            return false;
+        }
+        if (ret > 0 && pfds[1].revents != 0) {
+            *error = "shm peer closed";  // 引导套接字上不会再有数据，可读说明服务端已断开
+            return false;
+        }
+        if (ret > 0 && (pfds[0].revents & POLLIN)) {
+            uint64_t count = 0;
+            ssize_t n = read(response_efd_, &count, sizeof(count));
+            (void)n;
+        }
+    }
+}
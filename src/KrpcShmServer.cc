@@ -0,0 +1,380 @@
+#include "KrpcShmServer.h"
+#include "Krpccodec.h"
+#include "KrpcLogger.h"
+#include "KrpcUnixServer.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+
+namespace {
+// 响应环满时的重试：间隔从kRetryMinUs开始翻倍，最多kRetryMaxUs；
+// 等待超过kResponseWaitMs仍然写不进去时，认为客户端已经不再读取，关闭通道让它立即失败
+const int kRetryMinUs = 50;
+const int kRetryMaxUs = 10 * 1000;
+const int kResponseWaitMs = 1000;
+
+int64_t NowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Wakeup(int efd) {
+    uint64_t one = 1;
+    ssize_t n = write(efd, &one, sizeof(one));
+    (void)n;
+}
+}  // namespace
+
+// 一个客户端的共享内存通道，只在所属的IO线程中访问
+struct KrpcShmServer::Session
+{
+    int id = 0;
+    muduo::net::EventLoop *loop = nullptr;
+    int sock_fd = -1;
+    int request_efd = -1;
+    int response_efd = -1;
+    bool established = false;
+    KrpcShmSegment segment;
+    std::unique_ptr<muduo::net::Channel> sock_channel;
+    std::unique_ptr<muduo::net::Channel> request_channel;
+    std::deque<std::string> pending;  // 响应环满时暂存的响应帧，按顺序写入
+    int64_t pending_since_ms = 0;     // 最早的暂存帧开始等待的时间
+
+    ~Session() {
+        if (sock_fd >= 0) {
+            close(sock_fd);
+        }
+        if (request_efd >= 0) {
+            close(request_efd);
+        }
+        if (response_efd >= 0) {
+            close(response_efd);
+        }
+    }
+};
+
+KrpcShmServer::KrpcShmServer(muduo::net::EventLoop *loop, const std::string &path)
+    : loop(loop), path(path), listen_fd(-1), next_session_id(1) {}
+
+KrpcShmServer::~KrpcShmServer() {
+    if (accept_channel) {
+        accept_channel->disableAll();
+        accept_channel->remove();
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        if (path[0] != '@') {
+            unlink(path.c_str());
+        }
+    }
+}
+
+bool KrpcShmServer::Start(const std::shared_ptr<muduo::net::EventLoopThreadPool> &threads) {
+    listen_fd = KrpcUnixServer::Listen(path);
+    if (listen_fd < 0) {
+        return false;
+    }
+    io_threads = threads;
+    accept_channel.reset(new muduo::net::Channel(loop, listen_fd));
+    accept_channel->setReadCallback(std::bind(&KrpcShmServer::OnAccept, this));
+    accept_channel->enableReading();
+    return true;
+}
+
+void KrpcShmServer::OnAccept() {
+    while (true) {
+        int connfd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (connfd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG(ERROR) << "shm bootstrap accept error: " << strerror(errno);
+            }
+            return;
+        }
+
+        SessionPtr session = std::make_shared<Session>();
+        session->id = next_session_id++;
+        session->loop = io_threads->getNextLoop();
+        session->sock_fd = connfd;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex);
+            sessions[session->id] = session;
+        }
+        session->loop->runInLoop([this, session]() {
+            std::weak_ptr<Session> weak = session;
+            session->sock_channel.reset(new muduo::net::Channel(session->loop, session->sock_fd));
+            session->sock_channel->setReadCallback([this, weak](muduo::Timestamp) {
+                if (SessionPtr s = weak.lock()) {
+                    OnBootstrapReadable(s);
+                }
+            });
+            session->sock_channel->enableReading();
+        });
+    }
+}
+
+// 引导套接字可读：第一次是客户端发来的引导消息，之后只可能是连接关闭
+void KrpcShmServer::OnBootstrapReadable(const SessionPtr &session) {
+    if (session->established) {
+        char buf[64];
+        ssize_t n = recv(session->sock_fd, buf, sizeof(buf), 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+            CloseSession(session);
+        }
+        return;
+    }
+
+    uint64_t ring_bytes = 0;
+    struct iovec iov = {&ring_bytes, sizeof(ring_bytes)};
+    int fds[3] = {-1, -1, -1};
+    char control[CMSG_SPACE(sizeof(fds))];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n = recvmsg(session->sock_fd, &msg, MSG_CMSG_CLOEXEC);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+        return;
+    }
+
+    struct cmsghdr *cmsg = n == static_cast<ssize_t>(sizeof(ring_bytes)) ? CMSG_FIRSTHDR(&msg) : nullptr;
+    bool has_fds = cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+                   cmsg->cmsg_len == CMSG_LEN(sizeof(fds));
+    if (cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+        // 无论消息是否合法，收到的描述符都要接管，避免泄漏
+        size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        memcpy(fds, CMSG_DATA(cmsg), std::min(count, static_cast<size_t>(3)) * sizeof(int));
+    }
+    session->request_efd = fds[1];
+    session->response_efd = fds[2];
+
+    // Attach成功后memfd归segment所有
+    if (!has_fds || (msg.msg_flags & MSG_CTRUNC) || !session->segment.Attach(fds[0], ring_bytes)) {
+        if (fds[0] >= 0 && session->segment.fd() != fds[0]) {
+            close(fds[0]);
+        }
+        LOG(ERROR) << "invalid shm bootstrap message";
+        char nack = 'E';
+        send(session->sock_fd, &nack, 1, MSG_NOSIGNAL);
+        CloseSession(session);
+        return;
+    }
+
+    // 初始状态下声明服务端在等待，客户端提交第一个请求时就会写eventfd唤醒
+    session->segment.request_ring().PrepareWait();
+    std::weak_ptr<Session> weak = session;
+    session->request_channel.reset(new muduo::net::Channel(session->loop, session->request_efd));
+    session->request_channel->setReadCallback([this, weak](muduo::Timestamp) {
+        if (SessionPtr s = weak.lock()) {
+            OnRequestReadable(s);
+        }
+    });
+    session->request_channel->enableReading();
+    session->established = true;
+
+    char ack = 'K';
+    if (send(session->sock_fd, &ack, 1, MSG_NOSIGNAL) != 1) {
+        CloseSession(session);
+    }
+}
+
+void KrpcShmServer::OnRequestReadable(const SessionPtr &session) {
+    uint64_t count = 0;
+    ssize_t n = read(session->request_efd, &count, sizeof(count));
+    (void)n;
+    session->segment.request_ring().CancelWait();
+    DrainRequests(session);
+}
+
+// 处理请求环中的全部请求，处理完后声明等待；声明期间又有新请求到达则继续处理
+void KrpcShmServer::DrainRequests(const SessionPtr &session) {
+    KrpcShmRing &ring = session->segment.request_ring();
+    std::weak_ptr<Session> weak = session;
+    ResponseSender sender = [this, weak](uint64_t call_id, google::protobuf::Message *response,
+                                         const KrpcController &controller) {
+        SessionPtr s = weak.lock();
+        if (!s) {
+            return;
+        }
+        KrpcAttachment attachment = controller.ResponseAttachment();
+        if (s->loop->isInLoopThread()) {
+            WriteResponse(s, call_id, response, attachment);
+            return;
+        }
+        // 业务方法在其他线程中完成时，先序列化出完整的帧再交给IO线程写入响应环
+        Krpc::RpcResponseHeader header;
+        std::string response_str;
+        std::string frame;
+        response->SerializeToString(&response_str);
+        header.set_call_id(call_id);
+        header.set_response_size(response_str.size());
+        header.set_attachment_size(attachment.size);
+        KrpcCodec::EncodeResponse(header, response_str, &frame);
+        frame.append(attachment.data, attachment.size);
+        s->loop->runInLoop(std::bind(&KrpcShmServer::WriteFrame, this, s, frame));
+    };
+
+    while (true) {
+        const char *data = nullptr;
+        size_t len = 0;
+        uint32_t flags = 0;
+        while (ring.Peek(&data, &len, &flags)) {
+            Krpc::RpcHeader header;
+            size_t args_offset = 0;
+            size_t frame_size = 0;
+            if (KrpcCodec::DecodeRequest(data, len, &header, &args_offset, &frame_size) !=
+                    KrpcCodec::DecodeStatus::kComplete ||
+                frame_size != len) {
+                LOG(ERROR) << "invalid request frame in shm ring";
+                CloseSession(session);
+                return;
+            }
+            // 请求在环中原地解析，回调返回后才释放这块空间
+            request_callback(header, data + args_offset, header.args_size(), data + args_offset + header.args_size(),
+                             sender);
+            ring.Release();
+        }
+        if (ring.PrepareWait()) {
+            return;
+        }
+    }
+}
+
+// 响应直接序列化到响应环中
+void KrpcShmServer::WriteResponse(const SessionPtr &session, uint64_t call_id, google::protobuf::Message *response,
+                                  const KrpcAttachment &attachment) {
+    if (!session->established) {
+        return;
+    }
+    size_t response_size = response->ByteSizeLong();
+    Krpc::RpcResponseHeader header;
+    header.set_call_id(call_id);
+    header.set_response_size(response_size);
+    header.set_attachment_size(attachment.size);
+    std::string header_str = header.SerializeAsString();
+    size_t frame_size = google::protobuf::io::CodedOutputStream::VarintSize32(static_cast<uint32_t>(header_str.size())) +
+                        header_str.size() + response_size + attachment.size;
+
+    KrpcShmRing &ring = session->segment.response_ring();
+    char *slot = session->pending.empty() && frame_size <= ring.MaxRecordSize() ? ring.Reserve(frame_size) : nullptr;
+    if (slot == nullptr) {
+        // 放不进环（或者前面还有暂存的响应）时组成完整的帧，交给WriteFrame处理
+        std::string response_str;
+        response->SerializeToString(&response_str);
+        std::string frame;
+        KrpcCodec::EncodeResponse(header, response_str, &frame);
+        frame.append(attachment.data, attachment.size);
+        WriteFrame(session, frame);
+        return;
+    }
+    uint8_t *p = google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(
+        static_cast<uint32_t>(header_str.size()), reinterpret_cast<uint8_t *>(slot));
+    memcpy(p, header_str.data(), header_str.size());
+    p += header_str.size();
+    p = response->SerializeWithCachedSizesToArray(p);
+    if (!attachment.empty()) {
+        memcpy(p, attachment.data, attachment.size);
+    }
+    if (ring.Commit(frame_size)) {
+        Wakeup(session->response_efd);
+    }
+}
+
+void KrpcShmServer::WriteFrame(const SessionPtr &session, const std::string &frame) {
+    if (!session->established) {
+        return;
+    }
+    if (session->pending.empty() && TryWriteFrame(session, frame)) {
+        return;
+    }
+    // 响应环已满：暂存起来，等客户端取走之前的响应后再写，不能丢弃
+    if (session->pending.empty()) {
+        session->pending_since_ms = NowMillis();
+        session->pending.push_back(frame);
+        ScheduleFlush(session, kRetryMinUs);
+    } else {
+        session->pending.push_back(frame);
+    }
+}
+
+// 把一个完整的响应帧写入响应环，超过环容量的帧写入一个kRecordTooLarge记录；环中没有空间时返回false
+bool KrpcShmServer::TryWriteFrame(const SessionPtr &session, const std::string &frame) {
+    KrpcShmRing &ring = session->segment.response_ring();
+    bool wake = false;
+    if (frame.size() <= ring.MaxRecordSize()) {
+        char *slot = ring.Reserve(frame.size());
+        if (slot == nullptr) {
+            return false;
+        }
+        memcpy(slot, frame.data(), frame.size());
+        wake = ring.Commit(frame.size());
+    } else {
+        if (ring.Reserve(0) == nullptr) {
+            return false;
+        }
+        LOG(ERROR) << "response of " << frame.size() << " bytes does not fit in shm ring";
+        wake = ring.Commit(0, KrpcShmRing::kRecordTooLarge);
+    }
+    if (wake) {
+        Wakeup(session->response_efd);
+    }
+    return true;
+}
+
+void KrpcShmServer::ScheduleFlush(const SessionPtr &session, int delay_us) {
+    std::weak_ptr<Session> weak = session;
+    session->loop->runAfter(delay_us / 1e6, [this, weak, delay_us]() {
+        if (SessionPtr s = weak.lock()) {
+            FlushPending(s, std::min(delay_us * 2, kRetryMaxUs));
+        }
+    });
+}
+
+// 按顺序写出暂存的响应，仍然写不进去时退避重试，等待太久则关闭通道
+void KrpcShmServer::FlushPending(const SessionPtr &session, int next_delay_us) {
+    if (!session->established) {
+        session->pending.clear();
+        return;
+    }
+    while (!session->pending.empty() && TryWriteFrame(session, session->pending.front())) {
+        session->pending.pop_front();
+        session->pending_since_ms = NowMillis();
+    }
+    if (session->pending.empty()) {
+        return;
+    }
+    if (NowMillis() - session->pending_since_ms >= kResponseWaitMs) {
+        LOG(ERROR) << "shm response ring full for " << kResponseWaitMs << "ms, " << session->pending.size()
+                   << " responses dropped, closing shm session " << session->id;
+        session->pending.clear();
+        CloseSession(session);
+        return;
+    }
+    ScheduleFlush(session, next_delay_us);
+}
+
+// 在会话所属的IO线程中调用
+void KrpcShmServer::CloseSession(const SessionPtr &session) {
+    session->established = false;
+    if (session->sock_channel) {
+        session->sock_channel->disableAll();
+        session->sock_channel->remove();
+    }
+    if (session->request_channel) {
+        session->request_channel->disableAll();
+        session->request_channel->remove();
+    }
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        sessions.erase(session->id);
+    }
+    // 当前可能正处于Channel的事件回调中，延后到本轮循环结束再释放会话
+    SessionPtr hold = session;
+    session->loop->queueInLoop([hold]() {});
+}
@@ -0,0 +1,218 @@
+#include "KrpcStream.h"
+#include "Krpccodec.h"
+#include "Krpcapplication.h"
+#include "KrpcLogger.h"
+#include <muduo/net/EventLoop.h>
+#include <cstdlib>
+
+namespace {
+const uint32_t kDefaultStreamWindow = 16;                    // 默认窗口（消息条数）
+const uint32_t kDefaultStreamWindowBytes = 4 * 1024 * 1024;  // 默认窗口（字节数）
+
+uint32_t LoadWindow(const char *key, uint32_t default_value) {
+    std::string value = KrpcApplication::GetInstance().GetConfig().Load(key);
+    return value.empty() || atoi(value.c_str()) <= 0 ? default_value : static_cast<uint32_t>(atoi(value.c_str()));
+}
+}  // namespace
+
+uint32_t KrpcStreamWindow() {
+    static const uint32_t window = LoadWindow("stream_window", kDefaultStreamWindow);
+    return window;
+}
+
+uint32_t KrpcStreamWindowBytes() {
+    static const uint32_t window_bytes = LoadWindow("stream_window_bytes", kDefaultStreamWindowBytes);
+    return window_bytes;
+}
+
+KrpcStreamCredit::KrpcStreamCredit(uint32_t window, uint32_t window_bytes, bool limit_bytes)
+    : messages_(window), bytes_(window_bytes), limit_bytes_(limit_bytes) {}
+
+bool KrpcStreamCredit::Acquire(size_t size, bool may_block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!may_block && !Available()) {
+        return false;
+    }
+    cond_.wait(lock, [this]() { return Available() || closed_; });
+    if (closed_) {
+        return false;
+    }
+    --messages_;
+    bytes_ -= static_cast<int64_t>(size);
+    return true;
+}
+
+void KrpcStreamCredit::Grant(uint32_t messages, uint32_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_ += messages;
+        bytes_ += bytes;
+    }
+    cond_.notify_all();
+}
+
+void KrpcStreamCredit::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    cond_.notify_all();
+}
+
+bool KrpcStreamCredit::IsClosed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+}
+
+KrpcStreamInbox::KrpcStreamInbox(uint32_t window, uint32_t window_bytes, GrantFn grant)
+    : window_(window), window_bytes_(window_bytes), grant_(std::move(grant)) {}
+
+bool KrpcStreamInbox::Push(std::string message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) {
+            return true;  // 流已经取消，对端还在途中的消息直接丢弃
+        }
+        if (outstanding_ >= window_ || (window_bytes_ != 0 && outstanding_bytes_ >= window_bytes_)) {
+            return false;
+        }
+        ++outstanding_;
+        outstanding_bytes_ += message.size();
+        queue_.push_back(std::move(message));
+    }
+    cond_.notify_one();
+    return true;
+}
+
+void KrpcStreamInbox::End() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ended_ = true;
+    }
+    cond_.notify_all();
+}
+
+void KrpcStreamInbox::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        queue_.clear();
+    }
+    cond_.notify_all();
+}
+
+bool KrpcStreamInbox::Pop(std::string *message) {
+    uint32_t grant = 0;
+    uint64_t grant_bytes = 0;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this]() { return !queue_.empty() || ended_ || closed_; });
+        if (queue_.empty() || closed_) {
+            return false;
+        }
+        *message = std::move(queue_.front());
+        queue_.pop_front();
+        ++consumed_;
+        consumed_bytes_ += message->size();
+        // 取出半个窗口的消息（条数或字节数）就归还一次，流已经结束时不再归还
+        if (!ended_ && (consumed_ >= (window_ + 1) / 2 || (window_bytes_ != 0 && consumed_bytes_ >= window_bytes_ / 2))) {
+            grant = consumed_;
+            grant_bytes = consumed_bytes_;
+            outstanding_ -= consumed_;
+            outstanding_bytes_ -= consumed_bytes_;
+            consumed_ = 0;
+            consumed_bytes_ = 0;
+        }
+    }
+    if (grant != 0) {
+        grant_(grant, static_cast<uint32_t>(grant_bytes));
+    }
+    return true;
+}
+
+bool KrpcStreamInbox::WouldBlock() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.empty() && !ended_ && !closed_;
+}
+
+KrpcStreamWriter::KrpcStreamWriter(uint64_t call_id, uint32_t window, uint32_t window_bytes,
+                                   muduo::net::EventLoop *loop, FrameSink sink)
+    : call_id_(call_id), loop_(loop), sink_(std::move(sink)), credit_(window, window_bytes, window_bytes != 0) {}
+
+bool KrpcStreamWriter::Write(const google::protobuf::Message &message) {
+    std::string payload;
+    if (!message.SerializeToString(&payload)) {
+        LOG(ERROR) << "stream " << call_id_ << " serialize message error";
+        return false;
+    }
+    // 在IO线程中等待会让它收不到归还窗口的帧，只能拒绝
+    bool in_loop = loop_ != nullptr && loop_->isInLoopThread();
+    if (!credit_.Acquire(payload.size(), !in_loop)) {
+        if (in_loop && !credit_.IsClosed()) {
+            LOG(ERROR) << "stream " << call_id_ << " window exhausted in io thread, write from a worker thread instead";
+        }
+        return false;
+    }
+
+    Krpc::RpcResponseHeader header;
+    header.set_call_id(call_id_);
+    header.set_response_size(payload.size());
+    header.set_stream_message(true);
+    std::string frame;
+    if (!KrpcCodec::EncodeResponse(header, payload, &frame)) {
+        LOG(ERROR) << "stream " << call_id_ << " serialize header error";
+        return false;
+    }
+    sink_(std::move(frame));
+    return true;
+}
+
+void KrpcStreamWriter::AddCredit(uint32_t messages, uint32_t bytes) {
+    credit_.Grant(messages, bytes);
+}
+
+void KrpcStreamWriter::Close() {
+    credit_.Close();
+}
+
+bool KrpcStreamWriter::IsClosed() const {
+    return credit_.IsClosed();
+}
+
+KrpcStreamReader::KrpcStreamReader(uint64_t call_id, uint32_t window, uint32_t window_bytes,
+                                   muduo::net::EventLoop *loop, KrpcStreamWriter::FrameSink sink)
+    : call_id_(call_id), window_(window), window_bytes_(window_bytes), loop_(loop), sink_(std::move(sink)),
+      inbox_(window, window_bytes, [this](uint32_t messages, uint32_t bytes) { SendCredit(messages, bytes); }) {}
+
+void KrpcStreamReader::Start() {
+    SendCredit(window_, window_bytes_);
+}
+
+bool KrpcStreamReader::Read(google::protobuf::Message *message) {
+    if (loop_ != nullptr && loop_->isInLoopThread() && inbox_.WouldBlock()) {
+        // 消息由IO线程收下，在IO线程中等待永远等不到
+        LOG(ERROR) << "stream " << call_id_ << " has no message ready in io thread, read from a worker thread instead";
+        return false;
+    }
+    std::string payload;
+    if (!inbox_.Pop(&payload)) {
+        return false;
+    }
+    if (!message->ParseFromString(payload)) {
+        LOG(ERROR) << "stream " << call_id_ << " parse message error";
+        return false;
+    }
+    return true;
+}
+
+// 用响应头的stream_credit帧把窗口归还给客户端
+void KrpcStreamReader::SendCredit(uint32_t messages, uint32_t bytes) {
+    Krpc::RpcResponseHeader header;
+    header.set_call_id(call_id_);
+    header.set_stream_credit(messages);
+    header.set_stream_credit_bytes(bytes);
+    std::string frame;
+    if (KrpcCodec::EncodeResponse(header, std::string(), &frame)) {
+        sink_(std::move(frame));
+    }
+}
@@ -0,0 +1,346 @@
+#include "KrpcStreamChannel.h"
+#include "Krpccodec.h"
+#include "Krpcendpoint.h"
+#include "KrpcLogger.h"
+#include "KrpcTrace.h"
+#include "KrpcUnixServer.h"
+#include "zookeeperutil.h"
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+// 把len字节全部写入阻塞的socket
+bool WriteAll(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int ConnectTcp(const std::string &ip, uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr(ip.c_str());
+    if (connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+}  // namespace
+
+KrpcBidiStream::KrpcBidiStream(KrpcStreamChannel *channel, uint64_t call_id)
+    : channel_(channel), call_id_(call_id), credit_(0, 0, true),  // 窗口由服务端在流建立后给出
+      inbox_(KrpcStreamWindow(), KrpcStreamWindowBytes(), [this](uint32_t messages, uint32_t bytes) {
+          Krpc::RpcHeader header;
+          header.set_call_id(call_id_);
+          header.set_stream_credit(messages);
+          header.set_stream_credit_bytes(bytes);
+          channel_->SendFrame(header, std::string());
+      }) {}
+
+bool KrpcBidiStream::Write(const google::protobuf::Message &message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (writes_done_ || finished_) {
+            return false;
+        }
+    }
+    std::string payload;
+    if (!message.SerializeToString(&payload)) {
+        LOG(ERROR) << "stream " << call_id_ << " serialize message error";
+        return false;
+    }
+    if (!credit_.Acquire(payload.size(), true)) {
+        return false;
+    }
+    Krpc::RpcHeader header;
+    header.set_call_id(call_id_);
+    header.set_stream_message(true);
+    return channel_->SendFrame(header, payload);
+}
+
+bool KrpcBidiStream::WritesDone() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (writes_done_ || finished_) {
+            return false;
+        }
+        writes_done_ = true;
+    }
+    Krpc::RpcHeader header;
+    header.set_call_id(call_id_);
+    header.set_stream_end(true);
+    return channel_->SendFrame(header, std::string());
+}
+
+bool KrpcBidiStream::Read(google::protobuf::Message *message) {
+    std::string payload;
+    if (!inbox_.Pop(&payload)) {
+        return false;
+    }
+    if (!message->ParseFromString(payload)) {
+        LOG(ERROR) << "stream " << call_id_ << " parse message error";
+        return false;
+    }
+    return true;
+}
+
+bool KrpcBidiStream::Finish(google::protobuf::Message *response, std::string *error) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return finished_; });
+    if (!error_.empty()) {
+        *error = error_;
+        return false;
+    }
+    if (!response->ParseFromString(response_)) {
+        *error = "parse response error";
+        return false;
+    }
+    return true;
+}
+
+void KrpcBidiStream::OnCredit(uint32_t messages, uint32_t bytes) {
+    credit_.Grant(messages, bytes);
+}
+
+void KrpcBidiStream::OnMessage(std::string message) {
+    if (!inbox_.Push(std::move(message))) {
+        OnError("server exceeded the stream window");
+    }
+}
+
+// 服务端结束了流：已经收到的消息仍然可以读完，之后不能再写
+void KrpcBidiStream::OnFinish(std::string response) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        response_ = std::move(response);
+        finished_ = true;
+    }
+    inbox_.End();
+    credit_.Close();
+    cond_.notify_all();
+}
+
+void KrpcBidiStream::OnError(const std::string &error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (finished_) {
+            return;
+        }
+        error_ = error;
+        finished_ = true;
+    }
+    inbox_.Close();
+    credit_.Close();
+    cond_.notify_all();
+}
+
+std::unique_ptr<KrpcStreamChannel> KrpcStreamChannel::Connect(const google::protobuf::MethodDescriptor *method) {
+    std::string method_path = "/" + method->service()->name() + "/" + method->name();
+    ZkClient zkclient;
+    zkclient.Start();
+    std::string host_data = zkclient.GetData(method_path.c_str());
+    KrpcEndpoint endpoint;
+    if (host_data.empty() || !KrpcEndpoint::Parse(host_data, &endpoint)) {
+        LOG(ERROR) << method_path << " is not exist!";
+        return nullptr;
+    }
+    // 同机时优先使用Unix域套接字，失败时退回TCP
+    int fd = -1;
+    if (!endpoint.unix_path.empty() && endpoint.IsLocalHost()) {
+        fd = KrpcUnixServer::Connect(endpoint.unix_path);
+    }
+    if (fd == -1) {
+        fd = ConnectTcp(endpoint.ip, endpoint.port);
+    }
+    if (fd == -1) {
+        char errtxt[512] = {0};
+        LOG(ERROR) << "connect " << endpoint.ip << ":" << endpoint.port << " error:"
+                   << strerror_r(errno, errtxt, sizeof(errtxt));
+        return nullptr;
+    }
+    return std::unique_ptr<KrpcStreamChannel>(new KrpcStreamChannel(fd));
+}
+
+KrpcStreamChannel::KrpcStreamChannel(int fd) : fd_(fd), next_call_id_(0) {
+    receiver_ = std::thread(&KrpcStreamChannel::ReceiveLoop, this);
+}
+
+KrpcStreamChannel::~KrpcStreamChannel() {
+    shutdown(fd_, SHUT_RDWR);  // 唤醒阻塞在recv中的接收线程
+    receiver_.join();
+    close(fd_);
+}
+
+std::shared_ptr<KrpcBidiStream> KrpcStreamChannel::Open(const google::protobuf::MethodDescriptor *method,
+                                                        const google::protobuf::Message &request,
+                                                        uint32_t priority) {
+    std::string args;
+    if (!request.SerializeToString(&args)) {
+        LOG(ERROR) << "serialize request fail";
+        return nullptr;
+    }
+    uint64_t call_id = ++next_call_id_;
+    std::shared_ptr<KrpcBidiStream> stream(new KrpcBidiStream(this, call_id));
+    {
+        // 先登记再发送，服务端给出的初始窗口可能在发送返回前就到达
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        if (closed_) {
+            return nullptr;
+        }
+        streams_[call_id] = stream;
+    }
+
+    Krpc::RpcHeader header;
+    header.set_service_name(method->service()->name());
+    header.set_method_name(method->name());
+    header.set_call_id(call_id);
+    header.set_bidi_stream(true);
+    header.set_stream_window(KrpcStreamWindow());
+    header.set_stream_window_bytes(KrpcStreamWindowBytes());
+    header.set_framed_response(true);
+    header.set_accept_fragment(true);
+    header.set_priority(priority);
+    // 双向流只传递追踪上下文，不记录客户端span，服务端照常记录整个流的span
+    KrpcTraceContext trace = KrpcTracer::Instance().StartClient();
+    if (trace.valid()) {
+        trace.ToProto(header.mutable_trace());
+    }
+    if (!SendFrame(header, args)) {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        streams_.erase(call_id);
+        return nullptr;
+    }
+    return stream;
+}
+
+bool KrpcStreamChannel::SendFrame(Krpc::RpcHeader header, const std::string &payload) {
+    header.set_args_size(payload.size());
+    std::string frame;
+    if (!KrpcCodec::EncodeRequest(header, payload, &frame)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    return WriteAll(fd_, frame.data(), frame.size());
+}
+
+std::shared_ptr<KrpcBidiStream> KrpcStreamChannel::FindStream(uint64_t call_id) {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    auto it = streams_.find(call_id);
+    return it != streams_.end() ? it->second : nullptr;
+}
+
+// 接收线程：逐帧解析，按call_id分发给各个流
+void KrpcStreamChannel::ReceiveLoop() {
+    std::string buffer;
+    size_t received = 0;
+    while (true) {
+        // 先处理缓冲区中所有完整的帧，再把剩下的半个帧移到开头
+        size_t consumed = 0;
+        size_t frame_size = 0;
+        KrpcCodec::DecodeStatus status;
+        while (true) {
+            Krpc::RpcResponseHeader header;
+            size_t payload_offset = 0;
+            frame_size = 0;
+            status = KrpcCodec::DecodeResponse(buffer.data() + consumed, received - consumed, &header,
+                                               &payload_offset, &frame_size);
+            if (status != KrpcCodec::DecodeStatus::kComplete) {
+                break;
+            }
+            Dispatch(header, buffer.data() + consumed + payload_offset);
+            consumed += frame_size;
+        }
+        if (status == KrpcCodec::DecodeStatus::kError) {
+            LOG(ERROR) << "parse stream response header error";
+            break;
+        }
+        buffer.erase(0, consumed);
+        received -= consumed;
+
+        // 头部已经解析出来时一次备好整个帧的空间，否则先按64KB接收
+        size_t want = frame_size > received ? frame_size : received + 64 * 1024;
+        if (buffer.size() < want) {
+            buffer.resize(want);
+        }
+        ssize_t n = recv(fd_, &buffer[received], buffer.size() - received, 0);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        received += static_cast<size_t>(n);
+    }
+
+    // 连接已经断开，还没有结束的流全部失败
+    std::map<uint64_t, std::shared_ptr<KrpcBidiStream>> streams;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        closed_ = true;
+        streams.swap(streams_);
+    }
+    for (auto &entry : streams) {
+        entry.second->OnError("connection closed");
+    }
+}
+
+void KrpcStreamChannel::Dispatch(const Krpc::RpcResponseHeader &header, const char *payload) {
+    if (header.fragment_total() != 0) {
+        // 拼好的帧（流消息或者最终的响应）解析后再按普通的帧分发
+        std::string frame;
+        KrpcFragmentAssembler::Status status = fragments_.Add(header, payload, &frame);
+        if (status == KrpcFragmentAssembler::Status::kPending) {
+            return;
+        }
+        Krpc::RpcResponseHeader frame_header;
+        size_t payload_offset = 0;
+        size_t frame_size = 0;
+        if (status == KrpcFragmentAssembler::Status::kError ||
+            KrpcCodec::DecodeResponse(frame.data(), frame.size(), &frame_header, &payload_offset, &frame_size) !=
+                KrpcCodec::DecodeStatus::kComplete ||
+            frame_header.fragment_total() != 0) {
+            std::shared_ptr<KrpcBidiStream> stream = FindStream(header.call_id());
+            if (stream) {
+                stream->OnError("reassemble response fragments error");
+            }
+            return;
+        }
+        Dispatch(frame_header, frame.data() + payload_offset);
+        return;
+    }
+    std::shared_ptr<KrpcBidiStream> stream = FindStream(header.call_id());
+    if (!stream) {
+        return;  // 流已经结束
+    }
+    if (header.stream_credit() != 0 || header.stream_credit_bytes() != 0) {
+        stream->OnCredit(header.stream_credit(), header.stream_credit_bytes());
+    } else if (header.stream_message()) {
+        stream->OnMessage(std::string(payload, header.response_size()));
+    } else {
+        // 不带流标记的响应表示流结束
+        {
+            std::lock_guard<std::mutex> lock(streams_mutex_);
+            streams_.erase(header.call_id());
+        }
+        stream->OnFinish(std::string(payload, header.response_size()));
+    }
+}
@@ -0,0 +1,278 @@
+#include "KrpcTrace.h"
+#include "Krpcapplication.h"
+#include "KrpcLogger.h"
+#include "KrpcMetrics.h"
+#include "KrpcSampling.h"
+#include "Krpcheader.pb.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+const size_t kDefaultRingSize = 65536;
+const int kDefaultFlushMs = 100;
+
+thread_local KrpcTraceContext t_current;
+
+// 非0的ID
+uint64_t NewId() {
+    uint64_t id;
+    do {
+        id = KrpcRandom();
+    } while (id == 0);
+    return id;
+}
+}  // namespace
+
+void KrpcTraceContext::ToProto(Krpc::TraceContext *proto) const {
+    proto->set_trace_id(trace_id);
+    proto->set_span_id(span_id);
+    proto->set_parent_span_id(parent_span_id);
+    proto->set_sampled(sampled);
+}
+
+KrpcTraceContext KrpcTraceContext::FromProto(const Krpc::TraceContext &proto) {
+    KrpcTraceContext context;
+    context.trace_id = proto.trace_id();
+    context.span_id = proto.span_id();
+    context.parent_span_id = proto.parent_span_id();
+    context.sampled = proto.sampled();
+    return context;
+}
+
+KrpcSpanRing::KrpcSpanRing(size_t capacity) : enqueue_pos_(0), dequeue_pos_(0) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    cells_.reset(new Cell[size]);
+    for (size_t i = 0; i < size; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask_ = size - 1;
+}
+
+// 一格的序号等于写入位置时可以写，等于写入位置+1时可以读；读完后序号推进一圈，留给下一轮写入
+bool KrpcSpanRing::Push(const KrpcSpanRecord &record) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+        Cell &cell = cells_[pos & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.record = record;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // 满了
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool KrpcSpanRing::Pop(KrpcSpanRecord *record) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+        Cell &cell = cells_[pos & mask_];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                *record = cell.record;
+                cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // 空了
+        } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+KrpcTracer &KrpcTracer::Instance() {
+    static KrpcTracer tracer;
+    return tracer;
+}
+
+KrpcTracer::KrpcTracer() : flush_ms_(kDefaultFlushMs), exported_(0), dropped_(0) {
+    Krpcconfig &config = KrpcApplication::GetInstance().GetConfig();
+    std::string rate = config.Load("trace_sample_rate");
+    double sample_rate = rate.empty() ? 0 : atof(rate.c_str());
+    if (sample_rate >= 1) {
+        sample_all_ = true;
+    } else if (sample_rate > 0) {
+        sample_threshold_ = KrpcSampleThreshold(sample_rate);
+    }
+    std::string flush_ms = config.Load("trace_flush_ms");
+    if (!flush_ms.empty() && atoi(flush_ms.c_str()) > 0) {
+        flush_ms_ = atoi(flush_ms.c_str());
+    }
+
+    std::string file = config.Load("trace_file");
+    if (!file.empty()) {
+        file_ = fopen(file.c_str(), "a");
+        if (file_ == nullptr) {
+            LOG(ERROR) << "open trace_file " << file << " error: " << strerror(errno);
+        }
+    }
+    std::string collector = config.Load("trace_collector");
+    if (!collector.empty()) {
+        size_t colon = collector.rfind(':');
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        if (colon == std::string::npos ||
+            inet_pton(AF_INET, collector.substr(0, colon).c_str(), &addr.sin_addr) != 1) {
+            LOG(ERROR) << "invalid trace_collector " << collector << ", expect ip:port";
+        } else {
+            addr.sin_port = htons(static_cast<uint16_t>(atoi(collector.c_str() + colon + 1)));
+            collector_fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+            collector_addr_.assign(reinterpret_cast<const char *>(&addr), sizeof(addr));
+        }
+    }
+    if (file_ == nullptr && collector_fd_ == -1) {
+        return;  // 没有输出，只传递上下文
+    }
+
+    std::string ring_size = config.Load("trace_ring_size");
+    ring_.reset(new KrpcSpanRing(ring_size.empty() ? kDefaultRingSize : strtoull(ring_size.c_str(), nullptr, 10)));
+    std::thread([this]() { ExportLoop(); }).detach();
+}
+
+const KrpcTraceContext &KrpcTracer::Current() {
+    return t_current;
+}
+
+bool KrpcTracer::SampleRoot() {
+    return sample_all_ || (sample_threshold_ != 0 && KrpcRandom() < sample_threshold_);
+}
+
+KrpcTraceContext KrpcTracer::StartClient() {
+    const KrpcTraceContext &parent = t_current;
+    if (parent.valid()) {
+        KrpcTraceContext context;
+        context.trace_id = parent.trace_id;
+        context.span_id = NewId();
+        context.parent_span_id = parent.span_id;
+        context.sampled = parent.sampled;
+        return context;
+    }
+    if (!sample_all_ && sample_threshold_ == 0) {
+        return KrpcTraceContext();  // 没有开启采样，不作为调用链的入口
+    }
+    KrpcTraceContext context;
+    context.trace_id = NewId();
+    context.span_id = NewId();
+    context.sampled = SampleRoot();
+    return context;
+}
+
+KrpcTraceContext KrpcTracer::StartServer(const KrpcTraceContext &incoming) {
+    KrpcTraceContext context;
+    if (incoming.valid()) {
+        context.trace_id = incoming.trace_id;
+        context.span_id = NewId();
+        context.parent_span_id = incoming.span_id;
+        context.sampled = incoming.sampled;
+        return context;
+    }
+    if (!sample_all_ && sample_threshold_ == 0) {
+        return context;
+    }
+    context.trace_id = NewId();
+    context.span_id = NewId();
+    context.sampled = SampleRoot();
+    return context;
+}
+
+void KrpcTracer::Finish(const KrpcTraceContext &context, KrpcSpanRecord::Kind kind, const std::string &service,
+                        const std::string &method, int64_t start_unix_ns, uint64_t duration_ns, bool failed) {
+    if (!context.sampled || !ring_) {
+        return;
+    }
+    KrpcSpanRecord record;
+    record.trace_id = context.trace_id;
+    record.span_id = context.span_id;
+    record.parent_span_id = context.parent_span_id;
+    record.start_unix_ns = start_unix_ns;
+    record.duration_ns = duration_ns;
+    record.kind = kind;
+    record.failed = failed;
+    snprintf(record.name, sizeof(record.name), "%s.%s", service.c_str(), method.c_str());
+    if (!ring_->Push(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int64_t KrpcTracer::UnixNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// 后台线程：定期取空环形缓冲区
+void KrpcTracer::ExportLoop() {
+    KrpcSpanRecord record;
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(flush_ms_));
+        bool wrote = false;
+        while (ring_->Pop(&record)) {
+            Export(record);
+            wrote = true;
+        }
+        if (wrote && file_ != nullptr) {
+            fflush(file_);
+        }
+    }
+}
+
+void KrpcTracer::Export(const KrpcSpanRecord &record) {
+    char line[512];
+    int len = snprintf(line, sizeof(line),
+                       "{\"trace_id\":\"%016llx\",\"span_id\":\"%016llx\",\"parent_span_id\":\"%016llx\","
+                       "\"name\":\"%s\",\"kind\":\"%s\",\"start_unix_ns\":%lld,\"duration_ns\":%llu,\"error\":%s}\n",
+                       static_cast<unsigned long long>(record.trace_id),
+                       static_cast<unsigned long long>(record.span_id),
+                       static_cast<unsigned long long>(record.parent_span_id), record.name,
+                       record.kind == KrpcSpanRecord::kClient ? "client" : "server",
+                       static_cast<long long>(record.start_unix_ns),
+                       static_cast<unsigned long long>(record.duration_ns), record.failed ? "true" : "false");
+    if (len <= 0) {
+        return;
+    }
+    size_t size = static_cast<size_t>(len) < sizeof(line) ? static_cast<size_t>(len) : sizeof(line) - 1;
+    if (file_ != nullptr) {
+        fwrite(line, 1, size, file_);
+    }
+    if (collector_fd_ != -1) {
+        sendto(collector_fd_, line, size, MSG_DONTWAIT,
+               reinterpret_cast<const struct sockaddr *>(collector_addr_.data()),
+               static_cast<socklen_t>(collector_addr_.size()));
+    }
+    exported_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void KrpcTracer::AppendMetrics(std::string *out) {
+    KrpcAppendMetricFamily(out, "krpc_trace_spans", "counter", "Sampled spans by export result.");
+    KrpcAppendMetricSample(out, "krpc_trace_spans_total", "result=\"exported\"",
+                           static_cast<double>(exported_.load(std::memory_order_relaxed)));
+    KrpcAppendMetricSample(out, "krpc_trace_spans_total", "result=\"dropped\"",
+                           static_cast<double>(dropped_.load(std::memory_order_relaxed)));
+}
+
+KrpcTraceScope::KrpcTraceScope(const KrpcTraceContext &context) : saved_(t_current) {
+    t_current = context;
+}
+
+KrpcTraceScope::~KrpcTraceScope() {
+    t_current = saved_;
+}
@@ -0,0 +1,133 @@
+#include "KrpcUnixServer.h"
+#include "KrpcLogger.h"
+#include <muduo/net/InetAddress.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
+namespace {
+// 填充sockaddr_un，返回地址的实际长度，路径过长时返回0
+socklen_t MakeUnixAddress(const std::string &path, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+        return 0;
+    }
+    memcpy(addr->sun_path, path.data(), path.size());
+    if (path[0] == '@') {
+        addr->sun_path[0] = '\0';  // 抽象命名空间，不在文件系统中留下文件
+        return static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size());
+    }
+    return static_cast<socklen_t>(sizeof(*addr));
+}
+}  // namespace
+
+KrpcUnixServer::KrpcUnixServer(muduo::net::EventLoop *loop, const std::string &path)
+    : loop(loop), path(path), listen_fd(-1), next_conn_id(1) {}
+
+KrpcUnixServer::~KrpcUnixServer() {
+    if (accept_channel) {
+        accept_channel->disableAll();
+        accept_channel->remove();
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        if (path[0] != '@') {
+            unlink(path.c_str());
+        }
+    }
+    for (auto &item : connections) {
+        muduo::net::TcpConnectionPtr conn = item.second;
+        conn->getLoop()->runInLoop(std::bind(&muduo::net::TcpConnection::connectDestroyed, conn));
+    }
+}
+
+int KrpcUnixServer::Listen(const std::string &path) {
+    struct sockaddr_un addr;
+    socklen_t addr_len = MakeUnixAddress(path, &addr);
+    if (addr_len == 0) {
+        LOG(ERROR) << "invalid unix socket path: " << path;
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG(ERROR) << "unix socket create error: " << strerror(errno);
+        return -1;
+    }
+    if (path[0] != '@') {
+        unlink(path.c_str());  // 清理上次进程退出时遗留的套接字文件
+    }
+    if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), addr_len) < 0 || listen(fd, SOMAXCONN) < 0) {
+        LOG(ERROR) << "unix socket bind/listen error: " << path << " " << strerror(errno);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int KrpcUnixServer::Connect(const std::string &path) {
+    struct sockaddr_un addr;
+    socklen_t addr_len = MakeUnixAddress(path, &addr);
+    if (addr_len == 0) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, reinterpret_cast<struct sockaddr *>(&addr), addr_len) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool KrpcUnixServer::Start(const std::shared_ptr<muduo::net::EventLoopThreadPool> &threads) {
+    listen_fd = Listen(path);
+    if (listen_fd < 0) {
+        return false;
+    }
+    io_threads = threads;
+    accept_channel.reset(new muduo::net::Channel(loop, listen_fd));
+    accept_channel->setReadCallback(std::bind(&KrpcUnixServer::OnAccept, this));
+    accept_channel->enableReading();
+    return true;
+}
+
+// 与muduo::net::TcpServer::newConnection的流程一致
+void KrpcUnixServer::OnAccept() {
+    while (true) {
+        int connfd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (connfd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                LOG(ERROR) << "unix socket accept error: " << strerror(errno);
+            }
+            return;
+        }
+
+        muduo::net::EventLoop *io_loop = io_threads->getNextLoop();
+        std::string name = "KrpcUnix#" + std::to_string(next_conn_id++);
+        // Unix域套接字没有IP地址，本端和对端地址都留空
+        muduo::net::TcpConnectionPtr conn = std::make_shared<muduo::net::TcpConnection>(
+            io_loop, name, connfd, muduo::net::InetAddress(), muduo::net::InetAddress());
+        connections[name] = conn;
+        conn->setConnectionCallback(connection_callback);
+        conn->setMessageCallback(message_callback);
+        conn->setCloseCallback(std::bind(&KrpcUnixServer::RemoveConnection, this, std::placeholders::_1));
+        io_loop->runInLoop(std::bind(&muduo::net::TcpConnection::connectEstablished, conn));
+    }
+}
+
+void KrpcUnixServer::RemoveConnection(const muduo::net::TcpConnectionPtr &conn) {
+    loop->runInLoop(std::bind(&KrpcUnixServer::RemoveConnectionInLoop, this, conn));
+}
+
+void KrpcUnixServer::RemoveConnectionInLoop(const muduo::net::TcpConnectionPtr &conn) {
+    connections.erase(conn->name());
+    conn->getLoop()->queueInLoop(std::bind(&muduo::net::TcpConnection::connectDestroyed, conn));
+}
@@ -1,4 +1,5 @@
 #include "Krpcapplication.h"
+#include "KrpcLog.h"
 #include<cstdlib>
 #include<unistd.h>
 
@@ -36,6 +37,8 @@ void KrpcApplication::Init(int argc, char **argv) {
 
     // 加载配置文件
     m_config.LoadConfigFile(config_file.c_str());
+    // 按配置启动异步日志的后台线程
+    KrpcLog::Start();
 }
 
 // 获取单例对象的引用，保证全局只有一个实例
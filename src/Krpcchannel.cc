@@ -4,12 +4,23 @@
 #include "Krpcapplication.h"
 #include "Krpccontroller.h"
 #include "KrpcLogger.h"
+#include "Krpccodec.h"
+#include "Krpcendpoint.h"
+#include "KrpcUnixServer.h"
+#include "KrpcStream.h"
+#include "KrpcFragment.h"
+#include "KrpcMetrics.h"
+#include "KrpcTrace.h"
+#include "KrpcProbes.h"
+#include "KrpcLog.h"
+#include <google/protobuf/io/coded_stream.h>
 
 #include "memory"
 #include <errno.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <poll.h>
@@ -17,10 +28,166 @@
 #include <string.h>
 #include <iostream>
 #include <mutex>
+#include <chrono>
 
 std::mutex g_data_mutx; // 全局互斥锁，用于保护共享数据的线程安全
+const size_t kDefaultShmRingBytes = 8 * 1024 * 1024; // 共享内存通道每个方向的环形缓冲区大小
+const int kDefaultShmSpinUs = 20;                     // 共享内存通道等待响应时先自旋的时间（微秒）
 std::mutex KrpcChannel::s_load_balance_mutex;
 std::atomic<int> KrpcChannel::s_next_server_index(0);
+std::atomic<uint64_t> KrpcChannel::s_next_call_id(0);
+
+namespace {
+// 本次调用的超时时间，调用方没有使用KrpcController时取默认值
+int CallTimeoutMs(google::protobuf::RpcController *controller)
+{
+    KrpcController *krpc_controller = dynamic_cast<KrpcController *>(controller);
+    return krpc_controller != nullptr ? krpc_controller->GetTimeout() : 5000;
+}
+
+// 把一个请求帧和紧跟其后的附件一起写入socket，附件不拷贝进帧，直接由内核从调用方的内存中取走
+bool SendFrame(int fd, const std::string &frame, const KrpcAttachment &attachment, char *errtxt, size_t errlen)
+{
+    struct iovec iov[2];
+    iov[0].iov_base = const_cast<char *>(frame.data());
+    iov[0].iov_len = frame.size();
+    iov[1].iov_base = const_cast<char *>(attachment.data);
+    iov[1].iov_len = attachment.size;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = attachment.empty() ? 1 : 2;
+
+    // 大报文可能需要多次sendmsg才能发完，每次从上次写到的位置继续
+    while (msg.msg_iovlen > 0) {
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            strerror_r(errno, errtxt, errlen);
+            return false;
+        }
+        size_t left = static_cast<size_t>(n);
+        while (msg.msg_iovlen > 0 && left >= msg.msg_iov->iov_len) {
+            left -= msg.msg_iov->iov_len;
+            ++msg.msg_iov;
+            --msg.msg_iovlen;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov->iov_base = static_cast<char *>(msg.msg_iov->iov_base) + left;
+            msg.msg_iov->iov_len -= left;
+        }
+    }
+    return true;
+}
+
+// 把收到的响应附件交给调用方的控制器，holder持有附件所在的接收缓冲区
+void SetReceivedAttachment(KrpcController *controller, const char *data, size_t size, std::shared_ptr<void> holder)
+{
+    if (controller != nullptr && size > 0) {
+        controller->SetReceivedAttachment(data, size, std::move(holder));
+    }
+}
+
+// 调用结束时记录耗时、收发的字节数、各阶段的耗时、结果和客户端span，CallMethod的每一个返回路径都经过这里
+class CallRecorder
+{
+public:
+    CallRecorder(int metrics_id, const google::protobuf::MethodDescriptor *method,
+                 google::protobuf::RpcController *controller, const google::protobuf::Message *request,
+                 const google::protobuf::Message *response)
+        : metrics_id_(metrics_id), method_(method), controller_(controller), request_(request), response_(response),
+          start_(std::chrono::steady_clock::now()), last_(start_), phase_ns_(),
+          trace_(KrpcTracer::Instance().StartClient()), start_unix_ns_(trace_.sampled ? KrpcTracer::UnixNanos() : 0)
+    {
+    }
+    // 本次调用的追踪上下文，无效时请求头中不带
+    const KrpcTraceContext &trace() const { return trace_; }
+    // 请求头中的调用序号，call_end探针带上它；分配序号之前失败的调用为0
+    void SetCallId(uint64_t call_id) { call_id_ = call_id; }
+    // 上一次Lap以来的时间计入phase
+    void Lap(KrpcPhase phase)
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        phase_ns_[phase] += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_).count());
+        last_ = now;
+    }
+    // 响应头带回的服务端阶段，结束时从网络阶段中扣除
+    void ServerPhases(const Krpc::RpcResponseHeader &header)
+    {
+        phase_ns_[kPhaseServerQueue] = header.server_queue_ns();
+        phase_ns_[kPhaseServerHandler] = header.server_handler_ns();
+        phase_ns_[kPhaseServerSerialize] = header.server_serialize_ns();
+    }
+    ~CallRecorder()
+    {
+        uint64_t server_ns = phase_ns_[kPhaseServerQueue] + phase_ns_[kPhaseServerHandler] + phase_ns_[kPhaseServerSerialize];
+        phase_ns_[kPhaseNetwork] = phase_ns_[kPhaseNetwork] > server_ns ? phase_ns_[kPhaseNetwork] - server_ns : 0;
+        KrpcController *krpc_controller = dynamic_cast<KrpcController *>(controller_);
+        if (krpc_controller != nullptr)
+        {
+            for (int phase = 0; phase < kPhaseCount; ++phase)
+            {
+                krpc_controller->SetPhaseNanos(static_cast<KrpcPhase>(phase), phase_ns_[phase]);
+            }
+            krpc_controller->SetTraceContext(trace_);
+        }
+        uint64_t latency_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                        std::chrono::steady_clock::now() - start_).count());
+        bool failed = controller_->Failed();
+        KRPC_PROBE4(call_end, metrics_id_, call_id_, latency_ns, failed);
+        if (trace_.sampled)
+        {
+            KrpcTracer::Instance().Finish(trace_, KrpcSpanRecord::kClient, method_->service()->name(), method_->name(),
+                                          start_unix_ns_, latency_ns, failed);
+        }
+        if (metrics_id_ < 0)
+        {
+            return;
+        }
+        // 请求已经序列化过，直接取缓存的长度
+        size_t bytes_out = static_cast<size_t>(request_->GetCachedSize());
+        size_t bytes_in = failed ? 0 : response_->ByteSizeLong();
+        if (krpc_controller != nullptr)
+        {
+            bytes_out += krpc_controller->RequestAttachment().size;
+            bytes_in += failed ? 0 : krpc_controller->ResponseAttachment().size;
+        }
+        KrpcMetrics::Instance().Record(metrics_id_, latency_ns, bytes_in, bytes_out, failed);
+        KrpcMetrics::Instance().RecordPhases(metrics_id_, phase_ns_);
+    }
+
+private:
+    int metrics_id_;
+    const google::protobuf::MethodDescriptor *method_;
+    google::protobuf::RpcController *controller_;
+    const google::protobuf::Message *request_;
+    const google::protobuf::Message *response_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_;
+    uint64_t phase_ns_[kPhaseCount];
+    KrpcTraceContext trace_;
+    int64_t start_unix_ns_;
+    uint64_t call_id_ = 0;
+};
+
+#ifdef KRPC_WITH_UCX
+// 调用结束时释放通过旁路暴露的请求参数，服务端读取完成时也会通知释放，两者都可能先发生
+struct BulkReleaser
+{
+    KrpcBulkAgent *agent = nullptr;
+    uint64_t bulk_id = 0;
+    ~BulkReleaser()
+    {
+        if (agent != nullptr && bulk_id != 0)
+        {
+            agent->Release(bulk_id);
+        }
+    }
+};
+#endif
+} // namespace
 
 // 设置socket为非阻塞模式
 int KrpcChannel::setSocketNonBlocking(int fd)
@@ -77,97 +244,515 @@ void KrpcChannel::CallMethod(const ::google::protobuf::MethodDescriptor *method,
                              ::google::protobuf::Message *response,
                              ::google::protobuf::Closure *done)
 {
-    if (-1 == m_clientfd) {  // 如果客户端socket未初始化
+    if (method != m_metrics_method) {
+        m_metrics_id = KrpcMetrics::Instance().MethodId(KrpcMetrics::kClient, method->service()->name(), method->name());
+        m_metrics_method = method;
+    }
+    CallRecorder recorder(m_metrics_id, method, controller, request, response);
+
+    // 连接跨调用复用，换了服务时才重新查询；socket连接在上一次调用之后可能已被服务端关闭，此时重新连接
+    if (hasConnection() && method->service()->name() != service_name) {
+        resetConnections();
+    }
+    if (m_clientfd != -1 && !socketAlive()) {
+        closeConnection();
+    }
+    if (!hasConnection()) {  // 如果客户端socket、共享内存通道和UCX连接都未初始化
         // 获取服务对象名和方法名
         const google::protobuf::ServiceDescriptor *sd = method->service();
         service_name = sd->name();  // 服务名
         method_name = method->name();  // 方法名
+        m_method = nullptr;  // 下面重新按服务端的能力确定压缩参数
 
         // 客户端需要查询ZooKeeper，找到提供该服务的服务器地址
         ZkClient zkCli;
         zkCli.Start();  // 连接ZooKeeper服务器
         // this will use service config for location.
         std::string host_data = QueryServiceHost(&zkCli, service_name, method_name, m_idx);  // 查询服务地址
-        m_ip = host_data.substr(0, m_idx);  // 从查询结果中提取IP地址
-        // std::cout << "ip: " << m_ip << std::endl;
-        m_port = atoi(host_data.substr(m_idx + 1, host_data.size() - m_idx).c_str());  // 从查询结果中提取端口号
-        // std::cout << "port: " << m_port << std::endl;
-
-        // 尝试连接服务器
-        auto rt = newConnect(m_ip.c_str(), m_port);
-        if (!rt) {
-            LOG(ERROR) << "connect server error";  // 连接失败，记录错误日志
+        if (!KrpcEndpoint::Parse(host_data, &m_endpoint)) {
+            controller->SetFailed("invalid service address: " + host_data);
             return;
-        } else {
-            // LOG(INFO) << "connect server success";  // 连接成功，记录日志
         }
+        recorder.Lap(kPhaseDiscovery);
+        m_ip = m_endpoint.ip;  // 从查询结果中提取IP地址
+        m_port = m_endpoint.port;  // 从查询结果中提取端口号
+        m_peer = m_ip + ":" + std::to_string(m_port);
+
+        // 同机且开启了shm_enable时优先协商共享内存通道，通道建立后跨调用复用
+        Krpcconfig &config = KrpcApplication::GetInstance().GetConfig();
+        if (!m_endpoint.shm_path.empty() && m_endpoint.IsLocalHost() && config.Load("shm_enable") == "1") {
+            std::string ring_bytes = config.Load("shm_ring_bytes");
+            std::string spin_us = config.Load("shm_spin_us");
+            m_shm = KrpcShmClient::Connect(m_endpoint.shm_path,
+                                           ring_bytes.empty() ? kDefaultShmRingBytes : strtoull(ring_bytes.c_str(), nullptr, 10),
+                                           spin_us.empty() ? kDefaultShmSpinUs : atoi(spin_us.c_str()));
+        }
+#ifdef KRPC_WITH_UCX
+        // 服务端提供了UCX传输且开启了ucx_enable时使用UCX连接
+        if (!m_shm && m_endpoint.ucx_port != 0 && config.Load("ucx_enable") == "1") {
+            std::shared_ptr<UCXContext> ucx_context = KrpcSharedUcxContext();
+            if (ucx_context) {
+                m_ucx = UCXClient::Connect(ucx_context, m_ip, m_endpoint.ucx_port);
+                if (m_ucx) {
+                    m_ucx->setMaxMessageSize(KrpcCodec::MaxFrameSize());
+                }
+            }
+        }
+#endif
+        if (!hasConnection() && !connectEndpoint()) {
+            KRPC_LOG_ERROR("connect server {}:{} error", m_ip, m_port);  // 连接失败，记录错误日志
+            controller->SetFailed("connect server error");
+            return;
+        }
+        recorder.Lap(kPhaseConnect);
     }  // endif
 
-    // 将请求参数序列化为字符串，并计算其长度
-    uint32_t args_size{};
-    std::string args_str;
-    if (request->SerializeToString(&args_str)) {  // 序列化请求参数
-        args_size = args_str.size();  // 获取序列化后的长度
-    } else {
-        controller->SetFailed("serialize request fail");  // 序列化失败，设置错误信息
-        return;
+    // 同一个通道可以依次调用同一服务的不同方法，压缩参数按方法确定
+    if (method != m_method) {
+        method_name = method->name();
+        // 跨机调用时按服务端能解压的算法协商压缩，同机调用不压缩
+        const KrpcCompressPolicy &compress_policy = KrpcCompressPolicy::Instance();
+        bool remote = !m_endpoint.IsLocalHost();
+        m_accept_compress = remote ? compress_policy.SupportedMask() : 0;
+        m_compress_threshold = remote && (m_endpoint.compress_mask & compress_policy.SupportedMask())
+                                   ? compress_policy.Threshold(service_name, method_name)
+                                   : 0;
+        m_dict_method = service_name + "." + method_name;
+        m_compress_tracker = m_compress_threshold != 0 && compress_policy.Adaptive()
+                                 ? KrpcAdaptiveCompress::Instance().Tracker(m_peer, m_dict_method)
+                                 : nullptr;
+        m_method = method;
     }
 
     // 定义RPC请求的头部信息
+    uint64_t call_id = ++s_next_call_id;
     Krpc::RpcHeader krpcheader;
     krpcheader.set_service_name(service_name);  // 设置服务名
     krpcheader.set_method_name(method_name);  // 设置方法名
-    krpcheader.set_args_size(args_size);  // 设置参数长度
-
-    // 将RPC头部信息序列化为字符串，并计算其长度
-    uint32_t header_size = 0;
-    std::string rpc_header_str;
-    if (krpcheader.SerializeToString(&rpc_header_str)) {  // 序列化头部信息
-        header_size = rpc_header_str.size();  // 获取序列化后的长度
-    } else {
-        controller->SetFailed("serialize rpc header error!");  // 序列化失败，设置错误信息
+    krpcheader.set_call_id(call_id);  // 设置调用序号
+    recorder.SetCallId(call_id);
+    KRPC_PROBE4(call_start, m_metrics_id, call_id, service_name.c_str(), method_name.c_str());
+    if (recorder.trace().valid()) {
+        recorder.trace().ToProto(krpcheader.mutable_trace());  // 服务端的span以本次调用为父
+    }
+
+    // 附件只能通过KrpcController传递，紧跟在参数之后发送
+    KrpcController *krpc_controller = dynamic_cast<KrpcController *>(controller);
+    KrpcAttachment request_attachment;
+    if (krpc_controller != nullptr) {
+        request_attachment = krpc_controller->RequestAttachment();
+        krpc_controller->SetReceivedAttachment(nullptr, 0, nullptr);  // 丢掉上一次调用的响应附件
+    }
+    krpcheader.set_attachment_size(static_cast<uint32_t>(request_attachment.size));
+
+    // 设置了流消息处理函数时发起服务端流式调用，只走socket
+    KrpcController::StreamHandler stream_handler;
+    if (krpc_controller != nullptr) {
+        stream_handler = krpc_controller->GetStreamHandler();
+    }
+    uint32_t stream_window = stream_handler ? KrpcStreamWindow() : 0;
+    uint32_t stream_window_bytes = stream_handler ? KrpcStreamWindowBytes() : 0;
+    krpcheader.set_stream_window(stream_window);
+    krpcheader.set_stream_window_bytes(stream_window_bytes);
+    // 按响应帧接收响应；大响应可以分片接收，优先级决定服务端分片发送时的先后
+    krpcheader.set_framed_response(true);
+    krpcheader.set_accept_fragment(true);
+    if (krpc_controller != nullptr) {
+        krpcheader.set_priority(krpc_controller->GetPriority());
+    }
+
+    // 共享内存通道：请求直接序列化进共享内存，放不下时改走socket
+    if (m_shm && !stream_handler) {
+        krpcheader.set_args_size(static_cast<uint32_t>(request->ByteSizeLong()));
+        size_t header_size = krpcheader.ByteSizeLong();
+        size_t frame_size = google::protobuf::io::CodedOutputStream::VarintSize32(static_cast<uint32_t>(header_size)) +
+                            header_size + krpcheader.args_size() + request_attachment.size;
+        if (m_shm->Fits(frame_size)) {
+            std::string errtxt;
+            std::shared_ptr<std::string> response_attachment = std::make_shared<std::string>();
+            if (!m_shm->Call(krpcheader, *request, request_attachment.data, response, response_attachment.get(),
+                             CallTimeoutMs(controller), &errtxt)) {
+                m_shm.reset();  // 通道状态已不可知，下一次调用重新协商
+                controller->SetFailed(errtxt);
+                return;
+            }
+            // 共享内存通道不带回响应头，序列化、服务端和解析的时间都计入网络阶段
+            recorder.Lap(kPhaseNetwork);
+            SetReceivedAttachment(krpc_controller, response_attachment->data(), response_attachment->size(),
+                                  response_attachment);
+            return;
+        }
+    }
+
+#ifdef KRPC_WITH_UCX
+    // UCX连接：请求直接序列化进已注册的缓冲区，整帧作为一条活动消息发出，响应同样收在已注册的缓冲区中
+    if (m_ucx && !stream_handler) {
+        krpcheader.set_args_size(static_cast<uint32_t>(request->ByteSizeLong()));
+        UCXBuffer request_frame = m_ucx->pool().acquire(
+            KrpcCodec::FrameSize(krpcheader, krpcheader.args_size() + request_attachment.size));
+        if (!request_frame) {
+            controller->SetFailed("allocate ucx request buffer error");
+            return;
+        }
+        char *end = KrpcCodec::WriteFrame(krpcheader, *request, request_frame.data());
+        if (!request_attachment.empty()) {
+            memcpy(end, request_attachment.data, request_attachment.size);
+        }
+        recorder.Lap(kPhaseSerialize);
+
+        std::shared_ptr<UCXBuffer> response_frame = std::make_shared<UCXBuffer>();
+        std::string errtxt;
+        if (!m_ucx->Call(request_frame, response_frame.get(), CallTimeoutMs(controller), &errtxt)) {
+            m_ucx.reset();  // 连接已不可用，下一次调用重新建立
+            controller->SetFailed(errtxt);
+            return;
+        }
+        recorder.Lap(kPhaseNetwork);
+        Krpc::RpcResponseHeader response_header;
+        size_t response_offset = 0;
+        size_t frame_size = 0;
+        if (KrpcCodec::DecodeResponse(response_frame->data(), response_frame->size(), &response_header,
+                                      &response_offset, &frame_size) != KrpcCodec::DecodeStatus::kComplete ||
+            response_header.call_id() != call_id) {
+            m_ucx.reset();
+            controller->SetFailed("parse ucx response header error");
+            return;
+        }
+        recorder.ServerPhases(response_header);
+        const char *payload = response_frame->data() + response_offset;
+        if (!response->ParseFromArray(payload, response_header.response_size())) {
+            controller->SetFailed("parse response error");
+            return;
+        }
+        recorder.Lap(kPhaseParse);
+        // 响应附件留在已注册的缓冲区中，缓冲区随控制器释放后归还内存池
+        SetReceivedAttachment(krpc_controller, payload + response_header.response_size(),
+                              response_header.attachment_size(), response_frame);
         return;
     }
+#endif
+
+    // 共享内存通道放不下的请求和流式调用走socket
+    if (-1 == m_clientfd && !connectEndpoint()) {
+        controller->SetFailed("connect server error");
+        return;
+    }
+    recorder.Lap(kPhaseConnect);
+
+#ifdef KRPC_WITH_UCX
+    // 大负载旁路：参数和附件足够大且服务端支持时，两者依次写入已注册的内存中，由服务端通过UCX直接读取
+    KrpcBulkAgent *bulk_agent = KrpcBulkAgent::Instance();
+    BulkReleaser bulk_releaser;
+    if (bulk_agent != nullptr && !stream_handler) {
+        krpcheader.set_accept_bulk(true);  // 大响应同样可以走旁路
+        size_t request_size = request->ByteSizeLong();
+        if (m_endpoint.bulk && request_size + request_attachment.size >= bulk_agent->threshold()) {
+            UCXBuffer data = bulk_agent->pool().acquire(request_size + request_attachment.size);
+            if (data) {
+                uint8_t *end = request->SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t *>(data.data()));
+                if (!request_attachment.empty()) {
+                    memcpy(end, request_attachment.data, request_attachment.size);
+                }
+                krpcheader.set_args_size(static_cast<uint32_t>(request_size));
+                if (bulk_agent->Expose(std::move(data), krpcheader.mutable_bulk())) {
+                    bulk_releaser.agent = bulk_agent;
+                    bulk_releaser.bulk_id = krpcheader.bulk().bulk_id();
+                } else {
+                    krpcheader.clear_bulk();
+                }
+            }
+        }
+    }
+#endif
+
+    // 将请求参数序列化为字符串，并计算其长度（参数走旁路时帧中不带参数和附件）
+    std::string args_str;
+    if (!krpcheader.has_bulk()) {
+        if (!request->SerializeToString(&args_str)) {  // 序列化请求参数
+            controller->SetFailed("serialize request fail");  // 序列化失败，设置错误信息
+            return;
+        }
+        krpcheader.set_args_size(args_str.size());  // 设置参数长度
+    }
 
-    // 将头部长度和头部信息拼接成完整的RPC请求报文
+    // 服务端持有本方法的字典时用字典压缩小消息；否则参数足够大时压缩。
+    // 压缩后没有变小则照常发送原始参数；附件不压缩
+    const std::string *args_payload = &args_str;
+    KrpcDictStore &dicts = KrpcDictStore::Instance();
+    KrpcZstdDictPtr dict;
+    if (m_accept_compress != 0 && dicts.Enabled()) {
+        KrpcZstdDictPtr local_dict = dicts.ForMethod(m_dict_method);
+        krpcheader.set_accept_dict_id(local_dict ? local_dict->id() : 0);
+        if (args_str.size() >= dicts.MinBytes()) {
+            uint32_t peer_dict_id = dicts.PeerDictId(m_peer, m_dict_method);
+            if (peer_dict_id != 0) {
+                dict = dicts.ById(peer_dict_id);
+            }
+        }
+    }
+    if (dict) {
+        if (m_compressor.CompressWithDict(*dict, args_str.data(), args_str.size(), &m_compress_buf) &&
+            m_compress_buf.size() < args_str.size()) {
+            krpcheader.set_compress_type(Krpc::COMPRESS_ZSTD);
+            krpcheader.set_dict_id(dict->id());
+            args_payload = &m_compress_buf;
+        }
+    } else if (m_compress_threshold != 0 && args_str.size() >= m_compress_threshold) {
+        KrpcCompressChoice choice = m_compress_tracker != nullptr
+                                        ? m_compress_tracker->Choose(m_endpoint.compress_mask)
+                                        : KrpcCompressPolicy::Instance().Choose(m_endpoint.compress_mask);
+        if (KrpcCompressPayload(&m_compressor, m_compress_tracker, choice, args_str, &m_compress_buf)) {
+            krpcheader.set_compress_type(choice.type);
+            args_payload = &m_compress_buf;
+        }
+    }
+    if (args_payload == &m_compress_buf) {
+        krpcheader.set_raw_size(args_str.size());
+        krpcheader.set_args_size(m_compress_buf.size());
+    }
+    krpcheader.set_accept_compress(m_accept_compress);  // 服务端据此决定是否压缩响应
+
+    // 将头部长度、头部信息和请求参数拼接成RPC请求报文，附件不拼进来，发送时直接跟在后面
     std::string send_rpc_str;
-    {
-        google::protobuf::io::StringOutputStream string_output(&send_rpc_str);
-        google::protobuf::io::CodedOutputStream coded_output(&string_output);
-        coded_output.WriteVarint32(static_cast<uint32_t>(header_size));  // 写入头部长度
-        coded_output.WriteString(rpc_header_str);  // 写入头部信息
+    if (!KrpcCodec::EncodeRequest(krpcheader, *args_payload, &send_rpc_str)) {
+        controller->SetFailed("serialize rpc header error!");  // 序列化失败，设置错误信息
+        return;
     }
-    send_rpc_str += args_str;  // 拼接请求参数
+    recorder.Lap(kPhaseSerialize);
 
     // 发送RPC请求到服务器
-    if (-1 == send(m_clientfd, send_rpc_str.c_str(), send_rpc_str.size(), 0)) {
-        close(m_clientfd);  // 发送失败，关闭socket
-        char errtxt[512] = {};
-        std::cout << "send error: " << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;  // 打印错误信息
+    char errtxt[512] = {};
+    if (!SendFrame(m_clientfd, send_rpc_str, krpcheader.has_bulk() ? KrpcAttachment() : request_attachment, errtxt,
+                   sizeof(errtxt))) {
+        KRPC_LOG_ERROR("send error: {}", errtxt);  // 记录错误日志
+        closeConnection();  // 发送失败，关闭socket
         controller->SetFailed(errtxt);  // 设置错误信息
         return;
     }
+    recorder.Lap(kPhaseSend);
 
-    // 接收服务器的响应
-    char recv_buf[1024] = {0};
-    int recv_size = 0;
-    if (-1 == (recv_size = recv(m_clientfd, recv_buf, 1024, 0))) {
-        char errtxt[512] = {};
-        std::cout << "recv error" << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;  // 打印错误信息
-        controller->SetFailed(errtxt);  // 设置错误信息
+    // 接收服务器的响应，直到收到一个完整的响应帧。数据直接收进recv_buf，不经过中间缓冲区，
+    // 响应附件最后原地交给控制器。流式调用中先逐条收到流消息，最后才是响应
+    std::shared_ptr<std::string> recv_holder = std::make_shared<std::string>();
+    std::string &recv_buf = *recv_holder;
+    size_t received = 0;
+    Krpc::RpcResponseHeader response_header;
+    size_t response_offset = 0;
+    size_t frame_size = 0;
+    uint32_t stream_consumed = 0;        // 已经处理、还没有归还窗口的流消息条数
+    uint32_t stream_consumed_bytes = 0;  // 同上，字节数
+    KrpcFragmentAssembler fragments;     // 服务端分片发送的帧在这里拼回完整的帧
+    // 等待响应的时间不超过调用的超时（不大于0时不限），流式调用中每处理一条流消息重新计时
+    int timeout_ms = CallTimeoutMs(controller);
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        KrpcCodec::DecodeStatus status = KrpcCodec::DecodeResponse(recv_buf.data(), received, &response_header,
+                                                                   &response_offset, &frame_size);
+        if (status == KrpcCodec::DecodeStatus::kComplete && response_header.fragment_total() != 0) {
+            std::string assembled;
+            KrpcFragmentAssembler::Status fragment_status =
+                fragments.Add(response_header, recv_buf.data() + response_offset, &assembled);
+            if (fragment_status == KrpcFragmentAssembler::Status::kError) {
+                closeConnection();
+                controller->SetFailed("reassemble response fragments error");
+                return;
+            }
+            if (fragment_status == KrpcFragmentAssembler::Status::kPending) {
+                recv_buf.erase(0, frame_size);
+                received -= frame_size;
+            } else {
+                // 拼好的帧放回缓冲区开头，后面接上已经收到的其余数据，再按普通的帧解析
+                assembled.append(recv_buf, frame_size, received - frame_size);
+                recv_buf.swap(assembled);
+                received = recv_buf.size();
+            }
+            frame_size = 0;
+            continue;
+        }
+        if (status == KrpcCodec::DecodeStatus::kComplete && response_header.stream_message()) {
+            if (!stream_handler || response_header.call_id() != call_id) {
+                closeConnection();
+                controller->SetFailed("unexpected stream message");
+                return;
+            }
+            if (!stream_handler(recv_buf.data() + response_offset, response_header.response_size())) {
+                closeConnection();  // 服务端在连接断开后停止写入
+                controller->SetFailed("stream canceled by caller");
+                return;
+            }
+            // 处理完的流消息移出缓冲区，处理了半个窗口（条数或字节数）的消息就归还一次窗口；
+            // stream_window_bytes为0表示不限字节数，只按条数归还
+            stream_consumed_bytes += response_header.response_size();
+            deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            recv_buf.erase(0, frame_size);
+            received -= frame_size;
+            frame_size = 0;
+            if (++stream_consumed >= (stream_window + 1) / 2 ||
+                (stream_window_bytes != 0 && stream_consumed_bytes >= stream_window_bytes / 2)) {
+                Krpc::RpcHeader credit_header;
+                credit_header.set_call_id(call_id);
+                credit_header.set_stream_credit(stream_consumed);
+                credit_header.set_stream_credit_bytes(stream_consumed_bytes);
+                std::string credit_frame;
+                if (!KrpcCodec::EncodeRequest(credit_header, std::string(), &credit_frame) ||
+                    !SendFrame(m_clientfd, credit_frame, KrpcAttachment(), errtxt, sizeof(errtxt))) {
+                    closeConnection();
+                    controller->SetFailed(std::string("send stream credit error: ") + errtxt);
+                    return;
+                }
+                stream_consumed = 0;
+                stream_consumed_bytes = 0;
+            }
+            continue;
+        }
+        if (status == KrpcCodec::DecodeStatus::kComplete) {
+            break;
+        }
+        if (status == KrpcCodec::DecodeStatus::kError) {
+            closeConnection();
+            controller->SetFailed("parse response header error");
+            return;
+        }
+
+        // 头部已经解析出来时一次备好整个帧的空间，否则先按4KB接收
+        size_t want = status == KrpcCodec::DecodeStatus::kIncomplete && frame_size > received ? frame_size : received + 4096;
+        if (recv_buf.size() < want) {
+            recv_buf.resize(want);
+        }
+        int wait_ms = -1;
+        if (timeout_ms > 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            wait_ms = remaining.count() > 0 ? static_cast<int>(remaining.count()) : 0;
+        }
+        ssize_t recv_size = recvWithTimeout(m_clientfd, &recv_buf[received], recv_buf.size() - received, wait_ms);
+        if (recv_size == -1 && errno == EINTR) {
+            continue;
+        }
+        if (recv_size == -ETIMEDOUT) {
+            // 响应可能之后才到，连接上的帧已经对不上，不能再复用
+            KRPC_LOG_ERROR("{}.{} wait response timeout after {} ms", service_name, method_name, timeout_ms);
+            closeConnection();
+            KrpcController *krpc_controller = dynamic_cast<KrpcController *>(controller);
+            if (krpc_controller != nullptr) {
+                krpc_controller->SetTimedOut();
+            }
+            controller->SetFailed("wait response timeout");
+            return;
+        }
+        if (recv_size <= 0) {
+            char errtxt[512] = {};
+            if (recv_size == 0) {
+                snprintf(errtxt, sizeof(errtxt), "connection closed by peer");
+            } else {
+                strerror_r(errno, errtxt, sizeof(errtxt));
+            }
+            KRPC_LOG_ERROR("recv error: {}", errtxt);  // 记录错误日志
+            closeConnection();
+            controller->SetFailed(errtxt);  // 设置错误信息
+            return;
+        }
+        received += recv_size;
+    }
+    recorder.Lap(kPhaseNetwork);  // 流式调用中处理流消息的时间也在这里
+
+    // 一次只有一个调用在途，响应之后不应该还有数据，否则连接上的帧已经对不上，不能再复用
+    if (response_header.call_id() != call_id || received != frame_size) {
+        closeConnection();
+        controller->SetFailed("response call_id mismatch");
+        return;
+    }
+    recorder.ServerPhases(response_header);
+    if (m_accept_compress != 0 && KrpcDictStore::Instance().Enabled()) {
+        // 服务端的字典可能已经更新，记下来给之后的调用（包括重新连接之后的）使用
+        KrpcDictStore::Instance().SetPeerDictId(m_peer, m_dict_method, response_header.accept_dict_id());
+    }
+    if (!response_header.error().empty()) {
+        // 服务端没有处理这个请求，连接上的帧仍然完整，可以继续使用
+        controller->SetFailed(response_header.error());
         return;
     }
 
-    // 将接收到的响应数据反序列化为response对象
-    if (!response->ParseFromArray(recv_buf, recv_size)) {
-        close(m_clientfd);  // 反序列化失败，关闭socket
-        char errtxt[512] = {};
-        std::cout << "parse error" << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;  // 打印错误信息
-        controller->SetFailed(errtxt);  // 设置错误信息
+#ifdef KRPC_WITH_UCX
+    // 响应走了旁路：帧里只有描述符，通过UCX直接读取响应负载
+    if (response_header.has_bulk()) {
+        // 旁路的负载中依次是响应和附件
+        std::shared_ptr<UCXBuffer> data = std::make_shared<UCXBuffer>();
+        if (bulk_agent == nullptr || !bulk_agent->Fetch(response_header.bulk(), CallTimeoutMs(controller), data.get()) ||
+            data->size() != static_cast<size_t>(response_header.response_size()) + response_header.attachment_size() ||
+            !response->ParseFromArray(data->data(), response_header.response_size())) {
+            controller->SetFailed("fetch bulk response error");
+        } else {
+            SetReceivedAttachment(krpc_controller, data->data() + response_header.response_size(),
+                                  response_header.attachment_size(), data);
+        }
+        recorder.Lap(kPhaseNetwork);  // 读取旁路负载的时间计入网络阶段
         return;
     }
+#endif
 
-    close(m_clientfd);  // 关闭socket连接
+    // 将接收到的响应数据反序列化为response对象，压缩过的响应先解压到复用的缓冲区中
+    const char *response_data = recv_buf.data() + response_offset;
+    size_t response_size = response_header.response_size();
+    if (response_header.compress_type() != Krpc::COMPRESS_NONE) {
+        if (!m_compressor.Decompress(response_header.compress_type(), response_header.dict_id(), response_data,
+                                     response_size, response_header.raw_size(), &m_compress_buf)) {
+            closeConnection();
+            controller->SetFailed("decompress response error");
+            return;
+        }
+        response_data = m_compress_buf.data();
+        response_size = m_compress_buf.size();
+    }
+    if (!response->ParseFromArray(response_data, static_cast<int>(response_size))) {
+        closeConnection();  // 反序列化失败，关闭socket
+        controller->SetFailed("parse response error");  // 设置错误信息
+        return;
+    }
+    KrpcShrinkBuffer(&m_compress_buf);
+    recorder.Lap(kPhaseParse);
+    SetReceivedAttachment(krpc_controller, recv_buf.data() + response_offset + response_header.response_size(),
+                          response_header.attachment_size(), recv_holder);
+    // 连接留给下一次调用
+}
+
+// 是否已经有可用的连接（socket、共享内存通道或UCX连接）
+bool KrpcChannel::hasConnection() const {
+    if (m_shm || m_clientfd != -1) {
+        return true;
+    }
+#ifdef KRPC_WITH_UCX
+    if (m_ucx) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+// 关闭当前socket连接，下一次调用时重新建立
+void KrpcChannel::closeConnection() {
+    if (m_clientfd != -1) {
+        close(m_clientfd);
+        m_clientfd = -1;
+    }
+}
+
+// 关闭所有连接，下一次调用时重新查询服务地址
+void KrpcChannel::resetConnections() {
+    closeConnection();
+    m_shm.reset();
+#ifdef KRPC_WITH_UCX
+    m_ucx.reset();
+#endif
+}
+
+// 两次调用之间连接上不应该有任何数据，可读说明服务端已经关闭连接（或者数据流已经错乱）
+bool KrpcChannel::socketAlive() const {
+    struct pollfd pfd;
+    pfd.fd = m_clientfd;
+    pfd.events = POLLIN | POLLRDHUP;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) == 0;
 }
 
 // 创建新的socket连接
@@ -178,8 +763,7 @@ bool KrpcChannel::newConnect(const char *ip, uint16_t port) {
     int clientfd = socket(AF_INET, SOCK_STREAM, 0);
     if (-1 == clientfd) {
         char errtxt[512] = {0};
-        std::cout << "socket error" << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;  // 打印错误信息
-        LOG(ERROR) << "socket error:" << errtxt;  // 记录错误日志
+        KRPC_LOG_ERROR("socket error: {}", strerror_r(errno, errtxt, sizeof(errtxt)));  // 记录错误日志
         return false;
     }
 
@@ -193,8 +777,7 @@ bool KrpcChannel::newConnect(const char *ip, uint16_t port) {
     if (-1 == connect(clientfd, (struct sockaddr *)&server_addr, sizeof(server_addr))) {
         close(clientfd);  // 连接失败，关闭socket
         char errtxt[512] = {0};
-        std::cout << "connect error" << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;  // 打印错误信息
-        LOG(ERROR) << "connect server error" << errtxt;  // 记录错误日志
+        KRPC_LOG_ERROR("connect {}:{} error: {}", ip, port, strerror_r(errno, errtxt, sizeof(errtxt)));  // 记录错误日志
         return false;
     }
 
@@ -202,23 +785,47 @@ bool KrpcChannel::newConnect(const char *ip, uint16_t port) {
     return true;
 }
 
+// 按照m_endpoint建立socket连接：与服务端在同一台机器上时优先使用Unix域套接字，失败时退回TCP
+bool KrpcChannel::connectEndpoint() {
+    if (!m_endpoint.unix_path.empty() && m_endpoint.IsLocalHost() && newConnectUnix(m_endpoint.unix_path)) {
+        return true;
+    }
+    return newConnect(m_ip.c_str(), m_port);
+}
+
+// 通过Unix域套接字连接同机的服务端
+bool KrpcChannel::newConnectUnix(const std::string &path) {
+    int clientfd = KrpcUnixServer::Connect(path);
+    if (-1 == clientfd) {
+        KRPC_LOG_WARNING("connect unix socket {} error, fall back to tcp", path);
+        return false;
+    }
+    m_clientfd = clientfd;  // 后续的收发与TCP连接完全相同
+    return true;
+}
+
 // 从ZooKeeper查询服务地址
 std::string KrpcChannel::QueryServiceHost(ZkClient *zkclient, std::string service_name, std::string method_name, int &idx) {
     std::string method_path = "/" + service_name + "/" + method_name;  // 构造ZooKeeper路径
     // std::cout << "method_path: " << method_path << std::endl;
 
+    std::chrono::steady_clock::time_point lookup_start = std::chrono::steady_clock::now();
     std::unique_lock<std::mutex> lock(g_data_mutx);  // 加锁，保证线程安全
     std::string host_data_1 = zkclient->GetData(method_path.c_str());  // 从ZooKeeper获取数据
     lock.unlock();  // 解锁
+    KRPC_PROBE3(zk_lookup, method_path.c_str(),
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - lookup_start)
+                    .count(),
+                !host_data_1.empty());
 
     if (host_data_1 == "") {  // 如果未找到服务地址
-        LOG(ERROR) << method_path + " is not exist!";  // 记录错误日志
+        KRPC_LOG_ERROR("{} is not exist!", method_path);  // 记录错误日志
         return " ";
     }
 
     idx = host_data_1.find(":");  // 查找IP和端口的分隔符
     if (idx == -1) {  // 如果分隔符不存在
-        LOG(ERROR) << method_path + " address is invalid!";  // 记录错误日志
+        KRPC_LOG_ERROR("{} address is invalid!", method_path);  // 记录错误日志
         return " ";
     }
 
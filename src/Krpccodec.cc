@@ -0,0 +1,124 @@
+#include "Krpccodec.h"
+#include "KrpcCompress.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace
+{
+// 头部长度的上限，超过说明数据流已经错乱
+const uint32_t kMaxHeaderSize = 64 * 1024;
+
+// 请求帧和响应帧的布局相同，只是头部类型和负载长度字段不同
+template <typename Header>
+bool EncodeFrame(const Header &header, const std::string &payload, std::string *out)
+{
+    std::string header_str;
+    if (!header.SerializeToString(&header_str))
+    {
+        return false;
+    }
+    {
+        google::protobuf::io::StringOutputStream string_output(out);
+        google::protobuf::io::CodedOutputStream coded_output(&string_output);
+        coded_output.WriteVarint32(static_cast<uint32_t>(header_str.size())); // 写入头部长度
+        coded_output.WriteString(header_str);                                 // 写入头部信息
+    }
+    out->append(payload); // 拼接负载
+    return true;
+}
+
+template <typename Header, typename PayloadSize>
+KrpcCodec::DecodeStatus DecodeFrame(const char *data, size_t len, Header *header,
+                                    size_t *payload_offset, size_t *frame_size, PayloadSize payload_size)
+{
+    google::protobuf::io::CodedInputStream coded_input(reinterpret_cast<const uint8_t *>(data), static_cast<int>(len));
+
+    uint32_t header_size = 0;
+    if (!coded_input.ReadVarint32(&header_size))
+    {
+        // varint最长5个字节，不足5个字节时可能只是还没收全
+        return len < 5 ? KrpcCodec::DecodeStatus::kIncomplete : KrpcCodec::DecodeStatus::kError;
+    }
+    if (header_size > kMaxHeaderSize)
+    {
+        return KrpcCodec::DecodeStatus::kError;
+    }
+
+    size_t header_offset = coded_input.CurrentPosition();
+    if (len - header_offset < header_size)
+    {
+        return KrpcCodec::DecodeStatus::kIncomplete;
+    }
+    if (!header->ParseFromArray(data + header_offset, header_size))
+    {
+        return KrpcCodec::DecodeStatus::kError;
+    }
+
+    size_t offset = header_offset + header_size;
+    size_t size = payload_size(*header);
+    if (size > KrpcCompressPolicy::Instance().MaxMessageBytes())
+    {
+        return KrpcCodec::DecodeStatus::kError; // 在分配接收空间之前拒绝
+    }
+    if (len - offset < size)
+    {
+        *frame_size = offset + size; // 头部已经完整，告诉调用方整个帧还需要多少数据
+        return KrpcCodec::DecodeStatus::kIncomplete;
+    }
+
+    *payload_offset = offset;
+    *frame_size = offset + size;
+    return KrpcCodec::DecodeStatus::kComplete;
+}
+} // namespace
+
+bool KrpcCodec::EncodeRequest(const Krpc::RpcHeader &header, const std::string &args, std::string *out)
+{
+    return EncodeFrame(header, args, out);
+}
+
+bool KrpcCodec::EncodeResponse(const Krpc::RpcResponseHeader &header, const std::string &response, std::string *out)
+{
+    return EncodeFrame(header, response, out);
+}
+
+size_t KrpcCodec::MaxFrameSize()
+{
+    return 5 + kMaxHeaderSize + KrpcCompressPolicy::Instance().MaxMessageBytes();
+}
+
+size_t KrpcCodec::FrameSize(const google::protobuf::MessageLite &header, size_t payload_size)
+{
+    size_t header_size = header.ByteSizeLong();
+    return google::protobuf::io::CodedOutputStream::VarintSize32(static_cast<uint32_t>(header_size)) + header_size +
+           payload_size;
+}
+
+char *KrpcCodec::WriteFrame(const google::protobuf::MessageLite &header, const google::protobuf::MessageLite &payload,
+                            char *out)
+{
+    size_t header_size = header.ByteSizeLong();
+    uint8_t *p = google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(static_cast<uint32_t>(header_size),
+                                                                              reinterpret_cast<uint8_t *>(out));
+    p = header.SerializeWithCachedSizesToArray(p);
+    p = payload.SerializeWithCachedSizesToArray(p);
+    return reinterpret_cast<char *>(p);
+}
+
+KrpcCodec::DecodeStatus KrpcCodec::DecodeRequest(const char *data, size_t len, Krpc::RpcHeader *header,
+                                                 size_t *payload_offset, size_t *frame_size)
+{
+    return DecodeFrame(data, len, header, payload_offset, frame_size,
+                       [](const Krpc::RpcHeader &h) {
+                           return h.has_bulk() ? 0 : static_cast<size_t>(h.args_size()) + h.attachment_size();
+                       });
+}
+
+KrpcCodec::DecodeStatus KrpcCodec::DecodeResponse(const char *data, size_t len, Krpc::RpcResponseHeader *header,
+                                                  size_t *payload_offset, size_t *frame_size)
+{
+    return DecodeFrame(data, len, header, payload_offset, frame_size,
+                       [](const Krpc::RpcResponseHeader &h) {
+                           return h.has_bulk() ? 0 : static_cast<size_t>(h.response_size()) + h.attachment_size();
+                       });
+}
@@ -2,10 +2,14 @@
 
 // 构造函数，初始化控制器状态
 KrpcController::KrpcController()
-    : m_failed(false), m_is_canceled(false), m_is_timedout(false), m_timeout_ms(5000) // 默认超时5秒
+    : m_failed(false), m_is_canceled(false), m_is_timedout(false), m_timeout_ms(5000), m_priority(0) // 默认超时5秒
 {
     m_errText = "";             // 错误信息初始为空
     m_cancelCallback = nullptr; // 初始化取消回调为空
+    for (auto &ns : m_phase_ns)
+    {
+        ns = 0;
+    }
 }
 
 // 重置控制器状态，将失败标志和错误信息清空
@@ -15,7 +19,18 @@ void KrpcController::Reset()
     m_errText = "";        // 清空错误信息
     m_is_canceled = false; // 重置取消状态
     m_is_timedout = false; // 重置超时状态
-    // 不重置超时时间，保持用户设置的值
+    m_request_attachment = KrpcAttachment();
+    m_response_attachment = KrpcAttachment();
+    m_attachment_holder.reset();
+    m_stream_handler = nullptr;
+    m_response_stream.reset();
+    m_request_stream.reset();
+    for (auto &ns : m_phase_ns)
+    {
+        ns = 0;
+    }
+    m_trace = KrpcTraceContext();
+    // 不重置超时时间和优先级，保持用户设置的值
 }
 
 // 判断当前RPC调用是否失败
@@ -70,6 +85,16 @@ int KrpcController::GetTimeout() const
     return m_timeout_ms;
 }
 
+void KrpcController::SetPriority(uint32_t priority)
+{
+    m_priority = priority;
+}
+
+uint32_t KrpcController::GetPriority() const
+{
+    return m_priority;
+}
+
 bool KrpcController::IsTimedOut() const
 {
     return m_is_timedout;
@@ -79,4 +104,86 @@ void KrpcController::SetTimedOut()
 {
     m_is_timedout = true;
     SetFailed("RPC call timed out");
-}
\ No newline at end of file
+}
+
+// 附件相关方法实现
+void KrpcController::SetRequestAttachment(const char *data, size_t size)
+{
+    m_request_attachment.data = data;
+    m_request_attachment.size = size;
+}
+
+void KrpcController::SetResponseAttachment(const char *data, size_t size)
+{
+    m_response_attachment.data = data;
+    m_response_attachment.size = size;
+    m_attachment_holder.reset(); // 服务端设置的附件由业务方法自己持有
+}
+
+KrpcAttachment KrpcController::RequestAttachment() const
+{
+    return m_request_attachment;
+}
+
+KrpcAttachment KrpcController::ResponseAttachment() const
+{
+    return m_response_attachment;
+}
+
+void KrpcController::SetReceivedAttachment(const char *data, size_t size, std::shared_ptr<void> holder)
+{
+    m_response_attachment.data = data;
+    m_response_attachment.size = size;
+    m_attachment_holder = std::move(holder);
+}
+
+// 流式调用相关方法实现
+void KrpcController::SetStreamHandler(StreamHandler handler)
+{
+    m_stream_handler = std::move(handler);
+}
+
+const KrpcController::StreamHandler &KrpcController::GetStreamHandler() const
+{
+    return m_stream_handler;
+}
+
+KrpcStreamWriter *KrpcController::ResponseStream() const
+{
+    return m_response_stream.get();
+}
+
+KrpcStreamReader *KrpcController::RequestStream() const
+{
+    return m_request_stream.get();
+}
+
+void KrpcController::SetResponseStream(std::shared_ptr<KrpcStreamWriter> stream)
+{
+    m_response_stream = std::move(stream);
+}
+
+void KrpcController::SetRequestStream(std::shared_ptr<KrpcStreamReader> stream)
+{
+    m_request_stream = std::move(stream);
+}
+
+uint64_t KrpcController::PhaseNanos(KrpcPhase phase) const
+{
+    return m_phase_ns[phase];
+}
+
+void KrpcController::SetPhaseNanos(KrpcPhase phase, uint64_t ns)
+{
+    m_phase_ns[phase] = ns;
+}
+
+const KrpcTraceContext &KrpcController::TraceContext() const
+{
+    return m_trace;
+}
+
+void KrpcController::SetTraceContext(const KrpcTraceContext &context)
+{
+    m_trace = context;
+}
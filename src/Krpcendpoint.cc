@@ -0,0 +1,87 @@
+#include "Krpcendpoint.h"
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+std::string KrpcEndpoint::ToString() const {
+    std::string data = ip + ":" + std::to_string(port);
+    if (!host_id.empty()) {
+        data += ";host=" + host_id;
+    }
+    if (!unix_path.empty()) {
+        data += ";uds=" + unix_path;
+    }
+    if (!shm_path.empty()) {
+        data += ";shm=" + shm_path;
+    }
+    if (ucx_port != 0) {
+        data += ";ucx=" + std::to_string(ucx_port);
+    }
+    if (bulk) {
+        data += ";bulk=1";
+    }
+    if (compress_mask != 0) {
+        data += ";compress=" + std::to_string(compress_mask);
+    }
+    return data;
+}
+
+bool KrpcEndpoint::Parse(const std::string &data, KrpcEndpoint *endpoint) {
+    std::stringstream ss(data);
+    std::string item;
+    if (!std::getline(ss, item, ';')) {
+        return false;
+    }
+
+    // 第一段是ip:port
+    size_t idx = item.find(':');
+    if (idx == std::string::npos) {
+        return false;
+    }
+    endpoint->ip = item.substr(0, idx);
+    endpoint->port = static_cast<uint16_t>(atoi(item.substr(idx + 1).c_str()));
+
+    // 其余是key=value形式的扩展字段，不认识的字段直接忽略
+    while (std::getline(ss, item, ';')) {
+        idx = item.find('=');
+        if (idx == std::string::npos) {
+            continue;
+        }
+        std::string key = item.substr(0, idx);
+        std::string value = item.substr(idx + 1);
+        if (key == "host") {
+            endpoint->host_id = value;
+        } else if (key == "uds") {
+            endpoint->unix_path = value;
+        } else if (key == "shm") {
+            endpoint->shm_path = value;
+        } else if (key == "ucx") {
+            endpoint->ucx_port = static_cast<uint16_t>(atoi(value.c_str()));
+        } else if (key == "bulk") {
+            endpoint->bulk = value == "1";
+        } else if (key == "compress") {
+            endpoint->compress_mask = static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10));
+        }
+    }
+    return true;
+}
+
+bool KrpcEndpoint::IsLocalHost() const {
+    return !host_id.empty() && host_id == LocalHostId();
+}
+
+const std::string &KrpcEndpoint::LocalHostId() {
+    static const std::string host_id = [] {
+        std::ifstream in("/etc/machine-id");
+        std::string id;
+        std::getline(in, id);
+        if (id.empty()) {
+            char hostname[256] = {0};
+            gethostname(hostname, sizeof(hostname) - 1);
+            id = hostname;
+        }
+        return id;
+    }();
+    return host_id;
+}
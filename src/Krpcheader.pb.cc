@@ -14,339 +14,2297 @@
 #include <google/protobuf/wire_format.h>
 // @@protoc_insertion_point(includes)
 #include <google/protobuf/port_def.inc>
-namespace Krpc {
-class RpcHeaderDefaultTypeInternal {
- public:
-  ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<RpcHeader> _instance;
-} _RpcHeader_default_instance_;
-}  // namespace Krpc
-static void InitDefaultsscc_info_RpcHeader_Krpcheader_2eproto() {
-  GOOGLE_PROTOBUF_VERIFY_VERSION;
 
-  {
-    void* ptr = &::Krpc::_RpcHeader_default_instance_;
-    new (ptr) ::Krpc::RpcHeader();
-    ::PROTOBUF_NAMESPACE_ID::internal::OnShutdownDestroyMessage(ptr);
-  }
-  ::Krpc::RpcHeader::InitAsDefaultInstance();
-}
+PROTOBUF_PRAGMA_INIT_SEG
 
-::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<0> scc_info_RpcHeader_Krpcheader_2eproto =
-    {{ATOMIC_VAR_INIT(::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase::kUninitialized), 0, 0, InitDefaultsscc_info_RpcHeader_Krpcheader_2eproto}, {}};
+namespace _pb = ::PROTOBUF_NAMESPACE_ID;
+namespace _pbi = _pb::internal;
 
-static ::PROTOBUF_NAMESPACE_ID::Metadata file_level_metadata_Krpcheader_2eproto[1];
-static constexpr ::PROTOBUF_NAMESPACE_ID::EnumDescriptor const** file_level_enum_descriptors_Krpcheader_2eproto = nullptr;
-static constexpr ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor const** file_level_service_descriptors_Krpcheader_2eproto = nullptr;
+namespace Krpc {
+PROTOBUF_CONSTEXPR BulkDescriptor::BulkDescriptor(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.worker_address_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.rkey_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.remote_addr_)*/uint64_t{0u}
+  , /*decltype(_impl_.length_)*/uint64_t{0u}
+  , /*decltype(_impl_.bulk_id_)*/uint64_t{0u}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct BulkDescriptorDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR BulkDescriptorDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~BulkDescriptorDefaultTypeInternal() {}
+  union {
+    BulkDescriptor _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 BulkDescriptorDefaultTypeInternal _BulkDescriptor_default_instance_;
+PROTOBUF_CONSTEXPR TraceContext::TraceContext(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.trace_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.span_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.parent_span_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.sampled_)*/false
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct TraceContextDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR TraceContextDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~TraceContextDefaultTypeInternal() {}
+  union {
+    TraceContext _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 TraceContextDefaultTypeInternal _TraceContext_default_instance_;
+PROTOBUF_CONSTEXPR RpcHeader::RpcHeader(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.service_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.method_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.bulk_)*/nullptr
+  , /*decltype(_impl_.trace_)*/nullptr
+  , /*decltype(_impl_.call_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.args_size_)*/0u
+  , /*decltype(_impl_.attachment_size_)*/0u
+  , /*decltype(_impl_.compress_type_)*/0
+  , /*decltype(_impl_.raw_size_)*/0u
+  , /*decltype(_impl_.accept_compress_)*/0u
+  , /*decltype(_impl_.dict_id_)*/0u
+  , /*decltype(_impl_.accept_dict_id_)*/0u
+  , /*decltype(_impl_.stream_window_)*/0u
+  , /*decltype(_impl_.stream_credit_)*/0u
+  , /*decltype(_impl_.stream_window_bytes_)*/0u
+  , /*decltype(_impl_.accept_bulk_)*/false
+  , /*decltype(_impl_.bidi_stream_)*/false
+  , /*decltype(_impl_.stream_message_)*/false
+  , /*decltype(_impl_.stream_end_)*/false
+  , /*decltype(_impl_.stream_credit_bytes_)*/0u
+  , /*decltype(_impl_.priority_)*/0u
+  , /*decltype(_impl_.accept_fragment_)*/false
+  , /*decltype(_impl_.framed_response_)*/false
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct RpcHeaderDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR RpcHeaderDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~RpcHeaderDefaultTypeInternal() {}
+  union {
+    RpcHeader _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 RpcHeaderDefaultTypeInternal _RpcHeader_default_instance_;
+PROTOBUF_CONSTEXPR RpcResponseHeader::RpcResponseHeader(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.error_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.bulk_)*/nullptr
+  , /*decltype(_impl_.call_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.response_size_)*/0u
+  , /*decltype(_impl_.attachment_size_)*/0u
+  , /*decltype(_impl_.compress_type_)*/0
+  , /*decltype(_impl_.raw_size_)*/0u
+  , /*decltype(_impl_.dict_id_)*/0u
+  , /*decltype(_impl_.accept_dict_id_)*/0u
+  , /*decltype(_impl_.stream_message_)*/false
+  , /*decltype(_impl_.stream_credit_)*/0u
+  , /*decltype(_impl_.fragment_total_)*/uint64_t{0u}
+  , /*decltype(_impl_.fragment_offset_)*/uint64_t{0u}
+  , /*decltype(_impl_.server_queue_ns_)*/uint64_t{0u}
+  , /*decltype(_impl_.server_handler_ns_)*/uint64_t{0u}
+  , /*decltype(_impl_.server_serialize_ns_)*/uint64_t{0u}
+  , /*decltype(_impl_.stream_credit_bytes_)*/0u
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct RpcResponseHeaderDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR RpcResponseHeaderDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~RpcResponseHeaderDefaultTypeInternal() {}
+  union {
+    RpcResponseHeader _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 RpcResponseHeaderDefaultTypeInternal _RpcResponseHeader_default_instance_;
+}  // namespace Krpc
+static ::_pb::Metadata file_level_metadata_Krpcheader_2eproto[4];
+static const ::_pb::EnumDescriptor* file_level_enum_descriptors_Krpcheader_2eproto[1];
+static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_Krpcheader_2eproto = nullptr;
 
-const ::PROTOBUF_NAMESPACE_ID::uint32 TableStruct_Krpcheader_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+const uint32_t TableStruct_Krpcheader_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::Krpc::BulkDescriptor, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::Krpc::BulkDescriptor, _impl_.worker_address_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::BulkDescriptor, _impl_.remote_addr_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::BulkDescriptor, _impl_.rkey_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::BulkDescriptor, _impl_.length_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::BulkDescriptor, _impl_.bulk_id_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::Krpc::TraceContext, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::Krpc::TraceContext, _impl_.trace_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::TraceContext, _impl_.span_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::TraceContext, _impl_.parent_span_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::TraceContext, _impl_.sampled_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
-  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, service_name_),
-  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, method_name_),
-  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, args_size_),
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.service_name_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.method_name_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.args_size_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.call_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.bulk_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.accept_bulk_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.attachment_size_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.compress_type_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.raw_size_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.accept_compress_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.dict_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.accept_dict_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.stream_window_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.stream_credit_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.stream_window_bytes_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.stream_credit_bytes_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.bidi_stream_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.stream_message_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.stream_end_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.accept_fragment_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.priority_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.trace_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcHeader, _impl_.framed_response_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.call_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.response_size_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.bulk_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.attachment_size_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.compress_type_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.raw_size_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.dict_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.accept_dict_id_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.stream_message_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.stream_credit_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.stream_credit_bytes_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.fragment_total_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.fragment_offset_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.server_queue_ns_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.server_handler_ns_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.server_serialize_ns_),
+  PROTOBUF_FIELD_OFFSET(::Krpc::RpcResponseHeader, _impl_.error_),
 };
-static const ::PROTOBUF_NAMESPACE_ID::internal::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
-  { 0, -1, sizeof(::Krpc::RpcHeader)},
+static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  { 0, -1, -1, sizeof(::Krpc::BulkDescriptor)},
+  { 11, -1, -1, sizeof(::Krpc::TraceContext)},
+  { 21, -1, -1, sizeof(::Krpc::RpcHeader)},
+  { 50, -1, -1, sizeof(::Krpc::RpcResponseHeader)},
 };
 
-static ::PROTOBUF_NAMESPACE_ID::Message const * const file_default_instances[] = {
-  reinterpret_cast<const ::PROTOBUF_NAMESPACE_ID::Message*>(&::Krpc::_RpcHeader_default_instance_),
+static const ::_pb::Message* const file_default_instances[] = {
+  &::Krpc::_BulkDescriptor_default_instance_._instance,
+  &::Krpc::_TraceContext_default_instance_._instance,
+  &::Krpc::_RpcHeader_default_instance_._instance,
+  &::Krpc::_RpcResponseHeader_default_instance_._instance,
 };
 
 const char descriptor_table_protodef_Krpcheader_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
-  "\n\020Krpcheader.proto\022\004Krpc\"I\n\tRpcHeader\022\024\n"
-  "\014service_name\030\001 \001(\014\022\023\n\013method_name\030\002 \001(\014"
-  "\022\021\n\targs_size\030\003 \001(\rb\006proto3"
+  "\n\020Krpcheader.proto\022\004Krpc\"l\n\016BulkDescript"
+  "or\022\026\n\016worker_address\030\001 \001(\014\022\023\n\013remote_add"
+  "r\030\002 \001(\004\022\014\n\004rkey\030\003 \001(\014\022\016\n\006length\030\004 \001(\004\022\017\n"
+  "\007bulk_id\030\005 \001(\004\"Z\n\014TraceContext\022\020\n\010trace_"
+  "id\030\001 \001(\006\022\017\n\007span_id\030\002 \001(\006\022\026\n\016parent_span"
+  "_id\030\003 \001(\006\022\017\n\007sampled\030\004 \001(\010\"\273\004\n\tRpcHeader"
+  "\022\024\n\014service_name\030\001 \001(\014\022\023\n\013method_name\030\002 "
+  "\001(\014\022\021\n\targs_size\030\003 \001(\r\022\017\n\007call_id\030\004 \001(\004\022"
+  "\"\n\004bulk\030\005 \001(\0132\024.Krpc.BulkDescriptor\022\023\n\013a"
+  "ccept_bulk\030\006 \001(\010\022\027\n\017attachment_size\030\007 \001("
+  "\r\022)\n\rcompress_type\030\010 \001(\0162\022.Krpc.Compress"
+  "Type\022\020\n\010raw_size\030\t \001(\r\022\027\n\017accept_compres"
+  "s\030\n \001(\r\022\017\n\007dict_id\030\013 \001(\r\022\026\n\016accept_dict_"
+  "id\030\014 \001(\r\022\025\n\rstream_window\030\r \001(\r\022\025\n\rstrea"
+  "m_credit\030\016 \001(\r\022\033\n\023stream_window_bytes\030\017 "
+  "\001(\r\022\033\n\023stream_credit_bytes\030\020 \001(\r\022\023\n\013bidi"
+  "_stream\030\021 \001(\010\022\026\n\016stream_message\030\022 \001(\010\022\022\n"
+  "\nstream_end\030\023 \001(\010\022\027\n\017accept_fragment\030\024 \001"
+  "(\010\022\020\n\010priority\030\025 \001(\r\022!\n\005trace\030\026 \001(\0132\022.Kr"
+  "pc.TraceContext\022\027\n\017framed_response\030\027 \001(\010"
+  "\"\273\003\n\021RpcResponseHeader\022\017\n\007call_id\030\001 \001(\004\022"
+  "\025\n\rresponse_size\030\002 \001(\r\022\"\n\004bulk\030\003 \001(\0132\024.K"
+  "rpc.BulkDescriptor\022\027\n\017attachment_size\030\004 "
+  "\001(\r\022)\n\rcompress_type\030\005 \001(\0162\022.Krpc.Compre"
+  "ssType\022\020\n\010raw_size\030\006 \001(\r\022\017\n\007dict_id\030\007 \001("
+  "\r\022\026\n\016accept_dict_id\030\010 \001(\r\022\026\n\016stream_mess"
+  "age\030\t \001(\010\022\025\n\rstream_credit\030\n \001(\r\022\033\n\023stre"
+  "am_credit_bytes\030\013 \001(\r\022\026\n\016fragment_total\030"
+  "\014 \001(\004\022\027\n\017fragment_offset\030\r \001(\004\022\027\n\017server"
+  "_queue_ns\030\016 \001(\004\022\031\n\021server_handler_ns\030\017 \001"
+  "(\004\022\033\n\023server_serialize_ns\030\020 \001(\004\022\r\n\005error"
+  "\030\021 \001(\t*F\n\014CompressType\022\021\n\rCOMPRESS_NONE\020"
+  "\000\022\020\n\014COMPRESS_LZ4\020\001\022\021\n\rCOMPRESS_ZSTD\020\002b\006"
+  "proto3"
   ;
-static const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable*const descriptor_table_Krpcheader_2eproto_deps[1] = {
-};
-static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_Krpcheader_2eproto_sccs[1] = {
-  &scc_info_RpcHeader_Krpcheader_2eproto.base,
-};
-static ::PROTOBUF_NAMESPACE_ID::internal::once_flag descriptor_table_Krpcheader_2eproto_once;
-const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_Krpcheader_2eproto = {
-  false, false, descriptor_table_protodef_Krpcheader_2eproto, "Krpcheader.proto", 107,
-  &descriptor_table_Krpcheader_2eproto_once, descriptor_table_Krpcheader_2eproto_sccs, descriptor_table_Krpcheader_2eproto_deps, 1, 0,
-  schemas, file_default_instances, TableStruct_Krpcheader_2eproto::offsets,
-  file_level_metadata_Krpcheader_2eproto, 1, file_level_enum_descriptors_Krpcheader_2eproto, file_level_service_descriptors_Krpcheader_2eproto,
+static ::_pbi::once_flag descriptor_table_Krpcheader_2eproto_once;
+const ::_pbi::DescriptorTable descriptor_table_Krpcheader_2eproto = {
+    false, false, 1326, descriptor_table_protodef_Krpcheader_2eproto,
+    "Krpcheader.proto",
+    &descriptor_table_Krpcheader_2eproto_once, nullptr, 0, 4,
+    schemas, file_default_instances, TableStruct_Krpcheader_2eproto::offsets,
+    file_level_metadata_Krpcheader_2eproto, file_level_enum_descriptors_Krpcheader_2eproto,
+    file_level_service_descriptors_Krpcheader_2eproto,
 };
+PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_Krpcheader_2eproto_getter() {
+  return &descriptor_table_Krpcheader_2eproto;
+}
 
 // Force running AddDescriptors() at dynamic initialization time.
-static bool dynamic_init_dummy_Krpcheader_2eproto = (static_cast<void>(::PROTOBUF_NAMESPACE_ID::internal::AddDescriptors(&descriptor_table_Krpcheader_2eproto)), true);
+PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_Krpcheader_2eproto(&descriptor_table_Krpcheader_2eproto);
 namespace Krpc {
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* CompressType_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_Krpcheader_2eproto);
+  return file_level_enum_descriptors_Krpcheader_2eproto[0];
+}
+bool CompressType_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+      return true;
+    default:
+      return false;
+  }
+}
+
 
 // ===================================================================
 
-void RpcHeader::InitAsDefaultInstance() {
-}
-class RpcHeader::_Internal {
+class BulkDescriptor::_Internal {
  public:
 };
 
-RpcHeader::RpcHeader(::PROTOBUF_NAMESPACE_ID::Arena* arena)
-  : ::PROTOBUF_NAMESPACE_ID::Message(arena) {
-  SharedCtor();
-  RegisterArenaDtor(arena);
-  // @@protoc_insertion_point(arena_constructor:Krpc.RpcHeader)
+BulkDescriptor::BulkDescriptor(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:Krpc.BulkDescriptor)
 }
-RpcHeader::RpcHeader(const RpcHeader& from)
+BulkDescriptor::BulkDescriptor(const BulkDescriptor& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
+  BulkDescriptor* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.worker_address_){}
+    , decltype(_impl_.rkey_){}
+    , decltype(_impl_.remote_addr_){}
+    , decltype(_impl_.length_){}
+    , decltype(_impl_.bulk_id_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
-  service_name_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  if (!from._internal_service_name().empty()) {
-    service_name_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from._internal_service_name(),
-      GetArena());
+  _impl_.worker_address_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.worker_address_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_worker_address().empty()) {
+    _this->_impl_.worker_address_.Set(from._internal_worker_address(), 
+      _this->GetArenaForAllocation());
   }
-  method_name_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  if (!from._internal_method_name().empty()) {
-    method_name_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), from._internal_method_name(),
-      GetArena());
+  _impl_.rkey_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.rkey_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_rkey().empty()) {
+    _this->_impl_.rkey_.Set(from._internal_rkey(), 
+      _this->GetArenaForAllocation());
   }
-  args_size_ = from.args_size_;
-  // @@protoc_insertion_point(copy_constructor:Krpc.RpcHeader)
+  ::memcpy(&_impl_.remote_addr_, &from._impl_.remote_addr_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.bulk_id_) -
+    reinterpret_cast<char*>(&_impl_.remote_addr_)) + sizeof(_impl_.bulk_id_));
+  // @@protoc_insertion_point(copy_constructor:Krpc.BulkDescriptor)
 }
 
-void RpcHeader::SharedCtor() {
-  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&scc_info_RpcHeader_Krpcheader_2eproto.base);
-  service_name_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  method_name_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  args_size_ = 0u;
+inline void BulkDescriptor::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.worker_address_){}
+    , decltype(_impl_.rkey_){}
+    , decltype(_impl_.remote_addr_){uint64_t{0u}}
+    , decltype(_impl_.length_){uint64_t{0u}}
+    , decltype(_impl_.bulk_id_){uint64_t{0u}}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.worker_address_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.worker_address_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.rkey_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.rkey_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
-RpcHeader::~RpcHeader() {
-  // @@protoc_insertion_point(destructor:Krpc.RpcHeader)
+BulkDescriptor::~BulkDescriptor() {
+  // @@protoc_insertion_point(destructor:Krpc.BulkDescriptor)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
   SharedDtor();
-  _internal_metadata_.Delete<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
-void RpcHeader::SharedDtor() {
-  GOOGLE_DCHECK(GetArena() == nullptr);
-  service_name_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
-  method_name_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+inline void BulkDescriptor::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.worker_address_.Destroy();
+  _impl_.rkey_.Destroy();
 }
 
-void RpcHeader::ArenaDtor(void* object) {
-  RpcHeader* _this = reinterpret_cast< RpcHeader* >(object);
-  (void)_this;
-}
-void RpcHeader::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
-}
-void RpcHeader::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
+void BulkDescriptor::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
 }
-const RpcHeader& RpcHeader::default_instance() {
-  ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&::scc_info_RpcHeader_Krpcheader_2eproto.base);
-  return *internal_default_instance();
-}
-
 
-void RpcHeader::Clear() {
-// @@protoc_insertion_point(message_clear_start:Krpc.RpcHeader)
-  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+void BulkDescriptor::Clear() {
+// @@protoc_insertion_point(message_clear_start:Krpc.BulkDescriptor)
+  uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  service_name_.ClearToEmpty(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
-  method_name_.ClearToEmpty(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
-  args_size_ = 0u;
+  _impl_.worker_address_.ClearToEmpty();
+  _impl_.rkey_.ClearToEmpty();
+  ::memset(&_impl_.remote_addr_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.bulk_id_) -
+      reinterpret_cast<char*>(&_impl_.remote_addr_)) + sizeof(_impl_.bulk_id_));
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
-const char* RpcHeader::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+const char* BulkDescriptor::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
 #define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
-  ::PROTOBUF_NAMESPACE_ID::Arena* arena = GetArena(); (void)arena;
   while (!ctx->Done(&ptr)) {
-    ::PROTOBUF_NAMESPACE_ID::uint32 tag;
-    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
-    CHK_(ptr);
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
     switch (tag >> 3) {
-      // bytes service_name = 1;
+      // bytes worker_address = 1;
       case 1:
-        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 10)) {
-          auto str = _internal_mutable_service_name();
-          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_worker_address();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
           CHK_(ptr);
-        } else goto handle_unusual;
+        } else
+          goto handle_unusual;
         continue;
-      // bytes method_name = 2;
+      // uint64 remote_addr = 2;
       case 2:
-        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 18)) {
-          auto str = _internal_mutable_method_name();
-          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.remote_addr_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
-        } else goto handle_unusual;
+        } else
+          goto handle_unusual;
         continue;
-      // uint32 args_size = 3;
+      // bytes rkey = 3;
       case 3:
-        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 24)) {
-          args_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
-          CHK_(ptr);
-        } else goto handle_unusual;
-        continue;
-      default: {
-      handle_unusual:
-        if ((tag & 7) == 4 || tag == 0) {
-          ctx->SetLastTag(tag);
-          goto success;
-        }
-        ptr = UnknownFieldParse(tag,
-            _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
-            ptr, ctx);
-        CHK_(ptr != nullptr);
-        continue;
-      }
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          auto str = _internal_mutable_rkey();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 length = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.length_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 bulk_id = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _impl_.bulk_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
     }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
   }  // while
-success:
+message_done:
   return ptr;
 failure:
   ptr = nullptr;
-  goto success;
+  goto message_done;
 #undef CHK_
 }
 
-::PROTOBUF_NAMESPACE_ID::uint8* RpcHeader::_InternalSerialize(
-    ::PROTOBUF_NAMESPACE_ID::uint8* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
-  // @@protoc_insertion_point(serialize_to_array_start:Krpc.RpcHeader)
-  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+uint8_t* BulkDescriptor::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:Krpc.BulkDescriptor)
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  // bytes service_name = 1;
-  if (this->service_name().size() > 0) {
+  // bytes worker_address = 1;
+  if (!this->_internal_worker_address().empty()) {
     target = stream->WriteBytesMaybeAliased(
-        1, this->_internal_service_name(), target);
+        1, this->_internal_worker_address(), target);
   }
 
-  // bytes method_name = 2;
-  if (this->method_name().size() > 0) {
+  // uint64 remote_addr = 2;
+  if (this->_internal_remote_addr() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(2, this->_internal_remote_addr(), target);
+  }
+
+  // bytes rkey = 3;
+  if (!this->_internal_rkey().empty()) {
     target = stream->WriteBytesMaybeAliased(
-        2, this->_internal_method_name(), target);
+        3, this->_internal_rkey(), target);
   }
 
-  // uint32 args_size = 3;
-  if (this->args_size() != 0) {
+  // uint64 length = 4;
+  if (this->_internal_length() != 0) {
     target = stream->EnsureSpace(target);
-    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteUInt32ToArray(3, this->_internal_args_size(), target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(4, this->_internal_length(), target);
+  }
+
+  // uint64 bulk_id = 5;
+  if (this->_internal_bulk_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(5, this->_internal_bulk_id(), target);
   }
 
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
-    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::InternalSerializeUnknownFieldsToArray(
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
   }
-  // @@protoc_insertion_point(serialize_to_array_end:Krpc.RpcHeader)
+  // @@protoc_insertion_point(serialize_to_array_end:Krpc.BulkDescriptor)
   return target;
 }
 
-size_t RpcHeader::ByteSizeLong() const {
-// @@protoc_insertion_point(message_byte_size_start:Krpc.RpcHeader)
+size_t BulkDescriptor::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:Krpc.BulkDescriptor)
   size_t total_size = 0;
 
-  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+  uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  // bytes service_name = 1;
-  if (this->service_name().size() > 0) {
+  // bytes worker_address = 1;
+  if (!this->_internal_worker_address().empty()) {
     total_size += 1 +
       ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
-        this->_internal_service_name());
+        this->_internal_worker_address());
   }
 
-  // bytes method_name = 2;
-  if (this->method_name().size() > 0) {
+  // bytes rkey = 3;
+  if (!this->_internal_rkey().empty()) {
     total_size += 1 +
       ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
-        this->_internal_method_name());
+        this->_internal_rkey());
   }
 
-  // uint32 args_size = 3;
-  if (this->args_size() != 0) {
-    total_size += 1 +
-      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::UInt32Size(
-        this->_internal_args_size());
+  // uint64 remote_addr = 2;
+  if (this->_internal_remote_addr() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_remote_addr());
   }
 
-  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
-    return ::PROTOBUF_NAMESPACE_ID::internal::ComputeUnknownFieldsSize(
-        _internal_metadata_, total_size, &_cached_size_);
+  // uint64 length = 4;
+  if (this->_internal_length() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_length());
   }
-  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
-  SetCachedSize(cached_size);
-  return total_size;
-}
 
-void RpcHeader::MergeFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) {
-// @@protoc_insertion_point(generalized_merge_from_start:Krpc.RpcHeader)
-  GOOGLE_DCHECK_NE(&from, this);
-  const RpcHeader* source =
-      ::PROTOBUF_NAMESPACE_ID::DynamicCastToGenerated<RpcHeader>(
-          &from);
-  if (source == nullptr) {
-  // @@protoc_insertion_point(generalized_merge_from_cast_fail:Krpc.RpcHeader)
-    ::PROTOBUF_NAMESPACE_ID::internal::ReflectionOps::Merge(from, this);
-  } else {
-  // @@protoc_insertion_point(generalized_merge_from_cast_success:Krpc.RpcHeader)
-    MergeFrom(*source);
+  // uint64 bulk_id = 5;
+  if (this->_internal_bulk_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_bulk_id());
   }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
-void RpcHeader::MergeFrom(const RpcHeader& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:Krpc.RpcHeader)
-  GOOGLE_DCHECK_NE(&from, this);
-  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
-  ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData BulkDescriptor::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    BulkDescriptor::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*BulkDescriptor::GetClassData() const { return &_class_data_; }
+
+
+void BulkDescriptor::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<BulkDescriptor*>(&to_msg);
+  auto& from = static_cast<const BulkDescriptor&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:Krpc.BulkDescriptor)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
-  if (from.service_name().size() > 0) {
-    _internal_set_service_name(from._internal_service_name());
+  if (!from._internal_worker_address().empty()) {
+    _this->_internal_set_worker_address(from._internal_worker_address());
+  }
+  if (!from._internal_rkey().empty()) {
+    _this->_internal_set_rkey(from._internal_rkey());
   }
-  if (from.method_name().size() > 0) {
-    _internal_set_method_name(from._internal_method_name());
+  if (from._internal_remote_addr() != 0) {
+    _this->_internal_set_remote_addr(from._internal_remote_addr());
   }
-  if (from.args_size() != 0) {
-    _internal_set_args_size(from._internal_args_size());
+  if (from._internal_length() != 0) {
+    _this->_internal_set_length(from._internal_length());
   }
+  if (from._internal_bulk_id() != 0) {
+    _this->_internal_set_bulk_id(from._internal_bulk_id());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
-void RpcHeader::CopyFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) {
-// @@protoc_insertion_point(generalized_copy_from_start:Krpc.RpcHeader)
+void BulkDescriptor::CopyFrom(const BulkDescriptor& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:Krpc.BulkDescriptor)
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-void RpcHeader::CopyFrom(const RpcHeader& from) {
-// @@protoc_insertion_point(class_specific_copy_from_start:Krpc.RpcHeader)
+bool BulkDescriptor::IsInitialized() const {
+  return true;
+}
+
+void BulkDescriptor::InternalSwap(BulkDescriptor* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.worker_address_, lhs_arena,
+      &other->_impl_.worker_address_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.rkey_, lhs_arena,
+      &other->_impl_.rkey_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(BulkDescriptor, _impl_.bulk_id_)
+      + sizeof(BulkDescriptor::_impl_.bulk_id_)
+      - PROTOBUF_FIELD_OFFSET(BulkDescriptor, _impl_.remote_addr_)>(
+          reinterpret_cast<char*>(&_impl_.remote_addr_),
+          reinterpret_cast<char*>(&other->_impl_.remote_addr_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata BulkDescriptor::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_Krpcheader_2eproto_getter, &descriptor_table_Krpcheader_2eproto_once,
+      file_level_metadata_Krpcheader_2eproto[0]);
+}
+
+// ===================================================================
+
+class TraceContext::_Internal {
+ public:
+};
+
+TraceContext::TraceContext(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:Krpc.TraceContext)
+}
+TraceContext::TraceContext(const TraceContext& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  TraceContext* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.trace_id_){}
+    , decltype(_impl_.span_id_){}
+    , decltype(_impl_.parent_span_id_){}
+    , decltype(_impl_.sampled_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.trace_id_, &from._impl_.trace_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.sampled_) -
+    reinterpret_cast<char*>(&_impl_.trace_id_)) + sizeof(_impl_.sampled_));
+  // @@protoc_insertion_point(copy_constructor:Krpc.TraceContext)
+}
+
+inline void TraceContext::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.trace_id_){uint64_t{0u}}
+    , decltype(_impl_.span_id_){uint64_t{0u}}
+    , decltype(_impl_.parent_span_id_){uint64_t{0u}}
+    , decltype(_impl_.sampled_){false}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+TraceContext::~TraceContext() {
+  // @@protoc_insertion_point(destructor:Krpc.TraceContext)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void TraceContext::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void TraceContext::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void TraceContext::Clear() {
+// @@protoc_insertion_point(message_clear_start:Krpc.TraceContext)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  ::memset(&_impl_.trace_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.sampled_) -
+      reinterpret_cast<char*>(&_impl_.trace_id_)) + sizeof(_impl_.sampled_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* TraceContext::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // fixed64 trace_id = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 9)) {
+          _impl_.trace_id_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<uint64_t>(ptr);
+          ptr += sizeof(uint64_t);
+        } else
+          goto handle_unusual;
+        continue;
+      // fixed64 span_id = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 17)) {
+          _impl_.span_id_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<uint64_t>(ptr);
+          ptr += sizeof(uint64_t);
+        } else
+          goto handle_unusual;
+        continue;
+      // fixed64 parent_span_id = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 25)) {
+          _impl_.parent_span_id_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<uint64_t>(ptr);
+          ptr += sizeof(uint64_t);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool sampled = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.sampled_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* TraceContext::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:Krpc.TraceContext)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // fixed64 trace_id = 1;
+  if (this->_internal_trace_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFixed64ToArray(1, this->_internal_trace_id(), target);
+  }
+
+  // fixed64 span_id = 2;
+  if (this->_internal_span_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFixed64ToArray(2, this->_internal_span_id(), target);
+  }
+
+  // fixed64 parent_span_id = 3;
+  if (this->_internal_parent_span_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFixed64ToArray(3, this->_internal_parent_span_id(), target);
+  }
+
+  // bool sampled = 4;
+  if (this->_internal_sampled() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(4, this->_internal_sampled(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:Krpc.TraceContext)
+  return target;
+}
+
+size_t TraceContext::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:Krpc.TraceContext)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // fixed64 trace_id = 1;
+  if (this->_internal_trace_id() != 0) {
+    total_size += 1 + 8;
+  }
+
+  // fixed64 span_id = 2;
+  if (this->_internal_span_id() != 0) {
+    total_size += 1 + 8;
+  }
+
+  // fixed64 parent_span_id = 3;
+  if (this->_internal_parent_span_id() != 0) {
+    total_size += 1 + 8;
+  }
+
+  // bool sampled = 4;
+  if (this->_internal_sampled() != 0) {
+    total_size += 1 + 1;
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData TraceContext::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    TraceContext::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*TraceContext::GetClassData() const { return &_class_data_; }
+
+
+void TraceContext::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<TraceContext*>(&to_msg);
+  auto& from = static_cast<const TraceContext&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:Krpc.TraceContext)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from._internal_trace_id() != 0) {
+    _this->_internal_set_trace_id(from._internal_trace_id());
+  }
+  if (from._internal_span_id() != 0) {
+    _this->_internal_set_span_id(from._internal_span_id());
+  }
+  if (from._internal_parent_span_id() != 0) {
+    _this->_internal_set_parent_span_id(from._internal_parent_span_id());
+  }
+  if (from._internal_sampled() != 0) {
+    _this->_internal_set_sampled(from._internal_sampled());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void TraceContext::CopyFrom(const TraceContext& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:Krpc.TraceContext)
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-bool RpcHeader::IsInitialized() const {
+bool TraceContext::IsInitialized() const {
   return true;
 }
 
-void RpcHeader::InternalSwap(RpcHeader* other) {
+void TraceContext::InternalSwap(TraceContext* other) {
   using std::swap;
-  _internal_metadata_.Swap<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(&other->_internal_metadata_);
-  service_name_.Swap(&other->service_name_, &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
-  method_name_.Swap(&other->method_name_, &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
-  swap(args_size_, other->args_size_);
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(TraceContext, _impl_.sampled_)
+      + sizeof(TraceContext::_impl_.sampled_)
+      - PROTOBUF_FIELD_OFFSET(TraceContext, _impl_.trace_id_)>(
+          reinterpret_cast<char*>(&_impl_.trace_id_),
+          reinterpret_cast<char*>(&other->_impl_.trace_id_));
 }
 
-::PROTOBUF_NAMESPACE_ID::Metadata RpcHeader::GetMetadata() const {
-  return GetMetadataStatic();
+::PROTOBUF_NAMESPACE_ID::Metadata TraceContext::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_Krpcheader_2eproto_getter, &descriptor_table_Krpcheader_2eproto_once,
+      file_level_metadata_Krpcheader_2eproto[1]);
 }
 
+// ===================================================================
 
-// @@protoc_insertion_point(namespace_scope)
-}  // namespace Krpc
-PROTOBUF_NAMESPACE_OPEN
-template<> PROTOBUF_NOINLINE ::Krpc::RpcHeader* Arena::CreateMaybeMessage< ::Krpc::RpcHeader >(Arena* arena) {
-  return Arena::CreateMessageInternal< ::Krpc::RpcHeader >(arena);
+class RpcHeader::_Internal {
+ public:
+  static const ::Krpc::BulkDescriptor& bulk(const RpcHeader* msg);
+  static const ::Krpc::TraceContext& trace(const RpcHeader* msg);
+};
+
+const ::Krpc::BulkDescriptor&
+RpcHeader::_Internal::bulk(const RpcHeader* msg) {
+  return *msg->_impl_.bulk_;
+}
+const ::Krpc::TraceContext&
+RpcHeader::_Internal::trace(const RpcHeader* msg) {
+  return *msg->_impl_.trace_;
+}
+RpcHeader::RpcHeader(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:Krpc.RpcHeader)
+}
+RpcHeader::RpcHeader(const RpcHeader& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  RpcHeader* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.service_name_){}
+    , decltype(_impl_.method_name_){}
+    , decltype(_impl_.bulk_){nullptr}
+    , decltype(_impl_.trace_){nullptr}
+    , decltype(_impl_.call_id_){}
+    , decltype(_impl_.args_size_){}
+    , decltype(_impl_.attachment_size_){}
+    , decltype(_impl_.compress_type_){}
+    , decltype(_impl_.raw_size_){}
+    , decltype(_impl_.accept_compress_){}
+    , decltype(_impl_.dict_id_){}
+    , decltype(_impl_.accept_dict_id_){}
+    , decltype(_impl_.stream_window_){}
+    , decltype(_impl_.stream_credit_){}
+    , decltype(_impl_.stream_window_bytes_){}
+    , decltype(_impl_.accept_bulk_){}
+    , decltype(_impl_.bidi_stream_){}
+    , decltype(_impl_.stream_message_){}
+    , decltype(_impl_.stream_end_){}
+    , decltype(_impl_.stream_credit_bytes_){}
+    , decltype(_impl_.priority_){}
+    , decltype(_impl_.accept_fragment_){}
+    , decltype(_impl_.framed_response_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.service_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.service_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_service_name().empty()) {
+    _this->_impl_.service_name_.Set(from._internal_service_name(), 
+      _this->GetArenaForAllocation());
+  }
+  _impl_.method_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.method_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_method_name().empty()) {
+    _this->_impl_.method_name_.Set(from._internal_method_name(), 
+      _this->GetArenaForAllocation());
+  }
+  if (from._internal_has_bulk()) {
+    _this->_impl_.bulk_ = new ::Krpc::BulkDescriptor(*from._impl_.bulk_);
+  }
+  if (from._internal_has_trace()) {
+    _this->_impl_.trace_ = new ::Krpc::TraceContext(*from._impl_.trace_);
+  }
+  ::memcpy(&_impl_.call_id_, &from._impl_.call_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.framed_response_) -
+    reinterpret_cast<char*>(&_impl_.call_id_)) + sizeof(_impl_.framed_response_));
+  // @@protoc_insertion_point(copy_constructor:Krpc.RpcHeader)
+}
+
+inline void RpcHeader::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.service_name_){}
+    , decltype(_impl_.method_name_){}
+    , decltype(_impl_.bulk_){nullptr}
+    , decltype(_impl_.trace_){nullptr}
+    , decltype(_impl_.call_id_){uint64_t{0u}}
+    , decltype(_impl_.args_size_){0u}
+    , decltype(_impl_.attachment_size_){0u}
+    , decltype(_impl_.compress_type_){0}
+    , decltype(_impl_.raw_size_){0u}
+    , decltype(_impl_.accept_compress_){0u}
+    , decltype(_impl_.dict_id_){0u}
+    , decltype(_impl_.accept_dict_id_){0u}
+    , decltype(_impl_.stream_window_){0u}
+    , decltype(_impl_.stream_credit_){0u}
+    , decltype(_impl_.stream_window_bytes_){0u}
+    , decltype(_impl_.accept_bulk_){false}
+    , decltype(_impl_.bidi_stream_){false}
+    , decltype(_impl_.stream_message_){false}
+    , decltype(_impl_.stream_end_){false}
+    , decltype(_impl_.stream_credit_bytes_){0u}
+    , decltype(_impl_.priority_){0u}
+    , decltype(_impl_.accept_fragment_){false}
+    , decltype(_impl_.framed_response_){false}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.service_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.service_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.method_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.method_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+RpcHeader::~RpcHeader() {
+  // @@protoc_insertion_point(destructor:Krpc.RpcHeader)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void RpcHeader::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.service_name_.Destroy();
+  _impl_.method_name_.Destroy();
+  if (this != internal_default_instance()) delete _impl_.bulk_;
+  if (this != internal_default_instance()) delete _impl_.trace_;
+}
+
+void RpcHeader::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void RpcHeader::Clear() {
+// @@protoc_insertion_point(message_clear_start:Krpc.RpcHeader)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.service_name_.ClearToEmpty();
+  _impl_.method_name_.ClearToEmpty();
+  if (GetArenaForAllocation() == nullptr && _impl_.bulk_ != nullptr) {
+    delete _impl_.bulk_;
+  }
+  _impl_.bulk_ = nullptr;
+  if (GetArenaForAllocation() == nullptr && _impl_.trace_ != nullptr) {
+    delete _impl_.trace_;
+  }
+  _impl_.trace_ = nullptr;
+  ::memset(&_impl_.call_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.framed_response_) -
+      reinterpret_cast<char*>(&_impl_.call_id_)) + sizeof(_impl_.framed_response_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* RpcHeader::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // bytes service_name = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_service_name();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes method_name = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_method_name();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 args_size = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.args_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 call_id = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.call_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .Krpc.BulkDescriptor bulk = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr = ctx->ParseMessage(_internal_mutable_bulk(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool accept_bulk = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _impl_.accept_bulk_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 attachment_size = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _impl_.attachment_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .Krpc.CompressType compress_type = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 64)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_compress_type(static_cast<::Krpc::CompressType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 raw_size = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 72)) {
+          _impl_.raw_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 accept_compress = 10;
+      case 10:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 80)) {
+          _impl_.accept_compress_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 dict_id = 11;
+      case 11:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 88)) {
+          _impl_.dict_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 accept_dict_id = 12;
+      case 12:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 96)) {
+          _impl_.accept_dict_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 stream_window = 13;
+      case 13:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 104)) {
+          _impl_.stream_window_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 stream_credit = 14;
+      case 14:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 112)) {
+          _impl_.stream_credit_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 stream_window_bytes = 15;
+      case 15:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 120)) {
+          _impl_.stream_window_bytes_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 stream_credit_bytes = 16;
+      case 16:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 128)) {
+          _impl_.stream_credit_bytes_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool bidi_stream = 17;
+      case 17:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 136)) {
+          _impl_.bidi_stream_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool stream_message = 18;
+      case 18:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 144)) {
+          _impl_.stream_message_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool stream_end = 19;
+      case 19:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 152)) {
+          _impl_.stream_end_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool accept_fragment = 20;
+      case 20:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 160)) {
+          _impl_.accept_fragment_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 priority = 21;
+      case 21:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 168)) {
+          _impl_.priority_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .Krpc.TraceContext trace = 22;
+      case 22:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 178)) {
+          ptr = ctx->ParseMessage(_internal_mutable_trace(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool framed_response = 23;
+      case 23:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 184)) {
+          _impl_.framed_response_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* RpcHeader::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:Krpc.RpcHeader)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // bytes service_name = 1;
+  if (!this->_internal_service_name().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        1, this->_internal_service_name(), target);
+  }
+
+  // bytes method_name = 2;
+  if (!this->_internal_method_name().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        2, this->_internal_method_name(), target);
+  }
+
+  // uint32 args_size = 3;
+  if (this->_internal_args_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(3, this->_internal_args_size(), target);
+  }
+
+  // uint64 call_id = 4;
+  if (this->_internal_call_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(4, this->_internal_call_id(), target);
+  }
+
+  // .Krpc.BulkDescriptor bulk = 5;
+  if (this->_internal_has_bulk()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(5, _Internal::bulk(this),
+        _Internal::bulk(this).GetCachedSize(), target, stream);
+  }
+
+  // bool accept_bulk = 6;
+  if (this->_internal_accept_bulk() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(6, this->_internal_accept_bulk(), target);
+  }
+
+  // uint32 attachment_size = 7;
+  if (this->_internal_attachment_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(7, this->_internal_attachment_size(), target);
+  }
+
+  // .Krpc.CompressType compress_type = 8;
+  if (this->_internal_compress_type() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      8, this->_internal_compress_type(), target);
+  }
+
+  // uint32 raw_size = 9;
+  if (this->_internal_raw_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(9, this->_internal_raw_size(), target);
+  }
+
+  // uint32 accept_compress = 10;
+  if (this->_internal_accept_compress() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(10, this->_internal_accept_compress(), target);
+  }
+
+  // uint32 dict_id = 11;
+  if (this->_internal_dict_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(11, this->_internal_dict_id(), target);
+  }
+
+  // uint32 accept_dict_id = 12;
+  if (this->_internal_accept_dict_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(12, this->_internal_accept_dict_id(), target);
+  }
+
+  // uint32 stream_window = 13;
+  if (this->_internal_stream_window() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(13, this->_internal_stream_window(), target);
+  }
+
+  // uint32 stream_credit = 14;
+  if (this->_internal_stream_credit() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(14, this->_internal_stream_credit(), target);
+  }
+
+  // uint32 stream_window_bytes = 15;
+  if (this->_internal_stream_window_bytes() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(15, this->_internal_stream_window_bytes(), target);
+  }
+
+  // uint32 stream_credit_bytes = 16;
+  if (this->_internal_stream_credit_bytes() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(16, this->_internal_stream_credit_bytes(), target);
+  }
+
+  // bool bidi_stream = 17;
+  if (this->_internal_bidi_stream() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(17, this->_internal_bidi_stream(), target);
+  }
+
+  // bool stream_message = 18;
+  if (this->_internal_stream_message() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(18, this->_internal_stream_message(), target);
+  }
+
+  // bool stream_end = 19;
+  if (this->_internal_stream_end() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(19, this->_internal_stream_end(), target);
+  }
+
+  // bool accept_fragment = 20;
+  if (this->_internal_accept_fragment() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(20, this->_internal_accept_fragment(), target);
+  }
+
+  // uint32 priority = 21;
+  if (this->_internal_priority() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(21, this->_internal_priority(), target);
+  }
+
+  // .Krpc.TraceContext trace = 22;
+  if (this->_internal_has_trace()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(22, _Internal::trace(this),
+        _Internal::trace(this).GetCachedSize(), target, stream);
+  }
+
+  // bool framed_response = 23;
+  if (this->_internal_framed_response() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(23, this->_internal_framed_response(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:Krpc.RpcHeader)
+  return target;
+}
+
+size_t RpcHeader::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:Krpc.RpcHeader)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes service_name = 1;
+  if (!this->_internal_service_name().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_service_name());
+  }
+
+  // bytes method_name = 2;
+  if (!this->_internal_method_name().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_method_name());
+  }
+
+  // .Krpc.BulkDescriptor bulk = 5;
+  if (this->_internal_has_bulk()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.bulk_);
+  }
+
+  // .Krpc.TraceContext trace = 22;
+  if (this->_internal_has_trace()) {
+    total_size += 2 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.trace_);
+  }
+
+  // uint64 call_id = 4;
+  if (this->_internal_call_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_call_id());
+  }
+
+  // uint32 args_size = 3;
+  if (this->_internal_args_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_args_size());
+  }
+
+  // uint32 attachment_size = 7;
+  if (this->_internal_attachment_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_attachment_size());
+  }
+
+  // .Krpc.CompressType compress_type = 8;
+  if (this->_internal_compress_type() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_compress_type());
+  }
+
+  // uint32 raw_size = 9;
+  if (this->_internal_raw_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_raw_size());
+  }
+
+  // uint32 accept_compress = 10;
+  if (this->_internal_accept_compress() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_accept_compress());
+  }
+
+  // uint32 dict_id = 11;
+  if (this->_internal_dict_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_dict_id());
+  }
+
+  // uint32 accept_dict_id = 12;
+  if (this->_internal_accept_dict_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_accept_dict_id());
+  }
+
+  // uint32 stream_window = 13;
+  if (this->_internal_stream_window() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_stream_window());
+  }
+
+  // uint32 stream_credit = 14;
+  if (this->_internal_stream_credit() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_stream_credit());
+  }
+
+  // uint32 stream_window_bytes = 15;
+  if (this->_internal_stream_window_bytes() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_stream_window_bytes());
+  }
+
+  // bool accept_bulk = 6;
+  if (this->_internal_accept_bulk() != 0) {
+    total_size += 1 + 1;
+  }
+
+  // bool bidi_stream = 17;
+  if (this->_internal_bidi_stream() != 0) {
+    total_size += 2 + 1;
+  }
+
+  // bool stream_message = 18;
+  if (this->_internal_stream_message() != 0) {
+    total_size += 2 + 1;
+  }
+
+  // bool stream_end = 19;
+  if (this->_internal_stream_end() != 0) {
+    total_size += 2 + 1;
+  }
+
+  // uint32 stream_credit_bytes = 16;
+  if (this->_internal_stream_credit_bytes() != 0) {
+    total_size += 2 +
+      ::_pbi::WireFormatLite::UInt32Size(
+        this->_internal_stream_credit_bytes());
+  }
+
+  // uint32 priority = 21;
+  if (this->_internal_priority() != 0) {
+    total_size += 2 +
+      ::_pbi::WireFormatLite::UInt32Size(
+        this->_internal_priority());
+  }
+
+  // bool accept_fragment = 20;
+  if (this->_internal_accept_fragment() != 0) {
+    total_size += 2 + 1;
+  }
+
+  // bool framed_response = 23;
+  if (this->_internal_framed_response() != 0) {
+    total_size += 2 + 1;
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData RpcHeader::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    RpcHeader::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*RpcHeader::GetClassData() const { return &_class_data_; }
+
+
+void RpcHeader::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<RpcHeader*>(&to_msg);
+  auto& from = static_cast<const RpcHeader&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:Krpc.RpcHeader)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_service_name().empty()) {
+    _this->_internal_set_service_name(from._internal_service_name());
+  }
+  if (!from._internal_method_name().empty()) {
+    _this->_internal_set_method_name(from._internal_method_name());
+  }
+  if (from._internal_has_bulk()) {
+    _this->_internal_mutable_bulk()->::Krpc::BulkDescriptor::MergeFrom(
+        from._internal_bulk());
+  }
+  if (from._internal_has_trace()) {
+    _this->_internal_mutable_trace()->::Krpc::TraceContext::MergeFrom(
+        from._internal_trace());
+  }
+  if (from._internal_call_id() != 0) {
+    _this->_internal_set_call_id(from._internal_call_id());
+  }
+  if (from._internal_args_size() != 0) {
+    _this->_internal_set_args_size(from._internal_args_size());
+  }
+  if (from._internal_attachment_size() != 0) {
+    _this->_internal_set_attachment_size(from._internal_attachment_size());
+  }
+  if (from._internal_compress_type() != 0) {
+    _this->_internal_set_compress_type(from._internal_compress_type());
+  }
+  if (from._internal_raw_size() != 0) {
+    _this->_internal_set_raw_size(from._internal_raw_size());
+  }
+  if (from._internal_accept_compress() != 0) {
+    _this->_internal_set_accept_compress(from._internal_accept_compress());
+  }
+  if (from._internal_dict_id() != 0) {
+    _this->_internal_set_dict_id(from._internal_dict_id());
+  }
+  if (from._internal_accept_dict_id() != 0) {
+    _this->_internal_set_accept_dict_id(from._internal_accept_dict_id());
+  }
+  if (from._internal_stream_window() != 0) {
+    _this->_internal_set_stream_window(from._internal_stream_window());
+  }
+  if (from._internal_stream_credit() != 0) {
+    _this->_internal_set_stream_credit(from._internal_stream_credit());
+  }
+  if (from._internal_stream_window_bytes() != 0) {
+    _this->_internal_set_stream_window_bytes(from._internal_stream_window_bytes());
+  }
+  if (from._internal_accept_bulk() != 0) {
+    _this->_internal_set_accept_bulk(from._internal_accept_bulk());
+  }
+  if (from._internal_bidi_stream() != 0) {
+    _this->_internal_set_bidi_stream(from._internal_bidi_stream());
+  }
+  if (from._internal_stream_message() != 0) {
+    _this->_internal_set_stream_message(from._internal_stream_message());
+  }
+  if (from._internal_stream_end() != 0) {
+    _this->_internal_set_stream_end(from._internal_stream_end());
+  }
+  if (from._internal_stream_credit_bytes() != 0) {
+    _this->_internal_set_stream_credit_bytes(from._internal_stream_credit_bytes());
+  }
+  if (from._internal_priority() != 0) {
+    _this->_internal_set_priority(from._internal_priority());
+  }
+  if (from._internal_accept_fragment() != 0) {
+    _this->_internal_set_accept_fragment(from._internal_accept_fragment());
+  }
+  if (from._internal_framed_response() != 0) {
+    _this->_internal_set_framed_response(from._internal_framed_response());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void RpcHeader::CopyFrom(const RpcHeader& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:Krpc.RpcHeader)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool RpcHeader::IsInitialized() const {
+  return true;
+}
+
+void RpcHeader::InternalSwap(RpcHeader* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.service_name_, lhs_arena,
+      &other->_impl_.service_name_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.method_name_, lhs_arena,
+      &other->_impl_.method_name_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(RpcHeader, _impl_.framed_response_)
+      + sizeof(RpcHeader::_impl_.framed_response_)
+      - PROTOBUF_FIELD_OFFSET(RpcHeader, _impl_.bulk_)>(
+          reinterpret_cast<char*>(&_impl_.bulk_),
+          reinterpret_cast<char*>(&other->_impl_.bulk_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata RpcHeader::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_Krpcheader_2eproto_getter, &descriptor_table_Krpcheader_2eproto_once,
+      file_level_metadata_Krpcheader_2eproto[2]);
+}
+
+// ===================================================================
+
+class RpcResponseHeader::_Internal {
+ public:
+  static const ::Krpc::BulkDescriptor& bulk(const RpcResponseHeader* msg);
+};
+
+const ::Krpc::BulkDescriptor&
+RpcResponseHeader::_Internal::bulk(const RpcResponseHeader* msg) {
+  return *msg->_impl_.bulk_;
+}
+RpcResponseHeader::RpcResponseHeader(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:Krpc.RpcResponseHeader)
+}
+RpcResponseHeader::RpcResponseHeader(const RpcResponseHeader& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  RpcResponseHeader* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.error_){}
+    , decltype(_impl_.bulk_){nullptr}
+    , decltype(_impl_.call_id_){}
+    , decltype(_impl_.response_size_){}
+    , decltype(_impl_.attachment_size_){}
+    , decltype(_impl_.compress_type_){}
+    , decltype(_impl_.raw_size_){}
+    , decltype(_impl_.dict_id_){}
+    , decltype(_impl_.accept_dict_id_){}
+    , decltype(_impl_.stream_message_){}
+    , decltype(_impl_.stream_credit_){}
+    , decltype(_impl_.fragment_total_){}
+    , decltype(_impl_.fragment_offset_){}
+    , decltype(_impl_.server_queue_ns_){}
+    , decltype(_impl_.server_handler_ns_){}
+    , decltype(_impl_.server_serialize_ns_){}
+    , decltype(_impl_.stream_credit_bytes_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.error_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.error_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_error().empty()) {
+    _this->_impl_.error_.Set(from._internal_error(), 
+      _this->GetArenaForAllocation());
+  }
+  if (from._internal_has_bulk()) {
+    _this->_impl_.bulk_ = new ::Krpc::BulkDescriptor(*from._impl_.bulk_);
+  }
+  ::memcpy(&_impl_.call_id_, &from._impl_.call_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.stream_credit_bytes_) -
+    reinterpret_cast<char*>(&_impl_.call_id_)) + sizeof(_impl_.stream_credit_bytes_));
+  // @@protoc_insertion_point(copy_constructor:Krpc.RpcResponseHeader)
+}
+
+inline void RpcResponseHeader::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.error_){}
+    , decltype(_impl_.bulk_){nullptr}
+    , decltype(_impl_.call_id_){uint64_t{0u}}
+    , decltype(_impl_.response_size_){0u}
+    , decltype(_impl_.attachment_size_){0u}
+    , decltype(_impl_.compress_type_){0}
+    , decltype(_impl_.raw_size_){0u}
+    , decltype(_impl_.dict_id_){0u}
+    , decltype(_impl_.accept_dict_id_){0u}
+    , decltype(_impl_.stream_message_){false}
+    , decltype(_impl_.stream_credit_){0u}
+    , decltype(_impl_.fragment_total_){uint64_t{0u}}
+    , decltype(_impl_.fragment_offset_){uint64_t{0u}}
+    , decltype(_impl_.server_queue_ns_){uint64_t{0u}}
+    , decltype(_impl_.server_handler_ns_){uint64_t{0u}}
+    , decltype(_impl_.server_serialize_ns_){uint64_t{0u}}
+    , decltype(_impl_.stream_credit_bytes_){0u}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.error_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.error_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+RpcResponseHeader::~RpcResponseHeader() {
+  // @@protoc_insertion_point(destructor:Krpc.RpcResponseHeader)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void RpcResponseHeader::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.error_.Destroy();
+  if (this != internal_default_instance()) delete _impl_.bulk_;
+}
+
+void RpcResponseHeader::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void RpcResponseHeader::Clear() {
+// @@protoc_insertion_point(message_clear_start:Krpc.RpcResponseHeader)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.error_.ClearToEmpty();
+  if (GetArenaForAllocation() == nullptr && _impl_.bulk_ != nullptr) {
+    delete _impl_.bulk_;
+  }
+  _impl_.bulk_ = nullptr;
+  ::memset(&_impl_.call_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.stream_credit_bytes_) -
+      reinterpret_cast<char*>(&_impl_.call_id_)) + sizeof(_impl_.stream_credit_bytes_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* RpcResponseHeader::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // uint64 call_id = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.call_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 response_size = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.response_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .Krpc.BulkDescriptor bulk = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          ptr = ctx->ParseMessage(_internal_mutable_bulk(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 attachment_size = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.attachment_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .Krpc.CompressType compress_type = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_compress_type(static_cast<::Krpc::CompressType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 raw_size = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _impl_.raw_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 dict_id = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _impl_.dict_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 accept_dict_id = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 64)) {
+          _impl_.accept_dict_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool stream_message = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 72)) {
+          _impl_.stream_message_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 stream_credit = 10;
+      case 10:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 80)) {
+          _impl_.stream_credit_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 stream_credit_bytes = 11;
+      case 11:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 88)) {
+          _impl_.stream_credit_bytes_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 fragment_total = 12;
+      case 12:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 96)) {
+          _impl_.fragment_total_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 fragment_offset = 13;
+      case 13:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 104)) {
+          _impl_.fragment_offset_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 server_queue_ns = 14;
+      case 14:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 112)) {
+          _impl_.server_queue_ns_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 server_handler_ns = 15;
+      case 15:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 120)) {
+          _impl_.server_handler_ns_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 server_serialize_ns = 16;
+      case 16:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 128)) {
+          _impl_.server_serialize_ns_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // string error = 17;
+      case 17:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 138)) {
+          auto str = _internal_mutable_error();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+          CHK_(::_pbi::VerifyUTF8(str, "Krpc.RpcResponseHeader.error"));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* RpcResponseHeader::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:Krpc.RpcResponseHeader)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // uint64 call_id = 1;
+  if (this->_internal_call_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(1, this->_internal_call_id(), target);
+  }
+
+  // uint32 response_size = 2;
+  if (this->_internal_response_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(2, this->_internal_response_size(), target);
+  }
+
+  // .Krpc.BulkDescriptor bulk = 3;
+  if (this->_internal_has_bulk()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(3, _Internal::bulk(this),
+        _Internal::bulk(this).GetCachedSize(), target, stream);
+  }
+
+  // uint32 attachment_size = 4;
+  if (this->_internal_attachment_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(4, this->_internal_attachment_size(), target);
+  }
+
+  // .Krpc.CompressType compress_type = 5;
+  if (this->_internal_compress_type() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      5, this->_internal_compress_type(), target);
+  }
+
+  // uint32 raw_size = 6;
+  if (this->_internal_raw_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(6, this->_internal_raw_size(), target);
+  }
+
+  // uint32 dict_id = 7;
+  if (this->_internal_dict_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(7, this->_internal_dict_id(), target);
+  }
+
+  // uint32 accept_dict_id = 8;
+  if (this->_internal_accept_dict_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(8, this->_internal_accept_dict_id(), target);
+  }
+
+  // bool stream_message = 9;
+  if (this->_internal_stream_message() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(9, this->_internal_stream_message(), target);
+  }
+
+  // uint32 stream_credit = 10;
+  if (this->_internal_stream_credit() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(10, this->_internal_stream_credit(), target);
+  }
+
+  // uint32 stream_credit_bytes = 11;
+  if (this->_internal_stream_credit_bytes() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(11, this->_internal_stream_credit_bytes(), target);
+  }
+
+  // uint64 fragment_total = 12;
+  if (this->_internal_fragment_total() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(12, this->_internal_fragment_total(), target);
+  }
+
+  // uint64 fragment_offset = 13;
+  if (this->_internal_fragment_offset() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(13, this->_internal_fragment_offset(), target);
+  }
+
+  // uint64 server_queue_ns = 14;
+  if (this->_internal_server_queue_ns() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(14, this->_internal_server_queue_ns(), target);
+  }
+
+  // uint64 server_handler_ns = 15;
+  if (this->_internal_server_handler_ns() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(15, this->_internal_server_handler_ns(), target);
+  }
+
+  // uint64 server_serialize_ns = 16;
+  if (this->_internal_server_serialize_ns() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(16, this->_internal_server_serialize_ns(), target);
+  }
+
+  // string error = 17;
+  if (!this->_internal_error().empty()) {
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      this->_internal_error().data(), static_cast<int>(this->_internal_error().length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "Krpc.RpcResponseHeader.error");
+    target = stream->WriteStringMaybeAliased(
+        17, this->_internal_error(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:Krpc.RpcResponseHeader)
+  return target;
+}
+
+size_t RpcResponseHeader::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:Krpc.RpcResponseHeader)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // string error = 17;
+  if (!this->_internal_error().empty()) {
+    total_size += 2 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+        this->_internal_error());
+  }
+
+  // .Krpc.BulkDescriptor bulk = 3;
+  if (this->_internal_has_bulk()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *_impl_.bulk_);
+  }
+
+  // uint64 call_id = 1;
+  if (this->_internal_call_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_call_id());
+  }
+
+  // uint32 response_size = 2;
+  if (this->_internal_response_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_response_size());
+  }
+
+  // uint32 attachment_size = 4;
+  if (this->_internal_attachment_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_attachment_size());
+  }
+
+  // .Krpc.CompressType compress_type = 5;
+  if (this->_internal_compress_type() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_compress_type());
+  }
+
+  // uint32 raw_size = 6;
+  if (this->_internal_raw_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_raw_size());
+  }
+
+  // uint32 dict_id = 7;
+  if (this->_internal_dict_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_dict_id());
+  }
+
+  // uint32 accept_dict_id = 8;
+  if (this->_internal_accept_dict_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_accept_dict_id());
+  }
+
+  // bool stream_message = 9;
+  if (this->_internal_stream_message() != 0) {
+    total_size += 1 + 1;
+  }
+
+  // uint32 stream_credit = 10;
+  if (this->_internal_stream_credit() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_stream_credit());
+  }
+
+  // uint64 fragment_total = 12;
+  if (this->_internal_fragment_total() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_fragment_total());
+  }
+
+  // uint64 fragment_offset = 13;
+  if (this->_internal_fragment_offset() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_fragment_offset());
+  }
+
+  // uint64 server_queue_ns = 14;
+  if (this->_internal_server_queue_ns() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_server_queue_ns());
+  }
+
+  // uint64 server_handler_ns = 15;
+  if (this->_internal_server_handler_ns() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_server_handler_ns());
+  }
+
+  // uint64 server_serialize_ns = 16;
+  if (this->_internal_server_serialize_ns() != 0) {
+    total_size += 2 +
+      ::_pbi::WireFormatLite::UInt64Size(
+        this->_internal_server_serialize_ns());
+  }
+
+  // uint32 stream_credit_bytes = 11;
+  if (this->_internal_stream_credit_bytes() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_stream_credit_bytes());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData RpcResponseHeader::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    RpcResponseHeader::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*RpcResponseHeader::GetClassData() const { return &_class_data_; }
+
+
+void RpcResponseHeader::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<RpcResponseHeader*>(&to_msg);
+  auto& from = static_cast<const RpcResponseHeader&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:Krpc.RpcResponseHeader)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_error().empty()) {
+    _this->_internal_set_error(from._internal_error());
+  }
+  if (from._internal_has_bulk()) {
+    _this->_internal_mutable_bulk()->::Krpc::BulkDescriptor::MergeFrom(
+        from._internal_bulk());
+  }
+  if (from._internal_call_id() != 0) {
+    _this->_internal_set_call_id(from._internal_call_id());
+  }
+  if (from._internal_response_size() != 0) {
+    _this->_internal_set_response_size(from._internal_response_size());
+  }
+  if (from._internal_attachment_size() != 0) {
+    _this->_internal_set_attachment_size(from._internal_attachment_size());
+  }
+  if (from._internal_compress_type() != 0) {
+    _this->_internal_set_compress_type(from._internal_compress_type());
+  }
+  if (from._internal_raw_size() != 0) {
+    _this->_internal_set_raw_size(from._internal_raw_size());
+  }
+  if (from._internal_dict_id() != 0) {
+    _this->_internal_set_dict_id(from._internal_dict_id());
+  }
+  if (from._internal_accept_dict_id() != 0) {
+    _this->_internal_set_accept_dict_id(from._internal_accept_dict_id());
+  }
+  if (from._internal_stream_message() != 0) {
+    _this->_internal_set_stream_message(from._internal_stream_message());
+  }
+  if (from._internal_stream_credit() != 0) {
+    _this->_internal_set_stream_credit(from._internal_stream_credit());
+  }
+  if (from._internal_fragment_total() != 0) {
+    _this->_internal_set_fragment_total(from._internal_fragment_total());
+  }
+  if (from._internal_fragment_offset() != 0) {
+    _this->_internal_set_fragment_offset(from._internal_fragment_offset());
+  }
+  if (from._internal_server_queue_ns() != 0) {
+    _this->_internal_set_server_queue_ns(from._internal_server_queue_ns());
+  }
+  if (from._internal_server_handler_ns() != 0) {
+    _this->_internal_set_server_handler_ns(from._internal_server_handler_ns());
+  }
+  if (from._internal_server_serialize_ns() != 0) {
+    _this->_internal_set_server_serialize_ns(from._internal_server_serialize_ns());
+  }
+  if (from._internal_stream_credit_bytes() != 0) {
+    _this->_internal_set_stream_credit_bytes(from._internal_stream_credit_bytes());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void RpcResponseHeader::CopyFrom(const RpcResponseHeader& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:Krpc.RpcResponseHeader)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool RpcResponseHeader::IsInitialized() const {
+  return true;
+}
+
+void RpcResponseHeader::InternalSwap(RpcResponseHeader* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.error_, lhs_arena,
+      &other->_impl_.error_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(RpcResponseHeader, _impl_.stream_credit_bytes_)
+      + sizeof(RpcResponseHeader::_impl_.stream_credit_bytes_)
+      - PROTOBUF_FIELD_OFFSET(RpcResponseHeader, _impl_.bulk_)>(
+          reinterpret_cast<char*>(&_impl_.bulk_),
+          reinterpret_cast<char*>(&other->_impl_.bulk_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata RpcResponseHeader::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_Krpcheader_2eproto_getter, &descriptor_table_Krpcheader_2eproto_once,
+      file_level_metadata_Krpcheader_2eproto[3]);
+}
+
+// @@protoc_insertion_point(namespace_scope)
+}  // namespace Krpc
+PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::Krpc::BulkDescriptor*
+Arena::CreateMaybeMessage< ::Krpc::BulkDescriptor >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::Krpc::BulkDescriptor >(arena);
+}
+template<> PROTOBUF_NOINLINE ::Krpc::TraceContext*
+Arena::CreateMaybeMessage< ::Krpc::TraceContext >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::Krpc::TraceContext >(arena);
+}
+template<> PROTOBUF_NOINLINE ::Krpc::RpcHeader*
+Arena::CreateMaybeMessage< ::Krpc::RpcHeader >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::Krpc::RpcHeader >(arena);
+}
+template<> PROTOBUF_NOINLINE ::Krpc::RpcResponseHeader*
+Arena::CreateMaybeMessage< ::Krpc::RpcResponseHeader >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::Krpc::RpcResponseHeader >(arena);
 }
 PROTOBUF_NAMESPACE_CLOSE
 
@@ -8,12 +8,12 @@
 #include <string>
 
 #include <google/protobuf/port_def.inc>
-#if PROTOBUF_VERSION < 3012000
+#if PROTOBUF_VERSION < 3021000
 #error This file was generated by a newer version of protoc which is
 #error incompatible with your Protocol Buffer headers. Please update
 #error your headers.
 #endif
-#if 3012004 < PROTOBUF_MIN_PROTOC_VERSION
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
 #error This file was generated by an older version of protoc which is
 #error incompatible with your Protocol Buffer headers. Please
 #error regenerate this file with a newer version of protoc.
@@ -23,14 +23,13 @@
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/arena.h>
 #include <google/protobuf/arenastring.h>
-#include <google/protobuf/generated_message_table_driven.h>
 #include <google/protobuf/generated_message_util.h>
-#include <google/protobuf/inlined_string_field.h>
 #include <google/protobuf/metadata_lite.h>
 #include <google/protobuf/generated_message_reflection.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/repeated_field.h>  // IWYU pragma: export
 #include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/generated_enum_reflection.h>
 #include <google/protobuf/unknown_field_set.h>
 // @@protoc_insertion_point(includes)
 #include <google/protobuf/port_def.inc>
@@ -43,34 +42,448 @@ PROTOBUF_NAMESPACE_CLOSE
 
 // Internal implementation detail -- do not use these members.
 struct TableStruct_Krpcheader_2eproto {
-  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTableField entries[]
-    PROTOBUF_SECTION_VARIABLE(protodesc_cold);
-  static const ::PROTOBUF_NAMESPACE_ID::internal::AuxillaryParseTableField aux[]
-    PROTOBUF_SECTION_VARIABLE(protodesc_cold);
-  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[1]
-    PROTOBUF_SECTION_VARIABLE(protodesc_cold);
-  static const ::PROTOBUF_NAMESPACE_ID::internal::FieldMetadata field_metadata[];
-  static const ::PROTOBUF_NAMESPACE_ID::internal::SerializationTable serialization_table[];
-  static const ::PROTOBUF_NAMESPACE_ID::uint32 offsets[];
+  static const uint32_t offsets[];
 };
 extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_Krpcheader_2eproto;
 namespace Krpc {
+class BulkDescriptor;
+struct BulkDescriptorDefaultTypeInternal;
+extern BulkDescriptorDefaultTypeInternal _BulkDescriptor_default_instance_;
 class RpcHeader;
-class RpcHeaderDefaultTypeInternal;
+struct RpcHeaderDefaultTypeInternal;
 extern RpcHeaderDefaultTypeInternal _RpcHeader_default_instance_;
+class RpcResponseHeader;
+struct RpcResponseHeaderDefaultTypeInternal;
+extern RpcResponseHeaderDefaultTypeInternal _RpcResponseHeader_default_instance_;
+class TraceContext;
+struct TraceContextDefaultTypeInternal;
+extern TraceContextDefaultTypeInternal _TraceContext_default_instance_;
 }  // namespace Krpc
 PROTOBUF_NAMESPACE_OPEN
+template<> ::Krpc::BulkDescriptor* Arena::CreateMaybeMessage<::Krpc::BulkDescriptor>(Arena*);
 template<> ::Krpc::RpcHeader* Arena::CreateMaybeMessage<::Krpc::RpcHeader>(Arena*);
+template<> ::Krpc::RpcResponseHeader* Arena::CreateMaybeMessage<::Krpc::RpcResponseHeader>(Arena*);
+template<> ::Krpc::TraceContext* Arena::CreateMaybeMessage<::Krpc::TraceContext>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace Krpc {
 
+enum CompressType : int {
+  COMPRESS_NONE = 0,
+  COMPRESS_LZ4 = 1,
+  COMPRESS_ZSTD = 2,
+  CompressType_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  CompressType_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool CompressType_IsValid(int value);
+constexpr CompressType CompressType_MIN = COMPRESS_NONE;
+constexpr CompressType CompressType_MAX = COMPRESS_ZSTD;
+constexpr int CompressType_ARRAYSIZE = CompressType_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* CompressType_descriptor();
+template<typename T>
+inline const std::string& CompressType_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, CompressType>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function CompressType_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    CompressType_descriptor(), enum_t_value);
+}
+inline bool CompressType_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, CompressType* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<CompressType>(
+    CompressType_descriptor(), name, value);
+}
 // ===================================================================
 
-class RpcHeader PROTOBUF_FINAL :
+class BulkDescriptor final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:Krpc.BulkDescriptor) */ {
+ public:
+  inline BulkDescriptor() : BulkDescriptor(nullptr) {}
+  ~BulkDescriptor() override;
+  explicit PROTOBUF_CONSTEXPR BulkDescriptor(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  BulkDescriptor(const BulkDescriptor& from);
+  BulkDescriptor(BulkDescriptor&& from) noexcept
+    : BulkDescriptor() {
+    *this = ::std::move(from);
+  }
+
+  inline BulkDescriptor& operator=(const BulkDescriptor& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline BulkDescriptor& operator=(BulkDescriptor&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const BulkDescriptor& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const BulkDescriptor* internal_default_instance() {
+    return reinterpret_cast<const BulkDescriptor*>(
+               &_BulkDescriptor_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(BulkDescriptor& a, BulkDescriptor& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(BulkDescriptor* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(BulkDescriptor* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  BulkDescriptor* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<BulkDescriptor>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const BulkDescriptor& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const BulkDescriptor& from) {
+    BulkDescriptor::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(BulkDescriptor* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "Krpc.BulkDescriptor";
+  }
+  protected:
+  explicit BulkDescriptor(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kWorkerAddressFieldNumber = 1,
+    kRkeyFieldNumber = 3,
+    kRemoteAddrFieldNumber = 2,
+    kLengthFieldNumber = 4,
+    kBulkIdFieldNumber = 5,
+  };
+  // bytes worker_address = 1;
+  void clear_worker_address();
+  const std::string& worker_address() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_worker_address(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_worker_address();
+  PROTOBUF_NODISCARD std::string* release_worker_address();
+  void set_allocated_worker_address(std::string* worker_address);
+  private:
+  const std::string& _internal_worker_address() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_worker_address(const std::string& value);
+  std::string* _internal_mutable_worker_address();
+  public:
+
+  // bytes rkey = 3;
+  void clear_rkey();
+  const std::string& rkey() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_rkey(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_rkey();
+  PROTOBUF_NODISCARD std::string* release_rkey();
+  void set_allocated_rkey(std::string* rkey);
+  private:
+  const std::string& _internal_rkey() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_rkey(const std::string& value);
+  std::string* _internal_mutable_rkey();
+  public:
+
+  // uint64 remote_addr = 2;
+  void clear_remote_addr();
+  uint64_t remote_addr() const;
+  void set_remote_addr(uint64_t value);
+  private:
+  uint64_t _internal_remote_addr() const;
+  void _internal_set_remote_addr(uint64_t value);
+  public:
+
+  // uint64 length = 4;
+  void clear_length();
+  uint64_t length() const;
+  void set_length(uint64_t value);
+  private:
+  uint64_t _internal_length() const;
+  void _internal_set_length(uint64_t value);
+  public:
+
+  // uint64 bulk_id = 5;
+  void clear_bulk_id();
+  uint64_t bulk_id() const;
+  void set_bulk_id(uint64_t value);
+  private:
+  uint64_t _internal_bulk_id() const;
+  void _internal_set_bulk_id(uint64_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:Krpc.BulkDescriptor)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr worker_address_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr rkey_;
+    uint64_t remote_addr_;
+    uint64_t length_;
+    uint64_t bulk_id_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_Krpcheader_2eproto;
+};
+// -------------------------------------------------------------------
+
+class TraceContext final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:Krpc.TraceContext) */ {
+ public:
+  inline TraceContext() : TraceContext(nullptr) {}
+  ~TraceContext() override;
+  explicit PROTOBUF_CONSTEXPR TraceContext(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  TraceContext(const TraceContext& from);
+  TraceContext(TraceContext&& from) noexcept
+    : TraceContext() {
+    *this = ::std::move(from);
+  }
+
+  inline TraceContext& operator=(const TraceContext& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline TraceContext& operator=(TraceContext&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const TraceContext& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const TraceContext* internal_default_instance() {
+    return reinterpret_cast<const TraceContext*>(
+               &_TraceContext_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(TraceContext& a, TraceContext& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(TraceContext* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(TraceContext* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  TraceContext* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<TraceContext>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const TraceContext& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const TraceContext& from) {
+    TraceContext::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(TraceContext* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "Krpc.TraceContext";
+  }
+  protected:
+  explicit TraceContext(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kTraceIdFieldNumber = 1,
+    kSpanIdFieldNumber = 2,
+    kParentSpanIdFieldNumber = 3,
+    kSampledFieldNumber = 4,
+  };
+  // fixed64 trace_id = 1;
+  void clear_trace_id();
+  uint64_t trace_id() const;
+  void set_trace_id(uint64_t value);
+  private:
+  uint64_t _internal_trace_id() const;
+  void _internal_set_trace_id(uint64_t value);
+  public:
+
+  // fixed64 span_id = 2;
+  void clear_span_id();
+  uint64_t span_id() const;
+  void set_span_id(uint64_t value);
+  private:
+  uint64_t _internal_span_id() const;
+  void _internal_set_span_id(uint64_t value);
+  public:
+
+  // fixed64 parent_span_id = 3;
+  void clear_parent_span_id();
+  uint64_t parent_span_id() const;
+  void set_parent_span_id(uint64_t value);
+  private:
+  uint64_t _internal_parent_span_id() const;
+  void _internal_set_parent_span_id(uint64_t value);
+  public:
+
+  // bool sampled = 4;
+  void clear_sampled();
+  bool sampled() const;
+  void set_sampled(bool value);
+  private:
+  bool _internal_sampled() const;
+  void _internal_set_sampled(bool value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:Krpc.TraceContext)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    uint64_t trace_id_;
+    uint64_t span_id_;
+    uint64_t parent_span_id_;
+    bool sampled_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_Krpcheader_2eproto;
+};
+// -------------------------------------------------------------------
+
+class RpcHeader final :
     public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:Krpc.RpcHeader) */ {
  public:
-  inline RpcHeader() : RpcHeader(nullptr) {};
-  virtual ~RpcHeader();
+  inline RpcHeader() : RpcHeader(nullptr) {}
+  ~RpcHeader() override;
+  explicit PROTOBUF_CONSTEXPR RpcHeader(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
   RpcHeader(const RpcHeader& from);
   RpcHeader(RpcHeader&& from) noexcept
@@ -83,8 +496,13 @@ class RpcHeader PROTOBUF_FINAL :
     return *this;
   }
   inline RpcHeader& operator=(RpcHeader&& from) noexcept {
-    if (GetArena() == from.GetArena()) {
-      if (this != &from) InternalSwap(&from);
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
     } else {
       CopyFrom(from);
     }
@@ -95,27 +513,32 @@ class RpcHeader PROTOBUF_FINAL :
     return GetDescriptor();
   }
   static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
-    return GetMetadataStatic().descriptor;
+    return default_instance().GetMetadata().descriptor;
   }
   static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
-    return GetMetadataStatic().reflection;
+    return default_instance().GetMetadata().reflection;
+  }
+  static const RpcHeader& default_instance() {
+    return *internal_default_instance();
   }
-  static const RpcHeader& default_instance();
-
-  static void InitAsDefaultInstance();  // FOR INTERNAL USE ONLY
   static inline const RpcHeader* internal_default_instance() {
     return reinterpret_cast<const RpcHeader*>(
                &_RpcHeader_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    0;
+    2;
 
   friend void swap(RpcHeader& a, RpcHeader& b) {
     a.Swap(&b);
   }
   inline void Swap(RpcHeader* other) {
     if (other == this) return;
-    if (GetArena() == other->GetArena()) {
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
       InternalSwap(other);
     } else {
       ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
@@ -123,56 +546,53 @@ class RpcHeader PROTOBUF_FINAL :
   }
   void UnsafeArenaSwap(RpcHeader* other) {
     if (other == this) return;
-    GOOGLE_DCHECK(GetArena() == other->GetArena());
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
     InternalSwap(other);
   }
 
   // implements Message ----------------------------------------------
 
-  inline RpcHeader* New() const final {
-    return CreateMaybeMessage<RpcHeader>(nullptr);
-  }
-
-  RpcHeader* New(::PROTOBUF_NAMESPACE_ID::Arena* arena) const final {
+  RpcHeader* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
     return CreateMaybeMessage<RpcHeader>(arena);
   }
-  void CopyFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) final;
-  void MergeFrom(const ::PROTOBUF_NAMESPACE_ID::Message& from) final;
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const RpcHeader& from);
-  void MergeFrom(const RpcHeader& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const RpcHeader& from) {
+    RpcHeader::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
   PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
 
   size_t ByteSizeLong() const final;
   const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
-  ::PROTOBUF_NAMESPACE_ID::uint8* _InternalSerialize(
-      ::PROTOBUF_NAMESPACE_ID::uint8* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  inline void SharedCtor();
-  inline void SharedDtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(RpcHeader* other);
+
+  private:
   friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
   static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
     return "Krpc.RpcHeader";
   }
   protected:
-  explicit RpcHeader(::PROTOBUF_NAMESPACE_ID::Arena* arena);
-  private:
-  static void ArenaDtor(void* object);
-  inline void RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  explicit RpcHeader(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
   public:
 
-  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
-  private:
-  static ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadataStatic() {
-    ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&::descriptor_table_Krpcheader_2eproto);
-    return ::descriptor_table_Krpcheader_2eproto.file_level_metadata[kIndexInFileMessages];
-  }
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
 
-  public:
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
 
   // nested types ----------------------------------------------------
 
@@ -181,281 +601,2024 @@ class RpcHeader PROTOBUF_FINAL :
   enum : int {
     kServiceNameFieldNumber = 1,
     kMethodNameFieldNumber = 2,
+    kBulkFieldNumber = 5,
+    kTraceFieldNumber = 22,
+    kCallIdFieldNumber = 4,
     kArgsSizeFieldNumber = 3,
+    kAttachmentSizeFieldNumber = 7,
+    kCompressTypeFieldNumber = 8,
+    kRawSizeFieldNumber = 9,
+    kAcceptCompressFieldNumber = 10,
+    kDictIdFieldNumber = 11,
+    kAcceptDictIdFieldNumber = 12,
+    kStreamWindowFieldNumber = 13,
+    kStreamCreditFieldNumber = 14,
+    kStreamWindowBytesFieldNumber = 15,
+    kAcceptBulkFieldNumber = 6,
+    kBidiStreamFieldNumber = 17,
+    kStreamMessageFieldNumber = 18,
+    kStreamEndFieldNumber = 19,
+    kStreamCreditBytesFieldNumber = 16,
+    kPriorityFieldNumber = 21,
+    kAcceptFragmentFieldNumber = 20,
+    kFramedResponseFieldNumber = 23,
   };
   // bytes service_name = 1;
   void clear_service_name();
   const std::string& service_name() const;
-  void set_service_name(const std::string& value);
-  void set_service_name(std::string&& value);
-  void set_service_name(const char* value);
-  void set_service_name(const void* value, size_t size);
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_service_name(ArgT0&& arg0, ArgT... args);
   std::string* mutable_service_name();
-  std::string* release_service_name();
+  PROTOBUF_NODISCARD std::string* release_service_name();
   void set_allocated_service_name(std::string* service_name);
-  GOOGLE_PROTOBUF_RUNTIME_DEPRECATED("The unsafe_arena_ accessors for"
-  "    string fields are deprecated and will be removed in a"
-  "    future release.")
-  std::string* unsafe_arena_release_service_name();
-  GOOGLE_PROTOBUF_RUNTIME_DEPRECATED("The unsafe_arena_ accessors for"
-  "    string fields are deprecated and will be removed in a"
-  "    future release.")
-  void unsafe_arena_set_allocated_service_name(
-      std::string* service_name);
   private:
   const std::string& _internal_service_name() const;
-  void _internal_set_service_name(const std::string& value);
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_service_name(const std::string& value);
   std::string* _internal_mutable_service_name();
   public:
 
   // bytes method_name = 2;
   void clear_method_name();
   const std::string& method_name() const;
-  void set_method_name(const std::string& value);
-  void set_method_name(std::string&& value);
-  void set_method_name(const char* value);
-  void set_method_name(const void* value, size_t size);
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_method_name(ArgT0&& arg0, ArgT... args);
   std::string* mutable_method_name();
-  std::string* release_method_name();
+  PROTOBUF_NODISCARD std::string* release_method_name();
   void set_allocated_method_name(std::string* method_name);
-  GOOGLE_PROTOBUF_RUNTIME_DEPRECATED("The unsafe_arena_ accessors for"
-  "    string fields are deprecated and will be removed in a"
-  "    future release.")
-  std::string* unsafe_arena_release_method_name();
-  GOOGLE_PROTOBUF_RUNTIME_DEPRECATED("The unsafe_arena_ accessors for"
-  "    string fields are deprecated and will be removed in a"
-  "    future release.")
-  void unsafe_arena_set_allocated_method_name(
-      std::string* method_name);
   private:
   const std::string& _internal_method_name() const;
-  void _internal_set_method_name(const std::string& value);
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_method_name(const std::string& value);
   std::string* _internal_mutable_method_name();
   public:
 
+  // .Krpc.BulkDescriptor bulk = 5;
+  bool has_bulk() const;
+  private:
+  bool _internal_has_bulk() const;
+  public:
+  void clear_bulk();
+  const ::Krpc::BulkDescriptor& bulk() const;
+  PROTOBUF_NODISCARD ::Krpc::BulkDescriptor* release_bulk();
+  ::Krpc::BulkDescriptor* mutable_bulk();
+  void set_allocated_bulk(::Krpc::BulkDescriptor* bulk);
+  private:
+  const ::Krpc::BulkDescriptor& _internal_bulk() const;
+  ::Krpc::BulkDescriptor* _internal_mutable_bulk();
+  public:
+  void unsafe_arena_set_allocated_bulk(
+      ::Krpc::BulkDescriptor* bulk);
+  ::Krpc::BulkDescriptor* unsafe_arena_release_bulk();
+
+  // .Krpc.TraceContext trace = 22;
+  bool has_trace() const;
+  private:
+  bool _internal_has_trace() const;
+  public:
+  void clear_trace();
+  const ::Krpc::TraceContext& trace() const;
+  PROTOBUF_NODISCARD ::Krpc::TraceContext* release_trace();
+  ::Krpc::TraceContext* mutable_trace();
+  void set_allocated_trace(::Krpc::TraceContext* trace);
+  private:
+  const ::Krpc::TraceContext& _internal_trace() const;
+  ::Krpc::TraceContext* _internal_mutable_trace();
+  public:
+  void unsafe_arena_set_allocated_trace(
+      ::Krpc::TraceContext* trace);
+  ::Krpc::TraceContext* unsafe_arena_release_trace();
+
+  // uint64 call_id = 4;
+  void clear_call_id();
+  uint64_t call_id() const;
+  void set_call_id(uint64_t value);
+  private:
+  uint64_t _internal_call_id() const;
+  void _internal_set_call_id(uint64_t value);
+  public:
+
   // uint32 args_size = 3;
   void clear_args_size();
-  ::PROTOBUF_NAMESPACE_ID::uint32 args_size() const;
-  void set_args_size(::PROTOBUF_NAMESPACE_ID::uint32 value);
+  uint32_t args_size() const;
+  void set_args_size(uint32_t value);
   private:
-  ::PROTOBUF_NAMESPACE_ID::uint32 _internal_args_size() const;
-  void _internal_set_args_size(::PROTOBUF_NAMESPACE_ID::uint32 value);
+  uint32_t _internal_args_size() const;
+  void _internal_set_args_size(uint32_t value);
   public:
 
-  // @@protoc_insertion_point(class_scope:Krpc.RpcHeader)
- private:
-  class _Internal;
+  // uint32 attachment_size = 7;
+  void clear_attachment_size();
+  uint32_t attachment_size() const;
+  void set_attachment_size(uint32_t value);
+  private:
+  uint32_t _internal_attachment_size() const;
+  void _internal_set_attachment_size(uint32_t value);
+  public:
 
-  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
-  typedef void InternalArenaConstructable_;
-  typedef void DestructorSkippable_;
-  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr service_name_;
-  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr method_name_;
-  ::PROTOBUF_NAMESPACE_ID::uint32 args_size_;
-  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
-  friend struct ::TableStruct_Krpcheader_2eproto;
-};
-// ===================================================================
+  // .Krpc.CompressType compress_type = 8;
+  void clear_compress_type();
+  ::Krpc::CompressType compress_type() const;
+  void set_compress_type(::Krpc::CompressType value);
+  private:
+  ::Krpc::CompressType _internal_compress_type() const;
+  void _internal_set_compress_type(::Krpc::CompressType value);
+  public:
 
+  // uint32 raw_size = 9;
+  void clear_raw_size();
+  uint32_t raw_size() const;
+  void set_raw_size(uint32_t value);
+  private:
+  uint32_t _internal_raw_size() const;
+  void _internal_set_raw_size(uint32_t value);
+  public:
 
-// ===================================================================
+  // uint32 accept_compress = 10;
+  void clear_accept_compress();
+  uint32_t accept_compress() const;
+  void set_accept_compress(uint32_t value);
+  private:
+  uint32_t _internal_accept_compress() const;
+  void _internal_set_accept_compress(uint32_t value);
+  public:
 
-#ifdef __GNUC__
-  #pragma GCC diagnostic push
-  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
-#endif  // __GNUC__
-// RpcHeader
+  // uint32 dict_id = 11;
+  void clear_dict_id();
+  uint32_t dict_id() const;
+  void set_dict_id(uint32_t value);
+  private:
+  uint32_t _internal_dict_id() const;
+  void _internal_set_dict_id(uint32_t value);
+  public:
 
-// bytes service_name = 1;
-inline void RpcHeader::clear_service_name() {
-  service_name_.ClearToEmpty(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
-}
-inline const std::string& RpcHeader::service_name() const {
-  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.service_name)
-  return _internal_service_name();
-}
-inline void RpcHeader::set_service_name(const std::string& value) {
-  _internal_set_service_name(value);
-  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.service_name)
-}
-inline std::string* RpcHeader::mutable_service_name() {
-  // @@protoc_insertion_point(field_mutable:Krpc.RpcHeader.service_name)
-  return _internal_mutable_service_name();
-}
-inline const std::string& RpcHeader::_internal_service_name() const {
-  return service_name_.Get();
-}
+  // uint32 accept_dict_id = 12;
+  void clear_accept_dict_id();
+  uint32_t accept_dict_id() const;
+  void set_accept_dict_id(uint32_t value);
+  private:
+  uint32_t _internal_accept_dict_id() const;
+  void _internal_set_accept_dict_id(uint32_t value);
+  public:
+
+  // uint32 stream_window = 13;
+  void clear_stream_window();
+  uint32_t stream_window() const;
+  void set_stream_window(uint32_t value);
+  private:
+  uint32_t _internal_stream_window() const;
+  void _internal_set_stream_window(uint32_t value);
+  public:
+
+  // uint32 stream_credit = 14;
+  void clear_stream_credit();
+  uint32_t stream_credit() const;
+  void set_stream_credit(uint32_t value);
+  private:
+  uint32_t _internal_stream_credit() const;
+  void _internal_set_stream_credit(uint32_t value);
+  public:
+
+  // uint32 stream_window_bytes = 15;
+  void clear_stream_window_bytes();
+  uint32_t stream_window_bytes() const;
+  void set_stream_window_bytes(uint32_t value);
+  private:
+  uint32_t _internal_stream_window_bytes() const;
+  void _internal_set_stream_window_bytes(uint32_t value);
+  public:
+
+  // bool accept_bulk = 6;
+  void clear_accept_bulk();
+  bool accept_bulk() const;
+  void set_accept_bulk(bool value);
+  private:
+  bool _internal_accept_bulk() const;
+  void _internal_set_accept_bulk(bool value);
+  public:
+
+  // bool bidi_stream = 17;
+  void clear_bidi_stream();
+  bool bidi_stream() const;
+  void set_bidi_stream(bool value);
+  private:
+  bool _internal_bidi_stream() const;
+  void _internal_set_bidi_stream(bool value);
+  public:
+
+  // bool stream_message = 18;
+  void clear_stream_message();
+  bool stream_message() const;
+  void set_stream_message(bool value);
+  private:
+  bool _internal_stream_message() const;
+  void _internal_set_stream_message(bool value);
+  public:
+
+  // bool stream_end = 19;
+  void clear_stream_end();
+  bool stream_end() const;
+  void set_stream_end(bool value);
+  private:
+  bool _internal_stream_end() const;
+  void _internal_set_stream_end(bool value);
+  public:
+
+  // uint32 stream_credit_bytes = 16;
+  void clear_stream_credit_bytes();
+  uint32_t stream_credit_bytes() const;
+  void set_stream_credit_bytes(uint32_t value);
+  private:
+  uint32_t _internal_stream_credit_bytes() const;
+  void _internal_set_stream_credit_bytes(uint32_t value);
+  public:
+
+  // uint32 priority = 21;
+  void clear_priority();
+  uint32_t priority() const;
+  void set_priority(uint32_t value);
+  private:
+  uint32_t _internal_priority() const;
+  void _internal_set_priority(uint32_t value);
+  public:
+
+  // bool accept_fragment = 20;
+  void clear_accept_fragment();
+  bool accept_fragment() const;
+  void set_accept_fragment(bool value);
+  private:
+  bool _internal_accept_fragment() const;
+  void _internal_set_accept_fragment(bool value);
+  public:
+
+  // bool framed_response = 23;
+  void clear_framed_response();
+  bool framed_response() const;
+  void set_framed_response(bool value);
+  private:
+  bool _internal_framed_response() const;
+  void _internal_set_framed_response(bool value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:Krpc.RpcHeader)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr service_name_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr method_name_;
+    ::Krpc::BulkDescriptor* bulk_;
+    ::Krpc::TraceContext* trace_;
+    uint64_t call_id_;
+    uint32_t args_size_;
+    uint32_t attachment_size_;
+    int compress_type_;
+    uint32_t raw_size_;
+    uint32_t accept_compress_;
+    uint32_t dict_id_;
+    uint32_t accept_dict_id_;
+    uint32_t stream_window_;
+    uint32_t stream_credit_;
+    uint32_t stream_window_bytes_;
+    bool accept_bulk_;
+    bool bidi_stream_;
+    bool stream_message_;
+    bool stream_end_;
+    uint32_t stream_credit_bytes_;
+    uint32_t priority_;
+    bool accept_fragment_;
+    bool framed_response_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_Krpcheader_2eproto;
+};
+// -------------------------------------------------------------------
+
+class RpcResponseHeader final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:Krpc.RpcResponseHeader) */ {
+ public:
+  inline RpcResponseHeader() : RpcResponseHeader(nullptr) {}
+  ~RpcResponseHeader() override;
+  explicit PROTOBUF_CONSTEXPR RpcResponseHeader(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  RpcResponseHeader(const RpcResponseHeader& from);
+  RpcResponseHeader(RpcResponseHeader&& from) noexcept
+    : RpcResponseHeader() {
+    *this = ::std::move(from);
+  }
+
+  inline RpcResponseHeader& operator=(const RpcResponseHeader& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline RpcResponseHeader& operator=(RpcResponseHeader&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const RpcResponseHeader& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const RpcResponseHeader* internal_default_instance() {
+    return reinterpret_cast<const RpcResponseHeader*>(
+               &_RpcResponseHeader_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    3;
+
+  friend void swap(RpcResponseHeader& a, RpcResponseHeader& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(RpcResponseHeader* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(RpcResponseHeader* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  RpcResponseHeader* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<RpcResponseHeader>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const RpcResponseHeader& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const RpcResponseHeader& from) {
+    RpcResponseHeader::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(RpcResponseHeader* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "Krpc.RpcResponseHeader";
+  }
+  protected:
+  explicit RpcResponseHeader(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kErrorFieldNumber = 17,
+    kBulkFieldNumber = 3,
+    kCallIdFieldNumber = 1,
+    kResponseSizeFieldNumber = 2,
+    kAttachmentSizeFieldNumber = 4,
+    kCompressTypeFieldNumber = 5,
+    kRawSizeFieldNumber = 6,
+    kDictIdFieldNumber = 7,
+    kAcceptDictIdFieldNumber = 8,
+    kStreamMessageFieldNumber = 9,
+    kStreamCreditFieldNumber = 10,
+    kFragmentTotalFieldNumber = 12,
+    kFragmentOffsetFieldNumber = 13,
+    kServerQueueNsFieldNumber = 14,
+    kServerHandlerNsFieldNumber = 15,
+    kServerSerializeNsFieldNumber = 16,
+    kStreamCreditBytesFieldNumber = 11,
+  };
+  // string error = 17;
+  void clear_error();
+  const std::string& error() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_error(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_error();
+  PROTOBUF_NODISCARD std::string* release_error();
+  void set_allocated_error(std::string* error);
+  private:
+  const std::string& _internal_error() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_error(const std::string& value);
+  std::string* _internal_mutable_error();
+  public:
+
+  // .Krpc.BulkDescriptor bulk = 3;
+  bool has_bulk() const;
+  private:
+  bool _internal_has_bulk() const;
+  public:
+  void clear_bulk();
+  const ::Krpc::BulkDescriptor& bulk() const;
+  PROTOBUF_NODISCARD ::Krpc::BulkDescriptor* release_bulk();
+  ::Krpc::BulkDescriptor* mutable_bulk();
+  void set_allocated_bulk(::Krpc::BulkDescriptor* bulk);
+  private:
+  const ::Krpc::BulkDescriptor& _internal_bulk() const;
+  ::Krpc::BulkDescriptor* _internal_mutable_bulk();
+  public:
+  void unsafe_arena_set_allocated_bulk(
+      ::Krpc::BulkDescriptor* bulk);
+  ::Krpc::BulkDescriptor* unsafe_arena_release_bulk();
+
+  // uint64 call_id = 1;
+  void clear_call_id();
+  uint64_t call_id() const;
+  void set_call_id(uint64_t value);
+  private:
+  uint64_t _internal_call_id() const;
+  void _internal_set_call_id(uint64_t value);
+  public:
+
+  // uint32 response_size = 2;
+  void clear_response_size();
+  uint32_t response_size() const;
+  void set_response_size(uint32_t value);
+  private:
+  uint32_t _internal_response_size() const;
+  void _internal_set_response_size(uint32_t value);
+  public:
+
+  // uint32 attachment_size = 4;
+  void clear_attachment_size();
+  uint32_t attachment_size() const;
+  void set_attachment_size(uint32_t value);
+  private:
+  uint32_t _internal_attachment_size() const;
+  void _internal_set_attachment_size(uint32_t value);
+  public:
+
+  // .Krpc.CompressType compress_type = 5;
+  void clear_compress_type();
+  ::Krpc::CompressType compress_type() const;
+  void set_compress_type(::Krpc::CompressType value);
+  private:
+  ::Krpc::CompressType _internal_compress_type() const;
+  void _internal_set_compress_type(::Krpc::CompressType value);
+  public:
+
+  // uint32 raw_size = 6;
+  void clear_raw_size();
+  uint32_t raw_size() const;
+  void set_raw_size(uint32_t value);
+  private:
+  uint32_t _internal_raw_size() const;
+  void _internal_set_raw_size(uint32_t value);
+  public:
+
+  // uint32 dict_id = 7;
+  void clear_dict_id();
+  uint32_t dict_id() const;
+  void set_dict_id(uint32_t value);
+  private:
+  uint32_t _internal_dict_id() const;
+  void _internal_set_dict_id(uint32_t value);
+  public:
+
+  // uint32 accept_dict_id = 8;
+  void clear_accept_dict_id();
+  uint32_t accept_dict_id() const;
+  void set_accept_dict_id(uint32_t value);
+  private:
+  uint32_t _internal_accept_dict_id() const;
+  void _internal_set_accept_dict_id(uint32_t value);
+  public:
+
+  // bool stream_message = 9;
+  void clear_stream_message();
+  bool stream_message() const;
+  void set_stream_message(bool value);
+  private:
+  bool _internal_stream_message() const;
+  void _internal_set_stream_message(bool value);
+  public:
+
+  // uint32 stream_credit = 10;
+  void clear_stream_credit();
+  uint32_t stream_credit() const;
+  void set_stream_credit(uint32_t value);
+  private:
+  uint32_t _internal_stream_credit() const;
+  void _internal_set_stream_credit(uint32_t value);
+  public:
+
+  // uint64 fragment_total = 12;
+  void clear_fragment_total();
+  uint64_t fragment_total() const;
+  void set_fragment_total(uint64_t value);
+  private:
+  uint64_t _internal_fragment_total() const;
+  void _internal_set_fragment_total(uint64_t value);
+  public:
+
+  // uint64 fragment_offset = 13;
+  void clear_fragment_offset();
+  uint64_t fragment_offset() const;
+  void set_fragment_offset(uint64_t value);
+  private:
+  uint64_t _internal_fragment_offset() const;
+  void _internal_set_fragment_offset(uint64_t value);
+  public:
+
+  // uint64 server_queue_ns = 14;
+  void clear_server_queue_ns();
+  uint64_t server_queue_ns() const;
+  void set_server_queue_ns(uint64_t value);
+  private:
+  uint64_t _internal_server_queue_ns() const;
+  void _internal_set_server_queue_ns(uint64_t value);
+  public:
+
+  // uint64 server_handler_ns = 15;
+  void clear_server_handler_ns();
+  uint64_t server_handler_ns() const;
+  void set_server_handler_ns(uint64_t value);
+  private:
+  uint64_t _internal_server_handler_ns() const;
+  void _internal_set_server_handler_ns(uint64_t value);
+  public:
+
+  // uint64 server_serialize_ns = 16;
+  void clear_server_serialize_ns();
+  uint64_t server_serialize_ns() const;
+  void set_server_serialize_ns(uint64_t value);
+  private:
+  uint64_t _internal_server_serialize_ns() const;
+  void _internal_set_server_serialize_ns(uint64_t value);
+  public:
+
+  // uint32 stream_credit_bytes = 11;
+  void clear_stream_credit_bytes();
+  uint32_t stream_credit_bytes() const;
+  void set_stream_credit_bytes(uint32_t value);
+  private:
+  uint32_t _internal_stream_credit_bytes() const;
+  void _internal_set_stream_credit_bytes(uint32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:Krpc.RpcResponseHeader)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr error_;
+    ::Krpc::BulkDescriptor* bulk_;
+    uint64_t call_id_;
+    uint32_t response_size_;
+    uint32_t attachment_size_;
+    int compress_type_;
+    uint32_t raw_size_;
+    uint32_t dict_id_;
+    uint32_t accept_dict_id_;
+    bool stream_message_;
+    uint32_t stream_credit_;
+    uint64_t fragment_total_;
+    uint64_t fragment_offset_;
+    uint64_t server_queue_ns_;
+    uint64_t server_handler_ns_;
+    uint64_t server_serialize_ns_;
+    uint32_t stream_credit_bytes_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_Krpcheader_2eproto;
+};
+// ===================================================================
+
+
+// ===================================================================
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif  // __GNUC__
+// BulkDescriptor
+
+// bytes worker_address = 1;
+inline void BulkDescriptor::clear_worker_address() {
+  _impl_.worker_address_.ClearToEmpty();
+}
+inline const std::string& BulkDescriptor::worker_address() const {
+  // @@protoc_insertion_point(field_get:Krpc.BulkDescriptor.worker_address)
+  return _internal_worker_address();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void BulkDescriptor::set_worker_address(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.worker_address_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:Krpc.BulkDescriptor.worker_address)
+}
+inline std::string* BulkDescriptor::mutable_worker_address() {
+  std::string* _s = _internal_mutable_worker_address();
+  // @@protoc_insertion_point(field_mutable:Krpc.BulkDescriptor.worker_address)
+  return _s;
+}
+inline const std::string& BulkDescriptor::_internal_worker_address() const {
+  return _impl_.worker_address_.Get();
+}
+inline void BulkDescriptor::_internal_set_worker_address(const std::string& value) {
+  
+  _impl_.worker_address_.Set(value, GetArenaForAllocation());
+}
+inline std::string* BulkDescriptor::_internal_mutable_worker_address() {
+  
+  return _impl_.worker_address_.Mutable(GetArenaForAllocation());
+}
+inline std::string* BulkDescriptor::release_worker_address() {
+  // @@protoc_insertion_point(field_release:Krpc.BulkDescriptor.worker_address)
+  return _impl_.worker_address_.Release();
+}
+inline void BulkDescriptor::set_allocated_worker_address(std::string* worker_address) {
+  if (worker_address != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.worker_address_.SetAllocated(worker_address, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.worker_address_.IsDefault()) {
+    _impl_.worker_address_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:Krpc.BulkDescriptor.worker_address)
+}
+
+// uint64 remote_addr = 2;
+inline void BulkDescriptor::clear_remote_addr() {
+  _impl_.remote_addr_ = uint64_t{0u};
+}
+inline uint64_t BulkDescriptor::_internal_remote_addr() const {
+  return _impl_.remote_addr_;
+}
+inline uint64_t BulkDescriptor::remote_addr() const {
+  // @@protoc_insertion_point(field_get:Krpc.BulkDescriptor.remote_addr)
+  return _internal_remote_addr();
+}
+inline void BulkDescriptor::_internal_set_remote_addr(uint64_t value) {
+  
+  _impl_.remote_addr_ = value;
+}
+inline void BulkDescriptor::set_remote_addr(uint64_t value) {
+  _internal_set_remote_addr(value);
+  // @@protoc_insertion_point(field_set:Krpc.BulkDescriptor.remote_addr)
+}
+
+// bytes rkey = 3;
+inline void BulkDescriptor::clear_rkey() {
+  _impl_.rkey_.ClearToEmpty();
+}
+inline const std::string& BulkDescriptor::rkey() const {
+  // @@protoc_insertion_point(field_get:Krpc.BulkDescriptor.rkey)
+  return _internal_rkey();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void BulkDescriptor::set_rkey(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.rkey_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:Krpc.BulkDescriptor.rkey)
+}
+inline std::string* BulkDescriptor::mutable_rkey() {
+  std::string* _s = _internal_mutable_rkey();
+  // @@protoc_insertion_point(field_mutable:Krpc.BulkDescriptor.rkey)
+  return _s;
+}
+inline const std::string& BulkDescriptor::_internal_rkey() const {
+  return _impl_.rkey_.Get();
+}
+inline void BulkDescriptor::_internal_set_rkey(const std::string& value) {
+  
+  _impl_.rkey_.Set(value, GetArenaForAllocation());
+}
+inline std::string* BulkDescriptor::_internal_mutable_rkey() {
+  
+  return _impl_.rkey_.Mutable(GetArenaForAllocation());
+}
+inline std::string* BulkDescriptor::release_rkey() {
+  // @@protoc_insertion_point(field_release:Krpc.BulkDescriptor.rkey)
+  return _impl_.rkey_.Release();
+}
+inline void BulkDescriptor::set_allocated_rkey(std::string* rkey) {
+  if (rkey != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.rkey_.SetAllocated(rkey, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.rkey_.IsDefault()) {
+    _impl_.rkey_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:Krpc.BulkDescriptor.rkey)
+}
+
+// uint64 length = 4;
+inline void BulkDescriptor::clear_length() {
+  _impl_.length_ = uint64_t{0u};
+}
+inline uint64_t BulkDescriptor::_internal_length() const {
+  return _impl_.length_;
+}
+inline uint64_t BulkDescriptor::length() const {
+  // @@protoc_insertion_point(field_get:Krpc.BulkDescriptor.length)
+  return _internal_length();
+}
+inline void BulkDescriptor::_internal_set_length(uint64_t value) {
+  
+  _impl_.length_ = value;
+}
+inline void BulkDescriptor::set_length(uint64_t value) {
+  _internal_set_length(value);
+  // @@protoc_insertion_point(field_set:Krpc.BulkDescriptor.length)
+}
+
+// uint64 bulk_id = 5;
+inline void BulkDescriptor::clear_bulk_id() {
+  _impl_.bulk_id_ = uint64_t{0u};
+}
+inline uint64_t BulkDescriptor::_internal_bulk_id() const {
+  return _impl_.bulk_id_;
+}
+inline uint64_t BulkDescriptor::bulk_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.BulkDescriptor.bulk_id)
+  return _internal_bulk_id();
+}
+inline void BulkDescriptor::_internal_set_bulk_id(uint64_t value) {
+  
+  _impl_.bulk_id_ = value;
+}
+inline void BulkDescriptor::set_bulk_id(uint64_t value) {
+  _internal_set_bulk_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.BulkDescriptor.bulk_id)
+}
+
+// -------------------------------------------------------------------
+
+// TraceContext
+
+// fixed64 trace_id = 1;
+inline void TraceContext::clear_trace_id() {
+  _impl_.trace_id_ = uint64_t{0u};
+}
+inline uint64_t TraceContext::_internal_trace_id() const {
+  return _impl_.trace_id_;
+}
+inline uint64_t TraceContext::trace_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.TraceContext.trace_id)
+  return _internal_trace_id();
+}
+inline void TraceContext::_internal_set_trace_id(uint64_t value) {
+  
+  _impl_.trace_id_ = value;
+}
+inline void TraceContext::set_trace_id(uint64_t value) {
+  _internal_set_trace_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.TraceContext.trace_id)
+}
+
+// fixed64 span_id = 2;
+inline void TraceContext::clear_span_id() {
+  _impl_.span_id_ = uint64_t{0u};
+}
+inline uint64_t TraceContext::_internal_span_id() const {
+  return _impl_.span_id_;
+}
+inline uint64_t TraceContext::span_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.TraceContext.span_id)
+  return _internal_span_id();
+}
+inline void TraceContext::_internal_set_span_id(uint64_t value) {
+  
+  _impl_.span_id_ = value;
+}
+inline void TraceContext::set_span_id(uint64_t value) {
+  _internal_set_span_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.TraceContext.span_id)
+}
+
+// fixed64 parent_span_id = 3;
+inline void TraceContext::clear_parent_span_id() {
+  _impl_.parent_span_id_ = uint64_t{0u};
+}
+inline uint64_t TraceContext::_internal_parent_span_id() const {
+  return _impl_.parent_span_id_;
+}
+inline uint64_t TraceContext::parent_span_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.TraceContext.parent_span_id)
+  return _internal_parent_span_id();
+}
+inline void TraceContext::_internal_set_parent_span_id(uint64_t value) {
+  
+  _impl_.parent_span_id_ = value;
+}
+inline void TraceContext::set_parent_span_id(uint64_t value) {
+  _internal_set_parent_span_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.TraceContext.parent_span_id)
+}
+
+// bool sampled = 4;
+inline void TraceContext::clear_sampled() {
+  _impl_.sampled_ = false;
+}
+inline bool TraceContext::_internal_sampled() const {
+  return _impl_.sampled_;
+}
+inline bool TraceContext::sampled() const {
+  // @@protoc_insertion_point(field_get:Krpc.TraceContext.sampled)
+  return _internal_sampled();
+}
+inline void TraceContext::_internal_set_sampled(bool value) {
+  
+  _impl_.sampled_ = value;
+}
+inline void TraceContext::set_sampled(bool value) {
+  _internal_set_sampled(value);
+  // @@protoc_insertion_point(field_set:Krpc.TraceContext.sampled)
+}
+
+// -------------------------------------------------------------------
+
+// RpcHeader
+
+// bytes service_name = 1;
+inline void RpcHeader::clear_service_name() {
+  _impl_.service_name_.ClearToEmpty();
+}
+inline const std::string& RpcHeader::service_name() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.service_name)
+  return _internal_service_name();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void RpcHeader::set_service_name(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.service_name_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.service_name)
+}
+inline std::string* RpcHeader::mutable_service_name() {
+  std::string* _s = _internal_mutable_service_name();
+  // @@protoc_insertion_point(field_mutable:Krpc.RpcHeader.service_name)
+  return _s;
+}
+inline const std::string& RpcHeader::_internal_service_name() const {
+  return _impl_.service_name_.Get();
+}
 inline void RpcHeader::_internal_set_service_name(const std::string& value) {
   
-  service_name_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), value, GetArena());
+  _impl_.service_name_.Set(value, GetArenaForAllocation());
+}
+inline std::string* RpcHeader::_internal_mutable_service_name() {
+  
+  return _impl_.service_name_.Mutable(GetArenaForAllocation());
+}
+inline std::string* RpcHeader::release_service_name() {
+  // @@protoc_insertion_point(field_release:Krpc.RpcHeader.service_name)
+  return _impl_.service_name_.Release();
+}
+inline void RpcHeader::set_allocated_service_name(std::string* service_name) {
+  if (service_name != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.service_name_.SetAllocated(service_name, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.service_name_.IsDefault()) {
+    _impl_.service_name_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:Krpc.RpcHeader.service_name)
+}
+
+// bytes method_name = 2;
+inline void RpcHeader::clear_method_name() {
+  _impl_.method_name_.ClearToEmpty();
+}
+inline const std::string& RpcHeader::method_name() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.method_name)
+  return _internal_method_name();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void RpcHeader::set_method_name(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.method_name_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.method_name)
+}
+inline std::string* RpcHeader::mutable_method_name() {
+  std::string* _s = _internal_mutable_method_name();
+  // @@protoc_insertion_point(field_mutable:Krpc.RpcHeader.method_name)
+  return _s;
+}
+inline const std::string& RpcHeader::_internal_method_name() const {
+  return _impl_.method_name_.Get();
+}
+inline void RpcHeader::_internal_set_method_name(const std::string& value) {
+  
+  _impl_.method_name_.Set(value, GetArenaForAllocation());
+}
+inline std::string* RpcHeader::_internal_mutable_method_name() {
+  
+  return _impl_.method_name_.Mutable(GetArenaForAllocation());
+}
+inline std::string* RpcHeader::release_method_name() {
+  // @@protoc_insertion_point(field_release:Krpc.RpcHeader.method_name)
+  return _impl_.method_name_.Release();
+}
+inline void RpcHeader::set_allocated_method_name(std::string* method_name) {
+  if (method_name != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.method_name_.SetAllocated(method_name, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.method_name_.IsDefault()) {
+    _impl_.method_name_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:Krpc.RpcHeader.method_name)
+}
+
+// uint32 args_size = 3;
+inline void RpcHeader::clear_args_size() {
+  _impl_.args_size_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_args_size() const {
+  return _impl_.args_size_;
+}
+inline uint32_t RpcHeader::args_size() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.args_size)
+  return _internal_args_size();
+}
+inline void RpcHeader::_internal_set_args_size(uint32_t value) {
+  
+  _impl_.args_size_ = value;
+}
+inline void RpcHeader::set_args_size(uint32_t value) {
+  _internal_set_args_size(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.args_size)
+}
+
+// uint64 call_id = 4;
+inline void RpcHeader::clear_call_id() {
+  _impl_.call_id_ = uint64_t{0u};
+}
+inline uint64_t RpcHeader::_internal_call_id() const {
+  return _impl_.call_id_;
+}
+inline uint64_t RpcHeader::call_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.call_id)
+  return _internal_call_id();
+}
+inline void RpcHeader::_internal_set_call_id(uint64_t value) {
+  
+  _impl_.call_id_ = value;
+}
+inline void RpcHeader::set_call_id(uint64_t value) {
+  _internal_set_call_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.call_id)
+}
+
+// .Krpc.BulkDescriptor bulk = 5;
+inline bool RpcHeader::_internal_has_bulk() const {
+  return this != internal_default_instance() && _impl_.bulk_ != nullptr;
+}
+inline bool RpcHeader::has_bulk() const {
+  return _internal_has_bulk();
+}
+inline void RpcHeader::clear_bulk() {
+  if (GetArenaForAllocation() == nullptr && _impl_.bulk_ != nullptr) {
+    delete _impl_.bulk_;
+  }
+  _impl_.bulk_ = nullptr;
+}
+inline const ::Krpc::BulkDescriptor& RpcHeader::_internal_bulk() const {
+  const ::Krpc::BulkDescriptor* p = _impl_.bulk_;
+  return p != nullptr ? *p : reinterpret_cast<const ::Krpc::BulkDescriptor&>(
+      ::Krpc::_BulkDescriptor_default_instance_);
+}
+inline const ::Krpc::BulkDescriptor& RpcHeader::bulk() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.bulk)
+  return _internal_bulk();
+}
+inline void RpcHeader::unsafe_arena_set_allocated_bulk(
+    ::Krpc::BulkDescriptor* bulk) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.bulk_);
+  }
+  _impl_.bulk_ = bulk;
+  if (bulk) {
+    
+  } else {
+    
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:Krpc.RpcHeader.bulk)
+}
+inline ::Krpc::BulkDescriptor* RpcHeader::release_bulk() {
+  
+  ::Krpc::BulkDescriptor* temp = _impl_.bulk_;
+  _impl_.bulk_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::Krpc::BulkDescriptor* RpcHeader::unsafe_arena_release_bulk() {
+  // @@protoc_insertion_point(field_release:Krpc.RpcHeader.bulk)
+  
+  ::Krpc::BulkDescriptor* temp = _impl_.bulk_;
+  _impl_.bulk_ = nullptr;
+  return temp;
+}
+inline ::Krpc::BulkDescriptor* RpcHeader::_internal_mutable_bulk() {
+  
+  if (_impl_.bulk_ == nullptr) {
+    auto* p = CreateMaybeMessage<::Krpc::BulkDescriptor>(GetArenaForAllocation());
+    _impl_.bulk_ = p;
+  }
+  return _impl_.bulk_;
+}
+inline ::Krpc::BulkDescriptor* RpcHeader::mutable_bulk() {
+  ::Krpc::BulkDescriptor* _msg = _internal_mutable_bulk();
+  // @@protoc_insertion_point(field_mutable:Krpc.RpcHeader.bulk)
+  return _msg;
+}
+inline void RpcHeader::set_allocated_bulk(::Krpc::BulkDescriptor* bulk) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.bulk_;
+  }
+  if (bulk) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(bulk);
+    if (message_arena != submessage_arena) {
+      bulk = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, bulk, submessage_arena);
+    }
+    
+  } else {
+    
+  }
+  _impl_.bulk_ = bulk;
+  // @@protoc_insertion_point(field_set_allocated:Krpc.RpcHeader.bulk)
+}
+
+// bool accept_bulk = 6;
+inline void RpcHeader::clear_accept_bulk() {
+  _impl_.accept_bulk_ = false;
+}
+inline bool RpcHeader::_internal_accept_bulk() const {
+  return _impl_.accept_bulk_;
+}
+inline bool RpcHeader::accept_bulk() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.accept_bulk)
+  return _internal_accept_bulk();
+}
+inline void RpcHeader::_internal_set_accept_bulk(bool value) {
+  
+  _impl_.accept_bulk_ = value;
+}
+inline void RpcHeader::set_accept_bulk(bool value) {
+  _internal_set_accept_bulk(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.accept_bulk)
+}
+
+// uint32 attachment_size = 7;
+inline void RpcHeader::clear_attachment_size() {
+  _impl_.attachment_size_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_attachment_size() const {
+  return _impl_.attachment_size_;
+}
+inline uint32_t RpcHeader::attachment_size() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.attachment_size)
+  return _internal_attachment_size();
+}
+inline void RpcHeader::_internal_set_attachment_size(uint32_t value) {
+  
+  _impl_.attachment_size_ = value;
+}
+inline void RpcHeader::set_attachment_size(uint32_t value) {
+  _internal_set_attachment_size(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.attachment_size)
+}
+
+// .Krpc.CompressType compress_type = 8;
+inline void RpcHeader::clear_compress_type() {
+  _impl_.compress_type_ = 0;
+}
+inline ::Krpc::CompressType RpcHeader::_internal_compress_type() const {
+  return static_cast< ::Krpc::CompressType >(_impl_.compress_type_);
+}
+inline ::Krpc::CompressType RpcHeader::compress_type() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.compress_type)
+  return _internal_compress_type();
+}
+inline void RpcHeader::_internal_set_compress_type(::Krpc::CompressType value) {
+  
+  _impl_.compress_type_ = value;
+}
+inline void RpcHeader::set_compress_type(::Krpc::CompressType value) {
+  _internal_set_compress_type(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.compress_type)
+}
+
+// uint32 raw_size = 9;
+inline void RpcHeader::clear_raw_size() {
+  _impl_.raw_size_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_raw_size() const {
+  return _impl_.raw_size_;
+}
+inline uint32_t RpcHeader::raw_size() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.raw_size)
+  return _internal_raw_size();
+}
+inline void RpcHeader::_internal_set_raw_size(uint32_t value) {
+  
+  _impl_.raw_size_ = value;
+}
+inline void RpcHeader::set_raw_size(uint32_t value) {
+  _internal_set_raw_size(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.raw_size)
+}
+
+// uint32 accept_compress = 10;
+inline void RpcHeader::clear_accept_compress() {
+  _impl_.accept_compress_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_accept_compress() const {
+  return _impl_.accept_compress_;
+}
+inline uint32_t RpcHeader::accept_compress() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.accept_compress)
+  return _internal_accept_compress();
+}
+inline void RpcHeader::_internal_set_accept_compress(uint32_t value) {
+  
+  _impl_.accept_compress_ = value;
+}
+inline void RpcHeader::set_accept_compress(uint32_t value) {
+  _internal_set_accept_compress(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.accept_compress)
+}
+
+// uint32 dict_id = 11;
+inline void RpcHeader::clear_dict_id() {
+  _impl_.dict_id_ = 0u;
 }
-inline void RpcHeader::set_service_name(std::string&& value) {
+inline uint32_t RpcHeader::_internal_dict_id() const {
+  return _impl_.dict_id_;
+}
+inline uint32_t RpcHeader::dict_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.dict_id)
+  return _internal_dict_id();
+}
+inline void RpcHeader::_internal_set_dict_id(uint32_t value) {
   
-  service_name_.Set(
-    &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::move(value), GetArena());
-  // @@protoc_insertion_point(field_set_rvalue:Krpc.RpcHeader.service_name)
+  _impl_.dict_id_ = value;
+}
+inline void RpcHeader::set_dict_id(uint32_t value) {
+  _internal_set_dict_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.dict_id)
+}
+
+// uint32 accept_dict_id = 12;
+inline void RpcHeader::clear_accept_dict_id() {
+  _impl_.accept_dict_id_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_accept_dict_id() const {
+  return _impl_.accept_dict_id_;
 }
-inline void RpcHeader::set_service_name(const char* value) {
-  GOOGLE_DCHECK(value != nullptr);
+inline uint32_t RpcHeader::accept_dict_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.accept_dict_id)
+  return _internal_accept_dict_id();
+}
+inline void RpcHeader::_internal_set_accept_dict_id(uint32_t value) {
   
-  service_name_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::string(value),
-              GetArena());
-  // @@protoc_insertion_point(field_set_char:Krpc.RpcHeader.service_name)
+  _impl_.accept_dict_id_ = value;
+}
+inline void RpcHeader::set_accept_dict_id(uint32_t value) {
+  _internal_set_accept_dict_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.accept_dict_id)
+}
+
+// uint32 stream_window = 13;
+inline void RpcHeader::clear_stream_window() {
+  _impl_.stream_window_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_stream_window() const {
+  return _impl_.stream_window_;
+}
+inline uint32_t RpcHeader::stream_window() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.stream_window)
+  return _internal_stream_window();
 }
-inline void RpcHeader::set_service_name(const void* value,
-    size_t size) {
+inline void RpcHeader::_internal_set_stream_window(uint32_t value) {
   
-  service_name_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::string(
-      reinterpret_cast<const char*>(value), size), GetArena());
-  // @@protoc_insertion_point(field_set_pointer:Krpc.RpcHeader.service_name)
+  _impl_.stream_window_ = value;
 }
-inline std::string* RpcHeader::_internal_mutable_service_name() {
+inline void RpcHeader::set_stream_window(uint32_t value) {
+  _internal_set_stream_window(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.stream_window)
+}
+
+// uint32 stream_credit = 14;
+inline void RpcHeader::clear_stream_credit() {
+  _impl_.stream_credit_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_stream_credit() const {
+  return _impl_.stream_credit_;
+}
+inline uint32_t RpcHeader::stream_credit() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.stream_credit)
+  return _internal_stream_credit();
+}
+inline void RpcHeader::_internal_set_stream_credit(uint32_t value) {
   
-  return service_name_.Mutable(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
+  _impl_.stream_credit_ = value;
 }
-inline std::string* RpcHeader::release_service_name() {
-  // @@protoc_insertion_point(field_release:Krpc.RpcHeader.service_name)
-  return service_name_.Release(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
+inline void RpcHeader::set_stream_credit(uint32_t value) {
+  _internal_set_stream_credit(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.stream_credit)
 }
-inline void RpcHeader::set_allocated_service_name(std::string* service_name) {
-  if (service_name != nullptr) {
+
+// uint32 stream_window_bytes = 15;
+inline void RpcHeader::clear_stream_window_bytes() {
+  _impl_.stream_window_bytes_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_stream_window_bytes() const {
+  return _impl_.stream_window_bytes_;
+}
+inline uint32_t RpcHeader::stream_window_bytes() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.stream_window_bytes)
+  return _internal_stream_window_bytes();
+}
+inline void RpcHeader::_internal_set_stream_window_bytes(uint32_t value) {
+  
+  _impl_.stream_window_bytes_ = value;
+}
+inline void RpcHeader::set_stream_window_bytes(uint32_t value) {
+  _internal_set_stream_window_bytes(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.stream_window_bytes)
+}
+
+// uint32 stream_credit_bytes = 16;
+inline void RpcHeader::clear_stream_credit_bytes() {
+  _impl_.stream_credit_bytes_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_stream_credit_bytes() const {
+  return _impl_.stream_credit_bytes_;
+}
+inline uint32_t RpcHeader::stream_credit_bytes() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.stream_credit_bytes)
+  return _internal_stream_credit_bytes();
+}
+inline void RpcHeader::_internal_set_stream_credit_bytes(uint32_t value) {
+  
+  _impl_.stream_credit_bytes_ = value;
+}
+inline void RpcHeader::set_stream_credit_bytes(uint32_t value) {
+  _internal_set_stream_credit_bytes(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.stream_credit_bytes)
+}
+
+// bool bidi_stream = 17;
+inline void RpcHeader::clear_bidi_stream() {
+  _impl_.bidi_stream_ = false;
+}
+inline bool RpcHeader::_internal_bidi_stream() const {
+  return _impl_.bidi_stream_;
+}
+inline bool RpcHeader::bidi_stream() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.bidi_stream)
+  return _internal_bidi_stream();
+}
+inline void RpcHeader::_internal_set_bidi_stream(bool value) {
+  
+  _impl_.bidi_stream_ = value;
+}
+inline void RpcHeader::set_bidi_stream(bool value) {
+  _internal_set_bidi_stream(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.bidi_stream)
+}
+
+// bool stream_message = 18;
+inline void RpcHeader::clear_stream_message() {
+  _impl_.stream_message_ = false;
+}
+inline bool RpcHeader::_internal_stream_message() const {
+  return _impl_.stream_message_;
+}
+inline bool RpcHeader::stream_message() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.stream_message)
+  return _internal_stream_message();
+}
+inline void RpcHeader::_internal_set_stream_message(bool value) {
+  
+  _impl_.stream_message_ = value;
+}
+inline void RpcHeader::set_stream_message(bool value) {
+  _internal_set_stream_message(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.stream_message)
+}
+
+// bool stream_end = 19;
+inline void RpcHeader::clear_stream_end() {
+  _impl_.stream_end_ = false;
+}
+inline bool RpcHeader::_internal_stream_end() const {
+  return _impl_.stream_end_;
+}
+inline bool RpcHeader::stream_end() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.stream_end)
+  return _internal_stream_end();
+}
+inline void RpcHeader::_internal_set_stream_end(bool value) {
+  
+  _impl_.stream_end_ = value;
+}
+inline void RpcHeader::set_stream_end(bool value) {
+  _internal_set_stream_end(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.stream_end)
+}
+
+// bool accept_fragment = 20;
+inline void RpcHeader::clear_accept_fragment() {
+  _impl_.accept_fragment_ = false;
+}
+inline bool RpcHeader::_internal_accept_fragment() const {
+  return _impl_.accept_fragment_;
+}
+inline bool RpcHeader::accept_fragment() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.accept_fragment)
+  return _internal_accept_fragment();
+}
+inline void RpcHeader::_internal_set_accept_fragment(bool value) {
+  
+  _impl_.accept_fragment_ = value;
+}
+inline void RpcHeader::set_accept_fragment(bool value) {
+  _internal_set_accept_fragment(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.accept_fragment)
+}
+
+// uint32 priority = 21;
+inline void RpcHeader::clear_priority() {
+  _impl_.priority_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_priority() const {
+  return _impl_.priority_;
+}
+inline uint32_t RpcHeader::priority() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.priority)
+  return _internal_priority();
+}
+inline void RpcHeader::_internal_set_priority(uint32_t value) {
+  
+  _impl_.priority_ = value;
+}
+inline void RpcHeader::set_priority(uint32_t value) {
+  _internal_set_priority(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.priority)
+}
+
+// .Krpc.TraceContext trace = 22;
+inline bool RpcHeader::_internal_has_trace() const {
+  return this != internal_default_instance() && _impl_.trace_ != nullptr;
+}
+inline bool RpcHeader::has_trace() const {
+  return _internal_has_trace();
+}
+inline void RpcHeader::clear_trace() {
+  if (GetArenaForAllocation() == nullptr && _impl_.trace_ != nullptr) {
+    delete _impl_.trace_;
+  }
+  _impl_.trace_ = nullptr;
+}
+inline const ::Krpc::TraceContext& RpcHeader::_internal_trace() const {
+  const ::Krpc::TraceContext* p = _impl_.trace_;
+  return p != nullptr ? *p : reinterpret_cast<const ::Krpc::TraceContext&>(
+      ::Krpc::_TraceContext_default_instance_);
+}
+inline const ::Krpc::TraceContext& RpcHeader::trace() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.trace)
+  return _internal_trace();
+}
+inline void RpcHeader::unsafe_arena_set_allocated_trace(
+    ::Krpc::TraceContext* trace) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.trace_);
+  }
+  _impl_.trace_ = trace;
+  if (trace) {
     
   } else {
     
   }
-  service_name_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), service_name,
-      GetArena());
-  // @@protoc_insertion_point(field_set_allocated:Krpc.RpcHeader.service_name)
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:Krpc.RpcHeader.trace)
 }
-inline std::string* RpcHeader::unsafe_arena_release_service_name() {
-  // @@protoc_insertion_point(field_unsafe_arena_release:Krpc.RpcHeader.service_name)
-  GOOGLE_DCHECK(GetArena() != nullptr);
+inline ::Krpc::TraceContext* RpcHeader::release_trace() {
   
-  return service_name_.UnsafeArenaRelease(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
-      GetArena());
+  ::Krpc::TraceContext* temp = _impl_.trace_;
+  _impl_.trace_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
 }
-inline void RpcHeader::unsafe_arena_set_allocated_service_name(
-    std::string* service_name) {
-  GOOGLE_DCHECK(GetArena() != nullptr);
-  if (service_name != nullptr) {
+inline ::Krpc::TraceContext* RpcHeader::unsafe_arena_release_trace() {
+  // @@protoc_insertion_point(field_release:Krpc.RpcHeader.trace)
+  
+  ::Krpc::TraceContext* temp = _impl_.trace_;
+  _impl_.trace_ = nullptr;
+  return temp;
+}
+inline ::Krpc::TraceContext* RpcHeader::_internal_mutable_trace() {
+  
+  if (_impl_.trace_ == nullptr) {
+    auto* p = CreateMaybeMessage<::Krpc::TraceContext>(GetArenaForAllocation());
+    _impl_.trace_ = p;
+  }
+  return _impl_.trace_;
+}
+inline ::Krpc::TraceContext* RpcHeader::mutable_trace() {
+  ::Krpc::TraceContext* _msg = _internal_mutable_trace();
+  // @@protoc_insertion_point(field_mutable:Krpc.RpcHeader.trace)
+  return _msg;
+}
+inline void RpcHeader::set_allocated_trace(::Krpc::TraceContext* trace) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.trace_;
+  }
+  if (trace) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(trace);
+    if (message_arena != submessage_arena) {
+      trace = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, trace, submessage_arena);
+    }
     
   } else {
     
   }
-  service_name_.UnsafeArenaSetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
-      service_name, GetArena());
-  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:Krpc.RpcHeader.service_name)
+  _impl_.trace_ = trace;
+  // @@protoc_insertion_point(field_set_allocated:Krpc.RpcHeader.trace)
 }
 
-// bytes method_name = 2;
-inline void RpcHeader::clear_method_name() {
-  method_name_.ClearToEmpty(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
+// bool framed_response = 23;
+inline void RpcHeader::clear_framed_response() {
+  _impl_.framed_response_ = false;
 }
-inline const std::string& RpcHeader::method_name() const {
-  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.method_name)
-  return _internal_method_name();
+inline bool RpcHeader::_internal_framed_response() const {
+  return _impl_.framed_response_;
 }
-inline void RpcHeader::set_method_name(const std::string& value) {
-  _internal_set_method_name(value);
-  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.method_name)
+inline bool RpcHeader::framed_response() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.framed_response)
+  return _internal_framed_response();
 }
-inline std::string* RpcHeader::mutable_method_name() {
-  // @@protoc_insertion_point(field_mutable:Krpc.RpcHeader.method_name)
-  return _internal_mutable_method_name();
+inline void RpcHeader::_internal_set_framed_response(bool value) {
+  
+  _impl_.framed_response_ = value;
 }
-inline const std::string& RpcHeader::_internal_method_name() const {
-  return method_name_.Get();
+inline void RpcHeader::set_framed_response(bool value) {
+  _internal_set_framed_response(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.framed_response)
 }
-inline void RpcHeader::_internal_set_method_name(const std::string& value) {
-  
-  method_name_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), value, GetArena());
+
+// -------------------------------------------------------------------
+
+// RpcResponseHeader
+
+// uint64 call_id = 1;
+inline void RpcResponseHeader::clear_call_id() {
+  _impl_.call_id_ = uint64_t{0u};
 }
-inline void RpcHeader::set_method_name(std::string&& value) {
-  
-  method_name_.Set(
-    &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::move(value), GetArena());
-  // @@protoc_insertion_point(field_set_rvalue:Krpc.RpcHeader.method_name)
+inline uint64_t RpcResponseHeader::_internal_call_id() const {
+  return _impl_.call_id_;
 }
-inline void RpcHeader::set_method_name(const char* value) {
-  GOOGLE_DCHECK(value != nullptr);
-  
-  method_name_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::string(value),
-              GetArena());
-  // @@protoc_insertion_point(field_set_char:Krpc.RpcHeader.method_name)
+inline uint64_t RpcResponseHeader::call_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.call_id)
+  return _internal_call_id();
 }
-inline void RpcHeader::set_method_name(const void* value,
-    size_t size) {
+inline void RpcResponseHeader::_internal_set_call_id(uint64_t value) {
   
-  method_name_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ::std::string(
-      reinterpret_cast<const char*>(value), size), GetArena());
-  // @@protoc_insertion_point(field_set_pointer:Krpc.RpcHeader.method_name)
+  _impl_.call_id_ = value;
 }
-inline std::string* RpcHeader::_internal_mutable_method_name() {
+inline void RpcResponseHeader::set_call_id(uint64_t value) {
+  _internal_set_call_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.call_id)
+}
+
+// uint32 response_size = 2;
+inline void RpcResponseHeader::clear_response_size() {
+  _impl_.response_size_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_response_size() const {
+  return _impl_.response_size_;
+}
+inline uint32_t RpcResponseHeader::response_size() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.response_size)
+  return _internal_response_size();
+}
+inline void RpcResponseHeader::_internal_set_response_size(uint32_t value) {
   
-  return method_name_.Mutable(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
+  _impl_.response_size_ = value;
 }
-inline std::string* RpcHeader::release_method_name() {
-  // @@protoc_insertion_point(field_release:Krpc.RpcHeader.method_name)
-  return method_name_.Release(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArena());
+inline void RpcResponseHeader::set_response_size(uint32_t value) {
+  _internal_set_response_size(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.response_size)
 }
-inline void RpcHeader::set_allocated_method_name(std::string* method_name) {
-  if (method_name != nullptr) {
+
+// .Krpc.BulkDescriptor bulk = 3;
+inline bool RpcResponseHeader::_internal_has_bulk() const {
+  return this != internal_default_instance() && _impl_.bulk_ != nullptr;
+}
+inline bool RpcResponseHeader::has_bulk() const {
+  return _internal_has_bulk();
+}
+inline void RpcResponseHeader::clear_bulk() {
+  if (GetArenaForAllocation() == nullptr && _impl_.bulk_ != nullptr) {
+    delete _impl_.bulk_;
+  }
+  _impl_.bulk_ = nullptr;
+}
+inline const ::Krpc::BulkDescriptor& RpcResponseHeader::_internal_bulk() const {
+  const ::Krpc::BulkDescriptor* p = _impl_.bulk_;
+  return p != nullptr ? *p : reinterpret_cast<const ::Krpc::BulkDescriptor&>(
+      ::Krpc::_BulkDescriptor_default_instance_);
+}
+inline const ::Krpc::BulkDescriptor& RpcResponseHeader::bulk() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.bulk)
+  return _internal_bulk();
+}
+inline void RpcResponseHeader::unsafe_arena_set_allocated_bulk(
+    ::Krpc::BulkDescriptor* bulk) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.bulk_);
+  }
+  _impl_.bulk_ = bulk;
+  if (bulk) {
     
   } else {
     
   }
-  method_name_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), method_name,
-      GetArena());
-  // @@protoc_insertion_point(field_set_allocated:Krpc.RpcHeader.method_name)
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:Krpc.RpcResponseHeader.bulk)
 }
-inline std::string* RpcHeader::unsafe_arena_release_method_name() {
-  // @@protoc_insertion_point(field_unsafe_arena_release:Krpc.RpcHeader.method_name)
-  GOOGLE_DCHECK(GetArena() != nullptr);
+inline ::Krpc::BulkDescriptor* RpcResponseHeader::release_bulk() {
   
-  return method_name_.UnsafeArenaRelease(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
-      GetArena());
+  ::Krpc::BulkDescriptor* temp = _impl_.bulk_;
+  _impl_.bulk_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
 }
-inline void RpcHeader::unsafe_arena_set_allocated_method_name(
-    std::string* method_name) {
-  GOOGLE_DCHECK(GetArena() != nullptr);
-  if (method_name != nullptr) {
+inline ::Krpc::BulkDescriptor* RpcResponseHeader::unsafe_arena_release_bulk() {
+  // @@protoc_insertion_point(field_release:Krpc.RpcResponseHeader.bulk)
+  
+  ::Krpc::BulkDescriptor* temp = _impl_.bulk_;
+  _impl_.bulk_ = nullptr;
+  return temp;
+}
+inline ::Krpc::BulkDescriptor* RpcResponseHeader::_internal_mutable_bulk() {
+  
+  if (_impl_.bulk_ == nullptr) {
+    auto* p = CreateMaybeMessage<::Krpc::BulkDescriptor>(GetArenaForAllocation());
+    _impl_.bulk_ = p;
+  }
+  return _impl_.bulk_;
+}
+inline ::Krpc::BulkDescriptor* RpcResponseHeader::mutable_bulk() {
+  ::Krpc::BulkDescriptor* _msg = _internal_mutable_bulk();
+  // @@protoc_insertion_point(field_mutable:Krpc.RpcResponseHeader.bulk)
+  return _msg;
+}
+inline void RpcResponseHeader::set_allocated_bulk(::Krpc::BulkDescriptor* bulk) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete _impl_.bulk_;
+  }
+  if (bulk) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(bulk);
+    if (message_arena != submessage_arena) {
+      bulk = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, bulk, submessage_arena);
+    }
     
   } else {
     
   }
-  method_name_.UnsafeArenaSetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
-      method_name, GetArena());
-  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:Krpc.RpcHeader.method_name)
+  _impl_.bulk_ = bulk;
+  // @@protoc_insertion_point(field_set_allocated:Krpc.RpcResponseHeader.bulk)
 }
 
-// uint32 args_size = 3;
-inline void RpcHeader::clear_args_size() {
-  args_size_ = 0u;
+// uint32 attachment_size = 4;
+inline void RpcResponseHeader::clear_attachment_size() {
+  _impl_.attachment_size_ = 0u;
 }
-inline ::PROTOBUF_NAMESPACE_ID::uint32 RpcHeader::_internal_args_size() const {
-  return args_size_;
+inline uint32_t RpcResponseHeader::_internal_attachment_size() const {
+  return _impl_.attachment_size_;
 }
-inline ::PROTOBUF_NAMESPACE_ID::uint32 RpcHeader::args_size() const {
-  // @@protoc_insertion_point(field_get:Krpc.RpcHeader.args_size)
-  return _internal_args_size();
+inline uint32_t RpcResponseHeader::attachment_size() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.attachment_size)
+  return _internal_attachment_size();
 }
-inline void RpcHeader::_internal_set_args_size(::PROTOBUF_NAMESPACE_ID::uint32 value) {
+inline void RpcResponseHeader::_internal_set_attachment_size(uint32_t value) {
   
-  args_size_ = value;
+  _impl_.attachment_size_ = value;
 }
-inline void RpcHeader::set_args_size(::PROTOBUF_NAMESPACE_ID::uint32 value) {
-  _internal_set_args_size(value);
-  // @@protoc_insertion_point(field_set:Krpc.RpcHeader.args_size)
+inline void RpcResponseHeader::set_attachment_size(uint32_t value) {
+  _internal_set_attachment_size(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.attachment_size)
+}
+
+// .Krpc.CompressType compress_type = 5;
+inline void RpcResponseHeader::clear_compress_type() {
+  _impl_.compress_type_ = 0;
+}
+inline ::Krpc::CompressType RpcResponseHeader::_internal_compress_type() const {
+  return static_cast< ::Krpc::CompressType >(_impl_.compress_type_);
+}
+inline ::Krpc::CompressType RpcResponseHeader::compress_type() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.compress_type)
+  return _internal_compress_type();
+}
+inline void RpcResponseHeader::_internal_set_compress_type(::Krpc::CompressType value) {
+  
+  _impl_.compress_type_ = value;
+}
+inline void RpcResponseHeader::set_compress_type(::Krpc::CompressType value) {
+  _internal_set_compress_type(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.compress_type)
+}
+
+// uint32 raw_size = 6;
+inline void RpcResponseHeader::clear_raw_size() {
+  _impl_.raw_size_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_raw_size() const {
+  return _impl_.raw_size_;
+}
+inline uint32_t RpcResponseHeader::raw_size() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.raw_size)
+  return _internal_raw_size();
+}
+inline void RpcResponseHeader::_internal_set_raw_size(uint32_t value) {
+  
+  _impl_.raw_size_ = value;
+}
+inline void RpcResponseHeader::set_raw_size(uint32_t value) {
+  _internal_set_raw_size(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.raw_size)
+}
+
+// uint32 dict_id = 7;
+inline void RpcResponseHeader::clear_dict_id() {
+  _impl_.dict_id_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_dict_id() const {
+  return _impl_.dict_id_;
+}
+inline uint32_t RpcResponseHeader::dict_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.dict_id)
+  return _internal_dict_id();
+}
+inline void RpcResponseHeader::_internal_set_dict_id(uint32_t value) {
+  
+  _impl_.dict_id_ = value;
+}
+inline void RpcResponseHeader::set_dict_id(uint32_t value) {
+  _internal_set_dict_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.dict_id)
+}
+
+// uint32 accept_dict_id = 8;
+inline void RpcResponseHeader::clear_accept_dict_id() {
+  _impl_.accept_dict_id_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_accept_dict_id() const {
+  return _impl_.accept_dict_id_;
+}
+inline uint32_t RpcResponseHeader::accept_dict_id() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.accept_dict_id)
+  return _internal_accept_dict_id();
+}
+inline void RpcResponseHeader::_internal_set_accept_dict_id(uint32_t value) {
+  
+  _impl_.accept_dict_id_ = value;
+}
+inline void RpcResponseHeader::set_accept_dict_id(uint32_t value) {
+  _internal_set_accept_dict_id(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.accept_dict_id)
+}
+
+// bool stream_message = 9;
+inline void RpcResponseHeader::clear_stream_message() {
+  _impl_.stream_message_ = false;
+}
+inline bool RpcResponseHeader::_internal_stream_message() const {
+  return _impl_.stream_message_;
+}
+inline bool RpcResponseHeader::stream_message() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.stream_message)
+  return _internal_stream_message();
+}
+inline void RpcResponseHeader::_internal_set_stream_message(bool value) {
+  
+  _impl_.stream_message_ = value;
+}
+inline void RpcResponseHeader::set_stream_message(bool value) {
+  _internal_set_stream_message(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.stream_message)
+}
+
+// uint32 stream_credit = 10;
+inline void RpcResponseHeader::clear_stream_credit() {
+  _impl_.stream_credit_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_stream_credit() const {
+  return _impl_.stream_credit_;
+}
+inline uint32_t RpcResponseHeader::stream_credit() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.stream_credit)
+  return _internal_stream_credit();
+}
+inline void RpcResponseHeader::_internal_set_stream_credit(uint32_t value) {
+  
+  _impl_.stream_credit_ = value;
+}
+inline void RpcResponseHeader::set_stream_credit(uint32_t value) {
+  _internal_set_stream_credit(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.stream_credit)
+}
+
+// uint32 stream_credit_bytes = 11;
+inline void RpcResponseHeader::clear_stream_credit_bytes() {
+  _impl_.stream_credit_bytes_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_stream_credit_bytes() const {
+  return _impl_.stream_credit_bytes_;
+}
+inline uint32_t RpcResponseHeader::stream_credit_bytes() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.stream_credit_bytes)
+  return _internal_stream_credit_bytes();
+}
+inline void RpcResponseHeader::_internal_set_stream_credit_bytes(uint32_t value) {
+  
+  _impl_.stream_credit_bytes_ = value;
+}
+inline void RpcResponseHeader::set_stream_credit_bytes(uint32_t value) {
+  _internal_set_stream_credit_bytes(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.stream_credit_bytes)
+}
+
+// uint64 fragment_total = 12;
+inline void RpcResponseHeader::clear_fragment_total() {
+  _impl_.fragment_total_ = uint64_t{0u};
+}
+inline uint64_t RpcResponseHeader::_internal_fragment_total() const {
+  return _impl_.fragment_total_;
+}
+inline uint64_t RpcResponseHeader::fragment_total() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.fragment_total)
+  return _internal_fragment_total();
+}
+inline void RpcResponseHeader::_internal_set_fragment_total(uint64_t value) {
+  
+  _impl_.fragment_total_ = value;
+}
+inline void RpcResponseHeader::set_fragment_total(uint64_t value) {
+  _internal_set_fragment_total(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.fragment_total)
+}
+
+// uint64 fragment_offset = 13;
+inline void RpcResponseHeader::clear_fragment_offset() {
+  _impl_.fragment_offset_ = uint64_t{0u};
+}
+inline uint64_t RpcResponseHeader::_internal_fragment_offset() const {
+  return _impl_.fragment_offset_;
+}
+inline uint64_t RpcResponseHeader::fragment_offset() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.fragment_offset)
+  return _internal_fragment_offset();
+}
+inline void RpcResponseHeader::_internal_set_fragment_offset(uint64_t value) {
+  
+  _impl_.fragment_offset_ = value;
+}
+inline void RpcResponseHeader::set_fragment_offset(uint64_t value) {
+  _internal_set_fragment_offset(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.fragment_offset)
+}
+
+// uint64 server_queue_ns = 14;
+inline void RpcResponseHeader::clear_server_queue_ns() {
+  _impl_.server_queue_ns_ = uint64_t{0u};
+}
+inline uint64_t RpcResponseHeader::_internal_server_queue_ns() const {
+  return _impl_.server_queue_ns_;
+}
+inline uint64_t RpcResponseHeader::server_queue_ns() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.server_queue_ns)
+  return _internal_server_queue_ns();
+}
+inline void RpcResponseHeader::_internal_set_server_queue_ns(uint64_t value) {
+  
+  _impl_.server_queue_ns_ = value;
+}
+inline void RpcResponseHeader::set_server_queue_ns(uint64_t value) {
+  _internal_set_server_queue_ns(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.server_queue_ns)
+}
+
+// uint64 server_handler_ns = 15;
+inline void RpcResponseHeader::clear_server_handler_ns() {
+  _impl_.server_handler_ns_ = uint64_t{0u};
+}
+inline uint64_t RpcResponseHeader::_internal_server_handler_ns() const {
+  return _impl_.server_handler_ns_;
+}
+inline uint64_t RpcResponseHeader::server_handler_ns() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.server_handler_ns)
+  return _internal_server_handler_ns();
+}
+inline void RpcResponseHeader::_internal_set_server_handler_ns(uint64_t value) {
+  
+  _impl_.server_handler_ns_ = value;
+}
+inline void RpcResponseHeader::set_server_handler_ns(uint64_t value) {
+  _internal_set_server_handler_ns(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.server_handler_ns)
+}
+
+// uint64 server_serialize_ns = 16;
+inline void RpcResponseHeader::clear_server_serialize_ns() {
+  _impl_.server_serialize_ns_ = uint64_t{0u};
+}
+inline uint64_t RpcResponseHeader::_internal_server_serialize_ns() const {
+  return _impl_.server_serialize_ns_;
+}
+inline uint64_t RpcResponseHeader::server_serialize_ns() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.server_serialize_ns)
+  return _internal_server_serialize_ns();
+}
+inline void RpcResponseHeader::_internal_set_server_serialize_ns(uint64_t value) {
+  
+  _impl_.server_serialize_ns_ = value;
+}
+inline void RpcResponseHeader::set_server_serialize_ns(uint64_t value) {
+  _internal_set_server_serialize_ns(value);
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.server_serialize_ns)
+}
+
+// string error = 17;
+inline void RpcResponseHeader::clear_error() {
+  _impl_.error_.ClearToEmpty();
+}
+inline const std::string& RpcResponseHeader::error() const {
+  // @@protoc_insertion_point(field_get:Krpc.RpcResponseHeader.error)
+  return _internal_error();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void RpcResponseHeader::set_error(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.error_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:Krpc.RpcResponseHeader.error)
+}
+inline std::string* RpcResponseHeader::mutable_error() {
+  std::string* _s = _internal_mutable_error();
+  // @@protoc_insertion_point(field_mutable:Krpc.RpcResponseHeader.error)
+  return _s;
+}
+inline const std::string& RpcResponseHeader::_internal_error() const {
+  return _impl_.error_.Get();
+}
+inline void RpcResponseHeader::_internal_set_error(const std::string& value) {
+  
+  _impl_.error_.Set(value, GetArenaForAllocation());
+}
+inline std::string* RpcResponseHeader::_internal_mutable_error() {
+  
+  return _impl_.error_.Mutable(GetArenaForAllocation());
+}
+inline std::string* RpcResponseHeader::release_error() {
+  // @@protoc_insertion_point(field_release:Krpc.RpcResponseHeader.error)
+  return _impl_.error_.Release();
+}
+inline void RpcResponseHeader::set_allocated_error(std::string* error) {
+  if (error != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.error_.SetAllocated(error, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.error_.IsDefault()) {
+    _impl_.error_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:Krpc.RpcResponseHeader.error)
 }
 
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
 }  // namespace Krpc
 
+PROTOBUF_NAMESPACE_OPEN
+
+template <> struct is_proto_enum< ::Krpc::CompressType> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::Krpc::CompressType>() {
+  return ::Krpc::CompressType_descriptor();
+}
+
+PROTOBUF_NAMESPACE_CLOSE
+
 // @@protoc_insertion_point(global_scope)
 
 #include <google/protobuf/port_undef.inc>
@@ -2,10 +2,52 @@
 #include "Krpcapplication.h"
 #include "Krpcheader.pb.h"
 #include "KrpcLogger.h"
-#include "EpollServer.h"
+#include "Krpccodec.h"
+#include "KrpcAffinity.h"
+#include "Krpcendpoint.h"
+#include "Krpccontroller.h"
+#include "KrpcMetrics.h"
+#include "KrpcTrace.h"
+#include "KrpcResource.h"
+#include "KrpcProbes.h"
+#include "KrpcLog.h"
+#include "KrpcCapture.h"
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <malloc.h>
 #include <muduo/base/Logging.h>
 
+namespace {
+// 将任意可调用对象包装成protobuf的Closure，Run之后自动释放自身
+class KrpcClosure : public google::protobuf::Closure {
+public:
+    explicit KrpcClosure(std::function<void()> fn) : fn_(std::move(fn)) {}
+    void Run() override {
+        fn_();
+        delete this;
+    }
+
+private:
+    std::function<void()> fn_;
+};
+
+const size_t kDefaultFragmentBytes = 256 * 1024;  // 默认的分片大小
+
+int64_t NowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 服务端三个阶段的耗时写入响应头，序列化阶段从serialize_start_ns算到写入头部之前
+void SetServerPhases(Krpc::RpcResponseHeader *header, uint64_t queue_ns, uint64_t handler_ns, int64_t serialize_start_ns) {
+    header->set_server_queue_ns(queue_ns);
+    header->set_server_handler_ns(handler_ns);
+    header->set_server_serialize_ns(static_cast<uint64_t>(NowNanos() - serialize_start_ns));
+}
+}  // namespace
+
 // 注册服务对象及其方法，以便服务端能够处理客户端的RPC请求
 void KrpcProvider::NotifyService(google::protobuf::Service *service) {
     // 服务端需要知道客户端想要调用的服务对象和方法，
@@ -29,15 +71,17 @@ void KrpcProvider::NotifyService(google::protobuf::Service *service) {
     int method_count = psd->method_count();
 
     // 打印服务名
-    std::cout << "service_name=" << service_name << std::endl;
+    KRPC_LOG_INFO("service_name={}", service_name);
 
     // 遍历服务中的所有方法，并注册到服务信息中
     for (int i = 0; i < method_count; ++i) {
         // 获取服务中的方法描述
         const google::protobuf::MethodDescriptor *pmd = psd->method(i);
         std::string method_name = pmd->name();
-        std::cout << "method_name=" << method_name << std::endl;
+        KRPC_LOG_INFO("method_name={}", method_name);
         service_info.method_map.emplace(method_name, pmd);  // 将方法名和方法描述符存入map
+        service_info.compress_threshold[method_name] = KrpcCompressPolicy::Instance().Threshold(service_name, method_name);
+        service_info.metrics_id[method_name] = KrpcMetrics::Instance().MethodId(KrpcMetrics::kServer, service_name, method_name);
     }
     service_info.service = service;  // 保存服务对象
     service_map.emplace(service_name, service_info);  // 将服务信息存入服务map
@@ -64,11 +108,92 @@ void KrpcProvider::Run() {
     server->setConnectionCallback(std::bind(&KrpcProvider::OnConnection, this, std::placeholders::_1));
     server->setMessageCallback(std::bind(&KrpcProvider::OnMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
     
+    // 低延迟模式：IO线程绑定到指定的CPU上。muduo的EventLoop总是阻塞在epoll_wait上，不能在用户态自旋，
+    // 需要轮询时由内核的net.core.busy_poll/busy_read在epoll_wait和recv中轮询网卡队列
+    std::vector<int> reactor_cpus = KrpcAffinity::CpusFromConfig("reactor_cpus");
+    if (!reactor_cpus.empty()) {
+        auto next_cpu = std::make_shared<std::atomic<size_t>>(0);
+        server->setThreadInitCallback([reactor_cpus, next_cpu](muduo::net::EventLoop *) {
+            // 每个IO线程独占列表中的一个CPU，线程数多于CPU数时循环使用
+            KrpcAffinity::PinCurrentThread(reactor_cpus[(*next_cpu)++ % reactor_cpus.size()]);
+        });
+    }
+
+    // 大响应分片发送，避免挡住同一连接上的小响应
+    std::string fragment_conf = KrpcApplication::GetInstance().GetConfig().Load("fragment_bytes");
+    fragment_bytes = fragment_conf.empty() ? kDefaultFragmentBytes : static_cast<size_t>(atol(fragment_conf.c_str()));
+    // 每个请求多两次读取线程CPU时间的系统调用，对延迟极敏感时可以关闭
+    resource_accounting = KrpcApplication::GetInstance().GetConfig().Load("resource_accounting") != "0";
+
     // 设置muduo库的线程数量
     server->setThreadNum(10);
 
+    // 启动网络服务
+    server->start();
+    io_loops = server->threadPool()->getAllLoops();
+
+    // 同一台机器上的调用方可以通过Unix域套接字访问，绕过TCP协议栈
+    KrpcEndpoint endpoint;
+    endpoint.ip = ip;
+    endpoint.port = static_cast<uint16_t>(port);
+    endpoint.host_id = KrpcEndpoint::LocalHostId();
+    std::string unix_path = KrpcApplication::GetInstance().GetConfig().Load("rpcserverunixpath");
+    if (!unix_path.empty()) {
+        unix_server.reset(new KrpcUnixServer(&event_loop, unix_path));
+        unix_server->setConnectionCallback(std::bind(&KrpcProvider::OnConnection, this, std::placeholders::_1));
+        unix_server->setMessageCallback(std::bind(&KrpcProvider::OnMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+        if (unix_server->Start(server->threadPool())) {
+            endpoint.unix_path = unix_path;
+        } else {
+            unix_server.reset();
+        }
+    }
+    // 共享内存通道：客户端通过该Unix域套接字传来memfd，之后请求和响应都在共享内存中收发
+    std::string shm_path = KrpcApplication::GetInstance().GetConfig().Load("rpcservershmpath");
+    if (!shm_path.empty()) {
+        shm_server.reset(new KrpcShmServer(&event_loop, shm_path));
+        shm_server->setRequestCallback(std::bind(&KrpcProvider::HandleRequest, this, std::placeholders::_1,
+                                                 std::placeholders::_2, std::placeholders::_3, std::placeholders::_4,
+                                                 std::placeholders::_5, KrpcServerStream(), 0));
+        if (shm_server->Start(server->threadPool())) {
+            endpoint.shm_path = shm_path;
+        } else {
+            shm_server.reset();
+        }
+    }
+    // UCX传输：有RDMA网卡时绕过内核协议栈；也可以通过ucx_transports限定为tcp,shm等普通传输
+    std::string ucx_port = KrpcApplication::GetInstance().GetConfig().Load("rpcserverucxport");
+    if (!ucx_port.empty()) {
+#ifdef KRPC_WITH_UCX
+        std::shared_ptr<UCXContext> ucx_context = KrpcSharedUcxContext();
+        if (ucx_context) {
+            ucx_server.reset(new UCXServer(ucx_context));
+            ucx_server->setMessageCallback(std::bind(&KrpcProvider::OnUcxMessage, this, std::placeholders::_1,
+                                                     std::placeholders::_2, std::placeholders::_3,
+                                                     std::placeholders::_4));
+            ucx_server->setMaxMessageSize(KrpcCodec::MaxFrameSize());
+            if (ucx_server->start(ip, static_cast<uint16_t>(atoi(ucx_port.c_str())))) {
+                endpoint.ucx_port = static_cast<uint16_t>(atoi(ucx_port.c_str()));
+            } else {
+                ucx_server.reset();
+            }
+        }
+#else
+        KRPC_LOG_WARNING("rpcserverucxport is set but krpc was built without UCX, ignored");
+#endif
+    }
+#ifdef KRPC_WITH_UCX
+    // 大负载旁路：超过ucx_bulk_threshold的请求和响应负载通过UCX的RMA get读取，TCP连接上只传描述符
+    bulk_agent = KrpcBulkAgent::Instance();
+    endpoint.bulk = bulk_agent != nullptr;
+#endif
+    // 告诉客户端本端能解压哪些算法
+    endpoint.compress_mask = KrpcCompressPolicy::Instance().SupportedMask();
+    std::string endpoint_data = endpoint.ToString();
+
     // 将当前RPC节点上要发布的服务全部注册到ZooKeeper上，让RPC客户端可以在ZooKeeper上发现服务
-    ZkClient zkclient;
+    zk_client.reset(new ZkClient());
+    ZkClient &zkclient = *zk_client;
     zkclient.Start();  // 连接ZooKeeper服务器
     // service_name为永久节点，method_name为临时节点
     for (auto &sp : service_map) {
@@ -77,25 +202,87 @@ void KrpcProvider::Run() {
         zkclient.Create(service_path.c_str(), nullptr, 0);  // 创建服务节点
         for (auto &mp : sp.second.method_map) {
             std::string method_path = service_path + "/" + mp.first;
-            char method_path_data[128] = {0};
-            sprintf(method_path_data, "%s:%d", ip.c_str(), port);  // 将IP和端口信息存入节点数据
+            // 将IP、端口以及本机标识、Unix域套接字路径等信息存入节点数据
             // ZOO_EPHEMERAL表示这个节点是临时节点，在客户端断开连接后，ZooKeeper会自动删除这个节点
-            zkclient.Create(method_path.c_str(), method_path_data, strlen(method_path_data), ZOO_EPHEMERAL);
+            zkclient.Create(method_path.c_str(), endpoint_data.c_str(), endpoint_data.size(), ZOO_EPHEMERAL);
         }
     }
 
     // RPC服务端准备启动，打印信息
-    std::cout << "RpcProvider start service at ip:" << ip << " port:" << port << std::endl;
+    KRPC_LOG_INFO("RpcProvider start service at ip:{} port:{}", ip, port);
+    if (unix_server) {
+        KRPC_LOG_INFO("RpcProvider start service at unix:{}", unix_path);
+    }
+    if (shm_server) {
+        KRPC_LOG_INFO("RpcProvider start service at shm:{}", shm_path);
+    }
+    if (endpoint.ucx_port != 0) {
+        KRPC_LOG_INFO("RpcProvider start service at ucx port:{}", endpoint.ucx_port);
+    }
 
-    // 启动网络服务
-    server->start();
+    // 管理端口在accept线程中处理，不占用IO线程
+    std::string admin_port = KrpcApplication::GetInstance().GetConfig().Load("rpcserveradminport");
+    if (!admin_port.empty()) {
+        admin_server.reset(new KrpcAdminServer(&event_loop, ip, static_cast<uint16_t>(atoi(admin_port.c_str())),
+                                               std::bind(&KrpcProvider::AppendMetrics, this, std::placeholders::_1)));
+        // GET /top?n=20：按CPU时间排序的方法
+        admin_server->AddPage("/top", [](const std::string &query, std::string *out) {
+            size_t limit = 20;
+            if (query.compare(0, 2, "n=") == 0 && atoi(query.c_str() + 2) > 0) {
+                limit = static_cast<size_t>(atoi(query.c_str() + 2));
+            }
+            KrpcMetrics::Instance().AppendTopMethods(out, limit);
+        });
+        // GET /loglevel?level=debug：运行时调整日志级别，不带参数时返回当前级别
+        admin_server->AddPage("/loglevel", [](const std::string &query, std::string *out) {
+            if (query.compare(0, 6, "level=") == 0) {
+                KrpcLogLevel level;
+                if (!KrpcLog::ParseLevel(query.substr(6), &level)) {
+                    out->append("unknown level ").append(query.substr(6)).append("\n");
+                    return;
+                }
+                KrpcLog::SetLevel(level);
+            }
+            out->append(KrpcLog::LevelName(KrpcLog::Level())).append("\n");
+        });
+        admin_server->Start();
+        KRPC_LOG_INFO("RpcProvider start admin at ip:{} port:{}", ip, admin_port);
+    }
+
+    // 当前线程运行event_loop，负责accept新连接
+    KrpcAffinity::PinCurrentThread(KrpcAffinity::CpusFromConfig("accept_cpus"));
     event_loop.loop();  // 进入事件循环
 }
 
 // 连接回调函数，处理客户端连接事件
 void KrpcProvider::OnConnection(const muduo::net::TcpConnectionPtr &conn) {
-    std::cout << "OnConnection!" << std::endl;
-    if (!conn->connected()) {
+    KRPC_LOG_DEBUG("connection {} {} {}", conn->name(), conn->peerAddress().toIpPort(),
+                   conn->connected() ? "up" : "down");
+    if (conn->connected()) {
+        KRPC_PROBE2(conn_accept, conn->name().c_str(), conn->peerAddress().toIpPort().c_str());
+        ++open_connections;
+        // 为新连接创建私有状态
+        ConnectionContextPtr ctx = std::make_shared<ConnectionContext>();
+        if (fragment_bytes != 0) {
+            ctx->fragments.reset(new KrpcFragmentScheduler(fragment_bytes));
+            // muduo的发送缓冲区写空时继续发送下一个分片
+            conn->setWriteCompleteCallback(std::bind(&KrpcProvider::PumpFragments, this, std::placeholders::_1));
+        }
+        conn->setContext(ctx);
+    } else {
+        KRPC_PROBE2(conn_close, conn->name().c_str(), conn->peerAddress().toIpPort().c_str());
+        --open_connections;
+        // 连接断开时结束其上所有的流，阻塞在Write中的业务线程随之返回
+        if (!conn->getContext().empty()) {
+            ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+            for (auto &entry : ctx->streams) {
+                entry.second.writer->Close();
+                if (entry.second.reader) {
+                    entry.second.reader->Close();
+                }
+            }
+            ctx->streams.clear();
+        }
         // 如果连接关闭，则断开连接
         conn->shutdown();
     }
@@ -103,96 +290,651 @@ void KrpcProvider::OnConnection(const muduo::net::TcpConnectionPtr &conn) {
 
 // 消息回调函数，处理客户端发送的RPC请求
 void KrpcProvider::OnMessage(const muduo::net::TcpConnectionPtr &conn, muduo::net::Buffer *buffer, muduo::Timestamp receive_time) {
-    std::cout << "OnMessage" << std::endl;
+    KRPC_LOG_DEBUG("connection {} readable {} bytes", conn->name(), buffer->readableBytes());
+    int64_t receive_ns = NowNanos();  // 同一次读事件中排在后面的请求，等待前面的请求处理完的时间计入排队阶段
+    KRPC_PROBE2(request_received, conn->name().c_str(), buffer->readableBytes());
 
-    // 从网络缓冲区中读取远程RPC调用请求的字符流
-    std::string recv_buf = buffer->retrieveAllAsString();
+    // 一次读事件中可能包含多个流水线请求，也可能只有半个请求：
+    // 逐个解析出完整的帧进行处理，不完整的数据留在buffer中等待下一次读事件
+    while (buffer->readableBytes() > 0) {
+        Krpc::RpcHeader krpcHeader;
+        size_t args_offset = 0;
+        size_t frame_size = 0;
+        KrpcCodec::DecodeStatus status = KrpcCodec::DecodeRequest(buffer->peek(), buffer->readableBytes(),
+                                                                  &krpcHeader, &args_offset, &frame_size);
+        if (status == KrpcCodec::DecodeStatus::kIncomplete) {
+            break;
+        }
+        if (status == KrpcCodec::DecodeStatus::kError) {
+            // 数据流已经错乱，无法再找到下一个帧的边界，只能断开连接
+            KRPC_LOG_ERROR("krpcHeader parse error from {}", conn->peerAddress().toIpPort());
+            buffer->retrieveAll();
+            conn->shutdown();
+            return;
+        }
+
+        KRPC_PROBE5(header_decoded, krpcHeader.call_id(), krpcHeader.service_name().c_str(),
+                    krpcHeader.method_name().c_str(), krpcHeader.args_size(), krpcHeader.attachment_size());
+
+        if (krpcHeader.accept_fragment()) {
+            boost::any_cast<ConnectionContextPtr>(conn->getContext())->accept_fragment = true;
+        }
 
-    // 使用protobuf的CodedInputStream反序列化RPC请求
-    google::protobuf::io::ArrayInputStream raw_input(recv_buf.data(), recv_buf.size());
-    google::protobuf::io::CodedInputStream coded_input(&raw_input);
+        // 已经建立的流的后续帧
+        if (OnStreamFrame(conn, krpcHeader, buffer->peek() + args_offset)) {
+            buffer->retrieve(frame_size);
+            continue;
+        }
 
-    uint32_t header_size{};
-    coded_input.ReadVarint32(&header_size);  // 解析header_size
+#ifdef KRPC_WITH_UCX
+        if (krpcHeader.has_bulk()) {
+            FetchBulkRequest(conn, krpcHeader, receive_ns);  // 参数不在帧中，读取完成后再处理
+            buffer->retrieve(frame_size);
+            continue;
+        }
+#endif
+        const char *args = buffer->peek() + args_offset;
+        size_t args_size = krpcHeader.args_size();
+        const char *attachment = args + args_size;
+        ResponseOptions options = ResponseOptionsFor(krpcHeader, conn);
+        if (krpcHeader.compress_type() != Krpc::COMPRESS_NONE) {
+            // 参数解压到连接的缓冲区中，附件没有压缩，仍然留在接收缓冲区里
+            ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+            if (!ctx->compressor.Decompress(krpcHeader.compress_type(), krpcHeader.dict_id(), args, args_size,
+                                            krpcHeader.raw_size(), &ctx->compress_buf)) {
+                // 字典热更新之后，客户端仍可能用已经卸载的字典压缩，调用不能就此没有回音
+                KRPC_LOG_ERROR("{}.{} decompress request error", krpcHeader.service_name(), krpcHeader.method_name());
+                if (!options.framed) {
+                    // 旧版客户端的响应没有响应头，无法告诉它出错，只能断开连接让调用立即失败
+                    buffer->retrieveAll();
+                    conn->shutdown();
+                    return;
+                }
+                SendErrorResponse(conn, krpcHeader.call_id(), options, "decompress request error");
+                buffer->retrieve(frame_size);
+                continue;
+            }
+            args = ctx->compress_buf.data();
+            args_size = ctx->compress_buf.size();
+        }
+        KrpcServerStream stream;
+        if (krpcHeader.stream_window() != 0 || krpcHeader.bidi_stream()) {
+            stream = OpenStream(conn, krpcHeader);
+        }
+        HandleRequest(krpcHeader, args, args_size, attachment,
+                      [this, conn, options, stream](uint64_t call_id, google::protobuf::Message *response,
+                                                    const KrpcController &controller) {
+                          uint64_t queue_ns = controller.PhaseNanos(kPhaseServerQueue);
+                          uint64_t handler_ns = controller.PhaseNanos(kPhaseServerHandler);
+                          if (stream.writer) {
+                              FinishStream(conn, stream, call_id, response, controller.ResponseAttachment(), options,
+                                           queue_ns, handler_ns);
+                          } else {
+                              SendRpcResponse(conn, call_id, response, controller.ResponseAttachment(), options,
+                                              queue_ns, handler_ns);
+                          }
+                      },
+                      stream, receive_ns);
+        if (krpcHeader.compress_type() != Krpc::COMPRESS_NONE) {
+            // 参数已经解析完，解压过特别大的请求后释放连接的缓冲区
+            KrpcShrinkBuffer(&boost::any_cast<ConnectionContextPtr>(conn->getContext())->compress_buf);
+        }
+        buffer->retrieve(frame_size);
+    }
+}
 
-    // 根据header_size读取数据头的原始字符流，反序列化数据，得到RPC请求的详细信息
-    std::string rpc_header_str;
+#ifdef KRPC_WITH_UCX
+// UCX连接上收到的消息总是一个完整的请求帧。回调在UCX的progress线程中，业务方法可能阻塞或发起嵌套调用，
+// 不能在这里执行：与FetchBulkRequest一样，留住请求帧后轮流交给muduo的IO线程处理
+void KrpcProvider::OnUcxMessage(const UCXConnectionPtr &conn, const char *data, size_t len, UCXBuffer *buffer) {
+    int64_t receive_ns = NowNanos();  // 转交IO线程的时间计入排队阶段
     Krpc::RpcHeader krpcHeader;
-    std::string service_name;
-    std::string method_name;
-    uint32_t args_size{};
-
-    // 设置读取限制
-    google::protobuf::io::CodedInputStream::Limit msg_limit = coded_input.PushLimit(header_size);
-    coded_input.ReadString(&rpc_header_str, header_size);
-    // 恢复之前的限制，以便安全地继续读取其他数据
-    coded_input.PopLimit(msg_limit);
-
-    if (krpcHeader.ParseFromString(rpc_header_str)) {
-        service_name = krpcHeader.service_name();
-        method_name = krpcHeader.method_name();
-        args_size = krpcHeader.args_size();
-    } else {
-        KrpcLogger::ERROR("krpcHeader parse error");
+    size_t args_offset = 0;
+    size_t frame_size = 0;
+    if (KrpcCodec::DecodeRequest(data, len, &krpcHeader, &args_offset, &frame_size) != KrpcCodec::DecodeStatus::kComplete ||
+        frame_size != len) {
+        KRPC_LOG_ERROR("invalid request frame from ucx connection");
         return;
     }
+    // rendezvous收到的大请求已经在内存池的缓冲区中，直接接管缓冲区，请求处理完后归还；
+    // eager消息的数据只在回调期间有效，参数和附件一起拷贝出来
+    std::shared_ptr<void> holder;
+    const char *args = nullptr;
+    if (buffer != nullptr) {
+        std::shared_ptr<UCXBuffer> frame = std::make_shared<UCXBuffer>(std::move(*buffer));
+        args = frame->data() + args_offset;
+        holder = frame;
+    } else {
+        std::shared_ptr<std::string> payload = std::make_shared<std::string>(data + args_offset, len - args_offset);
+        args = payload->data();
+        holder = payload;
+    }
+    muduo::net::EventLoop *loop = io_loops.empty() ? &event_loop : io_loops[next_ucx_loop++ % io_loops.size()];
+    loop->runInLoop([this, conn, krpcHeader, holder, args, receive_ns]() {
+        HandleRequest(krpcHeader, args, krpcHeader.args_size(), args + krpcHeader.args_size(),
+                      [conn](uint64_t call_id, google::protobuf::Message *response, const KrpcController &controller) {
+                          // 响应直接序列化到已注册的缓冲区中，发送完成后缓冲区归还内存池
+                          int64_t serialize_start_ns = NowNanos();
+                          KrpcAttachment attachment = controller.ResponseAttachment();
+                          Krpc::RpcResponseHeader header;
+                          header.set_call_id(call_id);
+                          header.set_response_size(response->ByteSizeLong());
+                          header.set_attachment_size(attachment.size);
+                          // 这里记录的序列化阶段不含写入缓冲区，头部的长度必须在申请缓冲区之前确定
+                          SetServerPhases(&header, controller.PhaseNanos(kPhaseServerQueue),
+                                          controller.PhaseNanos(kPhaseServerHandler), serialize_start_ns);
+                          UCXBuffer frame = conn->pool().acquire(
+                              KrpcCodec::FrameSize(header, header.response_size() + attachment.size));
+                          if (!frame) {
+                              KRPC_LOG_ERROR("allocate ucx response buffer error");
+                              return;
+                          }
+                          char *end = KrpcCodec::WriteFrame(header, *response, frame.data());
+                          if (!attachment.empty()) {
+                              memcpy(end, attachment.data, attachment.size);
+                          }
+                          conn->send(std::move(frame));  // 可以在任意线程调用
+                      },
+                      KrpcServerStream(), receive_ns);
+    });
+}
+#endif
 
-    std::string args_str;  // RPC参数
-    // 直接读取args_size长度的字符串数据
-    bool read_args_success = coded_input.ReadString(&args_str, args_size);
-    if (!read_args_success) {
-        KrpcLogger::ERROR("read args error");
+#ifdef KRPC_WITH_UCX
+// 请求参数走了旁路：先通过UCX读取参数，再回到连接所属的IO线程处理请求。
+// 拿不到参数时没法给出响应，断开连接让客户端立即得知调用失败，而不是一直等到超时
+void KrpcProvider::FetchBulkRequest(const muduo::net::TcpConnectionPtr &conn, const Krpc::RpcHeader &header,
+                                    int64_t receive_ns) {
+    if (bulk_agent == nullptr) {
+        KRPC_LOG_ERROR("bulk request received but ucx_bulk_threshold is not configured");
+        conn->shutdown();
         return;
     }
+    // 读取参数的时间计入排队阶段
+    bulk_agent->FetchAsync(header.bulk(), [this, conn, header, receive_ns](bool ok, UCXBuffer data) {
+        if (!ok) {
+            KRPC_LOG_ERROR("{}.{} fetch bulk request error", header.service_name(), header.method_name());
+            conn->shutdown();  // 可以在任意线程调用
+            return;
+        }
+        // 读取回调在UCX的progress线程中，业务方法可能阻塞或发起嵌套调用，不能在这里执行
+        std::shared_ptr<UCXBuffer> args = std::make_shared<UCXBuffer>(std::move(data));
+        conn->getLoop()->runInLoop([this, conn, header, args, receive_ns]() {
+            // 旁路的负载中依次是参数和附件
+            if (args->size() != static_cast<size_t>(header.args_size()) + header.attachment_size()) {
+                KRPC_LOG_ERROR("{}.{} bulk request size mismatch", header.service_name(), header.method_name());
+                conn->shutdown();
+                return;
+            }
+            ResponseOptions options = ResponseOptionsFor(header, conn);
+            HandleRequest(header, args->data(), header.args_size(), args->data() + header.args_size(),
+                          [this, conn, options](uint64_t call_id, google::protobuf::Message *response,
+                                                const KrpcController &controller) {
+                              SendRpcResponse(conn, call_id, response, controller.ResponseAttachment(), options,
+                                              controller.PhaseNanos(kPhaseServerQueue),
+                                              controller.PhaseNanos(kPhaseServerHandler));
+                          },
+                          KrpcServerStream(), receive_ns);
+        });
+    });
+}
+#endif
+
+// 根据请求头找到对应的服务方法并调用
+void KrpcProvider::HandleRequest(const Krpc::RpcHeader &header, const char *args, size_t args_size,
+                                 const char *attachment, const ResponseSender &sender,
+                                 const KrpcServerStream &stream, int64_t receive_ns) {
+    const std::string &service_name = header.service_name();
+    const std::string &method_name = header.method_name();
 
     // 获取service对象和method对象
     auto it = service_map.find(service_name);
     if (it == service_map.end()) {
-        std::cout << service_name << " is not exist!" << std::endl;
+        KRPC_LOG_ERROR("{} is not exist!", service_name);
         return;
     }
     auto mit = it->second.method_map.find(method_name);
     if (mit == it->second.method_map.end()) {
-        std::cout << service_name << "." << method_name << " is not exist!" << std::endl;
+        KRPC_LOG_ERROR("{}.{} is not exist!", service_name, method_name);
         return;
     }
 
     google::protobuf::Service *service = it->second.service;  // 获取服务对象
     const google::protobuf::MethodDescriptor *method = mit->second;  // 获取方法对象
+    // 从开始处理请求到响应交给连接发送为止的耗时
+    auto metrics_it = it->second.metrics_id.find(method_name);
+    int metrics_id = metrics_it != it->second.metrics_id.end() ? metrics_it->second : -1;
+    int64_t start_ns = NowNanos();
+    size_t bytes_in = args_size + header.attachment_size();
+    // 本线程从解析请求到业务方法返回消耗的CPU时间和分配的内存；业务方法在其他线程中完成的部分不计入
+    uint64_t cpu_start_ns = resource_accounting ? KrpcThreadCpuNanos() : 0;
+    KrpcAllocCounters alloc_start = resource_accounting ? KrpcThreadAllocCounters() : KrpcAllocCounters();
+    // 抽样抓取请求，供krpc_replay重放；流式调用依赖后续的帧，参数走UCX旁路的请求帧里没有参数，都不抓
+    if (header.stream_window() == 0 && !header.bidi_stream() && !header.has_bulk() &&
+        KrpcCapture::Instance().Sample()) {
+        KrpcCapture::Instance().Record(header, args, args_size, attachment,
+                                       KrpcTracer::UnixNanos() - (receive_ns > 0 ? start_ns - receive_ns : 0));
+    }
 
     // 生成RPC方法调用请求的request和响应的response参数
     google::protobuf::Message *request = service->GetRequestPrototype(method).New();  // 动态创建请求对象
-    if (!request->ParseFromString(args_str)) {
-        std::cout << service_name << "." << method_name << " parse error!" << std::endl;
+    if (!request->ParseFromArray(args, static_cast<int>(args_size))) {
+        KRPC_LOG_ERROR("{}.{} parse error!", service_name, method_name);
+        KrpcMetrics::Instance().Record(metrics_id, static_cast<uint64_t>(NowNanos() - start_ns), bytes_in, 0, true);
+        delete request;
         return;
     }
     google::protobuf::Message *response = service->GetResponsePrototype(method).New();  // 动态创建响应对象
 
-    // 绑定回调函数，用于在方法调用完成后发送响应
-    google::protobuf::Closure *done = google::protobuf::NewCallback<KrpcProvider,
-                                                                    const muduo::net::TcpConnectionPtr &,
-                                                                    google::protobuf::Message *>(this,
-                                                                                                 &KrpcProvider::SendRpcResponse,
-                                                                                                 conn, response);
+    // 业务方法通过controller读取请求附件、设置响应附件，请求附件直接指向接收缓冲区
+    KrpcController *controller = new KrpcController();
+    controller->SetRequestAttachment(attachment, header.attachment_size());
+    controller->SetResponseStream(stream.writer);
+    controller->SetRequestStream(stream.reader);
+    controller->SetPhaseNanos(kPhaseServerQueue,
+                              receive_ns > 0 && start_ns > receive_ns ? static_cast<uint64_t>(start_ns - receive_ns) : 0);
+    // 服务端span从收到请求算起，以客户端span为父
+    KrpcTraceContext trace = KrpcTracer::Instance().StartServer(
+        header.has_trace() ? KrpcTraceContext::FromProto(header.trace()) : KrpcTraceContext());
+    controller->SetTraceContext(trace);
+    int64_t span_start_ns = receive_ns > 0 ? receive_ns : start_ns;
+
+    // 绑定回调函数，用于在方法调用完成后发送响应，并释放本次调用的request、response和controller
+    uint64_t call_id = header.call_id();
+    ++inflight_requests;
+    google::protobuf::Closure *done = new KrpcClosure([this, sender, call_id, request, response, controller,
+                                                       metrics_id, start_ns, bytes_in, span_start_ns,
+                                                       method]() {
+        // 业务方法的耗时要在发送前确定，随响应头带回客户端；发送的耗时只能记在本端
+        int64_t sender_start_ns = NowNanos();
+        controller->SetPhaseNanos(kPhaseServerHandler, static_cast<uint64_t>(sender_start_ns - start_ns));
+        KRPC_PROBE4(handler_end, metrics_id, call_id, sender_start_ns - start_ns, controller->Failed());
+        sender(call_id, response, *controller);
+        int64_t end_ns = NowNanos();
+        controller->SetPhaseNanos(kPhaseServerSerialize, static_cast<uint64_t>(end_ns - sender_start_ns));
+        --inflight_requests;
+        KrpcMetrics::Instance().Record(metrics_id, static_cast<uint64_t>(end_ns - start_ns), bytes_in,
+                                       response->ByteSizeLong() + controller->ResponseAttachment().size,
+                                       controller->Failed());
+        uint64_t phase_ns[kPhaseCount] = {};
+        for (KrpcPhase phase : {kPhaseServerQueue, kPhaseServerHandler, kPhaseServerSerialize}) {
+            phase_ns[phase] = controller->PhaseNanos(phase);
+        }
+        KrpcMetrics::Instance().RecordPhases(metrics_id, phase_ns);
+        const KrpcTraceContext &trace = controller->TraceContext();
+        if (trace.sampled) {
+            uint64_t span_ns = static_cast<uint64_t>(end_ns - span_start_ns);
+            KrpcTracer::Instance().Finish(trace, KrpcSpanRecord::kServer, method->service()->name(), method->name(),
+                                          KrpcTracer::UnixNanos() - static_cast<int64_t>(span_ns), span_ns,
+                                          controller->Failed());
+        }
+        delete request;
+        delete response;
+        delete controller;
+    });
 
     // 在框架上根据远端RPC请求，调用当前RPC节点上发布的方法
-    service->CallMethod(method, nullptr, request, response, done);  // 调用服务方法
+    // 业务方法执行期间本次调用是当前线程的追踪上下文，其中发起的嵌套调用成为服务端span的子span
+    KrpcTraceScope trace_scope(trace);
+    KRPC_PROBE5(handler_start, metrics_id, call_id, service_name.c_str(), method_name.c_str(),
+                controller->PhaseNanos(kPhaseServerQueue));
+    service->CallMethod(method, controller, request, response, done);  // 调用服务方法
+    if (resource_accounting) {
+        KrpcAllocCounters alloc_end = KrpcThreadAllocCounters();
+        KrpcMetrics::Instance().RecordResources(metrics_id, KrpcThreadCpuNanos() - cpu_start_ns,
+                                                alloc_end.bytes - alloc_start.bytes, alloc_end.count - alloc_start.count);
+    }
+}
+
+// 根据请求头中客户端声明的能力决定响应的发送方式
+KrpcProvider::ResponseOptions KrpcProvider::ResponseOptionsFor(const Krpc::RpcHeader &header,
+                                                               const muduo::net::TcpConnectionPtr &conn) {
+    ResponseOptions options;
+    options.accept_bulk = header.accept_bulk();
+    options.priority = header.priority();
+    options.framed = header.framed_response();
+    const KrpcCompressPolicy &compress_policy = KrpcCompressPolicy::Instance();
+    if (!(header.accept_compress() & compress_policy.SupportedMask())) {
+        return options;
+    }
+    KrpcDictStore &dicts = KrpcDictStore::Instance();
+    if (dicts.Enabled()) {
+        KrpcZstdDictPtr dict = dicts.ForMethod(header.service_name() + "." + header.method_name());
+        options.local_dict_id = dict ? dict->id() : 0;
+        options.accept_dict_id = header.accept_dict_id();
+    }
+    options.accept_compress = header.accept_compress();
+    auto it = service_map.find(header.service_name());
+    if (it != service_map.end()) {
+        auto tit = it->second.compress_threshold.find(header.method_name());
+        if (tit != it->second.compress_threshold.end()) {
+            options.compress_threshold = tit->second;
+        }
+    }
+    if (options.compress_threshold != 0 && compress_policy.Adaptive() && !conn->getContext().empty()) {
+        // 按客户端所在的机器统计，同一台机器上的多个连接共用一条链路。
+        // 连接的对端不变，统计对象在连接上按方法缓存，只有每个方法第一次压缩时才查全局的表
+        auto mit = it->second.method_map.find(header.method_name());
+        ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+        KrpcCompressTracker *&tracker = ctx->compress_trackers[mit->second];
+        if (tracker == nullptr) {
+            tracker = KrpcAdaptiveCompress::Instance().Tracker(conn->peerAddress().toIp(),
+                                                               header.service_name() + "." + header.method_name());
+        }
+        options.compress_tracker = tracker;
+    }
+    return options;
+}
+
+// 请求没能交给业务方法时回一个只带错误的响应帧，响应头中仍然带上本端的字典，
+// 客户端据此换掉已经失效的字典，之后的调用不会再因为同样的原因失败
+void KrpcProvider::SendErrorResponse(const muduo::net::TcpConnectionPtr &conn, uint64_t call_id,
+                                     const ResponseOptions &options, const std::string &error) {
+    Krpc::RpcResponseHeader header;
+    header.set_call_id(call_id);
+    header.set_accept_dict_id(options.local_dict_id);
+    header.set_error(error);
+    std::string frame;
+    KrpcCodec::EncodeResponse(header, std::string(), &frame);
+    QueueOutput(conn, call_id, options.priority, frame);
 }
 
 // 发送RPC响应给客户端
-void KrpcProvider::SendRpcResponse(const muduo::net::TcpConnectionPtr &conn, google::protobuf::Message *response) {
+void KrpcProvider::SendRpcResponse(const muduo::net::TcpConnectionPtr &conn, uint64_t call_id, google::protobuf::Message *response,
+                                   const KrpcAttachment &attachment, const ResponseOptions &options, uint64_t queue_ns,
+                                   uint64_t handler_ns) {
+    int64_t serialize_start_ns = NowNanos();
+#ifdef KRPC_WITH_UCX
+    // 响应足够大且客户端支持旁路时，响应和附件留在已注册的内存中，帧里只带描述符
+    if (options.accept_bulk && bulk_agent != nullptr) {
+        size_t response_size = response->ByteSizeLong();
+        if (response_size + attachment.size >= bulk_agent->threshold()) {
+            UCXBuffer data = bulk_agent->pool().acquire(response_size + attachment.size);
+            Krpc::RpcResponseHeader header;
+            header.set_call_id(call_id);
+            header.set_response_size(response_size);
+            header.set_attachment_size(attachment.size);
+            if (data) {
+                uint8_t *end = response->SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t *>(data.data()));
+                if (!attachment.empty()) {
+                    memcpy(end, attachment.data, attachment.size);
+                }
+                if (bulk_agent->Expose(std::move(data), header.mutable_bulk())) {
+                    SetServerPhases(&header, queue_ns, handler_ns, serialize_start_ns);
+                    std::string frame;
+                    KrpcCodec::EncodeResponse(header, std::string(), &frame);
+                    KRPC_PROBE3(response_sent, call_id, frame.size(), 0);
+                    QueueOutput(conn, call_id, options.priority, frame);
+                    return;
+                }
+            }
+            // 旁路不可用时退回普通路径
+        }
+    }
+#endif
     std::string response_str;
-    if (response->SerializeToString(&response_str)) {
-        // 序列化成功，通过网络把RPC方法执行的结果返回给RPC调用方
-        conn->send(response_str);
-    } else {
-        std::cout << "serialize error!" << std::endl;
+    if (!response->SerializeToString(&response_str)) {
+        KRPC_LOG_ERROR("serialize error!");
+        return;
+    }
+    if (!options.framed) {
+        // 旧版客户端只认序列化的响应本身，没有响应头，也就收不到附件
+        if (attachment.size > 0) {
+            KRPC_LOG_WARNING("client does not accept framed response, attachment of call {} dropped", call_id);
+        }
+        QueueOutput(conn, call_id, options.priority, response_str);
+        return;
+    }
+
+    // 响应头带回请求的call_id，客户端据此匹配流水线中的请求
+    Krpc::RpcResponseHeader header;
+    header.set_call_id(call_id);
+    header.set_response_size(response_str.size());
+    header.set_attachment_size(attachment.size);
+
+    header.set_accept_dict_id(options.local_dict_id);
+
+    // 客户端持有本方法的字典时用字典压缩，否则响应足够大且客户端能解压时才压缩。
+    // IO线程中使用连接自己的压缩上下文，业务方法在其他线程中完成时使用该线程的上下文
+    const std::string *payload = &response_str;
+    bool use_dict = options.accept_dict_id != 0 && response_str.size() >= KrpcDictStore::Instance().MinBytes();
+    bool use_codec = options.compress_threshold != 0 && response_str.size() >= options.compress_threshold;
+    if (use_dict || use_codec) {
+        static thread_local KrpcCompressor t_compressor;
+        static thread_local std::string t_compress_buf;
+        KrpcCompressor *compressor = &t_compressor;
+        std::string *compressed = &t_compress_buf;
+        if (conn->getLoop()->isInLoopThread() && !conn->getContext().empty()) {
+            ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+            compressor = &ctx->compressor;
+            compressed = &ctx->compress_buf;
+        }
+        KrpcZstdDictPtr dict = use_dict ? KrpcDictStore::Instance().ById(options.accept_dict_id) : nullptr;
+        if (dict) {
+            if (compressor->CompressWithDict(*dict, response_str.data(), response_str.size(), compressed) &&
+                compressed->size() < response_str.size()) {
+                header.set_compress_type(Krpc::COMPRESS_ZSTD);
+                header.set_dict_id(dict->id());
+                payload = compressed;
+            }
+        } else if (use_codec) {
+            KrpcCompressChoice choice = options.compress_tracker != nullptr
+                                            ? options.compress_tracker->Choose(options.accept_compress)
+                                            : KrpcCompressPolicy::Instance().Choose(options.accept_compress);
+            if (KrpcCompressPayload(compressor, options.compress_tracker, choice, response_str, compressed)) {
+                header.set_compress_type(choice.type);
+                payload = compressed;
+            }
+        }
+        if (payload == compressed) {
+            header.set_raw_size(response_str.size());
+            header.set_response_size(compressed->size());
+        }
+    }
+
+    SetServerPhases(&header, queue_ns, handler_ns, serialize_start_ns);
+    std::string frame;
+    if (!KrpcCodec::EncodeResponse(header, *payload, &frame)) {
+        KRPC_LOG_ERROR("serialize response header error!");
+        return;
     }
+    // 不立即发送，先放入连接的待发送缓冲区，由本轮事件循环末尾的FlushOutput统一写出
+    KRPC_PROBE3(response_sent, call_id, frame.size(), attachment.size);
+    QueueOutput(conn, call_id, options.priority, frame, attachment);
     // conn->shutdown(); // 模拟HTTP短链接，由RpcProvider主动断开连接
 }
 
+// 为流式调用创建写端和读端。流消息和归还窗口的帧一律排进IO线程的回调队列再写入待发送缓冲区，
+// FinishStream同样通过回调队列发送最终的响应，因此它总在已经写出的流消息之后
+KrpcServerStream KrpcProvider::OpenStream(const muduo::net::TcpConnectionPtr &conn, const Krpc::RpcHeader &header) {
+    muduo::net::EventLoop *loop = conn->getLoop();
+    std::weak_ptr<muduo::net::TcpConnection> weak_conn(conn);
+    uint64_t call_id = header.call_id();
+    uint32_t priority = header.priority();
+    KrpcStreamWriter::FrameSink sink = [this, loop, weak_conn, call_id, priority](std::string frame) {
+        loop->queueInLoop([this, weak_conn, call_id, priority, frame]() {
+            muduo::net::TcpConnectionPtr conn = weak_conn.lock();
+            if (conn) {
+                QueueOutput(conn, call_id, priority, frame);
+            }
+        });
+    };
+    KrpcServerStream stream;
+    stream.writer = std::make_shared<KrpcStreamWriter>(header.call_id(), header.stream_window(),
+                                                       header.stream_window_bytes(), loop, sink);
+    if (header.bidi_stream()) {
+        stream.reader = std::make_shared<KrpcStreamReader>(header.call_id(), KrpcStreamWindow(),
+                                                           KrpcStreamWindowBytes(), loop, sink);
+        stream.reader->Start();  // 给出客户端->服务端的初始窗口
+    }
+    ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+    ctx->streams[header.call_id()] = stream;
+    return stream;
+}
+
+bool KrpcProvider::OnStreamFrame(const muduo::net::TcpConnectionPtr &conn, const Krpc::RpcHeader &header,
+                                 const char *args) {
+    bool credit = header.stream_credit() != 0 || header.stream_credit_bytes() != 0;
+    if (!credit && !header.stream_message() && !header.stream_end()) {
+        return false;
+    }
+    ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+    auto it = ctx->streams.find(header.call_id());
+    if (it == ctx->streams.end()) {
+        return true;  // 流已经结束，还在途中的帧直接丢弃
+    }
+    KrpcServerStream &stream = it->second;
+    if (credit) {
+        stream.writer->AddCredit(header.stream_credit(), header.stream_credit_bytes());
+    }
+    if (header.stream_message()) {
+        // 消息只是放进队列，不会阻塞IO线程，也就不会影响同一连接上的其他流
+        if (!stream.reader || !stream.reader->Push(std::string(args, header.args_size()))) {
+            KRPC_LOG_ERROR("stream {} message exceeds the window, stream aborted", header.call_id());
+            stream.writer->Close();
+            if (stream.reader) {
+                stream.reader->Close();
+            }
+        }
+    }
+    if (header.stream_end() && stream.reader) {
+        stream.reader->End();
+    }
+    return true;
+}
+
+// 业务方法调用了done，结束流并发送最终的响应
+void KrpcProvider::FinishStream(const muduo::net::TcpConnectionPtr &conn, const KrpcServerStream &stream,
+                                uint64_t call_id, google::protobuf::Message *response,
+                                const KrpcAttachment &attachment, const ResponseOptions &options, uint64_t queue_ns,
+                                uint64_t handler_ns) {
+    stream.writer->Close();
+    if (stream.reader) {
+        stream.reader->Close();
+    }
+    // response和attachment在done返回后就失效，排队前先拷贝
+    std::shared_ptr<google::protobuf::Message> final_response(response->New());
+    final_response->CopyFrom(*response);
+    std::shared_ptr<std::string> final_attachment = std::make_shared<std::string>(attachment.data, attachment.size);
+    conn->getLoop()->queueInLoop([this, conn, call_id, final_response, final_attachment, options, queue_ns,
+                                  handler_ns]() {
+        KrpcAttachment attachment;
+        attachment.data = final_attachment->data();
+        attachment.size = final_attachment->size();
+        SendRpcResponse(conn, call_id, final_response.get(), attachment, options, queue_ns, handler_ns);
+        if (!conn->getContext().empty()) {
+            boost::any_cast<ConnectionContextPtr>(conn->getContext())->streams.erase(call_id);
+        }
+    });
+}
+
+// 将一个响应帧追加到连接的待发送缓冲区
+void KrpcProvider::QueueOutput(const muduo::net::TcpConnectionPtr &conn, uint64_t call_id, uint32_t priority,
+                               const std::string &frame, const KrpcAttachment &attachment) {
+    muduo::net::EventLoop *loop = conn->getLoop();
+    if (!loop->isInLoopThread()) {
+        // 业务方法可能在其他线程中异步调用done，转回连接所属的IO线程处理；
+        // 附件在done返回后就可能失效，只能和帧一起拷贝过去
+        std::string full_frame = frame;
+        full_frame.append(attachment.data, attachment.size);
+        loop->runInLoop(
+            std::bind(&KrpcProvider::QueueOutput, this, conn, call_id, priority, full_frame, KrpcAttachment()));
+        return;
+    }
+
+    if (conn->getContext().empty()) {
+        conn->send(frame);
+        if (!attachment.empty()) {
+            conn->send(attachment.data, static_cast<int>(attachment.size));
+        }
+        return;
+    }
+    // 附件从业务方法的内存直接写入待发送缓冲区，不经过中间的拼接
+    ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+    if (ctx->fragments && ctx->accept_fragment && ctx->fragments->Wants(call_id, frame.size() + attachment.size)) {
+        std::string full_frame = frame;
+        full_frame.append(attachment.data, attachment.size);
+        ctx->fragments->Add(call_id, priority, std::move(full_frame));
+    } else {
+        ctx->pending_output.append(frame);
+        ctx->pending_output.append(attachment.data, attachment.size);
+    }
+    if (!ctx->flush_scheduled) {
+        ctx->flush_scheduled = true;
+        // queueInLoop的回调在本轮就绪事件全部处理完之后才执行，
+        // 因此同一轮中同一连接上产生的多个响应只会触发一次write系统调用
+        loop->queueInLoop(std::bind(&KrpcProvider::FlushOutput, this, conn));
+    }
+}
+
+// 将本轮积攒的响应一次性写出
+void KrpcProvider::FlushOutput(const muduo::net::TcpConnectionPtr &conn) {
+    ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+    ctx->flush_scheduled = false;
+    if (!conn->connected()) {
+        ctx->pending_output.retrieveAll();
+        return;
+    }
+    if (ctx->pending_output.readableBytes() > 0) {
+        conn->send(&ctx->pending_output);  // send会取走缓冲区中的全部数据，写不完的部分由muduo在可写时继续发送
+    }
+    PumpFragments(conn);
+}
+
+// 分片只在muduo的发送缓冲区积压不到一个分片时才写入，之后产生的小响应最多排在一个分片之后；
+// 每次取出优先级最高的调用的下一个分片，同一优先级的调用轮流发送
+void KrpcProvider::PumpFragments(const muduo::net::TcpConnectionPtr &conn) {
+    if (conn->getContext().empty() || !conn->connected()) {
+        return;
+    }
+    ConnectionContextPtr ctx = boost::any_cast<ConnectionContextPtr>(conn->getContext());
+    if (!ctx->fragments) {
+        return;
+    }
+    std::string fragment;
+    while (!ctx->fragments->Empty() && conn->outputBuffer()->readableBytes() < ctx->fragments->fragment_size()) {
+        fragment.clear();
+        ctx->fragments->Next(&fragment);
+        conn->send(fragment);
+    }
+}
+
+void KrpcProvider::AppendMetrics(std::string *out) {
+    KrpcMetrics::Instance().AppendMetrics(out);
+    KrpcTracer::Instance().AppendMetrics(out);
+    KrpcAdaptiveCompress::Instance().AppendMetrics(out);
+    KrpcLog::AppendMetrics(out);
+    KrpcCapture::Instance().AppendMetrics(out);
+
+    KrpcAppendMetricFamily(out, "krpc_inflight_requests", "gauge", "Requests being handled, response not sent yet.");
+    KrpcAppendMetricSample(out, "krpc_inflight_requests", "", static_cast<double>(inflight_requests.load()));
+    KrpcAppendMetricFamily(out, "krpc_connections", "gauge", "Open TCP and unix socket connections.");
+    KrpcAppendMetricSample(out, "krpc_connections", "", static_cast<double>(open_connections.load()));
+    KrpcAppendMetricFamily(out, "krpc_io_loop_pending_functors", "gauge",
+                           "Callbacks queued to an io thread and not run yet.");
+    for (size_t i = 0; i < io_loops.size(); ++i) {
+        KrpcAppendMetricSample(out, "krpc_io_loop_pending_functors", "loop=\"" + std::to_string(i) + "\"",
+                               static_cast<double>(io_loops[i]->queueSize()));
+    }
+    KrpcAppendMetricFamily(out, "krpc_zookeeper_session", "stateset", "ZooKeeper session state.");
+    std::string zk_state = zk_client ? zk_client->StateName() : "closed";
+    for (const char *state : {"connected", "connecting", "associating", "expired", "auth_failed", "closed"}) {
+        KrpcAppendMetricSample(out, "krpc_zookeeper_session", std::string("krpc_zookeeper_session=\"") + state + "\"",
+                               zk_state == state ? 1 : 0);
+    }
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    // mallinfo2会遍历所有arena，只在抓取时调用
+    struct mallinfo2 info = mallinfo2();
+    KrpcAppendMetricFamily(out, "krpc_malloc_bytes", "gauge", "glibc malloc heap usage.");
+    KrpcAppendMetricSample(out, "krpc_malloc_bytes", "kind=\"in_use\"", static_cast<double>(info.uordblks));
+    KrpcAppendMetricSample(out, "krpc_malloc_bytes", "kind=\"free\"", static_cast<double>(info.fordblks));
+    KrpcAppendMetricSample(out, "krpc_malloc_bytes", "kind=\"arena\"", static_cast<double>(info.arena));
+    KrpcAppendMetricSample(out, "krpc_malloc_bytes", "kind=\"mmap\"", static_cast<double>(info.hblkhd));
+#endif
+}
+
 // 析构函数，退出事件循环
 KrpcProvider::~KrpcProvider() {
-    std::cout << "~KrpcProvider()" << std::endl;
+    KRPC_LOG_INFO("~KrpcProvider()");
     event_loop.quit();  // 退出事件循环
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "EpollServer.h"
 #include "KrpcLogger.h"
+#include "KrpcAffinity.h"
 #include <cstring>
 #include <fcntl.h>
 #include <netinet/in.h>
@@ -10,6 +11,15 @@
 #include <iostream> 
 #include <memory>
 #include <atomic>
+#include <chrono>
+
+// 较老的libc头文件中没有这些选项
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
 
 // 设置socket为非阻塞模式
 int setNonBlocking(int fd)
@@ -29,10 +39,8 @@ int setNonBlocking(int fd)
     return 0;
 }
 
-EpollServer::EpollServer() : listenFd_(-1), epollFd_(-1), running_(false)
+EpollServer::EpollServer() : listenFd_(-1), epollFd_(-1), running_(false), affinitySet_(false)
 {
-    // 创建线程池
-    threadPool_ = std::make_unique<ThreadPool>(8); // 默认8个线程
 }
 
 EpollServer::~EpollServer()
@@ -42,6 +50,17 @@ EpollServer::~EpollServer()
 
 bool EpollServer::start(const std::string &ip, int port)
 {
+    if (!affinitySet_)
+    {
+        reactorCpus_ = KrpcAffinity::CpusFromConfig("reactor_cpus");
+        workerCpus_ = KrpcAffinity::CpusFromConfig("worker_cpus");
+    }
+
+    // 创建线程池，工作线程整体绑定到workerCpus_上，由调度器在其中均衡
+    std::vector<int> workerCpus = workerCpus_;
+    threadPool_ = std::make_unique<ThreadPool>(8, [workerCpus](size_t)
+                                               { KrpcAffinity::PinCurrentThread(workerCpus); }); // 默认8个线程
+
     // 创建socket
     listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
     if (listenFd_ < 0)
@@ -165,14 +184,69 @@ void EpollServer::setMessageCallback(const MessageCallback &cb)
     messageCallback_ = cb;
 }
 
+void EpollServer::setBusyPollOptions(const BusyPollOptions &options)
+{
+    busyPoll_ = options;
+}
+
+void EpollServer::setCpuAffinity(const std::vector<int> &reactorCpus, const std::vector<int> &workerCpus)
+{
+    affinitySet_ = true;
+    reactorCpus_ = reactorCpus;
+    workerCpus_ = workerCpus;
+}
+
+// 等待就绪事件。开启自旋时先以0超时反复轮询，预算用完仍没有事件才阻塞等待
+int EpollServer::waitEvents(struct epoll_event *events, int maxEvents)
+{
+    if (busyPoll_.spin_us > 0)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(busyPoll_.spin_us);
+        do
+        {
+            int nfds = epoll_wait(epollFd_, events, maxEvents, 0);
+            if (nfds != 0)
+                return nfds;
+        } while (running_ && std::chrono::steady_clock::now() < deadline);
+    }
+    return epoll_wait(epollFd_, events, maxEvents, 100); // 100ms timeout
+}
+
+// 让内核在recv/epoll时直接轮询网卡队列，需要CAP_NET_ADMIN或者不超过net.core.busy_read
+void EpollServer::setBusyPollSockopts(int fd)
+{
+    if (busyPoll_.socket_busy_poll_us > 0)
+    {
+        int usec = busyPoll_.socket_busy_poll_us;
+        if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) < 0)
+        {
+            LOG(WARNING) << "setsockopt SO_BUSY_POLL error: " << strerror(errno);
+        }
+    }
+    if (busyPoll_.prefer_busy_poll)
+    {
+        int on = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &on, sizeof(on)) < 0)
+        {
+            LOG(WARNING) << "setsockopt SO_PREFER_BUSY_POLL error: " << strerror(errno);
+        }
+    }
+}
+
 void EpollServer::epollLoop()
 {
     constexpr int MAX_EVENTS = 1024;
     struct epoll_event events[MAX_EVENTS];
 
+    // 只有一个epoll线程，绑定到列表中的第一个CPU
+    if (!reactorCpus_.empty())
+    {
+        KrpcAffinity::PinCurrentThread(reactorCpus_.front());
+    }
+
     while (running_)
     {
-        int nfds = epoll_wait(epollFd_, events, MAX_EVENTS, 100); // 100ms timeout
+        int nfds = waitEvents(events, MAX_EVENTS);
 
         if (nfds < 0)
         {
@@ -194,8 +268,16 @@ void EpollServer::epollLoop()
             // 处理已有连接的读事件
             else if (events[i].events & EPOLLIN)
             {
-                threadPool_->enqueue([this, fd]
-                                     { handleReadEvent(fd); });
+                if (busyPoll_.spin_us > 0)
+                {
+                    // 低延迟模式下省去线程池的入队和唤醒开销
+                    handleReadEvent(fd);
+                }
+                else
+                {
+                    threadPool_->enqueue([this, fd]
+                                         { handleReadEvent(fd); });
+                }
             }
         }
     }
@@ -220,6 +302,8 @@ void EpollServer::handleNewConnection()
         return;
     }
 
+    setBusyPollSockopts(clientFd);
+
     // 添加到epoll监听
     struct epoll_event ev;
     ev.events = EPOLLIN;
@@ -11,16 +11,21 @@
 #include <vector>
 #include <deque>
 #include <condition_variable>
+
+struct epoll_event;
 // 简单的线程池实现
 class ThreadPool
 {
 public:
-    explicit ThreadPool(size_t numThreads)
+    // threadInit在每个工作线程启动时以线程序号为参数调用一次，可用于绑定CPU
+    explicit ThreadPool(size_t numThreads, std::function<void(size_t)> threadInit = nullptr)
     {
         for (size_t i = 0; i < numThreads; ++i)
         {
-            workers_.emplace_back([this]
+            workers_.emplace_back([this, i, threadInit]
                                   {
+                if (threadInit)
+                    threadInit(i);
                 while (true) {
                     std::function<void()> task;
                     {
@@ -103,6 +108,14 @@ public:
     using ConnectionCallback = std::function<void(std::shared_ptr<TcpConnection>)>;
     using MessageCallback = std::function<void(std::shared_ptr<TcpConnection>, std::shared_ptr<Buffer>)>;
 
+    // 低延迟模式的参数，默认全部关闭
+    struct BusyPollOptions
+    {
+        int spin_us = 0;               // 阻塞等待前用epoll_wait(..., 0)自旋的时间预算（微秒），0表示不自旋
+        int socket_busy_poll_us = 0;   // 设置到每个连接上的SO_BUSY_POLL（微秒），0表示不设置
+        bool prefer_busy_poll = false; // 是否设置SO_PREFER_BUSY_POLL（内核5.11+）
+    };
+
     EpollServer();
     ~EpollServer();
 
@@ -111,8 +124,15 @@ public:
 
     void setConnectionCallback(const ConnectionCallback &cb);
     void setMessageCallback(const MessageCallback &cb);
+    // 需要在start之前调用。开启自旋后读事件直接在epoll线程中处理，不再经过线程池
+    void setBusyPollOptions(const BusyPollOptions &options);
+    // 需要在start之前调用。epoll线程（同时负责accept）绑定到reactorCpus，线程池中的线程绑定到workerCpus，
+    // 不调用时使用配置文件中的reactor_cpus和worker_cpus
+    void setCpuAffinity(const std::vector<int> &reactorCpus, const std::vector<int> &workerCpus);
 
 private:
+    int waitEvents(struct epoll_event *events, int maxEvents);
+    void setBusyPollSockopts(int fd);
     void epollLoop();
     void handleNewConnection();
     void handleReadEvent(int fd);
@@ -129,4 +149,8 @@ private:
 
     ConnectionCallback connectionCallback_;
     MessageCallback messageCallback_;
+    BusyPollOptions busyPoll_;
+    bool affinitySet_;
+    std::vector<int> reactorCpus_;
+    std::vector<int> workerCpus_;
 };
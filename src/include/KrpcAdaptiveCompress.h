@@ -0,0 +1,93 @@
+#ifndef _KrpcAdaptiveCompress_H
+#define _KrpcAdaptiveCompress_H
+// 自适应压缩（compress_type=auto）：按对端和方法分别统计每种压缩方式实际达到的压缩率和压缩耗时，
+// 按对端统计发往该对端的流量，每条负载都在不压缩、LZ4、Zstd 1/3/9之间选择估计耗时最短的方式：
+//   耗时 = 压缩耗时 + 压缩后的字节数 / 链路剩余带宽
+// 链路空闲时剩余带宽大，倾向于省CPU；链路接近饱和时剩余带宽小，倾向于压缩率高的方式。
+// 链路容量由compress_link_mbps配置（默认1000）。为了让估计跟上数据的变化，每隔一段时间会轮流试用其他方式。
+// 各方式被选中的次数、压缩前后的字节数、压缩耗时和当前的选择可以通过AppendMetrics导出，选择变化时记录日志
+#include "KrpcCompress.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 候选的压缩方式个数：不压缩、LZ4、Zstd 1/3/9
+const int kCompressCandidates = 5;
+
+// 发往一个对端的流量统计，用来估计链路的剩余带宽
+struct KrpcLinkStats
+{
+    std::mutex mutex;
+    std::chrono::steady_clock::time_point window_start;
+    uint64_t window_bytes = 0;
+    double bytes_per_second = 0; // 平滑后的发送速率
+};
+
+// 一个对端上一个方法的压缩统计，可以在任意线程中使用
+class KrpcCompressTracker
+{
+public:
+    // 为一条负载选择压缩方式，peer_mask是对端能解压的算法
+    KrpcCompressChoice Choose(uint32_t peer_mask);
+    // 记录一条负载的结果，没有压缩时wire_size等于raw_size，compress_ns为0
+    void Record(const KrpcCompressChoice &choice, size_t raw_size, size_t wire_size, int64_t compress_ns);
+
+private:
+    friend class KrpcAdaptiveCompress;
+    struct Candidate
+    {
+        double ratio;       // 压缩后/压缩前，平滑后的估计
+        double ns_per_byte; // 每字节的压缩耗时，平滑后的估计
+        uint64_t samples = 0;
+        // 导出的统计
+        uint64_t chosen = 0;
+        uint64_t raw_bytes = 0;
+        uint64_t wire_bytes = 0;
+        uint64_t compress_ns = 0;
+    };
+
+    KrpcCompressTracker(const std::string &peer, const std::string &method, KrpcLinkStats *link,
+                        double link_bytes_per_second);
+    double AvailableBandwidth();
+    // 拷贝出各方式的统计，返回当前的选择
+    int Snapshot(Candidate *out);
+
+    std::string peer_;
+    std::string method_;
+    KrpcLinkStats *link_;
+    double link_capacity_; // 链路容量（字节/秒）
+    std::mutex mutex_;
+    Candidate candidates_[kCompressCandidates];
+    uint64_t payloads_ = 0;
+    int current_ = 0;    // 最近一次按估计耗时选出的方式
+    int next_probe_ = 1; // 下一次轮流试用的方式
+};
+
+// 所有对端和方法的压缩统计，进程内唯一
+class KrpcAdaptiveCompress
+{
+public:
+    static KrpcAdaptiveCompress &Instance();
+
+    // 取得对端peer上方法method的统计，返回的指针在进程内一直有效
+    KrpcCompressTracker *Tracker(const std::string &peer, const std::string &method);
+    // 以OpenMetrics文本格式追加全部统计
+    void AppendMetrics(std::string *out);
+
+private:
+    KrpcAdaptiveCompress();
+    double link_capacity_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<KrpcLinkStats>> links_;
+    std::unordered_map<std::string, std::unique_ptr<KrpcCompressTracker>> trackers_;
+};
+
+// 按choice压缩raw写入out，tracker不为空时记录结果。
+// 返回true表示out中是压缩后的负载；不压缩、压缩失败或者没有变小时返回false，应发送原始负载
+bool KrpcCompressPayload(KrpcCompressor *compressor, KrpcCompressTracker *tracker, const KrpcCompressChoice &choice,
+                         const std::string &raw, std::string *out);
+
+#endif
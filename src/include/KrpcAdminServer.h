@@ -0,0 +1,40 @@
+#ifndef _KrpcAdminServer_H
+#define _KrpcAdminServer_H
+// 管理端口：以OpenMetrics文本格式提供运行时统计（GET /metrics），供Prometheus等监控系统定期抓取；
+// 也可以用AddPage登记供人查看的纯文本页面。
+// 连接都在传入的loop（服务端的accept线程）中处理，不占用处理RPC的IO线程；
+// 统计在抓取时才从各线程的分片中合并，抓取不会阻塞正在记录统计的线程
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/TcpServer.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+class KrpcAdminServer
+{
+public:
+    // 把全部统计追加到out中，不包括结尾的"# EOF"
+    using MetricsCollector = std::function<void(std::string *out)>;
+
+    // 生成一个纯文本页面，query是URL中?之后的部分
+    using PageHandler = std::function<void(const std::string &query, std::string *out)>;
+
+    KrpcAdminServer(muduo::net::EventLoop *loop, const std::string &ip, uint16_t port, MetricsCollector collector);
+    // 在Start之前登记路径path（如"/top"）上的页面
+    void AddPage(const std::string &path, PageHandler handler);
+
+    void Start();
+
+private:
+    void OnConnection(const muduo::net::TcpConnectionPtr &conn);
+    void OnMessage(const muduo::net::TcpConnectionPtr &conn, muduo::net::Buffer *buffer, muduo::Timestamp receive_time);
+    void Reply(const muduo::net::TcpConnectionPtr &conn, const char *status, const char *content_type,
+               const std::string &body);
+
+    std::unique_ptr<muduo::net::TcpServer> server_;
+    MetricsCollector collector_;
+    std::map<std::string, PageHandler> pages_;
+};
+
+#endif
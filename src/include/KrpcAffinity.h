@@ -0,0 +1,32 @@
+#ifndef _KrpcAffinity_H
+#define _KrpcAffinity_H
+#include <string>
+#include <vector>
+
+// 线程的CPU/NUMA绑定工具
+// 相关配置项（均为"0-3,8"格式的CPU列表，不配置表示不绑定）：
+//   reactor_cpus   IO线程，每个线程独占列表中的一个CPU
+//   worker_cpus    业务线程池中的线程，绑定到整个列表
+//   accept_cpus    接受新连接的线程
+//   nic_numa_steer 网卡名，设置后IO线程只运行在该网卡所在NUMA节点的CPU上
+class KrpcAffinity
+{
+public:
+    // 解析"0-3,8,10-11"格式的CPU列表，格式错误的部分会被忽略
+    static std::vector<int> ParseCpuList(const std::string &spec);
+    // 从配置文件中读取key对应的CPU列表，reactor_cpus会按nic_numa_steer限制到网卡所在的NUMA节点
+    static std::vector<int> CpusFromConfig(const std::string &key);
+
+    // 将当前线程绑定到cpus中的所有CPU上，cpus为空时不做任何事。内存仍按内核默认的策略在首次访问的节点上分配，
+    // muduo的连接缓冲区由accept线程创建，因此accept_cpus也应当与reactor_cpus在同一个节点上
+    static bool PinCurrentThread(const std::vector<int> &cpus);
+    // 将当前线程绑定到单个CPU上
+    static bool PinCurrentThread(int cpu);
+
+    // 网卡所在的NUMA节点，未知时返回-1
+    static int NicNumaNode(const std::string &nic);
+    // NUMA节点上的CPU列表
+    static std::vector<int> NodeCpus(int node);
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef _KrpcBulk_H
+#define _KrpcBulk_H
+// 大负载旁路：控制面仍然走普通的Krpc TCP帧，负载超过ucx_bulk_threshold时帧里只带一个BulkDescriptor，
+// 负载本身留在发送方已注册的内存中，由接收方通过UCX的RMA get直接读取，不经过socket缓冲区，
+// 也不会因为一个上百MB的负载卡住同一连接上的小调用。
+// 读取完成后接收方用活动消息通知发送方，内存这时才归还内存池复用。没有收到通知就结束的暴露
+// （调用超时、对端异常后过期）直接注销内存，已经交出去的rkey随之失效，迟到的读取读不到后来的数据
+#ifdef KRPC_WITH_UCX
+#include "Krpcheader.pb.h"
+#include "ucpconnection.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 进程内共享的UCX上下文，第一次使用时按配置（ucx_transports、ucx_pool_bytes）创建，失败时返回nullptr
+std::shared_ptr<UCXContext> KrpcSharedUcxContext();
+
+class KrpcBulkAgent
+{
+public:
+    using FetchCallback = std::function<void(bool ok, UCXBuffer data)>;
+
+    // 配置了ucx_bulk_threshold时返回进程内唯一的实例，否则（或UCX初始化失败时）返回nullptr
+    static KrpcBulkAgent *Instance();
+
+    // 负载达到该大小时走旁路
+    size_t threshold() const { return threshold_; }
+    UCXMemoryPool &pool() { return loop_.context().pool(); }
+
+    // 暴露一块已经写好负载的缓冲区，填好描述符，返回false时调用方应改走普通路径
+    bool Expose(UCXBuffer data, Krpc::BulkDescriptor *desc);
+    // 调用结束时释放暴露的缓冲区，可以在任意线程调用。对端还没有通知读取完成时，
+    // 它的读取可能仍在进行，缓冲区注销后释放而不归还内存池
+    void Release(uint64_t bulk_id);
+
+    // 异步读取对端暴露的负载，done在progress线程中回调，不能在其中阻塞
+    void FetchAsync(const Krpc::BulkDescriptor &desc, FetchCallback done);
+    // 同步读取，超时或失败时返回false
+    bool Fetch(const Krpc::BulkDescriptor &desc, int timeout_ms, UCXBuffer *data);
+
+private:
+    struct Exposure
+    {
+        UCXBuffer data;
+        std::chrono::steady_clock::time_point expire;
+    };
+    struct FetchOp;
+
+    KrpcBulkAgent(const std::shared_ptr<UCXContext> &context, size_t threshold);
+    bool Init();
+    void StartFetch(const Krpc::BulkDescriptor &desc, FetchCallback done);
+    ucp_ep_h EndpointFor(const std::string &worker_address);
+    void SendRelease(ucp_ep_h ep, uint64_t bulk_id);
+    // 对端通知读取已经完成，缓冲区可以归还内存池
+    void Recycle(uint64_t bulk_id);
+    void ExpireExposures();
+    static void OnFetchDone(void *request, ucs_status_t status, void *user_data);
+    static void OnReleaseSent(void *request, ucs_status_t status, void *user_data);
+    static ucs_status_t OnRelease(void *arg, const void *header, size_t header_length, void *data, size_t length,
+                                  const ucp_am_recv_param_t *param);
+    static void OnError(void *arg, ucp_ep_h ep, ucs_status_t status);
+
+    UCXEventLoop loop_;
+    size_t threshold_;
+    std::string worker_address_;
+
+    std::mutex exposures_mutex_;
+    std::unordered_map<uint64_t, Exposure> exposures_;
+    uint64_t next_bulk_id_ = 0;
+
+    std::unordered_map<std::string, ucp_ep_h> endpoints_; // 按对端worker地址缓存的端点，只在progress线程中访问
+    std::chrono::steady_clock::time_point next_expire_check_;
+};
+
+#endif // KRPC_WITH_UCX
+#endif
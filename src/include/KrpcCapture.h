@@ -0,0 +1,66 @@
+#ifndef _KrpcCapture_H
+#define _KrpcCapture_H
+// 服务端抓取请求样本，写入二进制的抓包文件，供krpc_replay按真实的方法分布和负载重放。
+// 每个请求按capture_sample_rate抽样，抽中后还要受每秒条数和文件大小的限制；抽中的请求拷贝一份交给后台线程写出，
+// 处理请求的线程不做IO。没有配置capture_file时只多一次判断。配置：
+//   capture_file         抓包文件，不设置时不抓包；启动时截断重写
+//   capture_sample_rate  抽样比例，0到1，默认1
+//   capture_max_rps      每秒最多抓取的请求数，默认1000
+//   capture_max_mb       文件大小上限（MB），写满后停止抓包，默认256
+// 抓的是解压后的参数和附件，流式调用和参数走UCX旁路的请求不抓。文件格式（整数都是小端序）：
+//   文件头  "KRPCCAP1"
+//   每条记录 u32 记录长度（不含这4字节）、i64 到达时刻（Unix纳秒）、u32 头部长度、u32 参数长度、u32 附件长度，
+//           之后依次是序列化的RpcHeader、参数、附件。头部中只保留服务名、方法名、优先级等与重放有关的字段
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Krpcheader.pb.h"
+#include "KrpcSampling.h"
+
+class KrpcCapture
+{
+public:
+    // 抓包文件中的一条记录
+    struct Entry
+    {
+        int64_t arrival_unix_ns;
+        Krpc::RpcHeader header;
+        std::string args;
+        std::string attachment;
+    };
+
+    static KrpcCapture &Instance();
+
+    // 这个请求是否需要抓取（抽样和每秒条数限制），返回true后调用Record
+    bool Sample();
+    void Record(const Krpc::RpcHeader &header, const char *args, size_t args_size, const char *attachment,
+                int64_t arrival_unix_ns);
+    // 以OpenMetrics文本格式追加抓取和丢弃的请求数
+    void AppendMetrics(std::string *out);
+
+    // 读取整个抓包文件，格式错误时返回false并给出原因
+    static bool ReadFile(const std::string &path, std::vector<Entry> *entries, std::string *error);
+
+private:
+    KrpcCapture();
+    void WriteLoop();
+
+    bool enabled_ = false;           // 配置了capture_file并且文件已经打开
+    uint64_t sample_threshold_ = 0;  // 随机数小于它时抽中
+    bool sample_all_ = true;
+    uint32_t max_rps_;
+    uint64_t max_bytes_;
+    FILE *file_ = nullptr;
+    KrpcRateWindow rate_window_;     // 每秒抽中的请求数不超过max_rps_
+    std::atomic<uint64_t> reserved_; // 已经交给后台线程的字节数（含文件头），不超过max_bytes_
+    std::atomic<uint64_t> captured_;
+    std::atomic<uint64_t> dropped_;  // 抽中但因为大小上限或者待写的数据过多而丢弃的请求
+    std::mutex mutex_;
+    std::vector<std::string> pending_; // 待写出的记录
+    size_t pending_bytes_ = 0;
+};
+
+#endif
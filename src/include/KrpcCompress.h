@@ -0,0 +1,92 @@
+#ifndef _KrpcCompress_H
+#define _KrpcCompress_H
+// 帧负载的压缩。压缩只作用于protobuf负载（args/response），附件保持原样；
+// 负载小于方法的压缩阈值、或者压缩后没有变小时照常发送原始负载。
+// 协商方式：服务端在ZooKeeper的地址信息中登记自己能解压的算法（compress=位掩码），
+// 客户端在请求头的accept_compress中带上自己能解压的算法，双方各自从对端接受的算法中选出要用的。
+// LZ4和Zstd只有CMake找到对应的库时才会编译（KRPC_WITH_LZ4/KRPC_WITH_ZSTD）
+#include "Krpcheader.pb.h"
+#include "KrpcCompressDict.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 算法在协商位掩码中对应的位
+inline uint32_t KrpcCompressBit(Krpc::CompressType type)
+{
+    return 1u << static_cast<uint32_t>(type);
+}
+
+// 一条负载的压缩方式
+struct KrpcCompressChoice
+{
+    Krpc::CompressType type = Krpc::COMPRESS_NONE;
+    int level = 0;      // 只对zstd有效
+    int candidate = -1; // 自适应选择时的候选序号（见KrpcAdaptiveCompress.h）
+};
+
+// 从配置读取的压缩策略，进程内共享
+//   compress_type        本端使用的算法：lz4、zstd，或auto表示按观测到的压缩效果和链路负载自动选择；
+//                        不设置时不压缩（仍然可以解压对端的负载）
+//   compress_level       zstd的压缩级别，默认为1
+//   compress_threshold   负载不小于该字节数时才压缩，默认4096；
+//                        可以用compress_threshold.<服务名>.<方法名>为单个方法单独设置，0表示该方法不压缩
+//   max_message_bytes    一条消息负载的上限，默认64MB：帧头中的负载加附件长度、解压出的长度都不能超过它，
+//                        防止对端在头部填一个很大的值让本端分配内存
+class KrpcCompressPolicy
+{
+public:
+    static const KrpcCompressPolicy &Instance();
+
+    // 本端能解压的算法
+    uint32_t SupportedMask() const { return supported_mask_; }
+    bool Enabled() const { return preferred_ != Krpc::COMPRESS_NONE || adaptive_; }
+    bool Adaptive() const { return adaptive_; }
+    // zstd的压缩级别
+    int Level() const { return level_; }
+    // 固定配置下按对端能解压的算法选出压缩方式，对端不支持时返回COMPRESS_NONE
+    KrpcCompressChoice Choose(uint32_t peer_mask) const;
+    // 方法的压缩阈值，0表示不压缩。每次都会查配置，调用方应自行缓存
+    size_t Threshold(const std::string &service_name, const std::string &method_name) const;
+    // 一条消息负载的上限
+    size_t MaxMessageBytes() const { return max_message_bytes_; }
+
+private:
+    KrpcCompressPolicy();
+    uint32_t supported_mask_;
+    Krpc::CompressType preferred_;
+    bool adaptive_;
+    int level_;
+    size_t default_threshold_;
+    size_t max_message_bytes_;
+};
+
+// 压缩器，持有可复用的压缩和解压上下文，避免每次调用都分配。
+// 不是线程安全的，每个连接（或线程）使用自己的实例
+class KrpcCompressor
+{
+public:
+    KrpcCompressor();
+    ~KrpcCompressor();
+    KrpcCompressor(const KrpcCompressor &) = delete;
+    KrpcCompressor &operator=(const KrpcCompressor &) = delete;
+
+    // 压缩src写入out，out原有的容量会被复用。level只对zstd有效
+    bool Compress(Krpc::CompressType type, int level, const char *src, size_t len, std::string *out);
+    // 用字典压缩，结果总是zstd格式
+    bool CompressWithDict(const KrpcZstdDict &dict, const char *src, size_t len, std::string *out);
+    // 解压出raw_size字节写入out，out原有的容量会被复用。dict_id不为0时从KrpcDictStore中取字典。
+    // raw_size超过max_message_bytes或者超过len字节的压缩数据最多能解压出的长度时直接失败，不分配内存
+    bool Decompress(Krpc::CompressType type, uint32_t dict_id, const char *src, size_t len, size_t raw_size,
+                    std::string *out);
+
+private:
+    struct Contexts;
+    std::unique_ptr<Contexts> contexts_; // 第一次使用时创建
+};
+
+// 跨消息复用的缓冲区在处理过一条特别大的消息后释放掉，不让每个连接长期占着这块内存
+void KrpcShrinkBuffer(std::string *buffer);
+
+#endif
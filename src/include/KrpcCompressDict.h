@@ -0,0 +1,84 @@
+#ifndef _KrpcCompressDict_H
+#define _KrpcCompressDict_H
+// 小消息的Zstd字典压缩。单独压缩几百字节的消息几乎没有收益，但同一个方法的消息之间高度相似，
+// 用离线训练好的字典（见tools/krpc_dict_train）压缩就能得到可观的压缩率。
+// 字典放在compress_dict_dir目录中，文件名为<服务名>.<方法名>.dict，两端各自定期扫描目录，文件变化时热加载；
+// 加载过的字典按ID一直保留，帧中的dict_id总能找到对应的字典。
+// 每个请求/响应头的accept_dict_id告诉对端本端持有的该方法的字典，对端只会用本端声明过的字典压缩。
+// 只有编译时找到libzstd（KRPC_WITH_ZSTD）才会加载字典
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+// 一个加载好的字典，创建后不再修改，可以在多个线程中同时使用
+class KrpcZstdDict
+{
+public:
+    ~KrpcZstdDict();
+    KrpcZstdDict(const KrpcZstdDict &) = delete;
+    KrpcZstdDict &operator=(const KrpcZstdDict &) = delete;
+
+    uint32_t id() const { return id_; }
+    const std::string &method() const { return method_; }
+    ZSTD_CDict_s *cdict() const { return cdict_; }
+    ZSTD_DDict_s *ddict() const { return ddict_; }
+
+private:
+    friend class KrpcDictStore;
+    KrpcZstdDict() = default;
+    uint32_t id_ = 0;
+    std::string method_;
+    ZSTD_CDict_s *cdict_ = nullptr;
+    ZSTD_DDict_s *ddict_ = nullptr;
+};
+using KrpcZstdDictPtr = std::shared_ptr<const KrpcZstdDict>;
+
+// 字典仓库，进程内唯一
+//   compress_dict_dir          字典目录，不设置时不使用字典
+//   compress_dict_reload_s     重新扫描目录的间隔（秒），默认10
+//   compress_dict_min_bytes    负载不小于该字节数时才用字典压缩，默认32
+class KrpcDictStore
+{
+public:
+    static KrpcDictStore &Instance();
+
+    bool Enabled() const { return !dir_.empty(); }
+    size_t MinBytes() const { return min_bytes_; }
+    // 方法（"服务名.方法名"）当前的字典，没有时返回nullptr
+    KrpcZstdDictPtr ForMethod(const std::string &method);
+    // 按ID查找字典，没有时返回nullptr
+    KrpcZstdDictPtr ById(uint32_t id);
+    // 对端peer（"ip:port"）最近一次声明的方法method的字典ID，没有声明过时返回0。
+    // 记录跟连接无关，重新连接后第一个请求就能用上字典，不必再等对端声明一次
+    uint32_t PeerDictId(const std::string &peer, const std::string &method);
+    void SetPeerDictId(const std::string &peer, const std::string &method, uint32_t id);
+
+private:
+    struct FileState
+    {
+        int64_t mtime = 0;
+        int64_t size = 0;
+    };
+
+    KrpcDictStore();
+    void Scan();
+    void Load(const std::string &method, const std::string &data);
+
+    std::string dir_;
+    int reload_seconds_;
+    size_t min_bytes_;
+    std::map<std::string, FileState> files_; // 只在扫描线程中访问
+    std::mutex mutex_;
+    std::unordered_map<std::string, KrpcZstdDictPtr> by_method_;
+    std::unordered_map<uint32_t, KrpcZstdDictPtr> by_id_;
+    std::unordered_map<std::string, uint32_t> peer_dicts_; // "ip:port|服务名.方法名" -> 对端声明的字典ID
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef _KrpcFragment_H
+#define _KrpcFragment_H
+// 大响应的分片发送。一个连接上的响应按产生的顺序写出，一个200MB的响应会让排在后面的小响应一起等待；
+// 服务端把超过fragment_bytes（默认256KB）的响应帧切成分片，不同调用的分片按优先级轮流发送，
+// 并且只在连接的发送缓冲区基本写空后才放入下一个分片，小响应最多只需要等待一个分片和内核的发送缓冲区。
+// 分片帧的响应头带有fragment_total（完整帧的长度）和fragment_offset，response中是完整帧的一段；
+// 客户端为每个调用按fragment_total一次分配好缓冲区，依次拷入各个分片，拼完后当作普通的帧处理。
+// 同一调用的帧（例如流消息）总是按顺序、逐帧完整地发送，分片只在不同调用之间交错。
+// 只有在请求头中声明了accept_fragment的客户端才会收到分片
+#include "Krpcheader.pb.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// 服务端一个连接上的分片发送队列，只在连接所属的IO线程中使用
+class KrpcFragmentScheduler
+{
+public:
+    explicit KrpcFragmentScheduler(size_t fragment_size);
+
+    // 这一帧是否需要交给分片队列：帧超过分片大小，或者同一调用还有帧在队列中（保证同一调用的帧按顺序发送）
+    bool Wants(uint64_t call_id, size_t frame_size) const;
+    // priority越大越先发送，同一优先级的调用轮流发送分片
+    void Add(uint64_t call_id, uint32_t priority, std::string frame);
+    bool Empty() const { return calls_.empty(); }
+    // 取出下一段要写入连接的数据（一个分片帧，或者排在大帧之后的一个小帧），追加到out
+    void Next(std::string *out);
+    size_t fragment_size() const { return fragment_size_; }
+
+private:
+    struct Call
+    {
+        uint64_t call_id;
+        uint32_t priority;
+        std::deque<std::string> frames;
+        size_t offset = 0; // 队首的帧已经发出的字节数
+    };
+
+    size_t fragment_size_;
+    std::map<uint32_t, std::deque<std::shared_ptr<Call>>, std::greater<uint32_t>> queues_;
+    std::unordered_map<uint64_t, std::shared_ptr<Call>> calls_;
+};
+
+// 客户端把分片拼回完整的帧，只在接收线程中使用
+class KrpcFragmentAssembler
+{
+public:
+    enum class Status
+    {
+        kPending,  // 还有分片没有到达
+        kComplete, // frame中是拼好的完整帧
+        kError     // 分片不连续或者长度不对，连接无法继续使用
+    };
+
+    // 收下一个分片，data是header.response_size()字节的分片内容
+    Status Add(const Krpc::RpcResponseHeader &header, const char *data, std::string *frame);
+
+private:
+    struct Partial
+    {
+        std::string data; // 按完整帧的长度预先分配
+        size_t filled = 0;
+    };
+    std::unordered_map<uint64_t, Partial> partials_;
+};
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef _KrpcLog_H
+#define _KrpcLog_H
+// 请求路径上使用的异步日志。写日志的线程只把格式串的指针和参数的二进制值拷贝进自己的单生产者单消费者环形缓冲区，
+// 不格式化、不加锁、不做系统调用；后台线程定期取出所有线程的记录，按时间排序后格式化并写出。
+// 环满时丢弃新的记录并计数，写日志的线程不会阻塞。
+//   KRPC_LOG_INFO("call {} failed: {}", call_id, error);
+// 格式串必须是字符串字面量，{}依次替换为参数；参数可以是整数、浮点数、bool、const char*和std::string，
+// 字符串在写日志时拷贝（每条记录最多kTextBytes字节，超出的部分截断）。
+// 每个日志点每秒最多输出log_site_rate条（默认100），超出的被压制，下一条输出时带上压制的条数。配置：
+//   log_level        最低输出级别：debug/info/warning/error，默认info，运行时可以用KrpcLog::SetLevel修改
+//   log_file         日志文件（追加），不设置时写标准错误
+//   log_site_rate    每个日志点每秒最多输出的条数，0表示不限制
+//   log_ring_records 每个线程的环形缓冲区能容纳的记录数，默认4096
+//   log_flush_ms     后台线程写出的间隔（毫秒），默认50
+#include "KrpcSampling.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+enum class KrpcLogLevel : int
+{
+    kDebug = 0,
+    kInfo = 1,
+    kWarning = 2,
+    kError = 3
+};
+
+// 一个日志点，由宏定义为函数内的静态变量，常量初始化，没有初始化顺序的问题
+struct KrpcLogSite
+{
+    constexpr KrpcLogSite(const char *file_, int line_, KrpcLogLevel level_)
+        : file(file_), line(line_), level(level_), suppressed(0)
+    {
+    }
+    // 按每秒的窗口限流，返回false表示这一条被压制
+    bool Admit();
+
+    const char *file;
+    int line;
+    KrpcLogLevel level;
+    KrpcRateWindow rate_window;      // 每秒输出的条数不超过log_site_rate
+    std::atomic<uint64_t> suppressed; // 还没有报告的被压制的条数
+};
+
+// 一条记录中的一个参数
+struct KrpcLogArg
+{
+    enum Type : uint8_t
+    {
+        kInt,
+        kUint,
+        kDouble,
+        kBool,
+        kText // 拷贝到记录的文本区中，value.u的低32位是偏移，高32位是长度
+    };
+    Type type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+    } value;
+};
+
+// 环形缓冲区中的一条记录，定长以免写日志时分配内存
+struct KrpcLogRecord
+{
+    static const int kMaxArgs = 8;
+    static const size_t kTextBytes = 160;
+
+    const KrpcLogSite *site;
+    const char *format;
+    int64_t time_ns; // 墙上时间
+    uint64_t suppressed; // 在这一条之前被压制的条数
+    uint32_t tid;
+    uint16_t text_used;
+    uint8_t nargs;
+    KrpcLogArg args[kMaxArgs];
+    char text[kTextBytes];
+};
+
+class KrpcLog
+{
+public:
+    // 读取配置并启动后台线程，KrpcApplication::Init加载配置后调用；没有调用时第一次写日志时启动
+    static void Start();
+    static bool Enabled(KrpcLogLevel level)
+    {
+        return static_cast<int>(level) >= min_level_.load(std::memory_order_relaxed);
+    }
+    static void SetLevel(KrpcLogLevel level);
+    static KrpcLogLevel Level();
+    // "debug"/"info"/"warning"/"error"，不认识时返回false
+    static bool ParseLevel(const std::string &name, KrpcLogLevel *level);
+    static const char *LevelName(KrpcLogLevel level);
+    // 丢弃的记录数（环满）
+    static uint64_t Dropped();
+    // 以OpenMetrics文本格式追加丢弃和压制的记录数
+    static void AppendMetrics(std::string *out);
+
+    template <typename... Args>
+    static void Write(const KrpcLogSite *site, const char *format, const Args &...args)
+    {
+        KrpcLogRecord *record = Begin(site, format);
+        if (record == nullptr)
+        {
+            return;
+        }
+        Encode(record, args...);
+        Commit();
+    }
+
+private:
+    friend struct KrpcLogSite;
+    // 在当前线程的环中预留一条记录，环满时返回nullptr
+    static KrpcLogRecord *Begin(const KrpcLogSite *site, const char *format);
+    static void Commit();
+    static void AddArg(KrpcLogRecord *record, KrpcLogArg::Type type, uint64_t bits);
+    static void AddText(KrpcLogRecord *record, const char *data, size_t size);
+
+    static void Encode(KrpcLogRecord *) {}
+    template <typename T, typename... Rest>
+    static void Encode(KrpcLogRecord *record, const T &first, const Rest &...rest)
+    {
+        EncodeOne(record, first);
+        Encode(record, rest...);
+    }
+    static void EncodeOne(KrpcLogRecord *record, bool value) { AddArg(record, KrpcLogArg::kBool, value ? 1 : 0); }
+    static void EncodeOne(KrpcLogRecord *record, char value) { AddText(record, &value, 1); }
+    static void EncodeOne(KrpcLogRecord *record, int value) { EncodeSigned(record, value); }
+    static void EncodeOne(KrpcLogRecord *record, long value) { EncodeSigned(record, value); }
+    static void EncodeOne(KrpcLogRecord *record, long long value) { EncodeSigned(record, value); }
+    static void EncodeOne(KrpcLogRecord *record, unsigned value) { EncodeUnsigned(record, value); }
+    static void EncodeOne(KrpcLogRecord *record, unsigned long value) { EncodeUnsigned(record, value); }
+    static void EncodeOne(KrpcLogRecord *record, unsigned long long value) { EncodeUnsigned(record, value); }
+    static void EncodeOne(KrpcLogRecord *record, double value)
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        AddArg(record, KrpcLogArg::kDouble, bits);
+    }
+    static void EncodeOne(KrpcLogRecord *record, const char *value)
+    {
+        AddText(record, value != nullptr ? value : "(null)", value != nullptr ? strlen(value) : 6);
+    }
+    static void EncodeOne(KrpcLogRecord *record, const std::string &value) { AddText(record, value.data(), value.size()); }
+    static void EncodeSigned(KrpcLogRecord *record, long long value)
+    {
+        AddArg(record, KrpcLogArg::kInt, static_cast<uint64_t>(value));
+    }
+    static void EncodeUnsigned(KrpcLogRecord *record, unsigned long long value)
+    {
+        AddArg(record, KrpcLogArg::kUint, static_cast<uint64_t>(value));
+    }
+
+    static std::atomic<int> min_level_;
+};
+
+// 关闭的级别只多一次原子读，参数不会求值
+#define KRPC_LOG(level, ...)                                                    \
+    do                                                                          \
+    {                                                                           \
+        if (KrpcLog::Enabled(level))                                            \
+        {                                                                       \
+            static KrpcLogSite krpc_log_site_(__FILE__, __LINE__, level);       \
+            if (krpc_log_site_.Admit())                                         \
+            {                                                                   \
+                KrpcLog::Write(&krpc_log_site_, __VA_ARGS__);                   \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+#define KRPC_LOG_DEBUG(...) KRPC_LOG(KrpcLogLevel::kDebug, __VA_ARGS__)
+#define KRPC_LOG_INFO(...) KRPC_LOG(KrpcLogLevel::kInfo, __VA_ARGS__)
+#define KRPC_LOG_WARNING(...) KRPC_LOG(KrpcLogLevel::kWarning, __VA_ARGS__)
+#define KRPC_LOG_ERROR(...) KRPC_LOG(KrpcLogLevel::kError, __VA_ARGS__)
+
+#endif
@@ -1,8 +1,10 @@
 #ifndef KRPC_LOG_H
 #define KRPC_LOG_H
 #include<glog/logging.h>
+#include "KrpcLog.h"
 #include<string>
 //采用RAII的思想
+//Info/Warning/ERROR写入异步日志KrpcLog，不阻塞调用线程；Fatal仍然使用glog，保证进程退出前写出
 
 enum class LogLevel {
     INFO = google::INFO,
@@ -24,6 +26,8 @@ public:
       static void SetLogLevel(LogLevel level) {
         google::SetStderrLogging(static_cast<int>(level));
         currentLogLevel_ = level;
+        KrpcLog::SetLevel(level == LogLevel::INFO ? KrpcLogLevel::kInfo
+                          : level == LogLevel::WARNING ? KrpcLogLevel::kWarning : KrpcLogLevel::kError);
       }
       ~KrpcLogger(){
         google::ShutdownGoogleLogging();
@@ -31,13 +35,13 @@ public:
       //提供静态日志方法
       static void Info(const std::string &message)
       {
-        LOG(INFO)<<message;
+        KRPC_LOG_INFO("{}", message);
       }
       static void Warning(const std::string &message){
-        LOG(WARNING)<<message;
+        KRPC_LOG_WARNING("{}", message);
       }
       static void ERROR(const std::string &message){
-        LOG(ERROR)<<message;
+        KRPC_LOG_ERROR("{}", message);
       }
           static void Fatal(const std::string& message) {
         LOG(FATAL) << message;
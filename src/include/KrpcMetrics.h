@@ -0,0 +1,155 @@
+#ifndef _KrpcMetrics_H
+#define _KrpcMetrics_H
+// 按服务和方法统计调用次数、失败次数、收发的字节数和耗时分布，客户端和服务端分别统计。
+// 记录只写当前线程自己的分片，不加锁也没有原子的读-改-写，热路径上只有几次普通的内存写；
+// 读取时（Snapshot）才把所有线程的分片合并起来，线程退出时它的分片并入全局的累计值。
+// 耗时用HDR风格的对数-线性直方图记录（纳秒），每个2的幂区间再分成32格，相对误差不超过1/32
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 一次调用的各个阶段，客户端记录全部阶段（服务端的三个阶段由响应头带回），服务端只记录自己的三个阶段
+enum KrpcPhase
+{
+    kPhaseDiscovery = 0,   // 客户端：查询ZooKeeper得到服务地址
+    kPhaseConnect,         // 客户端：建立连接
+    kPhaseSerialize,       // 客户端：请求序列化、压缩和编码
+    kPhaseSend,            // 客户端：把请求写入socket
+    kPhaseServerQueue,     // 服务端：请求到达后等待处理
+    kPhaseServerHandler,   // 服务端：业务方法
+    kPhaseServerSerialize, // 服务端：响应序列化和压缩
+    kPhaseNetwork,         // 客户端：等待响应的时间减去服务端的三个阶段，即往返的网络和两端框架的开销
+    kPhaseParse,           // 客户端：响应解压和反序列化
+    kPhaseCount
+};
+const char *KrpcPhaseName(KrpcPhase phase);
+
+// 直方图，不是线程安全的，用于合并后的结果，也可以单独用来统计任意的耗时
+class KrpcHistogram
+{
+public:
+    static const int kSubBucketBits = 6;                                 // 小于64的值每个值一格
+    static const int kMaxValueBits = 42;                                 // 最大约73分钟，更大的值计入最后一格
+    static const int kBuckets = 64 + (kMaxValueBits - kSubBucketBits) * 32;
+
+    static int BucketOf(uint64_t value);
+    // 一格中的最大值，分位数按它报告
+    static uint64_t BucketUpper(int bucket);
+
+    KrpcHistogram() : counts_(kBuckets, 0) {}
+
+    void Record(uint64_t value, uint64_t count = 1);
+    // 按固定间隔发出请求的压测中，一次耗时为value的调用推迟了之后的请求，
+    // 把这些本该发出却没有发出的请求按它们应有的耗时补记进来（消除coordinated omission）
+    void RecordCorrected(uint64_t value, uint64_t expected_interval);
+    // 直接累加一格的计数和总和，用于合并按格保存的数据
+    void AddBucket(int bucket, uint64_t count);
+    void AddSum(uint64_t sum) { sum_ += sum; }
+    void Merge(const KrpcHistogram &other);
+
+    uint64_t Count() const { return count_; }
+    uint64_t Sum() const { return sum_; }
+    uint64_t Max() const;
+    double Mean() const { return count_ == 0 ? 0 : static_cast<double>(sum_) / count_; }
+    // q在[0, 1]之间，没有样本时返回0
+    uint64_t ValueAtQuantile(double q) const;
+    uint64_t BucketCount(int bucket) const { return counts_[bucket]; }
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+};
+
+// 一个方法合并后的统计
+struct KrpcMethodStats
+{
+    std::string side; // "client"或"server"
+    std::string service;
+    std::string method;
+    uint64_t requests = 0;
+    uint64_t errors = 0;
+    uint64_t bytes_in = 0;  // 收到的负载字节数（请求或响应的protobuf负载加附件，压缩前）
+    uint64_t bytes_out = 0; // 发出的负载字节数
+    KrpcHistogram latency;  // 纳秒
+    uint64_t phase_ns[kPhaseCount] = {}; // 各阶段的累计耗时
+    // 服务端：处理请求（解析请求、业务方法同步执行的部分、同步完成时的响应序列化）消耗的线程CPU时间和分配的内存
+    uint64_t cpu_ns = 0;
+    uint64_t alloc_bytes = 0;
+    uint64_t allocs = 0;
+};
+
+// 一侧（客户端或服务端）所有方法合并的一个阶段的耗时分布
+struct KrpcPhaseStats
+{
+    std::string side;
+    KrpcPhase phase;
+    KrpcHistogram latency; // 纳秒
+};
+
+// 进程内唯一的统计
+class KrpcMetrics
+{
+public:
+    enum Side
+    {
+        kClient = 0,
+        kServer = 1
+    };
+    static const int kMaxMethods = 1024; // 可以统计的方法数（客户端和服务端合计），超出的方法不统计
+
+    static KrpcMetrics &Instance();
+
+    // 取得方法的编号，调用方应缓存编号，之后的记录不再查找名字。超出kMaxMethods时返回-1
+    int MethodId(Side side, const std::string &service, const std::string &method);
+    // 记录一次调用，只写当前线程的分片，id为-1时忽略
+    void Record(int id, uint64_t latency_ns, size_t bytes_in, size_t bytes_out, bool failed);
+    // 记录一次调用各阶段的耗时（纳秒，为0的阶段没有发生）。
+    // 每个方法只累计各阶段的总耗时，分布按客户端/服务端合并所有方法统计，以免每个方法都带上一组直方图
+    void RecordPhases(int id, const uint64_t (&phase_ns)[kPhaseCount]);
+    // 记录一次调用消耗的CPU时间（纳秒）和分配的内存
+    void RecordResources(int id, uint64_t cpu_ns, uint64_t alloc_bytes, uint64_t allocs);
+    // 合并所有线程的分片，返回每个有调用记录的方法的统计
+    std::vector<KrpcMethodStats> Snapshot();
+    // 合并所有线程的阶段分布，返回有记录的阶段
+    std::vector<KrpcPhaseStats> PhaseSnapshot();
+    // 以OpenMetrics文本格式追加每个方法的调用次数、字节数和耗时分位数
+    void AppendMetrics(std::string *out);
+    // 以文本表格追加服务端按CPU时间排序的前limit个方法，用于容量规划和按方法核算CPU
+    void AppendTopMethods(std::string *out, size_t limit);
+
+private:
+    struct Shard;
+    struct PhaseShard;
+    struct ThreadShards;
+    friend struct ThreadShards;
+
+    KrpcMetrics();
+    ThreadShards *LocalShards();
+    // 当前线程上编号为id的方法的分片，第一次使用时分配
+    Shard *LocalShard(int id);
+    void Register(ThreadShards *shards);
+    void Unregister(ThreadShards *shards);
+    // 把分片中的数据加到stats上，调用时持有mutex_
+    static void Accumulate(const Shard &shard, KrpcMethodStats *stats);
+    static void AccumulatePhases(const PhaseShard &shard, std::vector<KrpcHistogram> *phases);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, int> ids_;
+    std::vector<KrpcMethodStats> methods_; // 按编号保存的方法名，以及已经退出的线程留下的统计
+    std::vector<ThreadShards *> threads_;
+    std::vector<KrpcHistogram> retired_phases_; // 已经退出的线程留下的阶段分布，按side*kPhaseCount+phase索引
+    Side sides_[kMaxMethods];                   // 每个编号所属的一侧，编号返回前写入
+};
+
+// OpenMetrics文本格式的辅助函数，各模块导出统计时共用
+// 追加一个指标族的HELP和TYPE行，counter类型的name不带_total后缀
+void KrpcAppendMetricFamily(std::string *out, const char *name, const char *type, const char *help);
+// 追加一个样本，labels形如a="x",b="y"，可以为空
+void KrpcAppendMetricSample(std::string *out, const std::string &name, const std::string &labels, double value);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef _KrpcProbes_H
+#define _KrpcProbes_H
+// USDT静态探针（provider为krpc），供bpftrace/perf/SystemTap在不重新编译、不打开日志的情况下观察线上进程。
+// 探针在代码中只是一条nop指令，没有挂载时几乎没有开销；编译环境没有<sys/sdt.h>（systemtap-sdt-dev）
+// 或者定义了KRPC_NO_USDT时探针为空。参数中的字符串是以'\0'结尾的指针，只在触发时有效。
+// 参考脚本见tools/bpftrace。探针和参数：
+//   服务端
+//     request_received(conn, readable_bytes)                           一次读事件，缓冲区中待解析的字节数
+//     header_decoded(call_id, service, method, args_size, attachment_size) 解析出一个请求帧的头部
+//     handler_start(method_id, call_id, service, method, queue_ns)     调用业务方法之前
+//     handler_end(method_id, call_id, handler_ns, failed)              业务方法调用了done
+//     response_sent(call_id, frame_bytes, attachment_bytes)            响应放入连接的待发送缓冲区
+//     conn_accept(conn, peer)   conn_close(conn, peer)                 连接建立和断开，peer形如"ip:port"
+//   客户端
+//     call_start(method_id, call_id, service, method)                  发出请求之前
+//     call_end(method_id, call_id, latency_ns, failed)                 调用返回之前（包括失败的调用）
+//     zk_lookup(path, latency_ns, found)                               查询ZooKeeper得到服务地址
+// conn是muduo的连接名，同一进程内唯一；method_id是KrpcMetrics中的方法编号（超出上限时为-1），call_id是请求头中的调用序号，两端相同
+
+#if defined(__has_include) && !defined(KRPC_NO_USDT)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define KRPC_HAVE_USDT 1
+#endif
+#endif
+
+#ifdef KRPC_HAVE_USDT
+#define KRPC_PROBE2(name, a1, a2) DTRACE_PROBE2(krpc, name, a1, a2)
+#define KRPC_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(krpc, name, a1, a2, a3)
+#define KRPC_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(krpc, name, a1, a2, a3, a4)
+#define KRPC_PROBE5(name, a1, a2, a3, a4, a5) DTRACE_PROBE5(krpc, name, a1, a2, a3, a4, a5)
+#else
+// 参数放在sizeof中不求值，只是避免只为探针计算的变量产生未使用的警告
+#define KRPC_PROBE2(name, a1, a2) do { (void)sizeof(a1); (void)sizeof(a2); } while (0)
+#define KRPC_PROBE3(name, a1, a2, a3) do { KRPC_PROBE2(name, a1, a2); (void)sizeof(a3); } while (0)
+#define KRPC_PROBE4(name, a1, a2, a3, a4) do { KRPC_PROBE3(name, a1, a2, a3); (void)sizeof(a4); } while (0)
+#define KRPC_PROBE5(name, a1, a2, a3, a4, a5) do { KRPC_PROBE4(name, a1, a2, a3, a4); (void)sizeof(a5); } while (0)
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef _KrpcResource_H
+#define _KrpcResource_H
+// 按线程统计资源消耗，服务端用它核算每个方法的CPU时间和内存分配。
+// 内存分配通过替换全局的operator new/delete统计，每次分配只给当前线程的两个计数器加上请求的字节数和次数，不加锁；
+// protobuf消息、std::string等C++分配都会被统计，直接调用malloc的分配不统计。
+// 替换会影响整个程序，因此不在krpc_core中：打开CMake选项KRPC_ALLOC_ACCOUNTING后，
+// 需要统计的程序自己链接krpc_alloc_accounting对象库（$<TARGET_OBJECTS:krpc_alloc_accounting>）。
+// 没有链接时分配数始终为0。配置项resource_accounting=0只是不再记录，已经链接的替换在运行时无法撤销
+#include <cstdint>
+
+struct KrpcAllocCounters
+{
+    uint64_t bytes = 0; // 累计分配的字节数（不扣除释放）
+    uint64_t count = 0; // 累计分配的次数
+};
+
+// 当前线程的累计分配，只增不减，两次读取之差就是期间的分配
+KrpcAllocCounters KrpcThreadAllocCounters();
+// 程序是否链接了分配统计的钩子
+bool KrpcAllocAccountingEnabled();
+// 分配统计的钩子在静态初始化时登记读取当前线程计数器的函数
+void KrpcRegisterAllocCounters(KrpcAllocCounters (*reader)());
+// 当前线程消耗的CPU时间（纳秒，CLOCK_THREAD_CPUTIME_ID），不包括线程等待和睡眠的时间
+uint64_t KrpcThreadCpuNanos();
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef _KrpcSampling_H
+#define _KrpcSampling_H
+// 追踪、流量录制和日志限流共用的抽样工具：线程独立的随机数、采样率到阈值的换算和每秒的放行窗口
+#include <time.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// 每个线程独立的随机数（splitmix64），不需要同步
+inline uint64_t KrpcRandom()
+{
+    static thread_local uint64_t state =
+        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+        (reinterpret_cast<uintptr_t>(&state) * 0x9e3779b97f4a7c15ULL);
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// 把(0, 1)中的采样率换算成阈值，KrpcRandom()小于阈值时抽中；rate不大于0时返回0（不抽样）
+inline uint64_t KrpcSampleThreshold(double rate)
+{
+    return rate > 0 ? static_cast<uint64_t>(rate * 18446744073709551616.0) : 0;
+}
+
+// KrpcSampleThreshold的反向换算，用于日志和监控
+inline double KrpcSampleRate(uint64_t threshold)
+{
+    return threshold / 18446744073709551616.0;
+}
+
+// 每秒最多放行limit次，可以在多个线程中并发使用。
+// 窗口变化时由一个线程清零计数，和它同时到达的少数调用可能仍算在上一秒里，不需要精确
+class KrpcRateWindow
+{
+public:
+    constexpr KrpcRateWindow() : window_(0), admitted_(0) {}
+
+    bool Admit(uint32_t limit)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        int64_t now = ts.tv_sec;
+        int64_t current = window_.load(std::memory_order_relaxed);
+        if (current != now && window_.compare_exchange_strong(current, now, std::memory_order_relaxed)) {
+            admitted_.store(0, std::memory_order_relaxed);
+        }
+        return admitted_.fetch_add(1, std::memory_order_relaxed) < limit;
+    }
+
+private:
+    std::atomic<int64_t> window_;    // 当前窗口（秒）
+    std::atomic<uint32_t> admitted_; // 当前窗口中已经放行的次数
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef _KrpcShmRing_H
+#define _KrpcShmRing_H
+#include "Krpcheader.pb.h"
+#include <google/protobuf/message.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 同机RPC使用的共享内存传输
+// 客户端创建一个memfd，里面放一对单生产者单消费者的环形缓冲区（请求环、响应环），
+// 通过Unix域套接字把memfd和两个eventfd传给服务端。之后请求直接序列化到请求环中，
+// 服务端在环里原地解析；只有对端已经表示要进入睡眠时才写eventfd唤醒它，忙碌时收发不需要任何系统调用。
+
+// 每个环的控制块，生产者和消费者各自修改的字段放在不同的cache line上
+struct KrpcShmRingControl
+{
+    alignas(64) std::atomic<uint64_t> head;             // 生产者写入位置，只增不减
+    alignas(64) std::atomic<uint64_t> tail;             // 消费者读取位置，只增不减
+    alignas(64) std::atomic<uint32_t> consumer_waiting; // 消费者准备睡眠，生产者提交后需要唤醒它
+};
+
+// 单生产者单消费者的环形缓冲区。数据区被连续映射两次，任意位置开始的记录在地址上都是连续的，
+// 因此整条消息可以直接序列化/解析，不需要在环的末尾拆开
+class KrpcShmRing
+{
+public:
+    // 记录的标志位
+    static const uint32_t kRecordTooLarge = 1; // 消息超过了环的容量，记录中没有数据
+
+    void Init(KrpcShmRingControl *control, char *data, size_t capacity);
+    size_t MaxRecordSize() const;
+
+    // 生产者：预留len字节的连续空间，空间不足时返回nullptr
+    char *Reserve(size_t len);
+    // 生产者：提交最近一次Reserve的记录，返回true表示消费者在等待，需要唤醒
+    bool Commit(size_t len, uint32_t flags = 0);
+
+    // 消费者：查看下一条记录，没有记录或者记录已损坏时返回false
+    bool Peek(const char **data, size_t *len, uint32_t *flags);
+    // 消费者：释放Peek得到的记录
+    void Release();
+    // 消费者：声明即将睡眠。返回false表示期间又来了新记录，不应该睡眠
+    bool PrepareWait();
+    void CancelWait();
+
+private:
+    KrpcShmRingControl *control_ = nullptr;
+    char *data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t peeked_ = 0; // Peek得到的记录占用的空间
+};
+
+// memfd中的一对环形缓冲区
+class KrpcShmSegment
+{
+public:
+    KrpcShmSegment() = default;
+    ~KrpcShmSegment();
+    KrpcShmSegment(const KrpcShmSegment &) = delete;
+    KrpcShmSegment &operator=(const KrpcShmSegment &) = delete;
+
+    // 客户端：创建并封印一个新的memfd，每个环的容量向上取整到页大小
+    bool Create(size_t ring_bytes);
+    // 服务端：映射客户端传来的memfd，会检查大小和封印，防止对端截断文件导致SIGBUS
+    bool Attach(int fd, size_t ring_bytes);
+
+    int fd() const { return fd_; }
+    size_t ring_bytes() const { return ring_bytes_; }
+    KrpcShmRing &request_ring() { return request_ring_; }
+    KrpcShmRing &response_ring() { return response_ring_; }
+
+private:
+    bool Map();
+
+    int fd_ = -1;
+    size_t ring_bytes_ = 0;
+    void *control_ = nullptr;
+    char *request_data_ = nullptr;
+    char *response_data_ = nullptr;
+    KrpcShmRing request_ring_;
+    KrpcShmRing response_ring_;
+};
+
+// 客户端的共享内存通道
+class KrpcShmClient
+{
+public:
+    // 连接path上的引导套接字并协商共享内存通道，失败返回nullptr
+    static std::unique_ptr<KrpcShmClient> Connect(const std::string &path, size_t ring_bytes, int spin_us);
+    ~KrpcShmClient();
+
+    // 请求帧能否放进请求环
+    bool Fits(size_t frame_size);
+    // 把请求直接序列化进请求环，等待并在响应环中原地解析响应。失败时返回false并设置error，通道不可再用
+    // header.attachment_size()不为0时attachment是紧跟在请求之后的附件；响应附件拷贝到response_attachment中
+    bool Call(const Krpc::RpcHeader &header, const google::protobuf::Message &request, const char *attachment,
+              google::protobuf::Message *response, std::string *response_attachment, int timeout_ms,
+              std::string *error);
+
+private:
+    KrpcShmClient() = default;
+    bool WaitResponse(int timeout_ms, std::string *error);
+
+    int sock_fd_ = -1;      // 引导用的Unix域套接字，连接断开即表示服务端已经释放通道
+    int request_efd_ = -1;  // 唤醒服务端
+    int response_efd_ = -1; // 唤醒客户端
+    int spin_us_ = 0;       // 等待响应时先自旋的时间
+    KrpcShmSegment segment_;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef _KrpcShmServer_H
+#define _KrpcShmServer_H
+#include "KrpcShmRing.h"
+#include "Krpcheader.pb.h"
+#include "Krpccontroller.h"
+#include <google/protobuf/message.h>
+#include <muduo/net/Channel.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThreadPool.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// 服务端的共享内存通道：在引导套接字上接受客户端传来的memfd和eventfd，
+// 每个通道交给一个muduo IO线程，请求eventfd可读时在请求环中原地解析并分发请求
+class KrpcShmServer
+{
+public:
+    // 发送响应：响应会直接序列化到响应环中，controller中设置的响应附件跟在响应之后
+    using ResponseSender = std::function<void(uint64_t call_id, google::protobuf::Message *response,
+                                              const KrpcController &controller)>;
+    // 处理一个请求，args和attachment指向请求环内部，只在回调期间有效
+    using RequestCallback = std::function<void(const Krpc::RpcHeader &header, const char *args, size_t args_size,
+                                               const char *attachment, const ResponseSender &sender)>;
+
+    KrpcShmServer(muduo::net::EventLoop *loop, const std::string &path);
+    ~KrpcShmServer();
+
+    void setRequestCallback(const RequestCallback &cb) { request_callback = cb; }
+    // 开始监听引导套接字，需要在loop所在线程中调用
+    bool Start(const std::shared_ptr<muduo::net::EventLoopThreadPool> &io_threads);
+
+private:
+    struct Session;
+    using SessionPtr = std::shared_ptr<Session>;
+
+    void OnAccept();
+    void OnBootstrapReadable(const SessionPtr &session);
+    void OnRequestReadable(const SessionPtr &session);
+    void DrainRequests(const SessionPtr &session);
+    void WriteResponse(const SessionPtr &session, uint64_t call_id, google::protobuf::Message *response,
+                       const KrpcAttachment &attachment);
+    void WriteFrame(const SessionPtr &session, const std::string &frame);
+    bool TryWriteFrame(const SessionPtr &session, const std::string &frame);
+    void ScheduleFlush(const SessionPtr &session, int delay_us);
+    void FlushPending(const SessionPtr &session, int next_delay_us);
+    void CloseSession(const SessionPtr &session);
+
+    muduo::net::EventLoop *loop;
+    std::string path;
+    int listen_fd;
+    int next_session_id;
+    std::unique_ptr<muduo::net::Channel> accept_channel;
+    std::shared_ptr<muduo::net::EventLoopThreadPool> io_threads;
+    std::mutex sessions_mutex;
+    std::map<int, SessionPtr> sessions;
+    RequestCallback request_callback;
+};
+
+#endif
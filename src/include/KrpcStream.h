@@ -0,0 +1,171 @@
+#ifndef _KrpcStream_H
+#define _KrpcStream_H
+// 流式调用：一次调用中双方可以各自逐条发送消息，整个结果不需要放进一个response中。
+//   服务端流式调用：客户端通过KrpcChannel发起（见KrpcController::SetStreamHandler），只有服务端发送流消息
+//   双向流：客户端通过KrpcStreamChannel发起（见KrpcStreamChannel.h），一个连接上可以同时进行多个流
+// 流控：每个方向、每个流各有一个窗口，同时限制消息条数和字节数，由接收方给出并在处理完消息后归还：
+//   服务端->客户端的窗口由请求头的stream_window/stream_window_bytes给出，客户端用stream_credit帧归还；
+//   客户端->服务端的窗口由服务端在流建立后用响应头的stream_credit帧给出并归还。
+// 接收方在窗口内收下消息时从不阻塞，只有发送方在窗口用完时阻塞，
+// 因此一个处理得慢的流不会让数据在对端堆积，也不会挡住同一连接上的其他流。
+// 流消息帧带有stream_message标记，服务端最后照常发送的response表示流结束。
+// 流式调用只走TCP/Unix域套接字连接
+#include "Krpccontroller.h"
+#include <google/protobuf/message.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace muduo { namespace net { class EventLoop; } }
+
+// 发送方的窗口，可以在任意线程中使用
+class KrpcStreamCredit
+{
+public:
+    // limit_bytes为false时不限制字节数（对端没有给出字节窗口）
+    KrpcStreamCredit(uint32_t window, uint32_t window_bytes, bool limit_bytes);
+
+    // 为一条size字节的消息占用窗口，窗口用完时may_block决定是否等待。
+    // 字节窗口只要还有剩余就允许发送，因此超出窗口的部分不会多于一条消息。
+    // 返回false表示流已经关闭，或者不允许等待而窗口已经用完
+    bool Acquire(size_t size, bool may_block);
+    // 对端归还了窗口
+    void Grant(uint32_t messages, uint32_t bytes);
+    // 流结束或连接断开，唤醒并拒绝之后的Acquire
+    void Close();
+    bool IsClosed() const;
+
+private:
+    bool Available() const { return messages_ > 0 && (!limit_bytes_ || bytes_ > 0); }
+
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    int64_t messages_;
+    int64_t bytes_;
+    bool limit_bytes_;
+    bool closed_ = false;
+};
+
+// 接收方的消息队列，队列的长度受发给对端的窗口限制，可以在任意线程中使用
+class KrpcStreamInbox
+{
+public:
+    // 归还窗口，在取出消息的线程中调用
+    using GrantFn = std::function<void(uint32_t messages, uint32_t bytes)>;
+
+    KrpcStreamInbox(uint32_t window, uint32_t window_bytes, GrantFn grant);
+
+    // 收下一条消息，从不阻塞；对端超出了窗口时返回false
+    bool Push(std::string message);
+    // 对端已经发完
+    void End();
+    // 连接断开或流被取消，丢弃未取出的消息
+    void Close();
+    // 取出一条消息，队列为空时等待。返回false表示流已经结束
+    bool Pop(std::string *message);
+    // 队列为空且流还没有结束，此时Pop会等待
+    bool WouldBlock() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::string> queue_;
+    uint32_t window_;
+    uint32_t window_bytes_;
+    GrantFn grant_;
+    uint64_t outstanding_ = 0;       // 已经给出窗口、还没有归还的消息条数
+    uint64_t outstanding_bytes_ = 0; // 同上，字节数
+    uint32_t consumed_ = 0;          // 已经取出、还没有归还窗口的消息条数
+    uint64_t consumed_bytes_ = 0;    // 同上，字节数
+    bool ended_ = false;
+    bool closed_ = false;
+};
+
+// 服务端一次流式调用的写端，可以在任意线程中使用
+class KrpcStreamWriter
+{
+public:
+    // 把编码好的帧交给连接发送
+    using FrameSink = std::function<void(std::string frame)>;
+
+    KrpcStreamWriter(uint64_t call_id, uint32_t window, uint32_t window_bytes, muduo::net::EventLoop *loop,
+                     FrameSink sink);
+
+    // 写出一条消息，窗口用完时阻塞到客户端归还窗口。
+    // 返回false表示连接已经断开或者流已经结束，业务方法应停止写入并尽快调用done->Run()。
+    // 连接所属的IO线程不能阻塞等待窗口，窗口用完时直接返回false，大结果应在业务线程中写
+    bool Write(const google::protobuf::Message &message);
+
+    // 框架内部使用：客户端归还了窗口
+    void AddCredit(uint32_t messages, uint32_t bytes);
+    // 框架内部使用：流结束或连接断开，唤醒并拒绝之后的Write
+    void Close();
+    bool IsClosed() const;
+    uint64_t call_id() const { return call_id_; }
+
+private:
+    uint64_t call_id_;
+    muduo::net::EventLoop *loop_;
+    FrameSink sink_;
+    KrpcStreamCredit credit_;
+};
+
+// 服务端双向流的读端，可以在任意线程中使用
+class KrpcStreamReader
+{
+public:
+    KrpcStreamReader(uint64_t call_id, uint32_t window, uint32_t window_bytes, muduo::net::EventLoop *loop,
+                     KrpcStreamWriter::FrameSink sink);
+
+    // 读取客户端发来的下一条消息，还没有到达时等待。
+    // 返回false表示客户端已经发完、连接已经断开，或者消息解析失败。
+    // 和Write一样，在连接所属的IO线程中不能等待，没有消息时直接返回false
+    bool Read(google::protobuf::Message *message);
+
+    // 框架内部使用：收到客户端的一条消息，超出了窗口时返回false
+    bool Push(std::string message) { return inbox_.Push(std::move(message)); }
+    // 框架内部使用：客户端已经发完
+    void End() { inbox_.End(); }
+    // 框架内部使用：流结束或连接断开
+    void Close() { inbox_.Close(); }
+    // 给出初始窗口，流建立后调用一次
+    void Start();
+
+private:
+    void SendCredit(uint32_t messages, uint32_t bytes);
+
+    uint64_t call_id_;
+    uint32_t window_;
+    uint32_t window_bytes_;
+    muduo::net::EventLoop *loop_;
+    KrpcStreamWriter::FrameSink sink_;
+    KrpcStreamInbox inbox_;
+};
+
+// 服务端一次流式调用的两端，普通调用时都为空，服务端流式调用时只有writer
+struct KrpcServerStream
+{
+    std::shared_ptr<KrpcStreamWriter> writer;
+    std::shared_ptr<KrpcStreamReader> reader;
+};
+
+// 接收窗口的配置（stream_window条、stream_window_bytes字节），两端都用它作为自己的接收窗口
+uint32_t KrpcStreamWindow();
+uint32_t KrpcStreamWindowBytes();
+
+// 客户端把每条流消息解析成T再交给fn，用法：
+//   controller.SetStreamHandler(KrpcTypedStreamHandler<Kuser::Row>([](const Kuser::Row &row) { ...; return true; }));
+template <typename T>
+KrpcController::StreamHandler KrpcTypedStreamHandler(std::function<bool(const T &)> fn)
+{
+    return [fn](const char *data, size_t size) {
+        T message;
+        return message.ParseFromArray(data, static_cast<int>(size)) && fn(message);
+    };
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef _KrpcStreamChannel_H
+#define _KrpcStreamChannel_H
+// 双向流的客户端（流控见KrpcStream.h）。KrpcStreamChannel持有一条到服务端的连接，
+// 连接上可以同时打开多个流，每个流各自有两个方向的窗口；一个独立的接收线程把收到的帧分发给各个流，
+// 分发时只是放进流的队列，某个流处理得慢不会挡住其他流。用法：
+//   auto channel = KrpcStreamChannel::Connect(Kuser::IngestRpc::descriptor()->FindMethodByName("Push"));
+//   auto stream = channel->Open(method, open_request);
+//   写线程：while (...) stream->Write(batch);  stream->WritesDone();
+//   读线程：while (stream->Read(&ack)) ...;   stream->Finish(&response, &error);
+#include "KrpcStream.h"
+#include "KrpcFragment.h"
+#include "Krpcheader.pb.h"
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class KrpcStreamChannel;
+
+// 客户端的一个双向流，Write和Read可以在不同的线程中同时调用
+class KrpcBidiStream
+{
+public:
+    // 发送一条消息，窗口用完时阻塞到服务端归还窗口；返回false表示流已经结束或连接已经断开
+    bool Write(const google::protobuf::Message &message);
+    // 告诉服务端已经发完，之后不能再Write
+    bool WritesDone();
+    // 读取服务端的下一条消息，还没有到达时等待；返回false表示服务端已经发完或出错，之后调用Finish
+    bool Read(google::protobuf::Message *message);
+    // 等待服务端结束流并取得最终的响应，返回false表示流失败，error为原因
+    bool Finish(google::protobuf::Message *response, std::string *error);
+    uint64_t call_id() const { return call_id_; }
+
+private:
+    friend class KrpcStreamChannel;
+    KrpcBidiStream(KrpcStreamChannel *channel, uint64_t call_id);
+    // 以下在连接的接收线程中调用
+    void OnCredit(uint32_t messages, uint32_t bytes);
+    void OnMessage(std::string message);
+    void OnFinish(std::string response);
+    void OnError(const std::string &error);
+
+    KrpcStreamChannel *channel_;
+    uint64_t call_id_;
+    KrpcStreamCredit credit_; // 客户端->服务端的窗口，由服务端给出
+    KrpcStreamInbox inbox_;   // 服务端发来的消息
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool writes_done_ = false;
+    bool finished_ = false;
+    std::string response_;
+    std::string error_;
+};
+
+class KrpcStreamChannel
+{
+public:
+    // 通过ZooKeeper查询method所在的服务端并建立连接，失败时返回nullptr。
+    // 连接上可以打开该服务端上任意方法的流，KrpcStreamChannel必须比其上的流活得更久
+    static std::unique_ptr<KrpcStreamChannel> Connect(const google::protobuf::MethodDescriptor *method);
+    ~KrpcStreamChannel();
+
+    // 打开一个双向流，request作为业务方法的request参数，连接已经断开时返回nullptr。
+    // priority同KrpcController::SetPriority，决定服务端分片发送大帧时各个流的先后
+    std::shared_ptr<KrpcBidiStream> Open(const google::protobuf::MethodDescriptor *method,
+                                         const google::protobuf::Message &request, uint32_t priority = 0);
+
+private:
+    friend class KrpcBidiStream;
+    explicit KrpcStreamChannel(int fd);
+    // 多个流的线程并发发送，每一帧整体互斥写出
+    bool SendFrame(Krpc::RpcHeader header, const std::string &payload);
+    void ReceiveLoop();
+    void Dispatch(const Krpc::RpcResponseHeader &header, const char *payload);
+    std::shared_ptr<KrpcBidiStream> FindStream(uint64_t call_id);
+
+    int fd_;
+    std::mutex send_mutex_;
+    std::mutex streams_mutex_;
+    std::map<uint64_t, std::shared_ptr<KrpcBidiStream>> streams_;
+    bool closed_ = false; // 连接已经断开，由streams_mutex_保护
+    std::atomic<uint64_t> next_call_id_;
+    std::thread receiver_;
+    KrpcFragmentAssembler fragments_; // 只在接收线程中使用
+};
+
+#endif
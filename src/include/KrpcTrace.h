@@ -0,0 +1,132 @@
+#ifndef _KrpcTrace_H
+#define _KrpcTrace_H
+// 分布式追踪：每次调用在客户端和服务端各产生一个span，追踪上下文（trace/span/父span/采样标志）随请求头传递。
+// 服务端处理请求期间把上下文设为当前线程的上下文，业务方法在同一线程中发起的嵌套调用自动成为它的子span。
+// 是否采样在调用链的入口按trace_sample_rate决定，之后整条链路都遵循入口的决定；
+// 不采样的调用只多生成两个随机数，不记录span。
+// span先写入进程内的无锁环形缓冲区，由后台线程定期取出，以每行一个JSON对象的格式写入文件或者发往本机的采集器（UDP）。
+// 环满时丢弃新的span并计数，记录span的线程不会阻塞。配置：
+//   trace_sample_rate    入口处的采样比例，0到1，默认0（不作为入口采样，但仍然传递和记录上游已采样的调用链）
+//   trace_file           span写入的文件（追加）
+//   trace_collector      span发往的采集器地址ip:port（UDP，每个数据报一个span），trace_file和它都不设置时不记录span
+//   trace_ring_size      环形缓冲区能容纳的span个数，默认65536
+//   trace_flush_ms       后台线程取出span的间隔（毫秒），默认100
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace Krpc
+{
+class TraceContext;
+}
+
+// 一次调用在调用链中的位置
+struct KrpcTraceContext
+{
+    uint64_t trace_id = 0;       // 整条调用链共用，0表示没有上下文
+    uint64_t span_id = 0;        // 本次调用的span
+    uint64_t parent_span_id = 0; // 父span，0表示调用链的入口
+    bool sampled = false;        // 是否记录span
+
+    bool valid() const { return trace_id != 0; }
+    void ToProto(Krpc::TraceContext *proto) const;
+    static KrpcTraceContext FromProto(const Krpc::TraceContext &proto);
+};
+
+// 环形缓冲区中的一个span，定长以免记录时分配内存
+struct KrpcSpanRecord
+{
+    enum Kind : uint8_t
+    {
+        kClient = 0,
+        kServer = 1
+    };
+    uint64_t trace_id;
+    uint64_t span_id;
+    uint64_t parent_span_id;
+    int64_t start_unix_ns; // 墙上时间，用于对齐不同机器上的span
+    uint64_t duration_ns;
+    Kind kind;
+    bool failed;
+    char name[86]; // "服务名.方法名"，过长时截断
+};
+
+// 多生产者多消费者的有界无锁队列（每格带序号，见Vyukov的bounded MPMC queue），满时Push返回false
+class KrpcSpanRing
+{
+public:
+    explicit KrpcSpanRing(size_t capacity); // 向上取整为2的幂
+    bool Push(const KrpcSpanRecord &record);
+    bool Pop(KrpcSpanRecord *record);
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        KrpcSpanRecord record;
+    };
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    // 两个位置分别由生产者和消费者修改，中间隔开一个cache line（对象用new分配，不用alignas）
+    std::atomic<size_t> enqueue_pos_;
+    char pad_[64];
+    std::atomic<size_t> dequeue_pos_;
+};
+
+// 追踪，进程内唯一
+class KrpcTracer
+{
+public:
+    static KrpcTracer &Instance();
+
+    // 当前线程正在处理的调用的上下文，没有时valid()为false
+    static const KrpcTraceContext &Current();
+    // 客户端发起调用：有当前上下文时生成它的子span，否则作为入口按采样比例决定；
+    // 既没有上下文也没有开启采样时返回的上下文无效，请求头中不带追踪上下文
+    KrpcTraceContext StartClient();
+    // 服务端收到请求：incoming有效时生成它的子span，否则作为入口按采样比例决定
+    KrpcTraceContext StartServer(const KrpcTraceContext &incoming);
+    // 调用结束，采样的调用写入一个span
+    void Finish(const KrpcTraceContext &context, KrpcSpanRecord::Kind kind, const std::string &service,
+                const std::string &method, int64_t start_unix_ns, uint64_t duration_ns, bool failed);
+    // 以OpenMetrics文本格式追加导出和丢弃的span数
+    void AppendMetrics(std::string *out);
+
+    // 墙上时间（纳秒），span的开始时间
+    static int64_t UnixNanos();
+
+private:
+    KrpcTracer();
+    bool SampleRoot();
+    void ExportLoop();
+    void Export(const KrpcSpanRecord &record);
+
+    uint64_t sample_threshold_ = 0; // 随机数小于它时采样，0表示不作为入口采样
+    bool sample_all_ = false;       // trace_sample_rate>=1
+    std::unique_ptr<KrpcSpanRing> ring_; // 没有配置输出时为空
+    int flush_ms_;
+    FILE *file_ = nullptr;
+    int collector_fd_ = -1;
+    std::string collector_addr_; // sockaddr_in，按字节保存以免头文件依赖网络头
+    std::atomic<uint64_t> exported_;
+    std::atomic<uint64_t> dropped_;
+};
+
+// 在作用域内把context设为当前线程的上下文，离开时恢复原来的上下文。
+// 业务方法把请求交给其他线程处理时，在那个线程中用controller->TraceContext()建立作用域，嵌套调用就能接上调用链
+class KrpcTraceScope
+{
+public:
+    explicit KrpcTraceScope(const KrpcTraceContext &context);
+    ~KrpcTraceScope();
+    KrpcTraceScope(const KrpcTraceScope &) = delete;
+    KrpcTraceScope &operator=(const KrpcTraceScope &) = delete;
+
+private:
+    KrpcTraceContext saved_;
+};
+
+#endif
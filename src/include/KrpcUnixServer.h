@@ -0,0 +1,50 @@
+#ifndef _KrpcUnixServer_H
+#define _KrpcUnixServer_H
+#include <muduo/net/Callbacks.h>
+#include <muduo/net/Channel.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThreadPool.h>
+#include <muduo/net/TcpConnection.h>
+#include <map>
+#include <memory>
+#include <string>
+
+// 在Unix域套接字上接受连接，并把连接交给muduo的IO线程处理
+// muduo的TcpServer只支持AF_INET/AF_INET6，这里仿照TcpServer自己完成accept，
+// 之后的读写仍由muduo::net::TcpConnection负责，因此上层的回调和TCP连接完全一样
+class KrpcUnixServer
+{
+public:
+    // path以'@'开头表示抽象命名空间，否则为文件系统路径
+    KrpcUnixServer(muduo::net::EventLoop *loop, const std::string &path);
+    ~KrpcUnixServer();
+
+    void setConnectionCallback(const muduo::net::ConnectionCallback &cb) { connection_callback = cb; }
+    void setMessageCallback(const muduo::net::MessageCallback &cb) { message_callback = cb; }
+
+    // 开始监听，新连接轮流分配给io_threads中的IO线程；需要在loop所在线程中调用
+    bool Start(const std::shared_ptr<muduo::net::EventLoopThreadPool> &io_threads);
+
+    // 创建监听在path上的非阻塞Unix域套接字，失败返回-1
+    static int Listen(const std::string &path);
+    // 连接到path上的Unix域套接字，失败返回-1
+    static int Connect(const std::string &path);
+
+private:
+    void OnAccept();
+    void RemoveConnection(const muduo::net::TcpConnectionPtr &conn);
+    void RemoveConnectionInLoop(const muduo::net::TcpConnectionPtr &conn);
+
+    muduo::net::EventLoop *loop;
+    std::string path;
+    int listen_fd;
+    int next_conn_id;
+    std::unique_ptr<muduo::net::Channel> accept_channel;
+    std::shared_ptr<muduo::net::EventLoopThreadPool> io_threads;
+    std::map<std::string, muduo::net::TcpConnectionPtr> connections; // 只在loop线程中访问
+
+    muduo::net::ConnectionCallback connection_callback;
+    muduo::net::MessageCallback message_callback;
+};
+
+#endif
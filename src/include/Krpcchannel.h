@@ -4,10 +4,17 @@
 // 目的是为了给客户端进行方法调用的时候，统一接收的
 #include <google/protobuf/service.h>
 #include "zookeeperutil.h"
+#include "Krpcendpoint.h"
+#include "KrpcShmRing.h"
+#include "ucpconnection.h"
+#include "KrpcBulk.h"
+#include "KrpcCompress.h"
+#include "KrpcAdaptiveCompress.h"
 #include <sys/types.h>
 #include <string>
 #include <mutex>
 #include <atomic>
+#include <memory>
 class KrpcChannel : public google::protobuf::RpcChannel
 {
 public:
@@ -27,7 +34,28 @@ private:
     uint16_t m_port;
     std::string method_name;
     int m_idx; // 用来划分服务器ip和port的下标
+    KrpcEndpoint m_endpoint; // 最近一次从ZooKeeper查到的服务地址
+    std::unique_ptr<KrpcShmClient> m_shm; // 同机共享内存通道，跨调用复用，未建立时为空
+#ifdef KRPC_WITH_UCX
+    std::unique_ptr<UCXClient> m_ucx; // UCX连接，跨调用复用，未建立时为空
+#endif
+    KrpcCompressor m_compressor; // 请求压缩和响应解压复用的上下文
+    std::string m_compress_buf;  // 压缩后的请求参数、解压出的响应，跨调用复用
+    size_t m_compress_threshold = 0; // 请求参数不小于该字节数时才压缩，0表示不压缩
+    KrpcCompressTracker *m_compress_tracker = nullptr; // 自适应压缩时本方法在该服务端上的统计
+    uint32_t m_accept_compress = 0;  // 请求头中声明的本端能解压的算法
+    std::string m_dict_method;       // 查找字典用的"服务名.方法名"
+    std::string m_peer;              // 服务端的"ip:port"，服务端声明的字典按它记录在KrpcDictStore中
+    const google::protobuf::MethodDescriptor *m_method = nullptr; // 上面的压缩参数对应的方法
+    const google::protobuf::MethodDescriptor *m_metrics_method = nullptr; // m_metrics_id对应的方法
+    int m_metrics_id = -1;           // 本方法在KrpcMetrics中的编号
+    bool hasConnection() const;
+    bool connectEndpoint();
     bool newConnect(const char *ip, uint16_t port);
+    bool newConnectUnix(const std::string &path);
+    void closeConnection();
+    void resetConnections();
+    bool socketAlive() const;
     std::string QueryServiceHost(ZkClient *zkclient, std::string service_name, std::string method_name, int &idx);
 
     // 超时控制相关的帮助函数
@@ -36,6 +64,7 @@ private:
     int setSocketNonBlocking(int fd);
     static std::mutex s_load_balance_mutex;            // 保护轮询计数器的互斥锁
     static std::atomic<int> s_next_server_index;       // 下一个服务器索引（全局计数器）
+    static std::atomic<uint64_t> s_next_call_id;       // 请求的调用序号（全局计数器）
     std::string SelectServerByRoundRobin(const std::vector<std::string>& server_list);  // 轮询选择服务器
 };
 #endif
@@ -0,0 +1,46 @@
+#ifndef _Krpccodec_H
+#define _Krpccodec_H
+#include "Krpcheader.pb.h"
+#include <google/protobuf/message_lite.h>
+#include <string>
+#include <cstddef>
+
+// Krpc帧的编解码
+// 请求帧：varint(header_size) + RpcHeader + args + attachment
+// 响应帧：varint(header_size) + RpcResponseHeader + response + attachment
+// 附件的长度记在头部的attachment_size中，编码时不包含附件，由调用方紧接着写出（可以直接用writev发送）
+// 帧本身是自描述的，一个缓冲区中可以连续存放多个帧（流水线请求/合并发送的响应）
+class KrpcCodec
+{
+public:
+    enum class DecodeStatus
+    {
+        kComplete,   // 已解析出一个完整的帧
+        kIncomplete, // 数据不足，需要继续接收
+        kError       // 帧格式错误，连接无法继续使用
+    };
+
+    // 将头部和负载编码成一个完整的帧，追加到out的末尾
+    static bool EncodeRequest(const Krpc::RpcHeader &header, const std::string &args, std::string *out);
+    static bool EncodeResponse(const Krpc::RpcResponseHeader &header, const std::string &response, std::string *out);
+
+    // 直接把帧写入调用方提供的内存（例如预先注册好的缓冲区），不经过中间的std::string
+    // header中的args_size/response_size必须已经设置为payload.ByteSizeLong()，WriteFrame使用其缓存的长度
+    static size_t FrameSize(const google::protobuf::MessageLite &header, size_t payload_size);
+    static char *WriteFrame(const google::protobuf::MessageLite &header, const google::protobuf::MessageLite &payload,
+                            char *out);
+
+    // 尝试从data中解析出一个完整的帧
+    // 成功时header为解析出的头部，负载位于data + payload_offset，附件紧跟在负载之后，整个帧的长度为frame_size
+    // 头部带有旁路描述符时帧中没有负载和附件，frame_size不包含它们
+    // 返回kIncomplete时，如果头部已经完整，frame_size被设置为整个帧的长度，调用方可以据此一次备好接收空间
+    // 负载加附件的长度超过max_message_bytes（见KrpcCompressPolicy）时返回kError，不会让调用方按它分配内存
+    static DecodeStatus DecodeRequest(const char *data, size_t len, Krpc::RpcHeader *header,
+                                      size_t *payload_offset, size_t *frame_size);
+    static DecodeStatus DecodeResponse(const char *data, size_t len, Krpc::RpcResponseHeader *header,
+                                       size_t *payload_offset, size_t *frame_size);
+    // 合法的帧最大的长度（头部上限加上负载上限），按对端声明的长度分配接收缓冲区之前用它检查
+    static size_t MaxFrameSize();
+};
+
+#endif
@@ -1,8 +1,26 @@
 #ifndef _Krpccontroller_H
 #define _Krpccontroller_H
 
+#include "KrpcMetrics.h"
+#include "KrpcTrace.h"
 #include <google/protobuf/service.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+
+// 附件的只读视图，不拥有内存
+struct KrpcAttachment
+{
+    const char *data = nullptr;
+    size_t size = 0;
+    bool empty() const { return size == 0; }
+};
+
+class KrpcStreamWriter;
+class KrpcStreamReader;
+
 // 用于描述RPC调用的控制器
 // 其主要作用是跟踪RPC方法调用的状态、错误信息并提供控制功能(如取消调用)。
 class KrpcController : public google::protobuf::RpcController
@@ -25,13 +43,67 @@ public:
     bool IsTimedOut() const;         // 检查是否已超时
     void SetTimedOut();              // 设置为已超时状态
 
+    // 调用的优先级，越大越优先，默认0。服务端分片发送大响应时（见KrpcFragment.h）先发送优先级高的调用，
+    // 同一优先级的调用轮流发送；不受Reset影响
+    void SetPriority(uint32_t priority);
+    uint32_t GetPriority() const;
+
+    // 附件：跟在protobuf负载之后的原始字节，不经过protobuf的序列化和拷贝，适合大块的二进制数据
+    // 客户端：调用前用SetRequestAttachment指定要发送的数据（调用返回前必须保持有效），
+    //         调用成功后用ResponseAttachment读取，数据由控制器持有，直到下一次调用或Reset
+    // 服务端：RequestAttachment指向接收缓冲区，只在业务方法同步执行期间有效，需要异步使用时自行拷贝；
+    //         done->Run()之前用SetResponseAttachment指定响应附件，数据在done->Run()返回前必须保持有效
+    void SetRequestAttachment(const char *data, size_t size);
+    void SetResponseAttachment(const char *data, size_t size);
+    KrpcAttachment RequestAttachment() const;
+    KrpcAttachment ResponseAttachment() const;
+    // 框架内部使用：客户端收到的响应附件，holder持有附件所在的接收缓冲区
+    void SetReceivedAttachment(const char *data, size_t size, std::shared_ptr<void> holder);
+
+    // 服务端流式调用（见KrpcStream.h），只走TCP/Unix域套接字连接
+    // 客户端：调用前用SetStreamHandler设置处理函数，服务端每写一条消息调用一次，data只在调用期间有效；
+    //         返回false时取消调用。处理函数返回后才归还窗口，处理得慢时服务端的写入会被阻塞
+    // 服务端：ResponseStream()不为空表示客户端发起的是流式调用，业务方法用它逐条写出消息，
+    //         写完后照常设置response并调用done->Run()结束流；
+    //         RequestStream()不为空表示双向流（客户端通过KrpcStreamChannel发起），用它逐条读取客户端的消息
+    using StreamHandler = std::function<bool(const char *data, size_t size)>;
+    void SetStreamHandler(StreamHandler handler);
+    const StreamHandler &GetStreamHandler() const;
+    KrpcStreamWriter *ResponseStream() const;
+    KrpcStreamReader *RequestStream() const;
+    // 框架内部使用：服务端为流式调用设置写端和读端
+    void SetResponseStream(std::shared_ptr<KrpcStreamWriter> stream);
+    void SetRequestStream(std::shared_ptr<KrpcStreamReader> stream);
+
+    // 调用各阶段的耗时（纳秒，见KrpcMetrics.h中的KrpcPhase），调用返回后可以读取，没有经过的阶段为0。
+    // 服务端的三个阶段由服务端测量后在响应头中带回（共享内存通道不带回，计入网络阶段）；
+    // 在服务端，业务方法执行期间可以读到排队阶段
+    uint64_t PhaseNanos(KrpcPhase phase) const;
+    // 框架内部使用：记录一个阶段的耗时
+    void SetPhaseNanos(KrpcPhase phase, uint64_t ns);
+
+    // 本次调用的追踪上下文（见KrpcTrace.h）：客户端在调用返回后可以读取trace_id；
+    // 服务端的业务方法把请求交给其他线程时，在那个线程中用KrpcTraceScope建立作用域，嵌套调用就能接上调用链
+    const KrpcTraceContext &TraceContext() const;
+    // 框架内部使用
+    void SetTraceContext(const KrpcTraceContext &context);
+
 private:
     bool m_failed;         // 失败标志
     std::string m_errText; // 错误信息
     bool m_is_canceled;    // 取消标志
     bool m_is_timedout;    // 超时标志
     int m_timeout_ms;      // 超时时间（毫秒）
+    uint32_t m_priority;   // 调用的优先级
     google::protobuf::Closure* m_cancelCallback;  // 取消操作的回调函数
+    KrpcAttachment m_request_attachment;  // 请求附件
+    KrpcAttachment m_response_attachment; // 响应附件
+    std::shared_ptr<void> m_attachment_holder; // 响应附件所在的接收缓冲区
+    StreamHandler m_stream_handler;                   // 客户端的流消息处理函数
+    std::shared_ptr<KrpcStreamWriter> m_response_stream; // 服务端流式调用的写端
+    std::shared_ptr<KrpcStreamReader> m_request_stream;  // 服务端双向流的读端
+    uint64_t m_phase_ns[kPhaseCount];                    // 各阶段的耗时
+    KrpcTraceContext m_trace;                            // 追踪上下文
 
 };
 
@@ -0,0 +1,34 @@
+#ifndef _Krpcendpoint_H
+#define _Krpcendpoint_H
+#include <string>
+#include <cstdint>
+
+// 服务节点在ZooKeeper中登记的地址信息
+// 格式为"ip:port"，后面可以跟若干";key=value"形式的扩展字段，只认识"ip:port"的旧客户端不受影响
+//   host  服务端所在机器的标识，客户端据此判断是否与服务端在同一台机器上
+//   uds   服务端监听的Unix域套接字路径，以'@'开头表示抽象命名空间
+//   shm   共享内存通道的引导套接字路径，格式同uds
+//   ucx   UCX传输监听的端口，IP与TCP相同
+//   bulk  值为1表示服务端可以通过UCX读取旁路的大负载（见KrpcBulk.h）
+//   compress  服务端能解压的算法的位掩码（见KrpcCompress.h）
+struct KrpcEndpoint
+{
+    std::string ip;
+    uint16_t port = 0;
+    std::string host_id;
+    std::string unix_path;
+    std::string shm_path;
+    uint16_t ucx_port = 0;
+    bool bulk = false;
+    uint32_t compress_mask = 0;
+
+    std::string ToString() const;
+    static bool Parse(const std::string &data, KrpcEndpoint *endpoint);
+
+    // 是否与当前进程在同一台机器上
+    bool IsLocalHost() const;
+    // 本机标识：优先使用/etc/machine-id，没有时使用主机名
+    static const std::string &LocalHostId();
+};
+
+#endif
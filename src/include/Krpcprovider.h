@@ -2,15 +2,30 @@
 #define _Krpcprovider_H__
 #include "google/protobuf/service.h"
 #include "zookeeperutil.h"
+#include "KrpcUnixServer.h"
+#include "KrpcShmServer.h"
+#include "ucpconnection.h"
+#include "KrpcBulk.h"
+#include "KrpcCompress.h"
+#include "KrpcAdaptiveCompress.h"
+#include "KrpcStream.h"
+#include "KrpcFragment.h"
+#include "KrpcAdminServer.h"
 #include<muduo/net/TcpServer.h>
 #include<muduo/net/EventLoop.h>
 #include<muduo/net/InetAddress.h>
 #include<muduo/net/TcpConnection.h>
+#include<muduo/net/Buffer.h>
 #include<google/protobuf/descriptor.h>
 #include<functional>
+#include<atomic>
+#include<vector>
 #include<string>
+#include<memory>
 #include<unordered_map>
 
+namespace Krpc { class RpcHeader; }
+
 class KrpcProvider
 {
 public:
@@ -21,16 +36,95 @@ public:
     void Run();
 private:
     muduo::net::EventLoop event_loop;
+    std::unique_ptr<KrpcUnixServer> unix_server; // 同机调用方使用的Unix域套接字监听，未配置时为空
+    std::unique_ptr<KrpcShmServer> shm_server;   // 同机调用方使用的共享内存通道，未配置时为空
+    std::unique_ptr<KrpcAdminServer> admin_server; // 导出统计的管理端口，未配置时为空
+    std::unique_ptr<ZkClient> zk_client;         // 注册服务的ZooKeeper会话，服务运行期间一直保持
+    std::vector<muduo::net::EventLoop*> io_loops; // 处理RPC连接的IO线程
+    std::atomic<int64_t> inflight_requests{0};   // 已经开始处理、还没有发送响应的请求数
+    std::atomic<int64_t> open_connections{0};    // TCP和Unix域套接字上的连接数
+#ifdef KRPC_WITH_UCX
+    std::unique_ptr<UCXServer> ucx_server;       // UCX传输，未配置时为空
+    std::atomic<size_t> next_ucx_loop{0};        // UCX请求轮流交给io_loops处理
+    KrpcBulkAgent* bulk_agent = nullptr;         // 大负载旁路，未配置ucx_bulk_threshold时为空
+#endif
     struct ServiceInfo
     {
         google::protobuf::Service* service;
         std::unordered_map<std::string, const google::protobuf::MethodDescriptor*> method_map;
+        std::unordered_map<std::string, size_t> compress_threshold; // 每个方法响应的压缩阈值，0表示不压缩
+        std::unordered_map<std::string, int> metrics_id; // 每个方法在KrpcMetrics中的编号
     };
     std::unordered_map<std::string, ServiceInfo>service_map;//保存服务对象和rpc方法
+
+    // 每个连接的私有状态，通过TcpConnection::setContext挂在连接上，只在连接所属的IO线程中访问
+    struct ConnectionContext
+    {
+        muduo::net::Buffer pending_output; // 本轮事件循环中产生的响应，循环末尾一次性写出
+        bool flush_scheduled = false;      // 是否已经登记了本轮的flush
+        KrpcCompressor compressor;         // 请求解压和响应压缩复用的上下文
+        std::string compress_buf;          // 解压出的请求参数、压缩后的响应，跨请求复用
+        std::unordered_map<uint64_t, KrpcServerStream> streams; // 进行中的流式调用，按call_id索引
+        bool accept_fragment = false;      // 客户端声明过能拼回分片的响应
+        std::unique_ptr<KrpcFragmentScheduler> fragments; // 分片发送的大响应，未配置fragment_bytes时为空
+        // 自适应压缩时各方法在该客户端上的统计，避免每个响应都拼接键并争用KrpcAdaptiveCompress的全局锁
+        std::unordered_map<const google::protobuf::MethodDescriptor*, KrpcCompressTracker*> compress_trackers;
+    };
+    using ConnectionContextPtr = std::shared_ptr<ConnectionContext>;
     
     void OnConnection(const muduo::net::TcpConnectionPtr& conn);
     void OnMessage(const muduo::net::TcpConnectionPtr& conn, muduo::net::Buffer* buffer, muduo::Timestamp receive_time);
-    void SendRpcResponse(const muduo::net::TcpConnectionPtr& conn, google::protobuf::Message* response);
+    // 发送响应的方式取决于请求来自哪种传输（TCP/Unix域套接字连接、共享内存通道）
+    using ResponseSender = KrpcShmServer::ResponseSender;
+    // 处理一个已经完整解析出头部的请求，业务方法完成后通过sender发送响应
+    // attachment是header.attachment_size()字节的请求附件，args和attachment都只在调用期间有效
+    // stream不为空时是流式调用，业务方法通过controller->ResponseStream()/RequestStream()收发流消息
+    // receive_ns是收到请求时的NowNanos()，用来计算排队阶段，0表示不知道（共享内存通道）
+    void HandleRequest(const Krpc::RpcHeader& header, const char* args, size_t args_size, const char* attachment,
+                       const ResponseSender& sender, const KrpcServerStream& stream, int64_t receive_ns);
+    // 由请求头决定的响应发送方式
+    struct ResponseOptions
+    {
+        bool accept_bulk = false;        // 客户端能够通过UCX读取旁路的响应负载
+        uint32_t accept_compress = 0;    // 客户端能解压的算法
+        size_t compress_threshold = 0;   // 响应负载不小于该字节数时才压缩，0表示不压缩
+        KrpcCompressTracker* compress_tracker = nullptr; // 自适应压缩时本方法在该客户端上的统计
+        uint32_t accept_dict_id = 0;     // 客户端持有的该方法的字典，可以用来压缩响应
+        uint32_t local_dict_id = 0;      // 本端持有的该方法的字典，在响应头中告诉客户端
+        uint32_t priority = 0;           // 调用的优先级，决定分片发送时的先后
+        bool framed = false;             // 客户端按响应帧接收，否则只回序列化的响应（旧版客户端）
+    };
+    ResponseOptions ResponseOptionsFor(const Krpc::RpcHeader& header, const muduo::net::TcpConnectionPtr& conn);
+    // 回一个带错误的响应帧，客户端的调用按error失败，只能发给framed的客户端
+    void SendErrorResponse(const muduo::net::TcpConnectionPtr& conn, uint64_t call_id, const ResponseOptions& options,
+                           const std::string& error);
+    // queue_ns和handler_ns连同本函数中序列化和压缩的耗时写入响应头，由客户端计入各阶段
+    void SendRpcResponse(const muduo::net::TcpConnectionPtr& conn, uint64_t call_id, google::protobuf::Message* response,
+                         const KrpcAttachment& attachment, const ResponseOptions& options, uint64_t queue_ns,
+                         uint64_t handler_ns);
+    // 为流式调用创建写端（双向流还有读端）并登记在连接上，需要在连接所属的IO线程中调用
+    KrpcServerStream OpenStream(const muduo::net::TcpConnectionPtr& conn, const Krpc::RpcHeader& header);
+    // 处理双向流中客户端发来的流消息、结束标记和归还窗口的帧，返回false表示不是这几种帧
+    bool OnStreamFrame(const muduo::net::TcpConnectionPtr& conn, const Krpc::RpcHeader& header, const char* args);
+    // 结束流：拒绝之后的读写，并在流消息之后发送最终的响应
+    void FinishStream(const muduo::net::TcpConnectionPtr& conn, const KrpcServerStream& stream, uint64_t call_id,
+                      google::protobuf::Message* response, const KrpcAttachment& attachment,
+                      const ResponseOptions& options, uint64_t queue_ns, uint64_t handler_ns);
+    // attachment紧接着frame写入待发送缓冲区；大帧以及同一调用排在大帧之后的帧交给分片队列
+    void QueueOutput(const muduo::net::TcpConnectionPtr& conn, uint64_t call_id, uint32_t priority,
+                     const std::string& frame, const KrpcAttachment& attachment = KrpcAttachment());
+    void FlushOutput(const muduo::net::TcpConnectionPtr& conn);
+    // 连接的发送缓冲区低于一个分片时从分片队列中补充，发送缓冲区写空后再次调用
+    void PumpFragments(const muduo::net::TcpConnectionPtr& conn);
+#ifdef KRPC_WITH_UCX
+    void OnUcxMessage(const UCXConnectionPtr& conn, const char* data, size_t len, UCXBuffer* buffer);
+    void FetchBulkRequest(const muduo::net::TcpConnectionPtr& conn, const Krpc::RpcHeader& header, int64_t receive_ns);
+#endif
+
+    size_t fragment_bytes = 0; // 响应帧超过该字节数时分片发送，0表示不分片
+    bool resource_accounting = true; // 按方法统计处理请求消耗的CPU时间和分配的内存
+    // 管理端口的统计：各方法的调用统计、进行中的请求、连接数、IO线程的待执行回调、ZooKeeper会话和内存分配器
+    void AppendMetrics(std::string* out);
 };
 #endif 
 
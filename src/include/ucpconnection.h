@@ -1,56 +1,286 @@
-// // ucx_connection.h
-// #pragma once
-// #include <ucp/api/ucp.h>
-// #include <functional>
-// #include <unordered_map>
-// #include <vector>
-// #include <sys/epoll.h>
-// #include <unistd.h>
-// #include <memory>
-
-// class UCXConnection;
-// using UCXConnectionPtr = std::shared_ptr<UCXConnection>;
-
-// using ConnectionCallback = std::function<void(const UCXConnectionPtr&)>;
-// using MessageCallback = std::function<void(const UCXConnectionPtr&, const char*, size_t)>;
-
-// class UCXServer {
-// public:
-//     UCXServer(ucp_context_h context, ucp_worker_h worker);
-//     ~UCXServer();
-
-//     bool listen(const struct sockaddr* addr, size_t addrlen);
-//     void setConnectionCallback(ConnectionCallback cb);
-//     void setMessageCallback(MessageCallback cb);
-//     void run();
-
-// private:
-//     void pollEvents();
-//     void onConnection(ucp_conn_request_h conn_request);
-//     void progress();
-
-//     ucp_context_h context_;
-//     ucp_worker_h worker_;
-//     ucp_listener_h listener_;
-//     int epoll_fd_;
-//     ConnectionCallback connection_cb_;
-//     MessageCallback message_cb_;
-// };
-
-// class UCXConnection : public std::enable_shared_from_this<UCXConnection> {
-// public:
-//     UCXConnection(ucp_worker_h worker, ucp_ep_h ep, MessageCallback msg_cb);
-//     ~UCXConnection();
-
-//     void asyncSend(const char* data, size_t size);
-//     void asyncRecv();
-
-// private:
-//     static void sendHandler(void* request, ucs_status_t status);
-//     static void recvHandler(void* request, ucs_status_t status, ucp_tag_recv_info_t* info);
-
-//     ucp_worker_h worker_;
-//     ucp_ep_h ep_;
-//     MessageCallback msg_cb_;
-//     std::vector<char> recv_buffer_;
-// };
+#ifndef _ucpconnection_H
+#define _ucpconnection_H
+// UCX传输：请求帧和响应帧作为UCX活动消息(Active Message)整帧收发，帧的格式与TCP连接上完全相同。
+// UCX会根据对端位置和可用的硬件自动选择底层传输（RDMA、共享内存、TCP等），
+// 没有RDMA网卡的机器上可以配置ucx_transports=tcp,shm（或设置环境变量UCX_TLS）验证整条链路。
+// 只有CMake找到UCX时才会定义KRPC_WITH_UCX并编译这部分代码
+#ifdef KRPC_WITH_UCX
+#include <ucp/api/ucp.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 活动消息ID
+enum UCXAmId : unsigned
+{
+    kUCXAmRequest = 1,  // 客户端发往服务端的请求帧
+    kUCXAmResponse = 2, // 服务端发回客户端的响应帧
+    kUCXAmBulkRelease = 3, // 旁路负载已经读取完成，头部是8字节的bulk_id（见KrpcBulk.h）
+};
+
+// 注册内存池默认最多缓存的空闲内存，可以通过ucx_pool_bytes配置
+const size_t kUCXDefaultPoolBytes = 256 * 1024 * 1024;
+
+class UCXServer;
+class UCXConnection;
+class UCXMemoryPool;
+
+// 内存池中的一块已注册内存
+struct UCXMemoryBlock
+{
+    char *data;
+    size_t capacity;
+    ucp_mem_h memh;
+    int size_class; // -1表示超过最大级别、单独分配的块
+};
+
+// 从UCXMemoryPool取得的缓冲区，析构时把内存块归还给内存池
+class UCXBuffer
+{
+public:
+    UCXBuffer() = default;
+    UCXBuffer(UCXBuffer &&other) noexcept;
+    UCXBuffer &operator=(UCXBuffer &&other) noexcept;
+    ~UCXBuffer() { reset(); }
+    UCXBuffer(const UCXBuffer &) = delete;
+    UCXBuffer &operator=(const UCXBuffer &) = delete;
+
+    char *data() const { return block_ != nullptr ? block_->data : nullptr; }
+    size_t size() const { return size_; }
+    ucp_mem_h memh() const { return block_ != nullptr ? block_->memh : nullptr; }
+    explicit operator bool() const { return block_ != nullptr; }
+    void reset();
+    // 不归还内存池，直接注销并释放内存块。rkey已经交给对端的内存用它释放，
+    // 对端迟到的读取只会失败，不会读到之后复用这块内存的调用写入的数据
+    void discard();
+
+private:
+    friend class UCXMemoryPool;
+    UCXMemoryPool *pool_ = nullptr;
+    UCXMemoryBlock *block_ = nullptr;
+    size_t size_ = 0;
+};
+
+// 按大小分级的注册内存池。每一级的块大小是2的幂，从256B到64MB，
+// 块在第一次用到时分配（64字节对齐，4KB以上按页对齐）并通过ucp_mem_map注册，之后反复使用，
+// 省掉大消息每次收发时的注册和注销。超过最大级别的缓冲区单独分配注册，用完即释放；
+// 空闲块的总大小超过max_cached_bytes时，归还的块直接释放。可以在任意线程中使用
+class UCXMemoryPool
+{
+public:
+    UCXMemoryPool(ucp_context_h context, size_t max_cached_bytes);
+    ~UCXMemoryPool();
+    UCXMemoryPool(const UCXMemoryPool &) = delete;
+    UCXMemoryPool &operator=(const UCXMemoryPool &) = delete;
+
+    // 取得size字节的缓冲区，失败时返回空的UCXBuffer
+    UCXBuffer acquire(size_t size);
+
+private:
+    friend class UCXBuffer;
+    enum
+    {
+        kMinBlockShift = 8,  // 256B
+        kMaxBlockShift = 26, // 64MB
+        kNumClasses = kMaxBlockShift - kMinBlockShift + 1,
+    };
+    UCXMemoryBlock *allocate(size_t capacity, int size_class);
+    void release(UCXMemoryBlock *block);
+    void destroy(UCXMemoryBlock *block);
+
+    ucp_context_h context_;
+    size_t max_cached_bytes_;
+    std::mutex mutex_;
+    std::vector<UCXMemoryBlock *> free_[kNumClasses];
+    size_t cached_bytes_ = 0;
+};
+
+// 缓冲区已经注册过，把memh直接交给UCX，省掉在注册缓存中的查找（UCX 1.14起支持）
+void UCXSetMemoryHandle(ucp_request_param_t *param, const UCXBuffer &buffer);
+
+using UCXConnectionPtr = std::shared_ptr<UCXConnection>;
+// buffer不为空时消息是按rendezvous协议收到已注册缓冲区中的，data指向其中，
+// 回调可以把缓冲区移走以便在回调返回后继续使用数据，不必再拷贝；为空时data只在回调期间有效
+using UCXMessageCallback = std::function<void(const UCXConnectionPtr &, const char *, size_t, UCXBuffer *buffer)>;
+
+// UCX上下文，同一进程内的所有worker共享
+class UCXContext
+{
+public:
+    // transports为空时由UCX自行选择（同样受UCX_TLS等环境变量控制），失败返回nullptr
+    // pool_bytes是注册内存池最多缓存的空闲内存
+    static std::shared_ptr<UCXContext> Create(const std::string &transports, size_t pool_bytes);
+    ~UCXContext();
+    UCXContext(const UCXContext &) = delete;
+    UCXContext &operator=(const UCXContext &) = delete;
+
+    ucp_context_h handle() const { return context_; }
+    UCXMemoryPool &pool() { return *pool_; }
+
+private:
+    UCXContext() = default;
+    ucp_context_h context_ = nullptr;
+    std::unique_ptr<UCXMemoryPool> pool_; // 注册内存属于context，必须先于context释放
+};
+
+// worker以单线程模式创建，只能在拥有它的线程中使用
+class UCXWorker
+{
+public:
+    static std::unique_ptr<UCXWorker> Create(const std::shared_ptr<UCXContext> &context);
+    ~UCXWorker();
+    UCXWorker(const UCXWorker &) = delete;
+    UCXWorker &operator=(const UCXWorker &) = delete;
+
+    ucp_worker_h handle() const { return worker_; }
+    bool setAmHandler(unsigned id, ucp_am_recv_callback_t cb, void *arg);
+    // 推进通信直到没有新的进展
+    void progressAll();
+    // 没有待处理的事件时阻塞等待，直到UCX有事件、wakeup_fd可读或超时
+    void wait(int timeout_ms, int wakeup_fd = -1);
+    // 等待一个非阻塞操作完成并释放它，request为空表示操作已经立即完成
+    ucs_status_t waitRequest(ucs_status_ptr_t request);
+
+private:
+    UCXWorker() = default;
+    std::shared_ptr<UCXContext> context_;
+    ucp_worker_h worker_ = nullptr;
+    int efd_ = -1;
+};
+
+// 服务端的一个UCX连接
+class UCXConnection : public std::enable_shared_from_this<UCXConnection>
+{
+public:
+    UCXConnection(UCXServer *server, ucp_ep_h ep);
+
+    // 发送一个完整的帧，可以在任意线程调用，实际发送总是在progress线程中进行，发送完成后缓冲区归还内存池
+    void send(UCXBuffer frame);
+    bool connected() const { return connected_; }
+    UCXMemoryPool &pool();
+
+private:
+    friend class UCXServer;
+    void sendInLoop(const std::shared_ptr<UCXBuffer> &frame);
+    static void sendHandler(void *request, ucs_status_t status, void *user_data);
+
+    UCXServer *server_;
+    ucp_ep_h ep_;
+    std::atomic<bool> connected_;
+};
+
+// 一个worker和推进它的progress线程，worker上的操作都在这个线程中进行
+class UCXEventLoop
+{
+public:
+    explicit UCXEventLoop(const std::shared_ptr<UCXContext> &context);
+    ~UCXEventLoop();
+    UCXEventLoop(const UCXEventLoop &) = delete;
+    UCXEventLoop &operator=(const UCXEventLoop &) = delete;
+
+    // 创建worker，注册活动消息回调等初始化工作需要在init之后、start之前完成
+    bool init();
+    void start(std::function<void()> thread_init_cb);
+    void stop();
+
+    // 在本轮progress结束后由progress线程执行fn，可以在任意线程调用
+    void queueInLoop(std::function<void()> fn);
+    bool isInLoopThread() const;
+    // 非阻塞地关闭端点，progress线程会一直推进到关闭完成
+    void closeEndpoint(ucp_ep_h ep);
+
+    UCXWorker *worker() const { return worker_.get(); }
+    UCXContext &context() const { return *context_; }
+
+private:
+    void run();
+    void runPending();
+    void reapClosing();
+    void wakeup();
+
+    std::shared_ptr<UCXContext> context_;
+    std::unique_ptr<UCXWorker> worker_;
+    std::vector<ucs_status_ptr_t> closing_; // 正在关闭的端点
+    int wakeup_fd_ = -1;
+    std::mutex pending_mutex_;
+    std::vector<std::function<void()>> pending_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+// UCX服务端，在独立的progress线程中接受连接、收发消息
+class UCXServer
+{
+public:
+    explicit UCXServer(const std::shared_ptr<UCXContext> &context);
+    ~UCXServer();
+
+    // 收到完整请求帧时在progress线程中回调
+    void setMessageCallback(UCXMessageCallback cb) { message_cb_ = std::move(cb); }
+    // progress线程启动时回调，用于绑定CPU等
+    void setThreadInitCallback(std::function<void()> cb) { thread_init_cb_ = std::move(cb); }
+    // 超过bytes的请求不接收，0表示不限制。需要在start之前调用
+    void setMaxMessageSize(size_t bytes) { max_message_size_ = bytes; }
+    // 监听ip:port并启动progress线程
+    bool start(const std::string &ip, uint16_t port);
+    UCXMemoryPool &pool() { return loop_.context().pool(); }
+
+private:
+    friend class UCXConnection;
+    struct PendingRecv; // 正在通过rendezvous协议接收的大请求
+
+    static void onConnRequest(ucp_conn_request_h conn_request, void *arg);
+    static ucs_status_t onRequest(void *arg, const void *header, size_t header_length, void *data, size_t length,
+                                  const ucp_am_recv_param_t *param);
+    static void onRecvData(void *request, ucs_status_t status, size_t length, void *user_data);
+    static void onError(void *arg, ucp_ep_h ep, ucs_status_t status);
+
+    UCXEventLoop loop_;
+    ucp_listener_h listener_ = nullptr;
+    std::unordered_map<ucp_ep_h, UCXConnectionPtr> connections_; // 只在progress线程中访问
+    UCXMessageCallback message_cb_;
+    std::function<void()> thread_init_cb_;
+    size_t max_message_size_ = 0;
+};
+
+// 客户端的UCX连接，由调用线程自己推进，不需要后台线程
+class UCXClient
+{
+public:
+    // 失败返回nullptr。端点是异步建立的，连接错误会在第一次Call时报告
+    static std::unique_ptr<UCXClient> Connect(const std::shared_ptr<UCXContext> &context, const std::string &ip,
+                                              uint16_t port);
+    ~UCXClient();
+
+    // 发送请求帧并等待响应帧，响应帧同样放在内存池的缓冲区中。失败时返回false并设置error，连接不可再用
+    bool Call(const UCXBuffer &request_frame, UCXBuffer *response_frame, int timeout_ms, std::string *error);
+    // 请求帧应该直接序列化到从这里取得的缓冲区中
+    UCXMemoryPool &pool() { return context_->pool(); }
+    // 超过bytes的响应按错误处理，0表示不限制
+    void setMaxMessageSize(size_t bytes) { max_message_size_ = bytes; }
+
+private:
+    UCXClient() = default;
+    static ucs_status_t onResponse(void *arg, const void *header, size_t header_length, void *data, size_t length,
+                                   const ucp_am_recv_param_t *param);
+    static void onResponseData(void *request, ucs_status_t status, size_t length, void *user_data);
+    static void onError(void *arg, ucp_ep_h ep, ucs_status_t status);
+    void close();
+
+    std::shared_ptr<UCXContext> context_;
+    std::unique_ptr<UCXWorker> worker_;
+    ucp_ep_h ep_ = nullptr;
+    ucs_status_t error_ = UCS_OK; // 端点出错后不再可用
+    bool response_ready_ = false;
+    UCXBuffer *response_ = nullptr; // 当前调用的响应缓冲区
+    size_t max_message_size_ = 0;
+};
+
+#endif // KRPC_WITH_UCX
+#endif
@@ -27,6 +27,9 @@ public:
     // 获取指定路径下的所有子节点数据
     std::vector<std::string> GetChildrenData(const char *path);
 
+    // 会话状态：connected、connecting、associating、expired、auth_failed，未启动时为closed
+    std::string StateName() const;
+
 private:
     zhandle_t *m_zhandle; // ZooKeeper客户端句柄
 };
@@ -0,0 +1,764 @@
+#include "ucpconnection.h"
+#ifdef KRPC_WITH_UCX
+#include "KrpcLogger.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+
+namespace {
+// progress线程没有事件时最多睡眠的时间，用于检查退出标志
+const int kPollTimeoutMs = 100;
+
+bool MakeSockAddr(const std::string &ip, uint16_t port, struct sockaddr_in *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+    if (ip.empty()) {
+        addr->sin_addr.s_addr = INADDR_ANY;
+        return true;
+    }
+    return inet_pton(AF_INET, ip.c_str(), &addr->sin_addr) == 1;
+}
+
+void CloseEndpointNow(UCXWorker *worker, ucp_ep_h ep) {
+    ucp_request_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = UCP_EP_CLOSE_FLAG_FORCE;
+    worker->waitRequest(ucp_ep_close_nbx(ep, &param));
+}
+}  // namespace
+
+void UCXSetMemoryHandle(ucp_request_param_t *param, const UCXBuffer &buffer) {
+#if UCP_API_VERSION >= UCP_VERSION(1, 14)
+    param->op_attr_mask |= UCP_OP_ATTR_FIELD_MEMH;
+    param->memh = buffer.memh();
+#else
+    (void)param;
+    (void)buffer;
+#endif
+}
+
+UCXBuffer::UCXBuffer(UCXBuffer &&other) noexcept
+    : pool_(other.pool_), block_(other.block_), size_(other.size_) {
+    other.pool_ = nullptr;
+    other.block_ = nullptr;
+    other.size_ = 0;
+}
+
+UCXBuffer &UCXBuffer::operator=(UCXBuffer &&other) noexcept {
+    if (this != &other) {
+        reset();
+        pool_ = other.pool_;
+        block_ = other.block_;
+        size_ = other.size_;
+        other.pool_ = nullptr;
+        other.block_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void UCXBuffer::reset() {
+    if (block_ != nullptr) {
+        pool_->release(block_);
+        pool_ = nullptr;
+        block_ = nullptr;
+        size_ = 0;
+    }
+}
+
+void UCXBuffer::discard() {
+    if (block_ != nullptr) {
+        pool_->destroy(block_);
+        pool_ = nullptr;
+        block_ = nullptr;
+        size_ = 0;
+    }
+}
+
+UCXMemoryPool::UCXMemoryPool(ucp_context_h context, size_t max_cached_bytes)
+    : context_(context), max_cached_bytes_(max_cached_bytes) {}
+
+UCXMemoryPool::~UCXMemoryPool() {
+    for (auto &blocks : free_) {
+        for (UCXMemoryBlock *block : blocks) {
+            destroy(block);
+        }
+    }
+}
+
+UCXBuffer UCXMemoryPool::acquire(size_t size) {
+    int size_class = -1;
+    size_t capacity = size;
+    for (int shift = kMinBlockShift; shift <= kMaxBlockShift; ++shift) {
+        if (size <= (static_cast<size_t>(1) << shift)) {
+            size_class = shift - kMinBlockShift;
+            capacity = static_cast<size_t>(1) << shift;
+            break;
+        }
+    }
+
+    UCXMemoryBlock *block = nullptr;
+    if (size_class >= 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<UCXMemoryBlock *> &blocks = free_[size_class];
+        if (!blocks.empty()) {
+            block = blocks.back();
+            blocks.pop_back();
+            cached_bytes_ -= block->capacity;
+        }
+    }
+    if (block == nullptr) {
+        // 注册比较慢，放在锁外进行
+        block = allocate(capacity, size_class);
+    }
+
+    UCXBuffer buffer;
+    if (block != nullptr) {
+        buffer.pool_ = this;
+        buffer.block_ = block;
+        buffer.size_ = size;
+    }
+    return buffer;
+}
+
+UCXMemoryBlock *UCXMemoryPool::allocate(size_t capacity, int size_class) {
+    const size_t kPageSize = 4096;
+    size_t alignment = capacity >= kPageSize ? kPageSize : 64;
+    if (size_class < 0) {
+        capacity = (capacity + kPageSize - 1) / kPageSize * kPageSize;
+    }
+    void *data = nullptr;
+    if (posix_memalign(&data, alignment, capacity) != 0) {
+        LOG(ERROR) << "allocate ucx buffer of " << capacity << " bytes error";
+        return nullptr;
+    }
+
+    ucp_mem_map_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_MEM_MAP_PARAM_FIELD_ADDRESS | UCP_MEM_MAP_PARAM_FIELD_LENGTH;
+    params.address = data;
+    params.length = capacity;
+    ucp_mem_h memh = nullptr;
+    ucs_status_t status = ucp_mem_map(context_, &params, &memh);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_mem_map " << capacity << " bytes error: " << ucs_status_string(status);
+        free(data);
+        return nullptr;
+    }
+    return new UCXMemoryBlock{static_cast<char *>(data), capacity, memh, size_class};
+}
+
+void UCXMemoryPool::release(UCXMemoryBlock *block) {
+    if (block->size_class >= 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cached_bytes_ + block->capacity <= max_cached_bytes_) {
+            free_[block->size_class].push_back(block);
+            cached_bytes_ += block->capacity;
+            return;
+        }
+    }
+    destroy(block);
+}
+
+void UCXMemoryPool::destroy(UCXMemoryBlock *block) {
+    ucp_mem_unmap(context_, block->memh);
+    free(block->data);
+    delete block;
+}
+
+std::shared_ptr<UCXContext> UCXContext::Create(const std::string &transports, size_t pool_bytes) {
+    ucp_config_t *config = nullptr;
+    ucs_status_t status = ucp_config_read(nullptr, nullptr, &config);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_config_read error: " << ucs_status_string(status);
+        return nullptr;
+    }
+    if (!transports.empty() && ucp_config_modify(config, "TLS", transports.c_str()) != UCS_OK) {
+        LOG(WARNING) << "invalid ucx transports: " << transports;
+    }
+
+    ucp_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_PARAM_FIELD_FEATURES | UCP_PARAM_FIELD_MT_WORKERS_SHARED;
+    params.features = UCP_FEATURE_AM | UCP_FEATURE_RMA | UCP_FEATURE_WAKEUP;
+    params.mt_workers_shared = 1; // 各线程的worker共享同一个上下文（注册内存、rkey打包等）
+
+    std::shared_ptr<UCXContext> context(new UCXContext());
+    status = ucp_init(&params, config, &context->context_);
+    ucp_config_release(config);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_init error: " << ucs_status_string(status);
+        context->context_ = nullptr;
+        return nullptr;
+    }
+    context->pool_.reset(new UCXMemoryPool(context->context_, pool_bytes));
+    return context;
+}
+
+UCXContext::~UCXContext() {
+    pool_.reset();
+    if (context_ != nullptr) {
+        ucp_cleanup(context_);
+    }
+}
+
+std::unique_ptr<UCXWorker> UCXWorker::Create(const std::shared_ptr<UCXContext> &context) {
+    ucp_worker_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    params.thread_mode = UCS_THREAD_MODE_SINGLE;
+
+    std::unique_ptr<UCXWorker> worker(new UCXWorker());
+    worker->context_ = context;
+    ucs_status_t status = ucp_worker_create(context->handle(), &params, &worker->worker_);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_worker_create error: " << ucs_status_string(status);
+        worker->worker_ = nullptr;
+        return nullptr;
+    }
+    status = ucp_worker_get_efd(worker->worker_, &worker->efd_);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_worker_get_efd error: " << ucs_status_string(status);
+        return nullptr;
+    }
+    return worker;
+}
+
+UCXWorker::~UCXWorker() {
+    if (worker_ != nullptr) {
+        ucp_worker_destroy(worker_);
+    }
+}
+
+bool UCXWorker::setAmHandler(unsigned id, ucp_am_recv_callback_t cb, void *arg) {
+    ucp_am_handler_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.field_mask = UCP_AM_HANDLER_PARAM_FIELD_ID | UCP_AM_HANDLER_PARAM_FIELD_CB |
+                       UCP_AM_HANDLER_PARAM_FIELD_ARG | UCP_AM_HANDLER_PARAM_FIELD_FLAGS;
+    param.id = id;
+    param.cb = cb;
+    param.arg = arg;
+    param.flags = UCP_AM_FLAG_WHOLE_MSG; // 帧总是整条交给回调，不需要自己拼接分片
+    ucs_status_t status = ucp_worker_set_am_recv_handler(worker_, &param);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucp_worker_set_am_recv_handler error: " << ucs_status_string(status);
+        return false;
+    }
+    return true;
+}
+
+void UCXWorker::progressAll() {
+    while (ucp_worker_progress(worker_) != 0) {
+    }
+}
+
+void UCXWorker::wait(int timeout_ms, int wakeup_fd) {
+    // arm返回BUSY说明还有未处理的事件，不能睡眠
+    if (ucp_worker_arm(worker_) == UCS_ERR_BUSY) {
+        return;
+    }
+    struct pollfd fds[2];
+    fds[0].fd = efd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeup_fd;
+    fds[1].events = POLLIN;
+    poll(fds, wakeup_fd >= 0 ? 2 : 1, timeout_ms);
+}
+
+ucs_status_t UCXWorker::waitRequest(ucs_status_ptr_t request) {
+    if (request == nullptr) {
+        return UCS_OK;
+    }
+    if (UCS_PTR_IS_ERR(request)) {
+        return UCS_PTR_STATUS(request);
+    }
+    ucs_status_t status;
+    while ((status = ucp_request_check_status(request)) == UCS_INPROGRESS) {
+        ucp_worker_progress(worker_);
+    }
+    ucp_request_free(request);
+    return status;
+}
+
+UCXConnection::UCXConnection(UCXServer *server, ucp_ep_h ep) : server_(server), ep_(ep), connected_(true) {}
+
+void UCXConnection::send(UCXBuffer frame) {
+    UCXConnectionPtr self = shared_from_this();
+    std::shared_ptr<UCXBuffer> buffer = std::make_shared<UCXBuffer>(std::move(frame));
+    // 即使在progress线程中也不直接发送：此时通常还处在UCX的接收回调里，
+    // 放到本轮progress结束后统一发出
+    server_->loop_.queueInLoop([self, buffer]() { self->sendInLoop(buffer); });
+}
+
+UCXMemoryPool &UCXConnection::pool() {
+    return server_->pool();
+}
+
+void UCXConnection::sendInLoop(const std::shared_ptr<UCXBuffer> &frame) {
+    if (!connected_) {
+        return;
+    }
+    // 发送完成前缓冲区必须保持有效，由完成回调归还内存池
+    UCXBuffer *buffer = new UCXBuffer(std::move(*frame));
+    ucp_request_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+    param.cb.send = &UCXConnection::sendHandler;
+    param.user_data = buffer;
+    UCXSetMemoryHandle(&param, *buffer);
+    ucs_status_ptr_t request = ucp_am_send_nbx(ep_, kUCXAmResponse, nullptr, 0, buffer->data(), buffer->size(), &param);
+    if (request == nullptr) {
+        delete buffer; // 已经立即完成，不会再调用回调
+    } else if (UCS_PTR_IS_ERR(request)) {
+        LOG(ERROR) << "ucx send response error: " << ucs_status_string(UCS_PTR_STATUS(request));
+        delete buffer;
+    }
+}
+
+void UCXConnection::sendHandler(void *request, ucs_status_t status, void *user_data) {
+    if (status != UCS_OK && status != UCS_ERR_CANCELED) {
+        LOG(WARNING) << "ucx send response error: " << ucs_status_string(status);
+    }
+    delete static_cast<UCXBuffer *>(user_data);
+    ucp_request_free(request);
+}
+
+// 正在通过rendezvous协议接收的大请求
+struct UCXServer::PendingRecv
+{
+    UCXServer *server;
+    UCXConnectionPtr conn;
+    UCXBuffer data;
+};
+
+UCXEventLoop::UCXEventLoop(const std::shared_ptr<UCXContext> &context) : context_(context), running_(false) {}
+
+UCXEventLoop::~UCXEventLoop() {
+    stop();
+    if (worker_) {
+        // 等待还没有完成关闭的端点，worker销毁前它们必须全部结束
+        reapClosing();
+        while (!closing_.empty()) {
+            worker_->progressAll();
+            reapClosing();
+        }
+    }
+    if (wakeup_fd_ >= 0) {
+        close(wakeup_fd_);
+    }
+}
+
+bool UCXEventLoop::init() {
+    worker_ = UCXWorker::Create(context_);
+    if (!worker_) {
+        return false;
+    }
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd_ < 0) {
+        LOG(ERROR) << "create ucx wakeup eventfd error";
+        return false;
+    }
+    return true;
+}
+
+void UCXEventLoop::start(std::function<void()> thread_init_cb) {
+    running_ = true;
+    thread_ = std::thread([this, thread_init_cb]() {
+        if (thread_init_cb) {
+            thread_init_cb();
+        }
+        run();
+    });
+}
+
+void UCXEventLoop::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        wakeup();
+        thread_.join();
+    }
+}
+
+bool UCXEventLoop::isInLoopThread() const {
+    return std::this_thread::get_id() == thread_.get_id();
+}
+
+void UCXEventLoop::wakeup() {
+    uint64_t one = 1;
+    ssize_t n = write(wakeup_fd_, &one, sizeof(one));
+    (void)n;
+}
+
+void UCXEventLoop::queueInLoop(std::function<void()> fn) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        wake = pending_.empty();
+        pending_.push_back(std::move(fn));
+    }
+    // 队列从空变为非空时唤醒一次即可；progress线程自己添加时wait前也会检查队列
+    if (wake) {
+        wakeup();
+    }
+}
+
+void UCXEventLoop::run() {
+    while (running_) {
+        worker_->progressAll();
+        runPending();
+        reapClosing();
+        bool idle;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            idle = pending_.empty();
+        }
+        if (idle) {
+            worker_->wait(kPollTimeoutMs, wakeup_fd_);
+            uint64_t count = 0;
+            ssize_t n = read(wakeup_fd_, &count, sizeof(count));
+            (void)n;
+        }
+    }
+}
+
+void UCXEventLoop::runPending() {
+    std::vector<std::function<void()>> functors;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        functors.swap(pending_);
+    }
+    for (auto &fn : functors) {
+        fn();
+    }
+}
+
+void UCXEventLoop::closeEndpoint(ucp_ep_h ep) {
+    ucp_request_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = UCP_EP_CLOSE_FLAG_FORCE;
+    ucs_status_ptr_t request = ucp_ep_close_nbx(ep, &param);
+    if (UCS_PTR_IS_PTR(request)) {
+        closing_.push_back(request);
+    }
+}
+
+void UCXEventLoop::reapClosing() {
+    for (size_t i = 0; i < closing_.size();) {
+        if (ucp_request_check_status(closing_[i]) == UCS_INPROGRESS) {
+            ++i;
+            continue;
+        }
+        ucp_request_free(closing_[i]);
+        closing_[i] = closing_.back();
+        closing_.pop_back();
+    }
+}
+
+UCXServer::UCXServer(const std::shared_ptr<UCXContext> &context) : loop_(context) {}
+
+UCXServer::~UCXServer() {
+    loop_.stop();
+    if (loop_.worker() != nullptr) {
+        if (listener_ != nullptr) {
+            ucp_listener_destroy(listener_);
+        }
+        // 关闭过程中推进worker可能触发onError修改connections_，先取出来
+        std::unordered_map<ucp_ep_h, UCXConnectionPtr> connections;
+        connections.swap(connections_);
+        for (auto &item : connections) {
+            item.second->connected_ = false;
+            CloseEndpointNow(loop_.worker(), item.first);
+        }
+    }
+}
+
+bool UCXServer::start(const std::string &ip, uint16_t port) {
+    if (!loop_.init() || !loop_.worker()->setAmHandler(kUCXAmRequest, &UCXServer::onRequest, this)) {
+        return false;
+    }
+
+    struct sockaddr_in addr;
+    if (!MakeSockAddr(ip, port, &addr)) {
+        LOG(ERROR) << "invalid ucx listen address: " << ip;
+        return false;
+    }
+    ucp_listener_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_LISTENER_PARAM_FIELD_SOCK_ADDR | UCP_LISTENER_PARAM_FIELD_CONN_HANDLER;
+    params.sockaddr.addr = reinterpret_cast<const struct sockaddr *>(&addr);
+    params.sockaddr.addrlen = sizeof(addr);
+    params.conn_handler.cb = &UCXServer::onConnRequest;
+    params.conn_handler.arg = this;
+    ucs_status_t status = ucp_listener_create(loop_.worker()->handle(), &params, &listener_);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucx listen on " << ip << ":" << port << " error: " << ucs_status_string(status);
+        listener_ = nullptr;
+        return false;
+    }
+    loop_.start(thread_init_cb_);
+    return true;
+}
+
+void UCXServer::onConnRequest(ucp_conn_request_h conn_request, void *arg) {
+    UCXServer *server = static_cast<UCXServer *>(arg);
+    ucp_ep_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_EP_PARAM_FIELD_CONN_REQUEST | UCP_EP_PARAM_FIELD_ERR_HANDLER |
+                        UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE;
+    params.conn_request = conn_request;
+    params.err_mode = UCP_ERR_HANDLING_MODE_PEER; // 对端异常退出时通过onError得知
+    params.err_handler.cb = &UCXServer::onError;
+    params.err_handler.arg = server;
+
+    ucp_ep_h ep = nullptr;
+    ucs_status_t status = ucp_ep_create(server->loop_.worker()->handle(), &params, &ep);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucx accept error: " << ucs_status_string(status);
+        return;
+    }
+    server->connections_[ep] = std::make_shared<UCXConnection>(server, ep);
+}
+
+ucs_status_t UCXServer::onRequest(void *arg, const void *header, size_t header_length, void *data, size_t length,
+                                  const ucp_am_recv_param_t *param) {
+    UCXServer *server = static_cast<UCXServer *>(arg);
+    // 客户端发送请求时带了UCP_AM_SEND_FLAG_REPLY，据此找到请求来自哪个连接
+    if (!(param->recv_attr & UCP_AM_RECV_ATTR_FIELD_REPLY_EP)) {
+        LOG(ERROR) << "ucx request without reply endpoint";
+        return UCS_OK;
+    }
+    auto it = server->connections_.find(param->reply_ep);
+    if (it == server->connections_.end()) {
+        return UCS_OK;
+    }
+
+    if (server->max_message_size_ != 0 && length > server->max_message_size_) {
+        // 不分配接收缓冲区，rendezvous的数据随回调返回一起丢弃
+        LOG(ERROR) << "ucx request of " << length << " bytes exceeds the max message size";
+        return UCS_OK;
+    }
+
+    if (param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) {
+        // 大消息走rendezvous协议，此时data只是描述符，需要先把数据拉到本地
+        // 直接接收到已注册的缓冲区中，请求处理完后归还内存池
+        PendingRecv *pending = new PendingRecv{server, it->second, server->pool().acquire(length)};
+        if (!pending->data) {
+            delete pending;
+            return UCS_OK;
+        }
+        ucp_request_param_t recv_param;
+        memset(&recv_param, 0, sizeof(recv_param));
+        recv_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+        recv_param.cb.recv_am = &UCXServer::onRecvData;
+        recv_param.user_data = pending;
+        UCXSetMemoryHandle(&recv_param, pending->data);
+        ucs_status_ptr_t request =
+            ucp_am_recv_data_nbx(server->loop_.worker()->handle(), data, pending->data.data(), length, &recv_param);
+        if (request == nullptr) {
+            onRecvData(nullptr, UCS_OK, length, pending);
+        } else if (UCS_PTR_IS_ERR(request)) {
+            onRecvData(nullptr, UCS_PTR_STATUS(request), 0, pending);
+        }
+        return UCS_OK;
+    }
+
+    // eager消息的数据在回调期间有效，直接原地处理
+    if (server->message_cb_) {
+        server->message_cb_(it->second, static_cast<const char *>(data), length, nullptr);
+    }
+    return UCS_OK;
+}
+
+void UCXServer::onRecvData(void *request, ucs_status_t status, size_t length, void *user_data) {
+    std::unique_ptr<PendingRecv> pending(static_cast<PendingRecv *>(user_data));
+    if (request != nullptr) {
+        ucp_request_free(request);
+    }
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucx receive request error: " << ucs_status_string(status);
+        return;
+    }
+    if (pending->conn->connected() && pending->server->message_cb_) {
+        pending->server->message_cb_(pending->conn, pending->data.data(), length, &pending->data);
+    }
+}
+
+void UCXServer::onError(void *arg, ucp_ep_h ep, ucs_status_t status) {
+    UCXServer *server = static_cast<UCXServer *>(arg);
+    auto it = server->connections_.find(ep);
+    if (it == server->connections_.end()) {
+        return;
+    }
+    it->second->connected_ = false;
+    server->connections_.erase(it);
+    // 回调中不能推进worker，端点留到本轮progress结束后再关闭
+    server->loop_.queueInLoop([server, ep]() { server->loop_.closeEndpoint(ep); });
+}
+
+std::unique_ptr<UCXClient> UCXClient::Connect(const std::shared_ptr<UCXContext> &context, const std::string &ip,
+                                              uint16_t port) {
+    std::unique_ptr<UCXClient> client(new UCXClient());
+    client->context_ = context;
+    client->worker_ = UCXWorker::Create(context);
+    if (!client->worker_ || !client->worker_->setAmHandler(kUCXAmResponse, &UCXClient::onResponse, client.get())) {
+        return nullptr;
+    }
+
+    struct sockaddr_in addr;
+    if (!MakeSockAddr(ip, port, &addr)) {
+        LOG(ERROR) << "invalid ucx server address: " << ip;
+        return nullptr;
+    }
+    ucp_ep_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.field_mask = UCP_EP_PARAM_FIELD_FLAGS | UCP_EP_PARAM_FIELD_SOCK_ADDR | UCP_EP_PARAM_FIELD_ERR_HANDLER |
+                        UCP_EP_PARAM_FIELD_ERR_HANDLING_MODE;
+    params.flags = UCP_EP_PARAMS_FLAGS_CLIENT_SERVER;
+    params.sockaddr.addr = reinterpret_cast<const struct sockaddr *>(&addr);
+    params.sockaddr.addrlen = sizeof(addr);
+    params.err_mode = UCP_ERR_HANDLING_MODE_PEER;
+    params.err_handler.cb = &UCXClient::onError;
+    params.err_handler.arg = client.get();
+    ucs_status_t status = ucp_ep_create(client->worker_->handle(), &params, &client->ep_);
+    if (status != UCS_OK) {
+        LOG(ERROR) << "ucx connect " << ip << ":" << port << " error: " << ucs_status_string(status);
+        client->ep_ = nullptr;
+        return nullptr;
+    }
+    return client;
+}
+
+UCXClient::~UCXClient() {
+    close();
+}
+
+void UCXClient::close() {
+    if (ep_ != nullptr) {
+        CloseEndpointNow(worker_.get(), ep_);
+        ep_ = nullptr;
+    }
+}
+
+bool UCXClient::Call(const UCXBuffer &request_frame, UCXBuffer *response_frame, int timeout_ms,
+                     std::string *error) {
+    if (ep_ == nullptr || error_ != UCS_OK) {
+        *error = "ucx connection is closed";
+        return false;
+    }
+    response_frame->reset();
+    response_ = response_frame;
+    response_ready_ = false;
+
+    ucp_request_param_t param;
+    memset(&param, 0, sizeof(param));
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = UCP_AM_SEND_FLAG_REPLY; // 让服务端能够拿到回复用的端点
+    UCXSetMemoryHandle(&param, request_frame);
+    ucs_status_ptr_t request =
+        ucp_am_send_nbx(ep_, kUCXAmRequest, nullptr, 0, request_frame.data(), request_frame.size(), &param);
+    if (UCS_PTR_IS_ERR(request)) {
+        error_ = UCS_PTR_STATUS(request);
+        *error = std::string("ucx send error: ") + ucs_status_string(error_);
+        response_ = nullptr;
+        close();
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    bool sent = request == nullptr;
+    while (error_ == UCS_OK && !(sent && response_ready_)) {
+        worker_->progressAll();
+        if (!sent && ucp_request_check_status(request) != UCS_INPROGRESS) {
+            ucs_status_t status = ucp_request_check_status(request);
+            ucp_request_free(request);
+            request = nullptr;
+            sent = true;
+            if (status != UCS_OK) {
+                error_ = status;
+                break;
+            }
+        }
+        if (sent && response_ready_) {
+            break;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            error_ = UCS_ERR_TIMED_OUT;
+            break;
+        }
+        worker_->wait(static_cast<int>(remaining.count()));
+    }
+
+    response_ = nullptr;
+    if (error_ != UCS_OK) {
+        *error = std::string("ucx call error: ") + ucs_status_string(error_);
+        if (request != nullptr) {
+            // 发送还没完成，先取消，请求帧的缓冲区在返回后就会失效
+            ucp_request_cancel(worker_->handle(), request);
+            worker_->waitRequest(request);
+        }
+        close();
+        return false;
+    }
+    return true;
+}
+
+ucs_status_t UCXClient::onResponse(void *arg, const void *header, size_t header_length, void *data, size_t length,
+                                   const ucp_am_recv_param_t *param) {
+    UCXClient *client = static_cast<UCXClient *>(arg);
+    if (client->response_ == nullptr) {
+        return UCS_OK; // 没有在等待的调用（例如已经超时），丢弃
+    }
+    if (client->max_message_size_ != 0 && length > client->max_message_size_) {
+        client->error_ = UCS_ERR_MESSAGE_TRUNCATED;
+        return UCS_OK;
+    }
+    *client->response_ = client->pool().acquire(length);
+    if (!*client->response_) {
+        client->error_ = UCS_ERR_NO_MEMORY;
+        return UCS_OK;
+    }
+    if (param->recv_attr & UCP_AM_RECV_ATTR_FLAG_RNDV) {
+        ucp_request_param_t recv_param;
+        memset(&recv_param, 0, sizeof(recv_param));
+        recv_param.op_attr_mask = UCP_OP_ATTR_FIELD_CALLBACK | UCP_OP_ATTR_FIELD_USER_DATA;
+        recv_param.cb.recv_am = &UCXClient::onResponseData;
+        recv_param.user_data = client;
+        UCXSetMemoryHandle(&recv_param, *client->response_);
+        ucs_status_ptr_t request =
+            ucp_am_recv_data_nbx(client->worker_->handle(), data, client->response_->data(), length, &recv_param);
+        if (request == nullptr) {
+            client->response_ready_ = true;
+        } else if (UCS_PTR_IS_ERR(request)) {
+            client->error_ = UCS_PTR_STATUS(request);
+        }
+        return UCS_OK;
+    }
+    memcpy(client->response_->data(), data, length);
+    client->response_ready_ = true;
+    return UCS_OK;
+}
+
+void UCXClient::onResponseData(void *request, ucs_status_t status, size_t length, void *user_data) {
+    UCXClient *client = static_cast<UCXClient *>(user_data);
+    if (status == UCS_OK) {
+        client->response_ready_ = true;
+    } else {
+        client->error_ = status;
+    }
+    ucp_request_free(request);
+}
+
+void UCXClient::onError(void *arg, ucp_ep_h ep, ucs_status_t status) {
+    static_cast<UCXClient *>(arg)->error_ = status;
+}
+
+#endif // KRPC_WITH_UCX
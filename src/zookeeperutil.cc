@@ -85,7 +85,7 @@ void ZkClient::Create(const char *path, const char *data, int datalen, int state
 
 // 获取ZooKeeper节点的数据
 std::string ZkClient::GetData(const char *path) {
-    char buf[64];  // 用于存储节点数据
+    char buf[512];  // 用于存储节点数据，节点数据中除了ip:port还有扩展字段
     int bufferlen = sizeof(buf);
 
     // 首先检查节点是否存在
@@ -104,7 +104,7 @@ std::string ZkClient::GetData(const char *path) {
         LOG(ERROR) << "zoo_get error for path: " << path << ", error code: " << flag;
         return "";  // 返回空字符串
     } else {  // 获取成功
-        return buf;  // 返回节点数据
+        return std::string(buf, bufferlen > 0 ? bufferlen : 0);  // 返回节点数据，zoo_get不会在末尾补'\0'
     }
 }
 
@@ -160,4 +160,29 @@ std::vector<std::string> ZkClient::GetChildrenData(const char *path) {
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+// 获取会话状态，可以在任意线程中调用
+std::string ZkClient::StateName() const {
+    if (m_zhandle == nullptr) {
+        return "closed";
+    }
+    int state = zoo_state(m_zhandle);
+    // 这些状态常量在zookeeper.h中是变量而不是枚举，不能用switch
+    if (state == ZOO_CONNECTED_STATE) {
+        return "connected";
+    }
+    if (state == ZOO_CONNECTING_STATE) {
+        return "connecting";
+    }
+    if (state == ZOO_ASSOCIATING_STATE) {
+        return "associating";
+    }
+    if (state == ZOO_EXPIRED_SESSION_STATE) {
+        return "expired";
+    }
+    if (state == ZOO_AUTH_FAILED_STATE) {
+        return "auth_failed";
+    }
+    return "closed";
+}
@@ -0,0 +1,57 @@
+#include "KrpcCompressDict.h"
+#include "Krpcheader.pb.h"
+#include <iostream>
+#include <cassert>
+#include <string>
+
+namespace {
+const char kPeer[] = "10.0.0.1:8000";
+const char kMethod[] = "UserServiceRpc.Login";
+
+// 按通道的做法填请求头中的dict_id：服务端声明过字典时用它压缩
+Krpc::RpcHeader MakeRequestHeader(const std::string &peer, const std::string &method) {
+    Krpc::RpcHeader header;
+    header.set_dict_id(KrpcDictStore::Instance().PeerDictId(peer, method));
+    return header;
+}
+}  // namespace
+
+// 第一次调用还不知道服务端的字典；从响应头中学到之后，即使中间重新连接，第二次调用也会带上dict_id
+void testSecondCallUsesLearnedDict() {
+    KrpcDictStore &dicts = KrpcDictStore::Instance();
+    assert(MakeRequestHeader(kPeer, kMethod).dict_id() == 0);
+
+    Krpc::RpcResponseHeader response_header;
+    response_header.set_accept_dict_id(7);
+    dicts.SetPeerDictId(kPeer, kMethod, response_header.accept_dict_id());
+
+    // 记录不属于某个连接，新连接上的第一个请求就能用字典
+    assert(MakeRequestHeader(kPeer, kMethod).dict_id() == 7);
+}
+
+// 字典按服务端和方法分别记录
+void testKeyedByPeerAndMethod() {
+    KrpcDictStore &dicts = KrpcDictStore::Instance();
+    dicts.SetPeerDictId("10.0.0.2:8000", "UserServiceRpc.Register", 9);
+    assert(dicts.PeerDictId("10.0.0.2:8000", "UserServiceRpc.Register") == 9);
+    assert(dicts.PeerDictId("10.0.0.2:8000", "UserServiceRpc.Login") == 0);
+    assert(dicts.PeerDictId("10.0.0.3:8000", "UserServiceRpc.Register") == 0);
+}
+
+// 服务端换了字典或者不再持有字典时以最近一次声明为准
+void testLatestDeclarationWins() {
+    KrpcDictStore &dicts = KrpcDictStore::Instance();
+    dicts.SetPeerDictId("10.0.0.4:8000", kMethod, 3);
+    dicts.SetPeerDictId("10.0.0.4:8000", kMethod, 4);
+    assert(dicts.PeerDictId("10.0.0.4:8000", kMethod) == 4);
+    dicts.SetPeerDictId("10.0.0.4:8000", kMethod, 0);
+    assert(dicts.PeerDictId("10.0.0.4:8000", kMethod) == 0);
+}
+
+int main() {
+    testSecondCallUsesLearnedDict();
+    testKeyedByPeerAndMethod();
+    testLatestDeclarationWins();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
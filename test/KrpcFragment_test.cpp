@@ -0,0 +1,132 @@
+#include "KrpcFragment.h"
+#include "Krpccodec.h"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+
+namespace {
+Krpc::RpcResponseHeader MakeFragment(uint64_t call_id, uint64_t total, uint64_t offset, size_t size) {
+    Krpc::RpcResponseHeader header;
+    header.set_call_id(call_id);
+    header.set_response_size(size);
+    header.set_fragment_total(total);
+    header.set_fragment_offset(offset);
+    return header;
+}
+
+std::string MakeFrame(size_t size) {
+    std::string frame(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        frame[i] = static_cast<char>('a' + i % 26);
+    }
+    return frame;
+}
+}  // namespace
+
+// 按顺序到达的分片拼回原来的帧，不同调用的分片可以交错
+void testInterleavedCalls() {
+    std::string a = MakeFrame(10);
+    std::string b = MakeFrame(7);
+    KrpcFragmentAssembler assembler;
+    std::string frame;
+    assert(assembler.Add(MakeFragment(1, 10, 0, 4), a.data(), &frame) == KrpcFragmentAssembler::Status::kPending);
+    assert(assembler.Add(MakeFragment(2, 7, 0, 4), b.data(), &frame) == KrpcFragmentAssembler::Status::kPending);
+    assert(assembler.Add(MakeFragment(1, 10, 4, 6), a.data() + 4, &frame) ==
+           KrpcFragmentAssembler::Status::kComplete);
+    assert(frame == a);
+    assert(assembler.Add(MakeFragment(2, 7, 4, 3), b.data() + 4, &frame) ==
+           KrpcFragmentAssembler::Status::kComplete);
+    assert(frame == b);
+}
+
+// 同一调用的分片跳过了一段
+void testOutOfOrderFragment() {
+    std::string a = MakeFrame(12);
+    KrpcFragmentAssembler assembler;
+    std::string frame;
+    assert(assembler.Add(MakeFragment(1, 12, 0, 4), a.data(), &frame) == KrpcFragmentAssembler::Status::kPending);
+    assert(assembler.Add(MakeFragment(1, 12, 8, 4), a.data() + 8, &frame) == KrpcFragmentAssembler::Status::kError);
+
+    // 第一个分片之前到达的后续分片同样是错误
+    KrpcFragmentAssembler other;
+    assert(other.Add(MakeFragment(1, 12, 4, 4), a.data() + 4, &frame) == KrpcFragmentAssembler::Status::kError);
+}
+
+// 分片与已经收到的数据重叠
+void testOverlappingFragment() {
+    std::string a = MakeFrame(12);
+    KrpcFragmentAssembler assembler;
+    std::string frame;
+    assert(assembler.Add(MakeFragment(1, 12, 0, 6), a.data(), &frame) == KrpcFragmentAssembler::Status::kPending);
+    assert(assembler.Add(MakeFragment(1, 12, 4, 6), a.data() + 4, &frame) == KrpcFragmentAssembler::Status::kError);
+}
+
+// 分片超出完整帧的长度，或者各分片声明的完整帧长度不一致
+void testFragmentBeyondTotal() {
+    std::string a = MakeFrame(16);
+    KrpcFragmentAssembler assembler;
+    std::string frame;
+    assert(assembler.Add(MakeFragment(1, 10, 0, 4), a.data(), &frame) == KrpcFragmentAssembler::Status::kPending);
+    assert(assembler.Add(MakeFragment(1, 10, 4, 8), a.data() + 4, &frame) == KrpcFragmentAssembler::Status::kError);
+
+    KrpcFragmentAssembler other;
+    assert(other.Add(MakeFragment(1, 10, 0, 4), a.data(), &frame) == KrpcFragmentAssembler::Status::kPending);
+    assert(other.Add(MakeFragment(1, 16, 4, 4), a.data() + 4, &frame) == KrpcFragmentAssembler::Status::kError);
+}
+
+// fragment_total超过上限时不分配缓冲区，直接报错
+void testFragmentTotalCap() {
+    std::string a = MakeFrame(4);
+    KrpcFragmentAssembler assembler;
+    std::string frame;
+    assert(assembler.Add(MakeFragment(1, 4ULL * 1024 * 1024 * 1024 + 1, 0, 4), a.data(), &frame) ==
+           KrpcFragmentAssembler::Status::kError);
+    // 出错的调用不影响同一连接上的其他调用
+    assert(assembler.Add(MakeFragment(2, 4, 0, 4), a.data(), &frame) == KrpcFragmentAssembler::Status::kComplete);
+    assert(frame == a);
+}
+
+// 调度器切出的分片交给拼装器后得到原来的帧，同一优先级的调用轮流发送
+void testSchedulerRoundTrip() {
+    std::vector<std::string> frames = {MakeFrame(25), MakeFrame(18)};
+    KrpcFragmentScheduler scheduler(8);
+    assert(scheduler.Wants(1, frames[0].size()));
+    assert(!scheduler.Wants(3, 8));
+    scheduler.Add(1, 0, frames[0]);
+    scheduler.Add(2, 0, frames[1]);
+    assert(scheduler.Wants(1, 1));  // 同一调用的帧要排在队列中的帧之后
+
+    KrpcFragmentAssembler assembler;
+    std::vector<uint64_t> order;
+    std::vector<std::string> done(2);
+    while (!scheduler.Empty()) {
+        std::string out;
+        scheduler.Next(&out);
+        Krpc::RpcResponseHeader header;
+        size_t payload_offset = 0;
+        size_t frame_size = 0;
+        assert(KrpcCodec::DecodeResponse(out.data(), out.size(), &header, &payload_offset, &frame_size) ==
+               KrpcCodec::DecodeStatus::kComplete);
+        assert(frame_size == out.size() && header.response_size() <= 8);
+        order.push_back(header.call_id());
+        std::string frame;
+        if (assembler.Add(header, out.data() + payload_offset, &frame) == KrpcFragmentAssembler::Status::kComplete) {
+            done[header.call_id() - 1] = frame;
+        }
+    }
+    assert(done[0] == frames[0] && done[1] == frames[1]);
+    assert(order.size() == 7);
+    assert(order[0] == 1 && order[1] == 2 && order[2] == 1 && order[3] == 2);
+}
+
+int main() {
+    testInterleavedCalls();
+    testOutOfOrderFragment();
+    testOverlappingFragment();
+    testFragmentBeyondTotal();
+    testFragmentTotalCap();
+    testSchedulerRoundTrip();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
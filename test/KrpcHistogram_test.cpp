@@ -0,0 +1,90 @@
+#include "KrpcMetrics.h"
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+
+// 小于64的值每个值一格，之后每个2的幂区间分成32格
+void testBucketBoundaries() {
+    for (uint64_t v = 0; v < 64; ++v) {
+        assert(KrpcHistogram::BucketOf(v) == static_cast<int>(v));
+        assert(KrpcHistogram::BucketUpper(static_cast<int>(v)) == v);
+    }
+    // [64, 128)每格2个值
+    assert(KrpcHistogram::BucketOf(64) == 64);
+    assert(KrpcHistogram::BucketOf(65) == 64);
+    assert(KrpcHistogram::BucketOf(66) == 65);
+    assert(KrpcHistogram::BucketUpper(64) == 65);
+    assert(KrpcHistogram::BucketOf(127) == 95);
+    assert(KrpcHistogram::BucketOf(128) == 96);
+    assert(KrpcHistogram::BucketUpper(96) == 131);
+
+    // 每格的上界和下一格的下界相邻，值总落在上界不小于它的格里
+    for (int b = 0; b + 1 < KrpcHistogram::kBuckets; ++b) {
+        uint64_t upper = KrpcHistogram::BucketUpper(b);
+        assert(KrpcHistogram::BucketOf(upper) == b);
+        assert(KrpcHistogram::BucketOf(upper + 1) == b + 1);
+    }
+    // 相对误差不超过1/32
+    for (uint64_t v = 64; v < (1ULL << 30); v = v * 3 / 2 + 1) {
+        uint64_t upper = KrpcHistogram::BucketUpper(KrpcHistogram::BucketOf(v));
+        assert(upper >= v && (upper - v) * 32 <= v);
+    }
+
+    // 超过上限的值计入最后一格
+    const int last = KrpcHistogram::kBuckets - 1;
+    assert(KrpcHistogram::BucketUpper(last) == (1ULL << KrpcHistogram::kMaxValueBits) - 1);
+    assert(KrpcHistogram::BucketOf(1ULL << KrpcHistogram::kMaxValueBits) == last);
+    assert(KrpcHistogram::BucketOf(UINT64_MAX) == last);
+}
+
+void testQuantiles() {
+    KrpcHistogram histogram;
+    assert(histogram.ValueAtQuantile(0.5) == 0 && histogram.Max() == 0);
+    for (uint64_t v = 1; v <= 100; ++v) {
+        histogram.Record(v);
+    }
+    assert(histogram.Count() == 100 && histogram.Sum() == 5050);
+    assert(histogram.ValueAtQuantile(0) == 1);
+    assert(histogram.ValueAtQuantile(0.5) == 50);
+    assert(histogram.ValueAtQuantile(0.99) == KrpcHistogram::BucketUpper(KrpcHistogram::BucketOf(99)));
+    assert(histogram.ValueAtQuantile(1) == histogram.Max());
+    assert(histogram.Max() == KrpcHistogram::BucketUpper(KrpcHistogram::BucketOf(100)));
+
+    KrpcHistogram other;
+    other.Record(1000, 100);
+    histogram.Merge(other);
+    assert(histogram.Count() == 200 && histogram.Sum() == 5050 + 100000);
+    assert(histogram.ValueAtQuantile(0.5) == KrpcHistogram::BucketUpper(KrpcHistogram::BucketOf(100)));
+    assert(histogram.ValueAtQuantile(0.51) == KrpcHistogram::BucketUpper(KrpcHistogram::BucketOf(1000)));
+}
+
+// 一次耗时100、期望间隔30的调用推迟了两个请求，补记70和40
+void testRecordCorrected() {
+    KrpcHistogram histogram;
+    histogram.RecordCorrected(100, 30);
+    assert(histogram.Count() == 3);
+    assert(histogram.Sum() == 100 + 70 + 40);
+    assert(histogram.BucketCount(KrpcHistogram::BucketOf(100)) == 1);
+    assert(histogram.BucketCount(KrpcHistogram::BucketOf(70)) == 1);
+    assert(histogram.BucketCount(KrpcHistogram::BucketOf(40)) == 1);
+
+    // 不超过期望间隔的调用不补记；间隔为0表示不修正
+    KrpcHistogram plain;
+    plain.RecordCorrected(30, 30);
+    plain.RecordCorrected(20, 30);
+    plain.RecordCorrected(1000, 0);
+    assert(plain.Count() == 3 && plain.Sum() == 1050);
+
+    // 正好是间隔整数倍时补记到等于间隔为止
+    KrpcHistogram exact;
+    exact.RecordCorrected(90, 30);
+    assert(exact.Count() == 3 && exact.Sum() == 90 + 60 + 30);
+}
+
+int main() {
+    testBucketBoundaries();
+    testQuantiles();
+    testRecordCorrected();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "KrpcStream.h"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+// 记录收件箱归还的窗口
+struct Grants
+{
+    std::vector<uint32_t> messages;
+    std::vector<uint32_t> bytes;
+
+    KrpcStreamInbox::GrantFn Fn() {
+        return [this](uint32_t m, uint32_t b) {
+            messages.push_back(m);
+            bytes.push_back(b);
+        };
+    }
+};
+}  // namespace
+
+// 对端没有给出字节窗口时只按条数限制，再大的消息也不受影响
+void testMessageOnlyWindow() {
+    KrpcStreamCredit credit(2, 0, false);
+    assert(credit.Acquire(1 << 20, false));
+    assert(credit.Acquire(1 << 20, false));
+    assert(!credit.Acquire(1, false));
+    credit.Grant(1, 0);
+    assert(credit.Acquire(1 << 20, false));
+    assert(!credit.Acquire(1, false));
+
+    // 收件箱的字节窗口为0时同样只按条数限制
+    Grants grants;
+    KrpcStreamInbox inbox(2, 0, grants.Fn());
+    assert(inbox.Push(std::string(1 << 20, 'a')));
+    assert(inbox.Push(std::string(1 << 20, 'b')));
+    assert(!inbox.Push("c"));
+}
+
+// 字节窗口和条数窗口同时生效，任何一个用完都不能再发送
+void testByteWindow() {
+    KrpcStreamCredit credit(10, 100, true);
+    assert(credit.Acquire(60, false));
+    assert(credit.Acquire(40, false));
+    assert(!credit.Acquire(1, false));
+    credit.Grant(0, 50);
+    assert(credit.Acquire(50, false));
+    assert(!credit.Acquire(1, false));
+}
+
+// 字节窗口只要还有剩余就允许发送，超出的部分不会多于一条消息
+void testByteOvershoot() {
+    KrpcStreamCredit credit(10, 100, true);
+    assert(credit.Acquire(80, false));
+    assert(credit.Acquire(50, false));  // 还剩20字节，这条消息超出30字节
+    assert(!credit.Acquire(1, false));
+    // 归还的窗口要先补上超出的部分
+    credit.Grant(0, 30);
+    assert(!credit.Acquire(1, false));
+    credit.Grant(0, 1);
+    assert(credit.Acquire(1000, false));
+
+    // 收件箱按同样的规则收下超出的那一条，再多就是对端违反了窗口
+    Grants grants;
+    KrpcStreamInbox inbox(10, 100, grants.Fn());
+    assert(inbox.Push(std::string(80, 'a')));
+    assert(inbox.Push(std::string(50, 'b')));
+    assert(!inbox.Push("c"));
+}
+
+// 取出半个窗口的消息就归还一次窗口
+void testGrantAfterHalfWindow() {
+    Grants grants;
+    KrpcStreamInbox inbox(4, 0, grants.Fn());
+    for (int i = 0; i < 4; ++i) {
+        assert(inbox.Push(std::string(10, 'a')));
+    }
+    assert(!inbox.Push("x"));
+
+    std::string message;
+    assert(inbox.Pop(&message));
+    assert(grants.messages.empty());
+    assert(inbox.Pop(&message));
+    assert(grants.messages.size() == 1 && grants.messages[0] == 2 && grants.bytes[0] == 20);
+    // 归还之后对端又可以发送两条
+    assert(inbox.Push("b"));
+    assert(inbox.Push("c"));
+    assert(!inbox.Push("d"));
+
+    // 字节数先到半个窗口时也归还
+    Grants byte_grants;
+    KrpcStreamInbox byte_inbox(10, 100, byte_grants.Fn());
+    assert(byte_inbox.Push(std::string(30, 'a')));
+    assert(byte_inbox.Push(std::string(30, 'b')));
+    assert(byte_inbox.Pop(&message));
+    assert(byte_grants.messages.empty());
+    assert(byte_inbox.Pop(&message));
+    assert(byte_grants.messages.size() == 1 && byte_grants.messages[0] == 2 && byte_grants.bytes[0] == 60);
+
+    // 流已经结束时不再归还
+    assert(byte_inbox.Push(std::string(60, 'c')));
+    byte_inbox.End();
+    assert(byte_inbox.Pop(&message));
+    assert(byte_grants.messages.size() == 1);
+    assert(!byte_inbox.Pop(&message));
+}
+
+// Close唤醒阻塞在Acquire中的发送方，之后的Acquire都被拒绝
+void testCloseWakesAcquire() {
+    KrpcStreamCredit credit(1, 0, false);
+    assert(credit.Acquire(1, true));
+    bool acquired = true;
+    std::thread sender([&]() { acquired = credit.Acquire(1, true); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    credit.Close();
+    sender.join();
+    assert(!acquired);
+    assert(credit.IsClosed());
+    credit.Grant(1, 0);
+    assert(!credit.Acquire(1, true));
+}
+
+int main() {
+    testMessageOnlyWindow();
+    testByteWindow();
+    testByteOvershoot();
+    testGrantAfterHalfWindow();
+    testCloseWakesAcquire();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
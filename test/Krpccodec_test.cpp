@@ -0,0 +1,187 @@
+#include "Krpccodec.h"
+#include <iostream>
+#include <cassert>
+#include <string>
+
+namespace {
+Krpc::RpcHeader MakeHeader(uint64_t call_id, const std::string &args) {
+    Krpc::RpcHeader header;
+    header.set_service_name("UserServiceRpc");
+    header.set_method_name("Login");
+    header.set_call_id(call_id);
+    header.set_args_size(static_cast<uint32_t>(args.size()));
+    header.set_framed_response(true);
+    return header;
+}
+}  // namespace
+
+// 编码后的帧能原样解析回来
+void testRoundTrip() {
+    std::string args(100, 'a');
+    std::string frame;
+    assert(KrpcCodec::EncodeRequest(MakeHeader(7, args), args, &frame));
+    Krpc::RpcHeader header;
+    size_t payload_offset = 0;
+    size_t frame_size = 0;
+    assert(KrpcCodec::DecodeRequest(frame.data(), frame.size(), &header, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kComplete);
+    assert(frame_size == frame.size());
+    assert(header.call_id() == 7);
+    assert(frame.compare(payload_offset, args.size(), args) == 0);
+
+    Krpc::RpcResponseHeader response_header;
+    response_header.set_call_id(7);
+    response_header.set_response_size(static_cast<uint32_t>(args.size()));
+    frame.clear();
+    assert(KrpcCodec::EncodeResponse(response_header, args, &frame));
+    Krpc::RpcResponseHeader decoded;
+    assert(KrpcCodec::DecodeResponse(frame.data(), frame.size(), &decoded, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kComplete);
+    assert(frame_size == frame.size() && decoded.call_id() == 7);
+}
+
+// 帧的任何一个前缀都只是数据不足；头部完整之后给出整个帧的长度
+void testIncompleteFrame() {
+    std::string args(1000, 'b');
+    std::string frame;
+    assert(KrpcCodec::EncodeRequest(MakeHeader(1, args), args, &frame));
+    size_t header_end = frame.size() - args.size();
+    for (size_t len = 0; len < frame.size(); ++len) {
+        Krpc::RpcHeader header;
+        size_t payload_offset = 0;
+        size_t frame_size = 0;
+        assert(KrpcCodec::DecodeRequest(frame.data(), len, &header, &payload_offset, &frame_size) ==
+               KrpcCodec::DecodeStatus::kIncomplete);
+        if (len >= header_end) {
+            assert(frame_size == frame.size());
+        }
+    }
+}
+
+// 头部长度的varint超过5个字节或者超过上限，说明数据流已经错乱
+void testOversizedVarint() {
+    Krpc::RpcHeader header;
+    size_t payload_offset = 0;
+    size_t frame_size = 0;
+    std::string bad(6, '\xff');
+    assert(KrpcCodec::DecodeRequest(bad.data(), bad.size(), &header, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kError);
+    // 不足5个字节时还可能是没收全
+    assert(KrpcCodec::DecodeRequest(bad.data(), 3, &header, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kIncomplete);
+    // 合法的varint，但头部长度超过64KB
+    std::string huge("\x80\x80\x80\x01", 4);  // 1 << 21
+    huge.append(16, '\0');
+    assert(KrpcCodec::DecodeRequest(huge.data(), huge.size(), &header, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kError);
+}
+
+// args_size超出已收到的数据时等待，不越界读取负载
+void testArgsBeyondBuffer() {
+    std::string args(10, 'c');
+    Krpc::RpcHeader header = MakeHeader(2, args);
+    header.set_args_size(1024 * 1024);
+    header.set_attachment_size(1024 * 1024);
+    std::string frame;
+    assert(KrpcCodec::EncodeRequest(header, args, &frame));
+    Krpc::RpcHeader decoded;
+    size_t payload_offset = 0;
+    size_t frame_size = 0;
+    assert(KrpcCodec::DecodeRequest(frame.data(), frame.size(), &decoded, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kIncomplete);
+    assert(frame_size == frame.size() - args.size() + 2 * 1024 * 1024);
+    assert(payload_offset == 0);
+}
+
+// 负载加附件超过max_message_bytes（默认64MB）时直接报错，调用方不会按头部声明的长度分配内存
+void testPayloadBeyondMax() {
+    std::string args(10, 'c');
+    Krpc::RpcHeader header = MakeHeader(2, args);
+    header.set_args_size(0xffffffffu);
+    header.set_attachment_size(0xffffffffu);
+    std::string frame;
+    assert(KrpcCodec::EncodeRequest(header, args, &frame));
+    Krpc::RpcHeader decoded;
+    size_t payload_offset = 0;
+    size_t frame_size = 0;
+    assert(KrpcCodec::DecodeRequest(frame.data(), frame.size(), &decoded, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kError);
+
+    // 单独的参数或附件没有超过，合计超过
+    header.set_args_size(48 * 1024 * 1024);
+    header.set_attachment_size(48 * 1024 * 1024);
+    frame.clear();
+    assert(KrpcCodec::EncodeRequest(header, args, &frame));
+    assert(KrpcCodec::DecodeRequest(frame.data(), frame.size(), &decoded, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kError);
+
+    Krpc::RpcResponseHeader response_header;
+    response_header.set_call_id(2);
+    response_header.set_response_size(64 * 1024 * 1024 + 1);
+    frame.clear();
+    assert(KrpcCodec::EncodeResponse(response_header, args, &frame));
+    Krpc::RpcResponseHeader decoded_response;
+    assert(KrpcCodec::DecodeResponse(frame.data(), frame.size(), &decoded_response, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kError);
+    assert(KrpcCodec::MaxFrameSize() > 64 * 1024 * 1024);
+}
+
+// 头部本身不是合法的protobuf
+void testCorruptHeader() {
+    std::string frame("\x03\xff\xff\xff", 4);
+    Krpc::RpcHeader header;
+    size_t payload_offset = 0;
+    size_t frame_size = 0;
+    assert(KrpcCodec::DecodeRequest(frame.data(), frame.size(), &header, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kError);
+}
+
+// 一个缓冲区中连续的多个帧（流水线请求）逐个解析，call_id保持发送顺序
+void testPipelinedFrames() {
+    std::string buffer;
+    for (uint64_t call_id = 1; call_id <= 3; ++call_id) {
+        std::string args(static_cast<size_t>(call_id) * 50, 'd');
+        assert(KrpcCodec::EncodeRequest(MakeHeader(call_id, args), args, &buffer));
+    }
+    size_t offset = 0;
+    for (uint64_t call_id = 1; call_id <= 3; ++call_id) {
+        Krpc::RpcHeader header;
+        size_t payload_offset = 0;
+        size_t frame_size = 0;
+        assert(KrpcCodec::DecodeRequest(buffer.data() + offset, buffer.size() - offset, &header, &payload_offset,
+                                        &frame_size) == KrpcCodec::DecodeStatus::kComplete);
+        assert(header.call_id() == call_id);
+        assert(header.args_size() == call_id * 50);
+        offset += frame_size;
+    }
+    assert(offset == buffer.size());
+}
+
+// 旁路的帧中没有负载
+void testBulkFrameHasNoPayload() {
+    Krpc::RpcResponseHeader header;
+    header.set_call_id(3);
+    header.set_response_size(1 << 20);
+    header.mutable_bulk()->set_length(1 << 20);
+    std::string frame;
+    assert(KrpcCodec::EncodeResponse(header, std::string(), &frame));
+    Krpc::RpcResponseHeader decoded;
+    size_t payload_offset = 0;
+    size_t frame_size = 0;
+    assert(KrpcCodec::DecodeResponse(frame.data(), frame.size(), &decoded, &payload_offset, &frame_size) ==
+           KrpcCodec::DecodeStatus::kComplete);
+    assert(frame_size == frame.size());
+}
+
+int main() {
+    testRoundTrip();
+    testIncompleteFrame();
+    testOversizedVarint();
+    testArgsBeyondBuffer();
+    testPayloadBeyondMax();
+    testCorruptHeader();
+    testPipelinedFrames();
+    testBulkFrameHasNoPayload();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
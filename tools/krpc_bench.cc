@@ -0,0 +1,406 @@
+// 开环压测：按给定的到达率（泊松或匀速）发出请求，不等上一个请求返回才决定下一个请求何时发出，
+// 报告扣除coordinated omission之后的耗时分位数和吞吐-耗时曲线：
+//   krpc_bench -i test.conf -m Kuser.UserServiceRpc.Login:9,Kuser.UserServiceRpc.Add:1
+//              -r 1000,2000,4000,8000 -d 10 -w 2 -c 16 -s 64,1024:2,16384 [-a constant] [-o curve.csv]
+//   -m 方法及权重，方法写完整的"包名.服务名.方法名"，工具需要链接对应的.pb.cc
+//   -r 目标到达率（每秒请求数），给出多个时依次压测，得到吞吐-耗时曲线
+//   -d 每个到达率的统计时长（秒）；-w 每个到达率开始统计前的预热时长（秒），预热期的请求不计入
+//   -c 连接数，每个连接一个发送线程（KrpcChannel是同步的），到达率平均分给各个连接
+//   -s 请求负载的字节数及权重，填入请求的第一个string/bytes字段；请求没有这种字段时按原样发送
+//   -a 到达过程：poisson（默认）或constant
+//   -t 单次调用的超时（毫秒），0表示不设置
+//   -o 把曲线另外写成CSV文件
+// 每个请求的耗时从它按计划应该发出的时刻算起，而不是从实际发出的时刻：服务端变慢导致发送线程落后时，
+// 排在后面的请求等待的时间也算进耗时，饱和时报告的耗时不会偏低。统计时长结束后发送线程继续发完积压的请求，
+// 超过同样长的时间仍然没有发出的请求按"截止时刻减去计划时刻"计入（这是它们耗时的下限），并单独报告个数。
+// 吞吐（ok/s）只计在统计区间内返回的成功请求，区间结束后才发完的积压不算进吞吐
+#include "Krpcapplication.h"
+#include "Krpccontroller.h"
+#include "KrpcMetrics.h"
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+struct WeightedItem
+{
+    std::string name;
+    uint32_t weight;
+};
+
+struct BenchOptions
+{
+    std::string config;
+    std::vector<WeightedItem> methods;
+    std::vector<double> rates;
+    std::vector<WeightedItem> sizes;
+    double duration_s = 10;
+    double warmup_s = 2;
+    int connections = 8;
+    bool poisson = true;
+    int timeout_ms = 0;
+    std::string csv;
+};
+
+// 一种请求：方法和负载大小确定后，请求消息只构造一次，之后每次调用复用
+struct RequestTemplate
+{
+    const google::protobuf::MethodDescriptor *method;
+    std::shared_ptr<google::protobuf::Message> request;
+    size_t payload;
+};
+
+// 一个连接在一个到达率下的统计
+struct WorkerResult
+{
+    KrpcHistogram latency;      // 从计划发出的时刻到返回，纳秒
+    KrpcHistogram service_time; // 从实际发出的时刻到返回，纳秒，仅用于对比
+    uint64_t completed = 0;     // 在统计区间内计划发出、并且已经返回的请求
+    uint64_t errors = 0;
+    uint64_t ok_in_window = 0;  // 在统计区间内返回的成功请求（不论计划时刻），用于计算吞吐
+    uint64_t missed = 0;        // 截止时仍未发出的请求
+    uint64_t late = 0;          // 实际发出时已经晚于计划时刻1毫秒以上的请求
+};
+
+void Usage(const char *prog) {
+    std::cerr << "usage: " << prog << " -i config -m Pkg.Service.Method[:weight],... -r rate[,rate...]"
+              << " [-d seconds] [-w seconds] [-c connections] [-s bytes[:weight],...] [-a poisson|constant]"
+              << " [-t timeout_ms] [-o curve.csv]" << std::endl;
+}
+
+std::vector<std::string> Split(const std::string &text, char sep) {
+    std::vector<std::string> parts;
+    std::stringstream in(text);
+    std::string part;
+    while (std::getline(in, part, sep)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+// "a:3,b,c:2"，省略的权重为1
+bool ParseWeighted(const std::string &text, std::vector<WeightedItem> *items) {
+    for (const std::string &part : Split(text, ',')) {
+        WeightedItem item;
+        size_t colon = part.rfind(':');
+        item.name = part.substr(0, colon);
+        item.weight = colon == std::string::npos ? 1 : static_cast<uint32_t>(atoi(part.c_str() + colon + 1));
+        if (item.name.empty() || item.weight == 0) {
+            return false;
+        }
+        items->push_back(item);
+    }
+    return !items->empty();
+}
+
+// 按权重把请求模板展开成一张抽样表，发送线程每次随机取一项
+bool BuildTemplates(const BenchOptions &options, std::vector<RequestTemplate> *templates) {
+    const google::protobuf::DescriptorPool *pool = google::protobuf::DescriptorPool::generated_pool();
+    google::protobuf::MessageFactory *factory = google::protobuf::MessageFactory::generated_factory();
+    for (const WeightedItem &method_item : options.methods) {
+        const google::protobuf::MethodDescriptor *method = pool->FindMethodByName(method_item.name);
+        if (method == nullptr) {
+            std::cerr << "unknown method " << method_item.name << ", is its .pb.cc linked?" << std::endl;
+            return false;
+        }
+        for (const WeightedItem &size_item : options.sizes) {
+            RequestTemplate tmpl;
+            tmpl.method = method;
+            tmpl.payload = strtoull(size_item.name.c_str(), nullptr, 10);
+            tmpl.request.reset(factory->GetPrototype(method->input_type())->New());
+            const google::protobuf::Descriptor *type = method->input_type();
+            for (int i = 0; i < type->field_count(); ++i) {
+                const google::protobuf::FieldDescriptor *field = type->field(i);
+                if (field->type() == google::protobuf::FieldDescriptor::TYPE_STRING && !field->is_repeated()) {
+                    tmpl.request->GetReflection()->SetString(tmpl.request.get(), field, std::string(tmpl.payload, 'k'));
+                    break;
+                }
+                if (field->type() == google::protobuf::FieldDescriptor::TYPE_BYTES && !field->is_repeated()) {
+                    std::string payload(tmpl.payload, '\0');
+                    for (size_t j = 0; j < payload.size(); ++j) {
+                        payload[j] = static_cast<char>(j * 131 + 7);
+                    }
+                    tmpl.request->GetReflection()->SetString(tmpl.request.get(), field, payload);
+                    break;
+                }
+            }
+            for (uint32_t w = 0; w < method_item.weight * size_item.weight; ++w) {
+                templates->push_back(tmpl);
+            }
+        }
+    }
+    return true;
+}
+
+uint64_t ElapsedNanos(Clock::time_point from, Clock::time_point to) {
+    return to > from ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count())
+                     : 0;
+}
+
+// 一个连接的发送线程。计划时刻由到达过程独立生成，与调用何时返回无关；
+// 计划时刻早于measure_start的请求是预热，计划时刻不早于measure_end的请求不再发出
+class Worker
+{
+public:
+    Worker(const BenchOptions &options, const std::vector<RequestTemplate> &templates, int index)
+        : options_(options), templates_(templates), rng_(0x6b727063ULL + static_cast<uint64_t>(index) * 7919) {}
+
+    void Run(double rate, Clock::time_point start, Clock::time_point measure_start, Clock::time_point measure_end,
+             Clock::time_point deadline, int index, WorkerResult *result) {
+        // 每个连接分到rate/connections，泊松过程的叠加仍然是泊松过程
+        double per_conn = rate / options_.connections;
+        std::exponential_distribution<double> exponential(per_conn);
+        std::uniform_int_distribution<size_t> pick(0, templates_.size() - 1);
+        double interval_s = 1.0 / per_conn;
+        // 匀速时各个连接错开相位，避免所有连接同时发送
+        double offset_s = options_.poisson ? exponential(rng_) : interval_s * index / options_.connections;
+        Clock::time_point intended = start + std::chrono::duration_cast<Clock::duration>(
+                                                 std::chrono::duration<double>(offset_s));
+        while (intended < measure_end) {
+            Clock::time_point now = Clock::now();
+            if (now >= deadline) {
+                break;
+            }
+            if (now < intended) {
+                std::this_thread::sleep_until(intended);
+                now = Clock::now();
+            }
+            const RequestTemplate &tmpl = templates_[pick(rng_)];
+            bool failed = !Call(tmpl);
+            Clock::time_point done = Clock::now();
+            if (!failed && done >= measure_start && done <= measure_end) {
+                ++result->ok_in_window;
+            }
+            if (intended >= measure_start) {
+                result->latency.Record(ElapsedNanos(intended, done));
+                result->service_time.Record(ElapsedNanos(now, done));
+                ++result->completed;
+                result->errors += failed ? 1 : 0;
+                result->late += ElapsedNanos(intended, now) > 1000000 ? 1 : 0;
+            }
+            double gap_s = options_.poisson ? exponential(rng_) : interval_s;
+            intended += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap_s));
+        }
+        // 截止时还没有发出的请求至少等待了deadline - intended
+        while (intended < measure_end) {
+            if (intended >= measure_start) {
+                result->latency.Record(ElapsedNanos(intended, deadline));
+                ++result->missed;
+            }
+            double gap_s = options_.poisson ? exponential(rng_) : interval_s;
+            intended += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap_s));
+        }
+    }
+
+private:
+    bool Call(const RequestTemplate &tmpl) {
+        // 每个服务一个通道。KrpcChannel的连接建立后跨调用复用，只有被服务端关闭时才重新连接，
+        // 因此每个发送线程对每个服务只占一个连接
+        std::unique_ptr<KrpcChannel> &channel = channels_[tmpl.method->service()];
+        if (!channel) {
+            channel.reset(new KrpcChannel(false));
+        }
+        std::unique_ptr<google::protobuf::Message> response(
+            google::protobuf::MessageFactory::generated_factory()->GetPrototype(tmpl.method->output_type())->New());
+        KrpcController controller;
+        if (options_.timeout_ms > 0) {
+            controller.SetTimeout(options_.timeout_ms);
+        }
+        channel->CallMethod(tmpl.method, &controller, tmpl.request.get(), response.get(), nullptr);
+        return !controller.Failed();
+    }
+
+    const BenchOptions &options_;
+    const std::vector<RequestTemplate> &templates_;
+    std::mt19937_64 rng_;
+    std::map<const google::protobuf::ServiceDescriptor *, std::unique_ptr<KrpcChannel>> channels_;
+};
+
+struct StepReport
+{
+    double target_rate;
+    double achieved_rate;
+    WorkerResult total;
+};
+
+StepReport RunStep(const BenchOptions &options, std::vector<std::unique_ptr<Worker>> &workers, double rate) {
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(10);
+    std::chrono::duration<double> warmup(options.warmup_s);
+    std::chrono::duration<double> duration(options.duration_s);
+    Clock::time_point measure_start = start + std::chrono::duration_cast<Clock::duration>(warmup);
+    Clock::time_point measure_end = measure_start + std::chrono::duration_cast<Clock::duration>(duration);
+    Clock::time_point deadline = measure_end + std::chrono::duration_cast<Clock::duration>(duration);
+
+    std::vector<WorkerResult> results(workers.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        Worker *worker = workers[i].get();
+        WorkerResult *result = &results[i];
+        threads.emplace_back([=]() {
+            worker->Run(rate, start, measure_start, measure_end, deadline, static_cast<int>(i), result);
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    StepReport report;
+    report.target_rate = rate;
+    report.total = WorkerResult();
+    for (const WorkerResult &result : results) {
+        report.total.latency.Merge(result.latency);
+        report.total.service_time.Merge(result.service_time);
+        report.total.completed += result.completed;
+        report.total.errors += result.errors;
+        report.total.ok_in_window += result.ok_in_window;
+        report.total.missed += result.missed;
+        report.total.late += result.late;
+    }
+    report.achieved_rate = report.total.ok_in_window / options.duration_s;
+    return report;
+}
+
+double Micros(uint64_t ns) {
+    return ns / 1000.0;
+}
+
+const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+void PrintHeader() {
+    printf("%10s %10s %9s %8s %8s %6s %10s %10s %10s %10s %10s %12s\n", "target/s", "ok/s", "completed", "errors",
+           "missed", "late%", "p50(us)", "p90(us)", "p99(us)", "p99.9(us)", "max(us)", "svc_p99(us)");
+}
+
+void PrintStep(const StepReport &report) {
+    const WorkerResult &total = report.total;
+    printf("%10.0f %10.0f %9llu %8llu %8llu %6.2f", report.target_rate, report.achieved_rate,
+           static_cast<unsigned long long>(total.completed), static_cast<unsigned long long>(total.errors),
+           static_cast<unsigned long long>(total.missed),
+           total.completed == 0 ? 0.0 : 100.0 * total.late / total.completed);
+    for (double q : kQuantiles) {
+        printf(" %10.1f", Micros(total.latency.ValueAtQuantile(q)));
+    }
+    printf(" %10.1f %12.1f\n", Micros(total.latency.Max()), Micros(total.service_time.ValueAtQuantile(0.99)));
+    fflush(stdout);
+}
+
+void WriteCsv(const std::string &path, const std::vector<StepReport> &reports) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "open " << path << " error" << std::endl;
+        return;
+    }
+    out << "target_rate,achieved_rate,completed,errors,missed,late,p50_us,p90_us,p99_us,p999_us,max_us,service_p99_us\n";
+    for (const StepReport &report : reports) {
+        const WorkerResult &total = report.total;
+        out << report.target_rate << "," << report.achieved_rate << "," << total.completed << "," << total.errors << ","
+            << total.missed << "," << total.late;
+        for (double q : kQuantiles) {
+            out << "," << Micros(total.latency.ValueAtQuantile(q));
+        }
+        out << "," << Micros(total.latency.Max()) << "," << Micros(total.service_time.ValueAtQuantile(0.99)) << "\n";
+    }
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    std::string sizes = "0";
+    int opt;
+    while ((opt = getopt(argc, argv, "i:m:r:d:w:c:s:a:t:o:")) != -1) {
+        switch (opt) {
+        case 'i':
+            options.config = optarg;
+            break;
+        case 'm':
+            if (!ParseWeighted(optarg, &options.methods)) {
+                Usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'r':
+            for (const std::string &rate : Split(optarg, ',')) {
+                options.rates.push_back(atof(rate.c_str()));
+            }
+            break;
+        case 'd':
+            options.duration_s = atof(optarg);
+            break;
+        case 'w':
+            options.warmup_s = atof(optarg);
+            break;
+        case 'c':
+            options.connections = atoi(optarg);
+            break;
+        case 's':
+            sizes = optarg;
+            break;
+        case 'a':
+            options.poisson = std::string(optarg) != "constant";
+            break;
+        case 't':
+            options.timeout_ms = atoi(optarg);
+            break;
+        case 'o':
+            options.csv = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.config.empty() || options.methods.empty() || options.rates.empty() || options.duration_s <= 0 ||
+        options.warmup_s < 0 || options.connections <= 0 || !ParseWeighted(sizes, &options.sizes) ||
+        std::any_of(options.rates.begin(), options.rates.end(), [](double rate) { return rate <= 0; })) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    // KrpcApplication::Init自己用getopt解析"-i 配置文件"
+    std::string prog = argv[0];
+    std::string flag = "-i";
+    char *init_argv[] = {&prog[0], &flag[0], &options.config[0], nullptr};
+    optind = 1;
+    KrpcApplication::Init(3, init_argv);
+
+    std::vector<RequestTemplate> templates;
+    if (!BuildTemplates(options, &templates)) {
+        return 1;
+    }
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < options.connections; ++i) {
+        workers.emplace_back(new Worker(options, templates, i));
+    }
+
+    printf("%s arrivals, %d connections, warm-up %.1fs, %.1fs per rate; latency measured from the intended send time\n",
+           options.poisson ? "poisson" : "constant", options.connections, options.warmup_s, options.duration_s);
+    PrintHeader();
+    std::vector<StepReport> reports;
+    for (double rate : options.rates) {
+        reports.push_back(RunStep(options, workers, rate));
+        PrintStep(reports.back());
+    }
+    if (!options.csv.empty()) {
+        WriteCsv(options.csv, reports);
+    }
+    return 0;
+}
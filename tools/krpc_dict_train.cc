@@ -0,0 +1,111 @@
+// 从抓取的消息样本训练某个方法的Zstd字典：
+//   krpc_dict_train [-s 字典大小] [-f] -o <服务名>.<方法名>.dict 样本文件...
+// 默认每个样本文件是一条序列化后的消息；加-f时每个文件包含多条消息，
+// 每条前面是4字节小端序的长度。把生成的字典放到两端的compress_dict_dir目录中即可热加载
+#include <zdict.h>
+#include <zstd.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+const size_t kDefaultDictSize = 16 * 1024;
+
+void Usage(const char *prog) {
+    std::cerr << "usage: " << prog << " [-s dict_size] [-f] -o Service.Method.dict samples..." << std::endl;
+}
+
+bool ReadFile(const std::string &path, std::string *data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    data->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    size_t dict_size = kDefaultDictSize;
+    bool framed = false;
+    std::string output;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:fo:")) != -1) {
+        switch (opt) {
+        case 's':
+            dict_size = strtoull(optarg, nullptr, 10);
+            break;
+        case 'f':
+            framed = true;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if (output.empty() || optind >= argc || dict_size == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    // 所有样本首尾相接放在一起，另外记录每条样本的长度
+    std::string samples;
+    std::vector<size_t> sizes;
+    for (int i = optind; i < argc; ++i) {
+        std::string data;
+        if (!ReadFile(argv[i], &data)) {
+            std::cerr << "read " << argv[i] << " error" << std::endl;
+            return 1;
+        }
+        if (!framed) {
+            samples += data;
+            sizes.push_back(data.size());
+            continue;
+        }
+        size_t pos = 0;
+        while (pos + 4 <= data.size()) {
+            const unsigned char *p = reinterpret_cast<const unsigned char *>(data.data() + pos);
+            uint32_t len = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+            pos += 4;
+            if (len > data.size() - pos) {
+                std::cerr << argv[i] << ": truncated sample at offset " << pos - 4 << std::endl;
+                return 1;
+            }
+            samples.append(data, pos, len);
+            sizes.push_back(len);
+            pos += len;
+        }
+    }
+    if (sizes.empty()) {
+        std::cerr << "no samples" << std::endl;
+        return 1;
+    }
+
+    // 训练出的字典头部带有随机的字典ID，两端据此找到同一个字典
+    std::string dict(dict_size, '\0');
+    size_t n = ZDICT_trainFromBuffer(&dict[0], dict.size(), samples.data(), sizes.data(),
+                                     static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(n)) {
+        std::cerr << "train dictionary error: " << ZDICT_getErrorName(n) << std::endl;
+        return 1;
+    }
+    dict.resize(n);
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out.write(dict.data(), dict.size())) {
+        std::cerr << "write " << output << " error" << std::endl;
+        return 1;
+    }
+    std::cout << "trained dictionary " << ZDICT_getDictID(dict.data(), dict.size()) << " (" << dict.size()
+              << " bytes) from " << sizes.size() << " samples into " << output << std::endl;
+    return 0;
+}
@@ -0,0 +1,289 @@
+// 请求路径上各个环节的微基准（Google Benchmark），单独测量每次调用的固定开销，在上线前发现退化：
+//   krpc_microbench [--benchmark_filter=Header] [--benchmark_format=json]
+// 带负载大小参数的基准在64B到256KB之间测量，SetBytesProcessed报告的是负载的吞吐
+#include "Krpccodec.h"
+#include "Krpcconfig.h"
+#include "EpollServer.h"
+#include "user.pb.h"
+#include <benchmark/benchmark.h>
+#include <google/protobuf/descriptor.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+void PayloadSizes(benchmark::internal::Benchmark *bench) {
+    for (int64_t size : {64, 1024, 16384, 262144}) {
+        bench->Arg(size);
+    }
+}
+
+// 与KrpcChannel::CallMethod中的请求头相同的字段
+Krpc::RpcHeader MakeHeader(size_t args_size) {
+    Krpc::RpcHeader header;
+    header.set_service_name("UserServiceRpc");
+    header.set_method_name("Login");
+    header.set_call_id(123456789);
+    header.set_args_size(static_cast<uint32_t>(args_size));
+    header.set_framed_response(true);
+    header.set_accept_fragment(true);
+    header.set_accept_compress(3);
+    Krpc::TraceContext *trace = header.mutable_trace();
+    trace->set_trace_id(0x0123456789abcdefULL);
+    trace->set_span_id(0x1122334455667788ULL);
+    trace->set_sampled(true);
+    return header;
+}
+
+Kuser::LoginRequest MakeRequest(size_t payload) {
+    Kuser::LoginRequest request;
+    request.set_name(std::string(payload, 'k'));
+    request.set_pwd("123456");
+    return request;
+}
+
+// 请求头单独序列化和解析，不含负载
+void BM_HeaderSerialize(benchmark::State &state) {
+    Krpc::RpcHeader header = MakeHeader(1024);
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        header.SerializeToString(&out);
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+BENCHMARK(BM_HeaderSerialize);
+
+void BM_HeaderParse(benchmark::State &state) {
+    std::string data = MakeHeader(1024).SerializeAsString();
+    Krpc::RpcHeader header;
+    for (auto _ : state) {
+        header.ParseFromArray(data.data(), static_cast<int>(data.size()));
+        benchmark::DoNotOptimize(header.call_id());
+    }
+}
+BENCHMARK(BM_HeaderParse);
+
+// socket路径：负载已经序列化成std::string，EncodeRequest再把头部和负载拷贝进帧
+void BM_EncodeRequest(benchmark::State &state) {
+    std::string args = MakeRequest(static_cast<size_t>(state.range(0))).SerializeAsString();
+    Krpc::RpcHeader header = MakeHeader(args.size());
+    std::string frame;
+    for (auto _ : state) {
+        frame.clear();
+        KrpcCodec::EncodeRequest(header, args, &frame);
+        benchmark::DoNotOptimize(frame.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(args.size()));
+}
+BENCHMARK(BM_EncodeRequest)->Apply(PayloadSizes);
+
+// 共享内存/UCX路径：头部和负载直接写入预先分配的内存，没有中间的std::string
+void BM_WriteFrame(benchmark::State &state) {
+    Kuser::LoginRequest request = MakeRequest(static_cast<size_t>(state.range(0)));
+    Krpc::RpcHeader header = MakeHeader(request.ByteSizeLong());
+    std::string buffer(KrpcCodec::FrameSize(header, header.args_size()), '\0');
+    for (auto _ : state) {
+        header.set_args_size(static_cast<uint32_t>(request.ByteSizeLong()));
+        KrpcCodec::FrameSize(header, header.args_size());
+        char *end = KrpcCodec::WriteFrame(header, request, &buffer[0]);
+        benchmark::DoNotOptimize(end);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(header.args_size()));
+}
+BENCHMARK(BM_WriteFrame)->Apply(PayloadSizes);
+
+// 只解析头部，负载留在原处，耗时应当与负载大小无关
+void BM_DecodeRequest(benchmark::State &state) {
+    std::string args = MakeRequest(static_cast<size_t>(state.range(0))).SerializeAsString();
+    std::string frame;
+    KrpcCodec::EncodeRequest(MakeHeader(args.size()), args, &frame);
+    Krpc::RpcHeader header;
+    size_t payload_offset = 0;
+    size_t frame_size = 0;
+    for (auto _ : state) {
+        KrpcCodec::DecodeStatus status =
+            KrpcCodec::DecodeRequest(frame.data(), frame.size(), &header, &payload_offset, &frame_size);
+        benchmark::DoNotOptimize(status);
+    }
+}
+BENCHMARK(BM_DecodeRequest)->Apply(PayloadSizes);
+
+// KrpcChannel::CallMethod在socket路径上构造一个请求帧的全部工作：填请求头、序列化参数、编码成帧
+void BM_BuildCallFrame(benchmark::State &state) {
+    Kuser::LoginRequest request = MakeRequest(static_cast<size_t>(state.range(0)));
+    const std::string service_name = "UserServiceRpc";
+    const std::string method_name = "Login";
+    uint64_t call_id = 0;
+    for (auto _ : state) {
+        Krpc::RpcHeader header;
+        header.set_service_name(service_name);
+        header.set_method_name(method_name);
+        header.set_call_id(++call_id);
+        header.set_attachment_size(0);
+        header.set_framed_response(true);
+        header.set_accept_fragment(true);
+        std::string args_str;
+        request.SerializeToString(&args_str);
+        header.set_args_size(static_cast<uint32_t>(args_str.size()));
+        header.set_accept_compress(0);
+        std::string send_rpc_str;
+        KrpcCodec::EncodeRequest(header, args_str, &send_rpc_str);
+        benchmark::DoNotOptimize(send_rpc_str.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BuildCallFrame)->Apply(PayloadSizes);
+
+// EpollServer的Buffer：一次追加一个负载，再整体取出
+void BM_BufferAppendRetrieve(benchmark::State &state) {
+    std::string payload(static_cast<size_t>(state.range(0)), 'k');
+    Buffer buffer;
+    for (auto _ : state) {
+        buffer.append(payload.data(), payload.size());
+        std::string out = buffer.retrieveAllAsString();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BufferAppendRetrieve)->Apply(PayloadSizes);
+
+// ThreadPool::enqueue的吞吐，参数是工作线程数；计时包括等待所有任务执行完
+void BM_ThreadPoolEnqueue(benchmark::State &state) {
+    const int kBatch = 1024;
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+    std::atomic<int64_t> done(0);
+    int64_t submitted = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < kBatch; ++i) {
+            pool.enqueue([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+        submitted += kBatch;
+        while (done.load(std::memory_order_relaxed) != submitted) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_ThreadPoolEnqueue)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// 本机回环上EpollServer的乒乓往返延迟，参数是epoll线程的自旋预算（微秒），0表示阻塞等待，
+// 两者之差就是自旋省下的唤醒开销。每次迭代是一个64字节的消息发出去再完整收回来
+void BM_EpollPingPong(benchmark::State &state) {
+    const int kPingPongPort = 18700;
+    EpollServer server;
+    EpollServer::BusyPollOptions options;
+    options.spin_us = static_cast<int>(state.range(0));
+    server.setBusyPollOptions(options);
+    server.setCpuAffinity(std::vector<int>(), std::vector<int>());
+    server.setMessageCallback([](std::shared_ptr<TcpConnection> conn, std::shared_ptr<Buffer> buffer) {
+        conn->send(buffer->retrieveAllAsString());
+    });
+    int port = kPingPongPort + static_cast<int>(state.range(0));
+    if (!server.start("127.0.0.1", port)) {
+        state.SkipWithError("start epoll server error");
+        return;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if (fd == -1 || connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1) {
+        state.SkipWithError("connect epoll server error");
+        if (fd != -1) {
+            close(fd);
+        }
+        return;
+    }
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    char message[64] = {};
+    char reply[sizeof(message)];
+    for (auto _ : state) {
+        if (send(fd, message, sizeof(message), 0) != static_cast<ssize_t>(sizeof(message))) {
+            state.SkipWithError("send error");
+            break;
+        }
+        size_t received = 0;
+        while (received < sizeof(reply)) {
+            ssize_t n = recv(fd, reply + received, sizeof(reply) - received, 0);
+            if (n <= 0) {
+                break;
+            }
+            received += static_cast<size_t>(n);
+        }
+        if (received < sizeof(reply)) {
+            state.SkipWithError("recv error");
+            break;
+        }
+    }
+    close(fd);
+    server.stop();
+}
+BENCHMARK(BM_EpollPingPong)->Arg(0)->Arg(50)->UseRealTime();
+
+// KrpcProvider::HandleRequest中按服务名、方法名查找方法的两级哈希表，结构与service_map/method_map相同
+void BM_ServiceMethodDispatch(benchmark::State &state) {
+    struct ServiceInfo
+    {
+        std::unordered_map<std::string, const google::protobuf::MethodDescriptor *> method_map;
+    };
+    std::unordered_map<std::string, ServiceInfo> service_map;
+    const google::protobuf::ServiceDescriptor *descriptor = Kuser::UserServiceRpc::descriptor();
+    for (int i = 0; i < descriptor->method_count(); ++i) {
+        service_map[descriptor->name()].method_map.emplace(descriptor->method(i)->name(), descriptor->method(i));
+    }
+    // 再放一些其他服务，让哈希表的规模接近实际部署
+    for (int i = 0; i < static_cast<int>(state.range(0)); ++i) {
+        service_map["Service" + std::to_string(i)].method_map.emplace("Method", descriptor->method(0));
+    }
+    Krpc::RpcHeader header = MakeHeader(0);
+    for (auto _ : state) {
+        auto it = service_map.find(header.service_name());
+        auto mit = it->second.method_map.find(header.method_name());
+        benchmark::DoNotOptimize(mit->second);
+    }
+}
+BENCHMARK(BM_ServiceMethodDispatch)->Arg(0)->Arg(64);
+
+// Krpcconfig::Load，请求路径上按需读取配置时的开销
+void BM_ConfigLoad(benchmark::State &state) {
+    char path[] = "/tmp/krpc_microbench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        state.SkipWithError("create config file error");
+        return;
+    }
+    FILE *fp = fdopen(fd, "w");
+    for (int i = 0; i < 64; ++i) {
+        fprintf(fp, "key_%d=value_%d\n", i, i);
+    }
+    fprintf(fp, "rpcserverip=127.0.0.1\nrpcserverport=8000\n");
+    fclose(fp);
+    Krpcconfig config;
+    config.LoadConfigFile(path);
+    unlink(path);
+    const std::string key = state.range(0) != 0 ? "rpcserverport" : "not_configured";
+    for (auto _ : state) {
+        std::string value = config.Load(key);
+        benchmark::DoNotOptimize(value.data());
+    }
+    state.SetLabel(state.range(0) != 0 ? "hit" : "miss");
+}
+BENCHMARK(BM_ConfigLoad)->Arg(1)->Arg(0);
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,352 @@
+// 重放服务端抓取的请求（见KrpcCapture，配置capture_file），按真实的方法分布和负载压测任意一个服务端：
+//   krpc_replay -f capture.bin -a 127.0.0.1:8000 [-x 1|N|max] [-c connections] [-l loops] [-t timeout_ms]
+//   -x 重放速度：1按抓包时的间隔（默认），N表示N倍速，max表示每个连接收到响应后立即发下一个请求
+//   -c 连接数，请求按顺序轮流分给各个连接，每个连接一个线程
+//   -l 重放的遍数，每一遍接在上一遍之后
+//   -t 单次调用的超时（毫秒），默认5000，超时的调用计为失败并重建连接
+// 直接按帧格式发送抓到的参数和附件，不需要业务的.pb.cc，也不经过ZooKeeper。
+// 按间隔重放时耗时从请求按计划应该发出的时刻算起，服务端变慢导致连接落后时排队的时间也计入耗时；
+// max速度下是闭环压测，耗时从实际发出的时刻算起
+#include "KrpcCapture.h"
+#include "Krpccodec.h"
+#include "KrpcMetrics.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+struct ReplayOptions
+{
+    std::string file;
+    std::string ip;
+    uint16_t port = 0;
+    double speed = 1; // 0表示max
+    int connections = 8;
+    int loops = 1;
+    int timeout_ms = 5000;
+};
+
+// 一个连接上某个方法的统计
+struct MethodResult
+{
+    KrpcHistogram latency; // 纳秒
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+};
+
+struct WorkerResult
+{
+    std::vector<MethodResult> methods; // 按方法编号
+    uint64_t max_lag_ns = 0;           // 实际发出时刻晚于计划时刻的最大值
+};
+
+void Usage(const char *prog) {
+    std::cerr << "usage: " << prog
+              << " -f capture_file -a ip:port [-x 1|N|max] [-c connections] [-l loops] [-t timeout_ms]" << std::endl;
+}
+
+uint64_t ElapsedNanos(Clock::time_point from, Clock::time_point to) {
+    return to > from ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count())
+                     : 0;
+}
+
+// 一个阻塞的TCP连接，按帧收发，超时或出错后关闭，下次调用时重新连接
+class ReplayConnection
+{
+public:
+    explicit ReplayConnection(const ReplayOptions &options) : options_(options) {}
+    ~ReplayConnection() { Close(); }
+
+    bool Call(const KrpcCapture::Entry &entry, uint64_t call_id) {
+        if (fd_ == -1 && !Connect()) {
+            return false;
+        }
+        Krpc::RpcHeader header = entry.header;
+        header.set_call_id(call_id);
+        header.set_framed_response(true);
+        frame_.clear();
+        if (!KrpcCodec::EncodeRequest(header, entry.args, &frame_)) {
+            return false;
+        }
+        struct iovec iov[2];
+        iov[0].iov_base = &frame_[0];
+        iov[0].iov_len = frame_.size();
+        iov[1].iov_base = const_cast<char *>(entry.attachment.data());
+        iov[1].iov_len = entry.attachment.size();
+        if (!WriteAll(iov, entry.attachment.empty() ? 1 : 2)) {
+            Close();
+            return false;
+        }
+        // 读到call_id相同的完整响应帧为止；没有响应（例如服务端找不到方法）时以超时结束
+        while (true) {
+            Krpc::RpcResponseHeader response;
+            size_t payload_offset = 0;
+            size_t frame_size = 0;
+            KrpcCodec::DecodeStatus status =
+                KrpcCodec::DecodeResponse(buffer_.data(), buffer_.size(), &response, &payload_offset, &frame_size);
+            if (status == KrpcCodec::DecodeStatus::kError) {
+                Close();
+                return false;
+            }
+            if (status == KrpcCodec::DecodeStatus::kComplete) {
+                buffer_.erase(0, frame_size);
+                if (response.call_id() == call_id) {
+                    return true;
+                }
+                continue;  // 之前超时的调用迟到的响应
+            }
+            char buf[65536];
+            ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                Close();
+                return false;
+            }
+            buffer_.append(buf, static_cast<size_t>(n));
+        }
+    }
+
+private:
+    bool Connect() {
+        fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd_ == -1) {
+            return false;
+        }
+        struct timeval tv;
+        tv.tv_sec = options_.timeout_ms / 1000;
+        tv.tv_usec = (options_.timeout_ms % 1000) * 1000;
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(options_.port);
+        inet_pton(AF_INET, options_.ip.c_str(), &addr.sin_addr);
+        if (connect(fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    bool WriteAll(struct iovec *iov, int count) {
+        while (count > 0) {
+            ssize_t n = writev(fd_, iov, count);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            size_t written = static_cast<size_t>(n);
+            while (count > 0 && written >= iov->iov_len) {
+                written -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char *>(iov->iov_base) + written;
+                iov->iov_len -= written;
+            }
+        }
+        return true;
+    }
+
+    void Close() {
+        if (fd_ != -1) {
+            close(fd_);
+            fd_ = -1;
+        }
+        buffer_.clear();
+    }
+
+    const ReplayOptions &options_;
+    int fd_ = -1;
+    std::string frame_;
+    std::string buffer_;
+};
+
+// 一个连接的重放线程，负责下标为index, index+connections, ...的请求
+void RunWorker(const ReplayOptions &options, const std::vector<KrpcCapture::Entry> &entries,
+               const std::vector<int> &method_of, int64_t first_arrival_ns, int64_t span_ns, Clock::time_point start,
+               int index, WorkerResult *result) {
+    ReplayConnection conn(options);
+    uint64_t call_id = static_cast<uint64_t>(index) << 48;
+    for (int loop = 0; loop < options.loops; ++loop) {
+        for (size_t i = static_cast<size_t>(index); i < entries.size(); i += static_cast<size_t>(options.connections)) {
+            Clock::time_point intended = Clock::now();
+            if (options.speed > 0) {
+                double offset_ns = (entries[i].arrival_unix_ns - first_arrival_ns + loop * span_ns) / options.speed;
+                intended = start + std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(
+                                       static_cast<int64_t>(offset_ns)));
+                if (Clock::now() < intended) {
+                    std::this_thread::sleep_until(intended);
+                }
+            }
+            Clock::time_point sent = Clock::now();
+            bool ok = conn.Call(entries[i], ++call_id);
+            Clock::time_point done = Clock::now();
+            MethodResult &method = result->methods[method_of[i]];
+            method.latency.Record(ElapsedNanos(intended, done));
+            ++method.calls;
+            method.errors += ok ? 0 : 1;
+            result->max_lag_ns = std::max(result->max_lag_ns, ElapsedNanos(intended, sent));
+        }
+    }
+}
+
+void PrintRow(const std::string &name, const MethodResult &result) {
+    const KrpcHistogram &latency = result.latency;
+    printf("%-40s %9llu %7llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", name.c_str(),
+           static_cast<unsigned long long>(result.calls), static_cast<unsigned long long>(result.errors),
+           latency.ValueAtQuantile(0.5) / 1000.0, latency.ValueAtQuantile(0.9) / 1000.0,
+           latency.ValueAtQuantile(0.99) / 1000.0, latency.ValueAtQuantile(0.999) / 1000.0, latency.Max() / 1000.0);
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    ReplayOptions options;
+    std::string address;
+    int opt;
+    while ((opt = getopt(argc, argv, "f:a:x:c:l:t:")) != -1) {
+        switch (opt) {
+        case 'f':
+            options.file = optarg;
+            break;
+        case 'a':
+            address = optarg;
+            break;
+        case 'x':
+            options.speed = std::string(optarg) == "max" ? 0 : atof(optarg);
+            if (options.speed <= 0 && std::string(optarg) != "max") {
+                Usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'c':
+            options.connections = atoi(optarg);
+            break;
+        case 'l':
+            options.loops = atoi(optarg);
+            break;
+        case 't':
+            options.timeout_ms = atoi(optarg);
+            break;
+        default:
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    size_t colon = address.rfind(':');
+    if (options.file.empty() || colon == std::string::npos || options.connections <= 0 || options.loops <= 0 ||
+        options.timeout_ms <= 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+    options.ip = address.substr(0, colon);
+    options.port = static_cast<uint16_t>(atoi(address.c_str() + colon + 1));
+
+    std::vector<KrpcCapture::Entry> entries;
+    std::string error;
+    if (!KrpcCapture::ReadFile(options.file, &entries, &error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (entries.empty()) {
+        std::cerr << options.file << " has no requests" << std::endl;
+        return 1;
+    }
+    // 抓包按写出的顺序保存，不同IO线程的请求之间可能略有乱序
+    std::stable_sort(entries.begin(), entries.end(), [](const KrpcCapture::Entry &a, const KrpcCapture::Entry &b) {
+        return a.arrival_unix_ns < b.arrival_unix_ns;
+    });
+
+    std::map<std::string, int> method_ids;
+    std::vector<std::string> method_names;
+    std::vector<int> method_of(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        std::string name = entries[i].header.service_name() + "." + entries[i].header.method_name();
+        std::map<std::string, int>::iterator it = method_ids.find(name);
+        if (it == method_ids.end()) {
+            it = method_ids.emplace(name, static_cast<int>(method_names.size())).first;
+            method_names.push_back(name);
+        }
+        method_of[i] = it->second;
+    }
+    int64_t first_arrival_ns = entries.front().arrival_unix_ns;
+    // 一遍的时长加上平均间隔，下一遍的第一个请求不会与上一遍的最后一个请求同时发出
+    int64_t captured_ns = entries.back().arrival_unix_ns - first_arrival_ns;
+    int64_t span_ns = captured_ns + captured_ns / static_cast<int64_t>(entries.size());
+
+    char speed[32] = "max";
+    if (options.speed > 0) {
+        snprintf(speed, sizeof(speed), "%gx", options.speed);
+    }
+    printf("replaying %zu requests (%zu methods, %.1fs captured) to %s, speed %s, %d connections, %d loops\n",
+           entries.size(), method_names.size(), captured_ns / 1e9, address.c_str(), speed, options.connections,
+           options.loops);
+
+    std::vector<WorkerResult> results(static_cast<size_t>(options.connections));
+    for (WorkerResult &result : results) {
+        result.methods.resize(method_names.size());
+    }
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(10);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.connections; ++i) {
+        WorkerResult *result = &results[static_cast<size_t>(i)];
+        threads.emplace_back([&options, &entries, &method_of, first_arrival_ns, span_ns, start, i, result]() {
+            RunWorker(options, entries, method_of, first_arrival_ns, span_ns, start, i, result);
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+    MethodResult total;
+    std::vector<MethodResult> methods(method_names.size());
+    uint64_t max_lag_ns = 0;
+    for (const WorkerResult &result : results) {
+        for (size_t m = 0; m < methods.size(); ++m) {
+            methods[m].latency.Merge(result.methods[m].latency);
+            methods[m].calls += result.methods[m].calls;
+            methods[m].errors += result.methods[m].errors;
+        }
+        max_lag_ns = std::max(max_lag_ns, result.max_lag_ns);
+    }
+    printf("%-40s %9s %7s %10s %10s %10s %10s %10s\n", "method", "calls", "errors", "p50(us)", "p90(us)", "p99(us)",
+           "p99.9(us)", "max(us)");
+    for (size_t m = 0; m < methods.size(); ++m) {
+        PrintRow(method_names[m], methods[m]);
+        total.latency.Merge(methods[m].latency);
+        total.calls += methods[m].calls;
+        total.errors += methods[m].errors;
+    }
+    PrintRow("total", total);
+    printf("elapsed %.2fs, %.0f calls/s", elapsed_s, total.calls / elapsed_s);
+    if (options.speed > 0) {
+        printf(", captured rate x%.2f = %.0f calls/s, max send lag %.1fms", options.speed,
+               captured_ns > 0 ? entries.size() * options.speed / (captured_ns / 1e9) : 0.0, max_lag_ns / 1e6);
+    }
+    printf("\n");
+    return total.errors == 0 ? 0 : 2;
+}